@@ -0,0 +1,189 @@
+#include <frame_layout.h>
+#include <pixel_format_converter.h>
+
+#include "conversion/conversion_cpu_features.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+struct FormatName {
+    PixelFormat pixelFormat;
+    const char *name;
+};
+
+#define FORMAT(name) {PixelFormat::name, #name}
+
+// uncompressed formats, every pair of them the converter supports gets benchmarked
+const FormatName FORMATS[] = {
+    FORMAT(RGB1), FORMAT(RGB4), FORMAT(RGB8), FORMAT(RGB555), FORMAT(RGB565), FORMAT(RGB24), FORMAT(RGB32),
+    FORMAT(BGRA32), FORMAT(BE16_555), FORMAT(BE16_565), FORMAT(LE16_555), FORMAT(LE16_565), FORMAT(LE16_5551),
+    FORMAT(ARGB1555), FORMAT(ARGB32), FORMAT(ARGB4444), FORMAT(A2R10G10B10), FORMAT(A2B10G10R10), FORMAT(IA44),
+    FORMAT(AI44), FORMAT(AYUV), FORMAT(I420), FORMAT(IYUV), FORMAT(NV11), FORMAT(NV12), FORMAT(UYVY), FORMAT(YUYV),
+    FORMAT(Y211), FORMAT(Y411), FORMAT(Y41P), FORMAT(Y41T), FORMAT(Y42T), FORMAT(YUY2), FORMAT(YV12), FORMAT(IMC1),
+    FORMAT(IMC2), FORMAT(IMC3), FORMAT(IMC4), FORMAT(IF09), FORMAT(YVU9), FORMAT(YVYU), FORMAT(Y800), FORMAT(P010),
+    FORMAT(P016), FORMAT(P210), FORMAT(P216), FORMAT(v210), FORMAT(v216), FORMAT(v308), FORMAT(v408), FORMAT(v410),
+    FORMAT(Y210), FORMAT(Y216), FORMAT(Y410), FORMAT(Y416), FORMAT(BayerRGGB8), FORMAT(BayerGRBG8), FORMAT(BayerGBRG8),
+    FORMAT(BayerBGGR8), FORMAT(BayerRGGB10), FORMAT(BayerGRBG10), FORMAT(BayerGBRG10), FORMAT(BayerBGGR10),
+    FORMAT(BayerRGGB12), FORMAT(BayerGRBG12), FORMAT(BayerGBRG12), FORMAT(BayerBGGR12), FORMAT(O420),
+    FORMAT(RGB32_D3D_DX7_RT), FORMAT(RGB16_D3D_DX7_RT), FORMAT(ARGB32_D3D_DX7_RT), FORMAT(ARGB4444_D3D_DX7_RT),
+    FORMAT(ARGB1555_D3D_DX7_RT), FORMAT(RGB32_D3D_DX9_RT), FORMAT(RGB16_D3D_DX9_RT), FORMAT(ARGB32_D3D_DX9_RT),
+    FORMAT(ARGB4444_D3D_DX9_RT), FORMAT(ARGB1555_D3D_DX9_RT), FORMAT(CLJR), FORMAT(IndexedGray8_WhiteIsZero)
+};
+
+#undef FORMAT
+
+const struct {
+    size_t width;
+    size_t height;
+} RESOLUTIONS[] = {
+    {640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160}
+};
+
+const struct {
+    Conversion_CpuFeatures::SimdLevel level;
+    const char *name;
+} SIMD_LEVELS[] = {
+    {Conversion_CpuFeatures::SimdLevel::None, "C"},
+    {Conversion_CpuFeatures::SimdLevel::SSE2, "SSE2"},
+    {Conversion_CpuFeatures::SimdLevel::AVX2, "AVX2"}
+};
+
+struct Case {
+    PixelFormat source;
+    PixelFormat destination;
+    size_t width;
+    size_t height;
+    size_t threads;
+    Conversion_CpuFeatures::SimdLevel simdLevel;
+};
+
+void convert(benchmark::State &state, Case c)
+{
+    Conversion_CpuFeatures::setMaxSimdLevel(c.simdLevel);
+    PixelFormatConverter::setThreadCount(c.threads);
+
+    Frame frame = Frame();
+    frame.pixelFormat = c.source;
+    std::vector<uint8_t> sourceBuffer(FrameLayout::setLayout(frame, c.width, c.height));
+    frame.plane[0] = sourceBuffer.data();
+
+    // noise, so that no kernel gets to take a shortcut on flat input
+    uint32_t seed = 1;
+
+    for (uint8_t &byte : sourceBuffer) {
+        seed = seed * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+
+    Frame converted = Frame();
+    converted.pixelFormat = c.destination;
+    std::vector<uint8_t> destinationBuffer(PixelFormatConverter::getDestinationLayout(frame, converted));
+    converted.plane[0] = destinationBuffer.data();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto _ : state) {
+        Frame destination = converted;
+
+        if (!PixelFormatConverter::convertInto(frame, destination)) {
+            state.SkipWithError("Conversion failed.");
+            break;
+        }
+
+        benchmark::DoNotOptimize(destination.plane[0]);
+        benchmark::ClobberMemory();
+    }
+
+    // wall-clock time, like the benchmarks report with UseRealTime()
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double frames = static_cast<double>(state.iterations());
+    const double bytes = frames * (sourceBuffer.size() + destinationBuffer.size());
+
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    // pixels per second, which the counter shows with an M for millions
+    state.counters["MPix"] = benchmark::Counter(frames * c.width * c.height, benchmark::Counter::kIsRate);
+    // over the cycles of the nominal clock, as cycle counters of the cores aren't portably readable, so turbo and
+    // power saving skew it
+    state.counters["bytes/nominal cycle"] = bytes / (elapsed.count() * benchmark::CPUInfo::Get().cycles_per_second);
+
+    Conversion_CpuFeatures::setMaxSimdLevel(Conversion_CpuFeatures::SimdLevel::AVX2);
+    PixelFormatConverter::setThreadCount(1);
+}
+
+/**
+ * Registers a benchmark for every supported pair of formats, at every resolution, single and multi-threaded, at every
+ * SIMD level the CPU has.
+ * Names read source>destination/WIDTHxHEIGHT/threads:N/LEVEL, for --benchmark_filter to pick from.
+ */
+void registerBenchmarks()
+{
+    std::vector<size_t> threadCounts(1, 1);
+    const size_t cores = std::thread::hardware_concurrency();
+
+    if (cores > 1) {
+        threadCounts.push_back(cores);
+    }
+
+    for (const FormatName &source : FORMATS) {
+        for (const FormatName &destination : FORMATS) {
+            for (const auto &resolution : RESOLUTIONS) {
+                Frame frame = Frame();
+                frame.pixelFormat = source.pixelFormat;
+                frame.width[0] = resolution.width;
+                frame.height[0] = resolution.height;
+
+                Frame converted = Frame();
+                converted.pixelFormat = destination.pixelFormat;
+
+                if (source.pixelFormat == destination.pixelFormat ||
+                    !PixelFormatConverter::getDestinationLayout(frame, converted)) {
+                    continue;
+                }
+
+                for (size_t threads : threadCounts) {
+                    for (const auto &simd : SIMD_LEVELS) {
+                        if (simd.level > Conversion_CpuFeatures::getSimdLevel()) {
+                            continue;
+                        }
+
+                        const Case c = {source.pixelFormat, destination.pixelFormat, resolution.width,
+                                        resolution.height, threads, simd.level
+                                       };
+                        const std::string name = std::string(source.name) + ">" + destination.name + "/" +
+                                                 std::to_string(resolution.width) + "x" +
+                                                 std::to_string(resolution.height) + "/threads:" +
+                                                 std::to_string(threads) + "/" + simd.name;
+
+                        benchmark::RegisterBenchmark(name.c_str(), convert, c)->Unit(benchmark::kMicrosecond)
+                        ->UseRealTime();
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
@@ -3,11 +3,7 @@
 
 #include <backend_implementation.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 #include <memory>
 #include <vector>
@@ -19,11 +15,7 @@ class BackendInterface;
 /**
  * Provides access to backends and information of their availability.
  */
-#ifdef _WIN32
 class WEBCAM_CAPTURE_EXPORT BackendFactory
-#elif __APPLE__
-class BackendFactory
-#endif
 {
 public:
     /**
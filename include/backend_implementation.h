@@ -10,7 +10,8 @@ enum class BackendImplementation {
     MediaFoundation,
     DirectShow,
     v4l, //TODO to fix v4l name. (maybe it using v4l2???)
-    AVFoundation
+    AVFoundation,
+    Synthetic // test pattern camera available on every platform, for testing without a camera
 };
 
 } // namespace webcam_capture
@@ -4,11 +4,7 @@
 #include <camera_information.h>
 #include <backend_implementation.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 #include <functional>
 #include <memory>
@@ -18,11 +14,7 @@ namespace webcam_capture {
 
 class CameraInterface;
 
-#ifdef _WIN32
-    enum class WEBCAM_CAPTURE_EXPORT CameraConnectionState {
-#elif __APPLE__
-    enum class CameraConnectionState {
-#endif
+enum class WEBCAM_CAPTURE_EXPORT CameraConnectionState {
 
     Connected, // camera was connected to the system and it's available for use
     Disconnected // camera was disconnected from the system and you should stop using it
@@ -35,11 +27,7 @@ typedef std::function<void(CameraInformation information, CameraConnectionState
  * Provides access to cameras and information of their availability.
  */
 
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT BackendInterface
-#elif __APPLE__
-    class BackendInterface
-#endif
+class WEBCAM_CAPTURE_EXPORT BackendInterface
 {
 public:
     BackendInterface(BackendImplementation implementation) : implementation(implementation) {}
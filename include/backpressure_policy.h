@@ -0,0 +1,25 @@
+#ifndef BACKPRESSURE_POLICY_H
+#define BACKPRESSURE_POLICY_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * What happens to frames that come in while the queue of FrameDelivery::Queued is full, because the callback fell
+ * behind.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT BackpressurePolicy {
+    DropNewest,   // the frame that came in is dropped, the callback catches up on the queued ones
+    DropOldest,   // the oldest queued frame is dropped, the callback gets the newest frames, for the lowest latency
+    Block,        // the capture thread waits for the callback, no frame is dropped and capturing slows down
+    KeyframesOnly // a keyframe that comes in replaces all queued frames, which it doesn't need to be decoded, and
+                  // other frames are dropped along with all frames up to the next keyframe, so that the callback
+                  // never gets a frame of a compressed stream it can't decode. Frames of uncompressed and intra-only
+                  // formats, e.g. MJPEG, are all keyframes
+};
+
+} // namespace webcam_capture
+
+#endif // BACKPRESSURE_POLICY_H
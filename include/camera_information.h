@@ -1,11 +1,7 @@
 #ifndef CAMERA_INFORMATION_H
 #define CAMERA_INFORMATION_H
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 #include <memory>
 #include <string>
@@ -17,11 +13,7 @@ class UniqueId;
 /**
  * Provides a brief description of a camera.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT CameraInformation
-#elif __APPLE__
-    class CameraInformation
-#endif
+class WEBCAM_CAPTURE_EXPORT CameraInformation
 {
 public:
     CameraInformation(std::shared_ptr<UniqueId> uniqueId, std::string cameraName) : uniqueId(uniqueId),
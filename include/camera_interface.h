@@ -1,16 +1,16 @@
 #ifndef CAMERA_INTERFACE_H
 #define CAMERA_INTERFACE_H
 
+#include <backpressure_policy.h>
 #include <capability.h>
+#include <decompression_scale.h>
 #include <frame.h>
+#include <frame_delivery.h>
+#include <frame_drop_statistics.h>
 #include <video_property.h>
 #include <video_property_range.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 #include <functional>
 #include <memory>
@@ -24,11 +24,7 @@ typedef std::function<void(Frame &frame)> FrameCallback;
  * Common interface of backend implementations.
  * Provides access to video capturing and camera information.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT CameraInterface
-#elif __APPLE__
-    class CameraInterface
-#endif
+class WEBCAM_CAPTURE_EXPORT CameraInterface
 {
 public:
     CameraInterface() {}
@@ -46,12 +42,24 @@ public:
      * @param width Width part of resolution of the captured video frames.
      * @param height Height part of resolution of the captured video frames.
      * @param fps Frame rate of capturing.
-     * @param callback Callback with the captured video frame data.
-     * @param decodeFormat Pixel format decode in
+     * @param callback Callback with the captured video frame data. The frame is valid only during the callback, wrap a
+     * callback with FrameRef::wrapCallback() to get frames that can be kept past it.
+     * @param decodeFormat Pixel format to deliver the frames in, if it differs from the captured one. The frames get
+     * converted in software along the cheapest chain of conversions, see PixelFormatConverter::getConversionPath().
+     * Backends with a color converter of their own use it for the conversions there is no such chain for.
      * @param decompressFormat Decompress format or intermediate format if you wan't decompres and convert formats in one step
+     * MJPEG can be decompressed in software on every backend, into RGB24, RGB32, BGRA32, ARGB32, YUY2, YUYV, I420, IYUV
+     * or NV12, if the library was built with libjpeg-turbo. Backends with a decompresser of their own prefer it for
+     * full size decompression.
+     * @param decompressScale Scale to decompress at, frames get delivered at the reduced size. Anything but
+     * DecompressionScale::Full is done in software.
+     * @param delivery Thread to call the callback on. FrameDelivery::Queued copies the frames into a bounded queue on
+     * the capture thread and runs the software stages and the callback on a thread of the library, so that a slow
+     * callback doesn't slow capturing down.
+     * @param backpressure What happens to frames that come in while the queue of FrameDelivery::Queued is full.
      * @return TODO(nurupo): add enum for: already in use, already started, invalid combination of capabilities, unknown error.
      */
-    virtual int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback callback, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN) = 0;
+    virtual int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback callback, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN, DecompressionScale decompressScale = DecompressionScale::Full, FrameDelivery delivery = FrameDelivery::Direct, BackpressurePolicy backpressure = BackpressurePolicy::DropNewest) = 0;
 
     /**
      * Stops video capture.
@@ -60,10 +68,22 @@ public:
     virtual int stop() = 0;         //TODO to add enum with error codes
 
     /**
-     * Takes a still photo.
-     * @return The captured frame.
+     * Gets the newest frame, for consumers that poll frames instead of taking them in the callback, e.g. once per
+     * redraw. Never blocks the capture thread, which keeps delivering frames to the callback as well, at the cost of a
+     * copy of every frame while capturing. Cameras pay for the copies only from the first call on, which is why it
+     * returns nullptr, and they go on for as long as the camera exists, across stop() and start().
+     * @return The frame, converted and decompressed as the callback gets it, with its owner keeping the pixel data
+     * alive for as long as the frame is. The same frame again if no newer one came since the last call, also after
+     * stop(), nullptr if no frame came since start() or the first call.
      */
-    virtual std::unique_ptr<Frame> captureFrame() = 0;  //TODO
+    virtual std::unique_ptr<Frame> captureFrame() = 0;
+
+    /**
+     * Gets the number of frames delivered to the callback and dropped by the library since capturing was last started,
+     * by the reason they were dropped. Can be called from any thread, while capturing or after stop().
+     * @return The counters, each read atomically but not all at once, so they may be off by a frame while capturing.
+     */
+    virtual FrameDropStatistics getDropStatistics() = 0;
 
     /**
      * Gets information about a video property range.
@@ -6,11 +6,7 @@
 
 #include <pixel_format.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 #include <vector>
 
@@ -19,11 +15,7 @@ namespace webcam_capture {
 /**
  * Provides FPS supported by the camera for some resolution and pixel format.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT CapabilityFps
-#elif __APPLE__
-    class CapabilityFps
-#endif
+class WEBCAM_CAPTURE_EXPORT CapabilityFps
 {
 public:
     CapabilityFps(float fps) :
@@ -48,11 +40,7 @@ private:
  * Provides resolution (width and height) supported by the camera for some pixel format,
  * along with a list of supported FPS values for that resolution.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT CapabilityResolution
-#elif __APPLE__
-    class CapabilityResolution
-#endif
+class WEBCAM_CAPTURE_EXPORT CapabilityResolution
 {
 public:
     CapabilityResolution(int width, int height, std::vector<CapabilityFps> fpses) :
@@ -97,11 +85,7 @@ private:
  * Provides pixel format supported by the camera,
  * along with a list of supported resolutions for that pixel format.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT CapabilityFormat
-#elif __APPLE__
-    class CapabilityFormat
-#endif
+class WEBCAM_CAPTURE_EXPORT CapabilityFormat
 {
 public:
     CapabilityFormat(PixelFormat pixelFormat, std::vector<CapabilityResolution> resolutions):
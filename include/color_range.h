@@ -0,0 +1,20 @@
+#ifndef COLOR_RANGE_H
+#define COLOR_RANGE_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * Ranges YUV values of a frame use.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT ColorRange {
+    Unknown, // the backend doesn't know, limited range is assumed
+    Limited, // Y in [16, 235], U and V in [16, 240], also called studio or TV range
+    Full     // Y, U and V in [0, 255], also called PC range, used by JPEG
+};
+
+} // namespace webcam_capture
+
+#endif // COLOR_RANGE_H
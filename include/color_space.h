@@ -0,0 +1,21 @@
+#ifndef COLOR_SPACE_H
+#define COLOR_SPACE_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * YUV to RGB matrices, i.e. which standard the YUV values of a frame follow.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT ColorSpace {
+    Unknown, // the backend doesn't know, BT.601 is assumed for frames lower than 720 pixels and BT.709 otherwise
+    BT601,   // SD video
+    BT709,   // HD video
+    BT2020   // UHD video, non-constant luminance
+};
+
+} // namespace webcam_capture
+
+#endif // COLOR_SPACE_H
@@ -0,0 +1,23 @@
+#ifndef DECOMPRESSION_SCALE_H
+#define DECOMPRESSION_SCALE_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * Sizes compressed frames can be decompressed at.
+ * Smaller sizes are produced by the inverse DCT itself, skipping most of the decompression work.
+ * Odd sizes round up, e.g. 1/8 of 1080 rows is 135 rows.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT DecompressionScale {
+    Full,    // the size the frame was captured at
+    Half,    // 1/2 of the width and height
+    Quarter, // 1/4 of the width and height
+    Eighth   // 1/8 of the width and height
+};
+
+} // namespace webcam_capture
+
+#endif // DECOMPRESSION_SCALE_H
@@ -7,25 +7,22 @@
 #ifndef FRAME_H
 #define FRAME_H
 
+#include <color_range.h>
+#include <color_space.h>
+#include <orientation.h>
 #include <pixel_format.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace webcam_capture {
 /**
  *  Provides video frame data.
  */
-#ifdef _WIN32
-    struct WEBCAM_CAPTURE_EXPORT Frame
-#elif __APPLE__
-    struct Frame
-#endif
+struct WEBCAM_CAPTURE_EXPORT Frame
 {
 
     /**
@@ -54,6 +51,7 @@ namespace webcam_capture {
 
     /**
      * Planar pixel formats have the byte offsets from the first byte / plane set.
+     * FrameLayout::setLayout() fills them in, along with the strides, for every uncompressed format.
      */
     size_t offset[3];
 
@@ -67,6 +65,29 @@ namespace webcam_capture {
      * The pixel format of the frame.
      */
     PixelFormat pixelFormat;
+
+    /**
+     * The YUV to RGB matrix the pixel data follows, if the pixel format is a YUV one.
+     * Optional, left Unknown if the backend doesn't know it.
+     */
+    ColorSpace colorSpace;
+
+    /**
+     * The range of the YUV values, if the pixel format is a YUV one.
+     * Optional, left Unknown if the backend doesn't know it.
+     */
+    ColorRange colorRange;
+
+    /**
+     * The order the rows are stored in. Converting the frame turns bottom-up frames upright.
+     */
+    Orientation orientation;
+
+    /**
+     * Keeps the pixel data alive, set when the library can hand it out past the callback, see FrameRef.
+     * Optional, left null for pixel data that is valid only during the callback and for frames made by the consumer.
+     */
+    std::shared_ptr<void> owner;
 };
 
 } // namespace webcam_capture
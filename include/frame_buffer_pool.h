@@ -0,0 +1,109 @@
+#ifndef FRAME_BUFFER_POOL_H
+#define FRAME_BUFFER_POOL_H
+
+#include <pixel_format.h>
+
+#include <webcam_capture_export.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace webcam_capture {
+
+/**
+ * Counters of a FrameBufferPool.
+ */
+struct WEBCAM_CAPTURE_EXPORT FrameBufferPoolStatistics
+{
+    uint64_t hits; // buffers handed out that were free
+    uint64_t misses; // requests that found no buffer free
+    uint64_t grows; // misses that allocated a new buffer, the rest hit the cap and failed
+    size_t buffers; // buffers allocated
+    size_t inUse; // buffers held by a frame
+};
+
+/**
+ * Pool of buffers of frames of one pixel format and size, which the software stages write the frames they pass on
+ * into, so that frames retained with FrameRef don't take an allocation each, which fragments the heap and stalls the
+ * capture thread at high resolutions and frame rates.
+ * Buffers go back to the pool when the last FrameRef holding their frame drops, and get handed out again, the most
+ * recently used ones first as they are still in the cache. The pool grows when consumers hold on to more frames than
+ * it has, up to a cap, past which frames get dropped.
+ * There is one pool per pixel format, size and row alignment, shared by every camera delivering such frames, which
+ * lives for as long as a camera or a consumer uses it. Buffers are sized by FrameLayout::setLayout() for that row
+ * alignment, so frames whose rows are padded further, e.g. Windows bitmaps, don't get buffers too small for them.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameBufferPool
+{
+public:
+    /**
+     * Number of buffers pools are prewarmed with when a camera starts, one being written into, one the consumer
+     * processes and one waiting for it.
+     */
+    static const size_t DEFAULT_PREWARMED_BUFFERS = 3;
+
+    /**
+     * Number of buffers pools grow to at most, unless set otherwise.
+     */
+    static const size_t DEFAULT_MAX_BUFFERS = 8;
+
+    /**
+     * Gets the pool of frames of a pixel format and size, creating it if no camera uses it yet.
+     * @param pixelFormat Pixel format of the frames.
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @param rowAlignment Number of bytes rows get padded to, as taken by FrameLayout::setLayout().
+     * @return The pool, nullptr if the pixel format is not described by FrameLayout::getTraits().
+     */
+    static std::shared_ptr<FrameBufferPool> getPool(PixelFormat pixelFormat, size_t width, size_t height,
+            size_t rowAlignment = 1);
+
+    /**
+     * @return Size of the buffers, the number of bytes a frame takes.
+     */
+    size_t getBufferSize() const;
+
+    /**
+     * Allocates buffers until the pool has count of them, and touches every page of the new ones, so that neither
+     * the allocation nor the page faults fall on the first frames.
+     * @param count Number of buffers to have, capped to the maximum.
+     */
+    void prewarm(size_t count);
+
+    /**
+     * Sets the number of buffers the pool grows to at most. Buffers already allocated are kept.
+     * @param count Maximum number of buffers, at least 1.
+     */
+    void setMaxBuffers(size_t count);
+    size_t getMaxBuffers() const;
+
+    /**
+     * Gets a free buffer, allocating one if there is none and the pool isn't at its cap.
+     * The buffer goes back to the pool when the last copy of the pointer drops, from whatever thread that is.
+     * @return The buffer, of getBufferSize() bytes, nullptr if all buffers are in use and the pool is at its cap.
+     */
+    std::shared_ptr<uint8_t> acquire();
+
+    FrameBufferPoolStatistics getStatistics() const;
+
+private:
+    explicit FrameBufferPool(size_t bufferSize);
+    FrameBufferPool(const FrameBufferPool &) = delete;
+    FrameBufferPool &operator=(const FrameBufferPool &) = delete;
+
+    const size_t bufferSize;
+    size_t maxBuffers;
+    size_t allocating; // buffers being allocated outside of the lock, which count against the cap
+
+    // the pool keeps a reference to every buffer, a buffer only the pool references is free
+    std::vector<std::shared_ptr<std::vector<uint8_t> > > buffers;
+    FrameBufferPoolStatistics statistics;
+    mutable std::mutex mutex;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_BUFFER_POOL_H
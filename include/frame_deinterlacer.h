@@ -0,0 +1,69 @@
+#ifndef FRAME_DEINTERLACER_H
+#define FRAME_DEINTERLACER_H
+
+#include <camera_interface.h>
+#include <pixel_format.h>
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture {
+
+/**
+ * Ways of turning a frame holding two interlaced fields into a progressive one.
+ */
+enum class WEBCAM_CAPTURE_EXPORT DeinterlaceMode {
+
+    Weave, // keeps both fields as they are, full resolution on still pictures but combing on motion
+    Bob, // replaces the second field with lines interpolated from the first, no combing but half the resolution
+    MotionAdaptive // weaves where the second field didn't change since the previous frame, bobs where it did
+};
+
+/**
+ * Which field of an interlaced frame was captured first.
+ */
+enum class WEBCAM_CAPTURE_EXPORT FieldOrder {
+
+    TopFirst, // the field of the even rows, counting the top row as row 0, usual for analog capture cards
+    BottomFirst // the field of the odd rows, e.g. DV
+};
+
+/**
+ * Deinterlacing stage to put between a camera and the frame callback, for capture cards digitizing analog NTSC, PAL
+ * and SECAM video, whose frames interleave two fields captured 1/50 or 1/60 of a second apart.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameDeinterlacer
+{
+public:
+    FrameDeinterlacer() = delete;
+
+    /**
+     * Wraps a callback into one deinterlacing every frame before passing it on. The result is passed to
+     * CameraInterface::start() in place of the callback, either directly or wrapped by another stage, e.g.
+     * FrameConverter's, so that the fields get deinterlaced before anything scales or converts them.
+     * Supported formats are YUY2, YUYV, UYVY, YVYU, NV12, I420, IYUV, YV12 and Y800. Chroma rows of 4:2:0 formats are
+     * taken as alternating between the fields too, as interlaced 4:2:0 video samples them.
+     * Lines are interpolated as the average of the lines above and below them, with SIMD code picked at runtime.
+     * MotionAdaptive compares the second field to the one of the previous frame, kept in a buffer that's reused from
+     * frame to frame, and interpolates only the bytes that changed by more than the noise of analog video. The first
+     * frame, and the first one after a change of format or size, is bobbed.
+     * The deinterlaced frame is valid only during the callback, unless retained with FrameRef. Its buffer is reused
+     * between frames while no FrameRef holds it, so the wrapping callback has to be called from one thread at a time,
+     * which cameras do.
+     * Frames of unsupported formats are dropped.
+     * @param mode How to deinterlace. Weave passes frames on untouched, and returns callback itself.
+     * @param fieldOrder Which field comes first, the other one is the one interpolated.
+     * @param callback Callback to pass deinterlaced frames to.
+     * @param pixelFormat Format the frames come in, if known, so that the buffers of the deinterlaced frames get
+     * allocated here rather than on the first frame.
+     * @param width Width of the frames, with pixelFormat.
+     * @param height Height of the frames, with pixelFormat.
+     * @return The wrapping callback, an empty one if the callback is empty.
+     */
+    static FrameCallback wrapCallback(DeinterlaceMode mode, FieldOrder fieldOrder, FrameCallback callback,
+                                      PixelFormat pixelFormat = PixelFormat::UNKNOWN, size_t width = 0,
+                                      size_t height = 0);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_DEINTERLACER_H
@@ -0,0 +1,19 @@
+#ifndef FRAME_DELIVERY_H
+#define FRAME_DELIVERY_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * Threads frames get delivered to the frame callback on.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT FrameDelivery {
+    Direct, // the callback runs on the capture thread of the backend, a slow callback slows capturing down
+    Queued  // the capture thread only queues the frames, the software stages and the callback run on a library thread
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_DELIVERY_H
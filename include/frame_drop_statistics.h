@@ -0,0 +1,27 @@
+#ifndef FRAME_DROP_STATISTICS_H
+#define FRAME_DROP_STATISTICS_H
+
+#include <webcam_capture_export.h>
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Counters of the frames a camera delivered and dropped since it was last started, by the reason they were dropped,
+ * see CameraInterface::getDropStatistics().
+ * Frames the driver drops before handing them to the library, and ones dropped by stages the consumer wraps the
+ * callback with, e.g. FrameScaler, are not counted. Frames still queued for FrameDelivery::Queued when the camera
+ * stops count as queueFull, so that every frame the library got is either delivered or dropped.
+ */
+struct WEBCAM_CAPTURE_EXPORT FrameDropStatistics
+{
+    uint64_t delivered; // frames passed to the callback
+    uint64_t queueFull; // frames dropped by the BackpressurePolicy, as the callback fell behind
+    uint64_t poolExhausted; // frames dropped as all buffers of a FrameBufferPool were held by retained frames
+    uint64_t decodeFailed; // frames that failed to decompress or convert
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_DROP_STATISTICS_H
@@ -0,0 +1,113 @@
+#ifndef FRAME_LAYOUT_H
+#define FRAME_LAYOUT_H
+
+#include <frame.h>
+#include <pixel_format.h>
+
+#include <webcam_capture_export.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * How the samples of a pixel format are arranged in memory.
+ */
+enum class WEBCAM_CAPTURE_EXPORT PixelPacking {
+
+    Packed, // all samples of a pixel next to each other, in one plane
+    SemiPlanar, // a luma plane followed by a plane of interleaved chroma pairs, e.g. NV12
+    Planar, // a luma plane followed by two chroma planes, e.g. I420
+    PlanarLumaStride, // planar, but the chroma rows take as many bytes as the luma ones, IMC1 and IMC3
+    PlanarSharedRows // a row of each chroma plane side by side in every row of luma stride, IMC2 and IMC4
+};
+
+/**
+ * What the samples of a pixel format describe.
+ */
+enum class WEBCAM_CAPTURE_EXPORT ColorModel {
+
+    RGB, // palettized and gray formats included
+    YUV,
+    Bayer
+};
+
+/**
+ * Describes the memory layout of an uncompressed pixel format.
+ */
+struct WEBCAM_CAPTURE_EXPORT PixelFormatTraits
+{
+    PixelFormat pixelFormat;
+    ColorModel colorModel;
+    PixelPacking packing;
+
+    /**
+     * Number of planes, counting the interleaved chroma plane of semi-planar formats as one.
+     */
+    uint8_t planes;
+
+    /**
+     * Significant bits of the widest sample, or of the palette index of palettized formats.
+     */
+    uint8_t bitsPerSample;
+
+    /**
+     * Chroma subsampling, as shifts of the luma width and height, e.g. 1 and 1 for 4:2:0.
+     */
+    uint8_t chromaShiftX;
+    uint8_t chromaShiftY;
+
+    /**
+     * Rows of the first plane are made of groups of blockWidth pixels taking blockBytes bytes, e.g. a macropixel of
+     * 2 pixels in 4 bytes for YUY2, or 8 pixels in a byte for RGB1.
+     */
+    uint8_t blockWidth;
+    uint8_t blockBytes;
+
+    /**
+     * Number of bytes the format itself pads rows to, e.g. 128 for v210. 1 for most formats.
+     */
+    uint8_t rowAlignment;
+};
+
+/**
+ * Computes where the planes of frames are, from the pixel format and size, so that consumers and backends don't have
+ * to know every format.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameLayout
+{
+public:
+    FrameLayout() = delete;
+
+    /**
+     * @return Description of the pixel format, nullptr for compressed formats and ones of unknown layout.
+     */
+    static const PixelFormatTraits *getTraits(PixelFormat pixelFormat);
+
+    /**
+     * Fills in the widths, heights, strides and offsets of all planes of a frame of frame.pixelFormat, and the number of
+     * bytes it takes.
+     * Strides set by the caller are kept. The chroma strides left 0 get derived from the luma one, the way formats
+     * laid out in a single buffer have them, and the luma stride left 0 is that of tightly packed rows, padded to
+     * rowAlignment and the format's own alignment.
+     * @param frame Frame to lay out.
+     * @param width Width of the frame.
+     * @param height Height of the frame.
+     * @param base Start of the buffer holding the frame. If set, the planes get pointed into it.
+     * @param rowAlignment Number of bytes the buffer pads luma rows to, e.g. 4 for Windows bitmaps.
+     * @return Number of bytes the frame takes, 0 if the pixel format is not described by getTraits().
+     */
+    static size_t setLayout(Frame &frame, size_t width, size_t height, uint8_t *base = nullptr,
+                            size_t rowAlignment = 1);
+
+    /**
+     * Points the chroma planes of a frame laid out in a single buffer into it, by their offsets from plane[0], e.g.
+     * once a conversion filled in the layout of the destination. Planes with no offset are left as they are.
+     */
+    static void setPlanes(Frame &frame);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_LAYOUT_H
@@ -0,0 +1,74 @@
+#ifndef FRAME_REF_H
+#define FRAME_REF_H
+
+#include <camera_interface.h>
+#include <frame.h>
+
+#include <webcam_capture_export.h>
+
+#include <functional>
+#include <memory>
+
+namespace webcam_capture {
+
+class FrameRef;
+
+typedef std::function<void(const FrameRef &frame)> FrameRefCallback;
+
+/**
+ * Reference counted handle to a frame, which consumers can keep past the callback, e.g. to process frames on another
+ * thread, without copying them.
+ * Handles share the frame and the buffer it points into, which the library keeps alive until the last handle drops.
+ * The frame itself is read only, whoever holds a handle may read its pixel data from any thread.
+ * Backends hand out the buffers of the platform where they can, which come from a small pool on most platforms, so
+ * holding on to many frames for long makes the camera drop frames or stall. Frames of software stages, e.g.
+ * FrameConverter or FrameScaler, come from a FrameBufferPool, a handle keeps the buffer out of it.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameRef
+{
+public:
+    /**
+     * Makes an empty handle.
+     */
+    FrameRef();
+
+    /**
+     * Makes a handle to a frame, sharing its pixel data if frame.owner is set, copying it otherwise, into a buffer of
+     * the FrameBufferPool of its pixel format and size for uncompressed frames. A pool no camera uses lives only as long
+     * as its buffers are in use, so each frame retained this way may take an allocation of its own, while
+     * wrapCallback() keeps the pool and reuses its buffers.
+     * @param frame Frame to retain, e.g. the one passed to a FrameCallback.
+     * @return The handle, an empty one if the frame has no pixel data or copying it fails, e.g. because all buffers of
+     * the pool are held by retained frames.
+     */
+    static FrameRef retain(const Frame &frame);
+
+    /**
+     * Wraps a callback taking handles into a FrameCallback, to be passed to CameraInterface::start() in place of the
+     * callback, either directly or wrapped by another stage. Every frame is retained as by retain() and passed on.
+     * @param callback Callback to pass the handles to.
+     * @return The wrapping callback, empty if callback is empty.
+     */
+    static FrameCallback wrapCallback(FrameRefCallback callback);
+
+    /**
+     * @return The frame, nullptr if the handle is empty.
+     */
+    const Frame *get() const;
+
+    const Frame &operator*() const;
+    const Frame *operator->() const;
+    explicit operator bool() const;
+
+    /**
+     * Drops the frame, the buffer is freed or handed back to the library if it was the last handle to it.
+     */
+    void reset();
+
+private:
+    std::shared_ptr<const Frame> frame;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_REF_H
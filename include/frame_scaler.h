@@ -0,0 +1,46 @@
+#ifndef FRAME_SCALER_H
+#define FRAME_SCALER_H
+
+#include <camera_interface.h>
+#include <pixel_format_converter.h>
+
+#include <webcam_capture_export.h>
+
+#include <cstddef>
+
+namespace webcam_capture {
+
+/**
+ * Resizing stage to put between a camera and the frame callback, e.g. to hand an encoder frames smaller than the
+ * camera captures.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameScaler
+{
+public:
+    FrameScaler() = delete;
+
+    /**
+     * Wraps a callback into one resizing every frame before passing it on.
+     * The result is passed to CameraInterface::start() in place of the callback, either directly or wrapped by another
+     * stage. The pixel format is kept. Frames of formats PixelFormatConverter::scaleInto() supports are resized with
+     * it, or along a cheaper chain if the library measured one, e.g. a scaled decompression for MJPEG. The others go
+     * through the cheapest chain of conversions and resizes there is, e.g. YUY2 through I420.
+     * The resized frame is valid only during the callback, unless retained with FrameRef. Its buffer is reused between
+     * frames while no FrameRef holds it, so the wrapping callback has to be called from one thread at a time, which
+     * cameras do.
+     * Frames that fail to resize are dropped.
+     * @param width Width to resize frames to.
+     * @param height Height to resize frames to.
+     * @param filter Filter to resize with.
+     * @param callback Callback to pass resized frames to.
+     * @param pixelFormat Format the frames come in, if known, so that the buffers of the resized frames get allocated
+     * here rather than on the first frame.
+     * @return The wrapping callback, an empty one if the size is 0 or the callback is empty.
+     */
+    static FrameCallback wrapCallback(size_t width, size_t height, ScaleFilter filter, FrameCallback callback,
+                                      PixelFormat pixelFormat = PixelFormat::UNKNOWN);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_SCALER_H
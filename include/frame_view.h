@@ -0,0 +1,65 @@
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+#include <frame.h>
+
+#include <webcam_capture_export.h>
+
+#include <cstddef>
+
+namespace webcam_capture {
+
+/**
+ * Rectangle of pixels of a frame, in the coordinates of the upright frame, whatever its orientation.
+ */
+struct WEBCAM_CAPTURE_EXPORT Rect
+{
+    size_t x;
+    size_t y;
+    size_t width;
+    size_t height;
+};
+
+/**
+ * Makes frames that show a part of another frame without copying any pixel data, e.g. for consumers interested only
+ * in a fixed region of the image.
+ * A view is a regular Frame with its planes pointing into the pixel data of the frame it's made of and the strides of
+ * that frame, so PixelFormatConverter takes it as a source or a destination like any other frame, and reads or writes
+ * only the pixels inside it.
+ */
+class WEBCAM_CAPTURE_EXPORT FrameView
+{
+public:
+    FrameView() = delete;
+
+    /**
+     * Gets the rectangle crop() actually makes a view of.
+     * Samples shared by several pixels, chroma samples of subsampled YUV formats, macropixels of packed ones and the
+     * 2x2 cells of Bayer formats, can't be split, so the rectangle gets grown outwards to whole ones, and clipped to
+     * the frame. Rows of bottom-up frames are aligned where they are in memory.
+     * @param frame Frame to crop.
+     * @param rect Rectangle to crop to.
+     * @return The aligned rectangle, an empty one if the rectangle is outside of the frame or the pixel format is not
+     * described by FrameLayout::getTraits().
+     */
+    static Rect alignRect(const Frame &frame, const Rect &rect);
+
+    /**
+     * Makes a view of a rectangle of a frame, without copying any pixel data.
+     * The view points into the pixel data of frame, so it's valid only for as long as frame's data is. All of its
+     * planes are set, along with their strides, which are the ones of frame. Its size is the one of the rectangle
+     * aligned by alignRect(), and it keeps the pixel format, color space, color range and orientation of frame.
+     * Planes of frame that are not set are expected to follow plane[0] as FrameLayout::setLayout() lays them out.
+     * Views of views are fine.
+     * @param frame Frame to crop.
+     * @param rect Rectangle to crop to.
+     * @param view Frame set to the view.
+     * @return true on success, false if the frame has no pixel data, the pixel format is compressed or not described
+     * by FrameLayout::getTraits(), or the rectangle is outside of the frame.
+     */
+    static bool crop(const Frame &frame, const Rect &rect, Frame &view);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_VIEW_H
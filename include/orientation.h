@@ -0,0 +1,19 @@
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+
+#include <webcam_capture_export.h>
+
+namespace webcam_capture  {
+
+/**
+ * Orders the rows of a frame can be stored in.
+ */
+
+enum class WEBCAM_CAPTURE_EXPORT Orientation {
+    TopDown, // the first row in memory is the top one
+    BottomUp // the first row in memory is the bottom one, as in uncompressed RGB DIBs DirectShow delivers
+};
+
+} // namespace webcam_capture
+
+#endif // ORIENTATION_H
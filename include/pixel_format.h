@@ -1,11 +1,7 @@
 #ifndef PIXEL_FORMAT_H
 #define PIXEL_FORMAT_H
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 /* Media Foundation
  *   - Formats: https://msdn.microsoft.com/en-us/library/windows/desktop/aa370819(v=vs.85).aspx
@@ -19,11 +15,7 @@ namespace webcam_capture {
 /**
  * Supported pixel formats.
  */
-#ifdef _WIN32
-    enum class WEBCAM_CAPTURE_EXPORT PixelFormat {
-#elif __APPLE__
-    enum class PixelFormat {
-#endif
+enum class WEBCAM_CAPTURE_EXPORT PixelFormat {
     //Uncompressed RGB Formats
     RGB1,           /* RGB, 1 bit per pixel (bpp), palettized*/
     RGB4,           /* RGB, 4 bpp, palettized*/
@@ -68,6 +60,7 @@ namespace webcam_capture {
     IF09,           /* IF09, Sampling 4:2:0, Planar, Bits per channel - 8*/
     YVU9,           /* Y211, Sampling "See remarks.", Planar, Bits per channel - 8*/
     YVYU,           /* YVYU, Sampling 4:2:2, Packed, Bits per channel - 8*/
+    Y800,           /* Y800, Sampling 4:0:0 (luma only, i.e. 8-bit gray), Planar, Bits per channel - 8*/
     //YUV Formats: 10-Bit and 16-Bit
     P010,           /* P010, Sampling 4:2:0, Planar, Bits per channel - 10*/
     P016,           /* P016, Sampling 4:2:0, Planar, Bits per channel - 16*/
@@ -82,6 +75,19 @@ namespace webcam_capture {
     Y216,           /* Y216, Sampling 4:2:2, Packed, Bits per channel - 16*/
     Y410,            /* Y410, Sampling 4:4:4, Packed, Bits per channel - 10*/
     Y416,           /* Y416, Sampling 4:4:4, Packed, Bits per channel - 16*/
+    //Raw Bayer Formats: one color sample per pixel, in 2x2 patterns named after their first two rows
+    BayerRGGB8,     /* Bayer RGGB, Bits per sample - 8*/
+    BayerGRBG8,     /* Bayer GRBG, Bits per sample - 8*/
+    BayerGBRG8,     /* Bayer GBRG, Bits per sample - 8*/
+    BayerBGGR8,     /* Bayer BGGR, Bits per sample - 8*/
+    BayerRGGB10,    /* Bayer RGGB, Bits per sample - 10, in the low bits of 16-bit little-endian words*/
+    BayerGRBG10,    /* Bayer GRBG, Bits per sample - 10, in the low bits of 16-bit little-endian words*/
+    BayerGBRG10,    /* Bayer GBRG, Bits per sample - 10, in the low bits of 16-bit little-endian words*/
+    BayerBGGR10,    /* Bayer BGGR, Bits per sample - 10, in the low bits of 16-bit little-endian words*/
+    BayerRGGB12,    /* Bayer RGGB, Bits per sample - 12, in the low bits of 16-bit little-endian words*/
+    BayerGRBG12,    /* Bayer GRBG, Bits per sample - 12, in the low bits of 16-bit little-endian words*/
+    BayerGBRG12,    /* Bayer GBRG, Bits per sample - 12, in the low bits of 16-bit little-endian words*/
+    BayerBGGR12,    /* Bayer BGGR, Bits per sample - 12, in the low bits of 16-bit little-endian words*/
     //Encoded Video Types
     DV25,           /* DVCPRO 25 (525-60 or 625-50)*/
     DV50,           /* DVCPRO 50 (525-60 or 625-50)*/
@@ -1,39 +1,298 @@
 #ifndef PIXEL_FORMAT_CONVERTER_H
 #define PIXEL_FORMAT_CONVERTER_H
 
+#include <decompression_scale.h>
 #include <frame.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <vector>
+
+#include <webcam_capture_export.h>
 
 namespace webcam_capture {
 
+/**
+ * Filters used when scaling frames.
+ */
+enum class WEBCAM_CAPTURE_EXPORT ScaleFilter {
+
+    Box, // area filter, averages all source pixels a scaled pixel covers, sharpest downscaling without aliasing
+    Bilinear, // interpolates between the 4 source pixels closest to a scaled pixel, reads only 2 source rows per row
+    Nearest // takes the source pixel closest to a scaled pixel, fastest, but aliases when downscaling
+};
+
+/**
+ * Ways of reducing high bit depth samples to 8 bits.
+ */
+enum class WEBCAM_CAPTURE_EXPORT DitherMode {
+
+    Round, // rounds every sample to the nearest 8-bit value, smooth gradients may show banding
+    Ordered // adds a 4x4 ordered dither pattern before dropping the low bits, trading banding for fine noise
+};
+
+/**
+ * Ways of interpolating the colors Bayer pixels are missing.
+ */
+enum class WEBCAM_CAPTURE_EXPORT DemosaicMode {
+
+    Bilinear, // averages the closest samples of each color, fastest, but leaves colored fringes along sharp edges
+    EdgeAware // interpolates green along edges rather than across them and corrects red and blue by the gradients
+};
+
+/**
+ * Flips and rotations conversions can apply in the same pass as the pixel format conversion.
+ * Vertical flips cost nothing extra, mirroring and rotating go through small tiles that stay in the cache. RGB and Y800
+ * destinations take all of them, YUV destinations and MJPEG sources take Transform::None only, or a vertical flip for
+ * RGB sources.
+ */
+enum class WEBCAM_CAPTURE_EXPORT Transform {
+
+    None,
+    FlipVertical, // upside down
+    FlipHorizontal, // mirrored, as in a preview of a front-facing camera
+    Rotate90, // clockwise
+    Rotate180, // e.g. for cameras mounted upside down on a ceiling
+    Rotate270 // clockwise, i.e. 90 degrees counterclockwise
+};
+
 /**
  * Handles conversion of frames' pixel formats.
+ *
+ * Conversions convertInto() supports:
+ *
+ *   Source                                     Destination
+ *   YUY2, YUYV, UYVY, YVYU                     RGB24, RGB32, BGRA32, ARGB32, Y800
+ *   NV12, I420, IYUV, YV12, IMC1-4             RGB24, RGB32, BGRA32, ARGB32, Y800
+ *   P010, P016                                 RGB24, RGB32, BGRA32, ARGB32, Y800, NV12, P016
+ *   P210, P216, v210, Y210, Y216               RGB24, RGB32, BGRA32, ARGB32, Y800, YUY2, P216
+ *   Y410, Y416                                 RGB24, RGB32, BGRA32, ARGB32, Y800, AYUV, Y416
+ *   AYUV, Y800                                 Y800
+ *   RGB24, RGB32, BGRA32, ARGB32               RGB24, RGB32, BGRA32, ARGB32, I420, IYUV, NV12, YUY2, YUYV
+ *   RGB555, RGB565, ARGB1555, ARGB4444,        RGB24, RGB32, BGRA32, ARGB32
+ *   their LE16_ and BE16_ variants, LE16_5551
+ *   and the Direct3D render target ones
+ *   BayerRGGB8 through BayerBGGR12             RGB24, RGB32, BGRA32, ARGB32
+ *   MJPG, jpeg, dmb1                           as decompressInto() at full size
+ *
+ * YUV values are interpreted according to frame.colorSpace and frame.colorRange, unknown color spaces are taken as
+ * BT.601 for frames lower than 720 pixels and BT.709 otherwise, unknown ranges as limited. High bit depth samples are
+ * reduced to 8 bits as set by setDitherMode() and scaled to the full 16 bits for the 16-bit destinations. Y800
+ * destinations are made of the luma samples only and keep the colorSpace and colorRange of the frame. 16-bit RGB is
+ * expanded by replicating the top bits of every channel into its low ones, alpha is kept by BGRA32 and ARGB32.
+ * Planes of 4:2:0 frames are expected in the order they are laid out in memory. If only plane[0] is set, the rest of
+ * the planes are expected to follow it contiguously. Views made by FrameView::crop() are taken as frames and as
+ * destinations, only the pixels inside them are read or written.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT PixelFormatConverter
-#elif __APPLE__
-    class PixelFormatConverter
-#endif
+class WEBCAM_CAPTURE_EXPORT PixelFormatConverter
 {
 public:
+    /**
+     * Sets the number of threads conversions use.
+     * Frames get split into horizontal stripes converted in parallel on a pool of worker threads that persists
+     * between conversions. The conversion functions still return only once the whole frame is converted.
+     * The pool works on one conversion at a time, the ones running meanwhile on other threads, e.g. of other cameras,
+     * are converted on their own thread.
+     * Defaults to 1, i.e. converting on the calling thread only.
+     * @param count Number of threads, including the calling one. 0 picks one thread per CPU core.
+     */
+    static void setThreadCount(size_t count);
+
+    /**
+     * @return Number of threads conversions use.
+     */
+    static size_t getThreadCount();
+
+    /**
+     * Sets how conversions from 10-bit and 16-bit formats to 8-bit ones reduce the samples, including the ones to RGB
+     * and Y800, and those of 10-bit and 12-bit Bayer formats before demosaicing.
+     * Defaults to DitherMode::Round.
+     * @param mode Way of reducing the samples.
+     */
+    static void setDitherMode(DitherMode mode);
+
+    /**
+     * @return Way conversions reduce high bit depth samples to 8 bits.
+     */
+    static DitherMode getDitherMode();
+
+    /**
+     * Sets how conversions from Bayer formats interpolate the missing colors of every pixel.
+     * Bayer frames need an even width and height, and a stride of 0 means that their rows are tightly packed samples.
+     * Defaults to DemosaicMode::Bilinear.
+     * @param mode Way of demosaicing.
+     */
+    static void setDemosaicMode(DemosaicMode mode);
+
+    /**
+     * @return Way conversions demosaic Bayer frames.
+     */
+    static DemosaicMode getDemosaicMode();
+
+    /**
+     * Fills in the layout of the frame converting frame to destination.pixelFormat produces: destination's width,
+     * height, stride and bytes. A stride already set in destination is kept, which allows padding the rows.
+     * Meant for allocating a destination buffer once and reusing it with convertInto() for every following frame.
+     * @param frame Frame to convert.
+     * @param destination Frame with pixelFormat set to the format to convert to.
+     * @param transform Transform to convert with. Rotations by 90 and 270 degrees swap the width and height.
+     * @return Number of bytes the destination buffer has to hold, 0 if the pair of pixel formats or the transform is
+     * not supported.
+     */
+    static size_t getDestinationLayout(const Frame &frame, Frame &destination, Transform transform = Transform::None);
+
+    /**
+     * Converts a video frame into a buffer allocated by the caller, without allocating any memory itself, see the
+     * class description for the supported pairs of pixel formats. The fastest SIMD code path the CPU supports is picked
+     * at runtime. Bottom-up frames are turned upright and transform is applied, both in the same pass.
+     * The pixels are written into destination.plane[0], in destination.pixelFormat. A stride of 0 means that rows are
+     * tightly packed. If destination.bytes is set, the conversion fails if the buffer is smaller. Destination's layout
+     * gets filled in, as by getDestinationLayout().
+     * @param frame Frame to convert.
+     * @param destination Frame receiving the converted version of the frame.
+     * @param transform Flip or rotation to apply.
+     * @return true on success, false if the pair of pixel formats or the transform is not supported or the buffer is
+     * too small.
+     */
+    static bool convertInto(const Frame &frame, Frame &destination, Transform transform = Transform::None);
+
+    /**
+     * Converts an 8-bit 4:2:2 or 4:2:0 YUV frame into RGB like convertInto(), mapping its samples through lookup tables
+     * on the way, e.g. to adjust brightness and contrast through the luma table and saturation through the chroma one
+     * in the same pass over the frame.
+     * @param lumaTable 256 values luma samples are mapped to.
+     * @param chromaTable 256 values U and V samples are mapped to.
+     * @return true on success, false if the conversion is not one from such a YUV format into RGB, or as convertInto().
+     */
+    static bool convertInto(const Frame &frame, Frame &destination, const uint8_t *lumaTable,
+                            const uint8_t *chromaTable, Transform transform = Transform::None);
+
+    /**
+     * Gets the luma plane of a planar YUV frame as a Y800 frame, without copying any pixel data.
+     * The returned frame points into the pixel data of frame, so it's valid only for as long as frame's data is.
+     * Its stride is the one of frame's luma plane, which may be larger than its width.
+     * Supported formats are NV12, I420, IYUV, YV12, IMC1-4 and Y800. Packed and high bit depth formats have no
+     * 8-bit luma plane to point to, convertInto() with a Y800 destination extracts their luma instead, deinterleaving
+     * packed formats and reducing high bit depth ones.
+     * @param frame Frame to get the luma plane of.
+     * @param luma Frame set to the luma plane.
+     * @return true on success, false if the pixel format has no 8-bit luma plane or the frame has no pixel data.
+     */
+    static bool getLumaPlane(const Frame &frame, Frame &luma);
+
+    /**
+     * Same as getDestinationLayout(const Frame &, Frame &, Transform), for a destination scaled by
+     * convertAndScaleInto(), or by scaleInto() if destination.pixelFormat is frame.pixelFormat.
+     * @param frame Frame to convert.
+     * @param destination Frame with pixelFormat set to the format to convert to.
+     * @param width Width of the scaled frame.
+     * @param height Height of the scaled frame.
+     * @return Number of bytes the destination buffer has to hold, 0 if the pair of pixel formats is not supported.
+     */
+    static size_t getDestinationLayout(const Frame &frame, Frame &destination, size_t width, size_t height);
+
+    /**
+     * Converts a video frame and scales it to width x height in a single pass, meant for getting small previews of
+     * large frames. Source memory is read only once and no full size intermediate frame is ever produced.
+     * Takes the same YUV pixel formats and follows the same rules as convertInto(), bottom-up frames included, but
+     * doesn't take a transform.
+     * @param frame Frame to convert.
+     * @param destination Frame receiving the converted and scaled version of the frame.
+     * @param width Width of the scaled frame.
+     * @param height Height of the scaled frame.
+     * @param filter Filter to scale with.
+     * @return true on success, false if the pair of pixel formats is not supported or the buffer is too small.
+     */
+    static bool convertAndScaleInto(const Frame &frame, Frame &destination, size_t width, size_t height,
+                                    ScaleFilter filter);
+
+    /**
+     * Resizes a video frame to width x height, keeping its pixel format, e.g. to downscale NV12 frames before encoding
+     * them or to make RGB24 thumbnails.
+     * Supported formats are NV12, I420, IYUV, YV12, Y800, RGB24, RGB32, BGRA32 and ARGB32. Chroma planes are resized
+     * to the chroma size of the resized frame, so odd sizes round the chroma up like the source's does.
+     * Resizes in two separable passes, vertically then horizontally, with the weights of the filter computed the first
+     * time a pair of sizes comes up and reused for the following frames. The AVX2 code path is picked at runtime if
+     * the CPU supports it. ScaleFilter::Box downscales rows and columns by at most 16384 / bytes per sample times.
+     * Follows the same rules about the frame and the destination as convertInto(), which doesn't allocate any memory
+     * either, except for the weights. Destination's pixelFormat, colorSpace, colorRange and orientation are set to
+     * frame's, so bottom-up frames stay so.
+     * Large frames are resized by several threads in parallel if setThreadCount() allows it.
+     * @param frame Frame to resize.
+     * @param destination Frame receiving the resized version of the frame.
+     * @param width Width of the resized frame.
+     * @param height Height of the resized frame.
+     * @param filter Filter to resize with.
+     * @return true on success, false if the pixel format is not supported or the buffer is too small.
+     */
+    static bool scaleInto(const Frame &frame, Frame &destination, size_t width, size_t height, ScaleFilter filter);
+
+    /**
+     * Same as getDestinationLayout(const Frame &, Frame &, Transform), for a destination decompressed by
+     * decompressInto().
+     * @param frame Compressed frame.
+     * @param destination Frame with pixelFormat set to the format to decompress to.
+     * @param scale Scale to decompress at.
+     * @return Number of bytes the destination buffer has to hold, 0 if the pair of pixel formats is not supported.
+     */
+    static size_t getDestinationLayout(const Frame &frame, Frame &destination, DecompressionScale scale);
+
+    /**
+     * Decompresses an MJPEG frame into a buffer allocated by the caller, optionally at a fraction of its size.
+     * Scaled decompression drops the high frequency coefficients in the inverse DCT, so it's several times cheaper
+     * than decompressing at full size and scaling down afterwards, which makes it a good fit for previews.
+     * Requires the library to be built with libjpeg-turbo or another libjpeg implementation.
+     * Supported source formats are MJPG, jpeg and dmb1, with frame.bytes set to the size of the compressed data.
+     * Supported destination formats are RGB24, RGB32, BGRA32, ARGB32, YUY2, YUYV, I420, IYUV and NV12. YUV
+     * destinations get the BT.601 full range values JPEG uses, and have their colorSpace and colorRange set so.
+     * Follows the same rules about the destination as convertInto(), which decompresses at full size.
+     * Unlike the conversions, libjpeg allocates its working memory for every call. Cameras started with a
+     * decompressFormat keep their decompression state between frames instead.
+     * @param frame Frame to decompress.
+     * @param destination Frame receiving the decompressed version of the frame.
+     * @param scale Scale to decompress at.
+     * @return true on success, false if the pair of formats is not supported, the buffer is too small or the frame
+     * is not a valid JPEG image.
+     */
+    static bool decompressInto(const Frame &frame, Frame &destination, DecompressionScale scale);
+
     /**
      * Converts a video frame to RGB pixel format.
+     * Same as convertInto(), limited to the RGB destination formats.
      * @param frame Frame to convert.
-     * @return RGB version of the frame.
+     * @param destination Frame receiving the RGB version of the frame.
+     * @return true on success, false if the pair of pixel formats is not supported.
      */
-    static Frame convertToRGB(const Frame &frame);
+    static bool convertToRGB(const Frame &frame, Frame &destination);
 
     /**
-     * Converts a video frame to YUV pixel format.
+     * Converts an RGB video frame to YUV pixel format, e.g. for feeding it to a video encoder.
+     * Same as convertInto(), limited to RGB24, RGB32, BGRA32 and ARGB32 sources and I420, IYUV, NV12, YUY2 and YUYV
+     * destinations. Every chroma sample is computed from the average of the pixels it covers, 2x2 of them for the 4:2:0
+     * formats and 2x1 for the 4:2:2 ones. Alpha is ignored.
+     * The matrix and range to convert with are taken from destination.colorSpace and destination.colorRange. Unknown
+     * ones are picked the way convertInto() picks them for YUV sources, and get filled in.
+     * Large frames are converted by several threads in parallel if setThreadCount() allows it.
      * @param frame Frame to convert.
-     * @return YUV version of the frame.
+     * @param destination Frame receiving the YUV version of the frame.
+     * @return true on success, false if the pair of pixel formats is not supported or the buffer is too small.
+     */
+    static bool convertToYUV(const Frame &frame, Frame &destination);
+
+    /**
+     * Plans the cheapest chain of convertInto() calls converting frames from one pixel format to another, e.g. for
+     * sources no single conversion reaches the destination format from.
+     * Conversions are weighted by their cost per pixel, MJPEG decompression included, measured on this CPU by a thread
+     * of the library, in the background, the first time a chain through them is considered. Until then their cost is
+     * estimated from the bytes they read and write, so nothing is timed on the calling thread. Chains are cached per
+     * pair of formats and resolution once made with measured costs.
+     * @param source Pixel format to convert from.
+     * @param destination Pixel format to convert to.
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @return The formats of the chain, source first and destination last. Just source if the formats are the same,
+     * empty if there is no chain between them.
      */
-    static Frame convertToYUV(const Frame &frame);
+    static std::vector<PixelFormat> getConversionPath(PixelFormat source, PixelFormat destination, size_t width,
+            size_t height);
 
 private:
     PixelFormatConverter();
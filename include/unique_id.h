@@ -3,11 +3,7 @@
 
 #include <backend_implementation.h>
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 namespace webcam_capture {
 
@@ -15,11 +11,7 @@ namespace webcam_capture {
  * Uniquely identifies a camera.
  * While the actual data is hidden by the backend implementations, you can still use it for comparison.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT UniqueId
-#elif __APPLE__
-    class UniqueId
-#endif
+class WEBCAM_CAPTURE_EXPORT UniqueId
 {
 public:
     UniqueId(const UniqueId &) = delete;
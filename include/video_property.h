@@ -1,11 +1,7 @@
 #ifndef VIDEO_PROPERTY_H
 #define VIDEO_PROPERTY_H
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 namespace webcam_capture  {
 
@@ -13,14 +9,11 @@ namespace webcam_capture  {
  *  Supported video properties.
  */
 
-#ifdef _WIN32
-    enum class WEBCAM_CAPTURE_EXPORT VideoProperty {
-#elif __APPLE__
-    enum class VideoProperty {
-#endif
+enum class WEBCAM_CAPTURE_EXPORT VideoProperty {
     Brightness,
     Contrast,
-    Saturation
+    Saturation,
+    Gamma
 };
 
 } // namespace webcam_capture
@@ -1,21 +1,13 @@
 #ifndef VIDEO_PROPERTY_RANGE_H
 #define VIDEO_PROPERTY_RANGE_H
 
-#ifdef _WIN32
-    #include <webcam_capture_export.h>
-#elif __APPLE__
-    //nothing to include
-#endif
+#include <webcam_capture_export.h>
 
 namespace webcam_capture {
 /**
  * Provides range information of a video property.
  */
-#ifdef _WIN32
-    class WEBCAM_CAPTURE_EXPORT VideoPropertyRange
-#elif __APPLE__
-    class VideoPropertyRange
-#endif
+class WEBCAM_CAPTURE_EXPORT VideoPropertyRange
 {
 public:
     VideoPropertyRange():
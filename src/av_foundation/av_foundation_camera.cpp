@@ -1,4 +1,5 @@
 #include "../capability_tree_builder.h"
+#include "../software_proc_amp.h"
 #include "av_foundation_camera.h"
 #include "av_foundation_interface.h"
 #include "av_foundation_unique_id.h"
@@ -44,7 +45,10 @@ int AVFoundation_Camera::start(PixelFormat pixelFormat,
                                   int height, float fps,
                                   FrameCallback cb,
 				  PixelFormat decodeFormat, 
-				  PixelFormat decompressFormat)
+				  PixelFormat decompressFormat,
+				  DecompressionScale decompressScale,
+				  FrameDelivery delivery,
+				  BackpressurePolicy backpressure)
 {
     if (!cb) {
         DEBUG_PRINT("Error: The callback function is empty. Capturing was not started.\n");
@@ -56,6 +60,15 @@ int AVFoundation_Camera::start(PixelFormat pixelFormat,
         return -2;      //TODO Err code
     }
 
+    // AVFoundation hands out the JPEG data as it is and exposes no image controls, so decompression, conversions into
+    // decodeFormat and the properties are all done in software
+    const int result = pipeline.start(cb, pixelFormat, width, height, decompressFormat, decompressScale, decodeFormat,
+                                      delivery, backpressure);
+
+    if (result < 0) {
+        return result;
+    }
+
     cb_frame = cb;
     webcam_capture_av_start_capturing(avFoundationInterface, pixelFormat, width, height, fps, cb);
     state |= CA_STATE_CAPTURING;
@@ -72,13 +85,20 @@ int AVFoundation_Camera::stop()
     state &= ~CA_STATE_CAPTURING;
     webcam_capture_av_stop_capturing(avFoundationInterface);
 
+    // frames still queued are dropped, so that the callback isn't called once stop() returned
+    pipeline.stop();
+
     return 1;   //TODO Err code
 }
 
 std::unique_ptr<Frame> AVFoundation_Camera::captureFrame()
 {
-    //TODO to realise method
-    return nullptr;
+    return pipeline.captureFrame();
+}
+
+FrameDropStatistics AVFoundation_Camera::getDropStatistics()
+{
+    return pipeline.getDropStatistics();
 }
 
 // ---- Capabilities ----
@@ -102,22 +122,21 @@ std::vector<CapabilityFormat> AVFoundation_Camera::getCapabilities()
 
 bool AVFoundation_Camera::getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange)
 {
-    return true;
+    return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
 }
 
 
 
 int AVFoundation_Camera::getProperty(VideoProperty property)
 {
-    int value;
-    return value;
+    return pipeline.getSoftwareProcAmp().getProperty(property);
 }
 
 
 
 bool AVFoundation_Camera::setProperty(const VideoProperty property, const int value)
 {
-    return true;
+    return pipeline.getSoftwareProcAmp().setProperty(property, value);
 }
 
 
@@ -9,6 +9,7 @@
 #include <vector>
 #include <memory>  //std::shared_ptr include
 
+#include "../frame_pipeline.h"
 #include "../utils.h"
 #include "../include/camera_interface.h"
 #include "../include/camera_information.h"
@@ -25,9 +26,10 @@ public:
     ~AVFoundation_Camera();
     static std::unique_ptr<CameraInterface> createCamera(std::shared_ptr<void> mfDeinitializer, const CameraInformation &information);
 
-    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN);
+    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN, DecompressionScale decompressScale = DecompressionScale::Full, FrameDelivery delivery = FrameDelivery::Direct, BackpressurePolicy backpressure = BackpressurePolicy::DropNewest);
     int stop();
     std::unique_ptr<Frame> captureFrame();
+    FrameDropStatistics getDropStatistics();
     // ---- Capabilities ----
     bool getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange);
     int getProperty(VideoProperty property);
@@ -46,6 +48,7 @@ public:
     FrameCallback cb_frame;
 private:
     void* avFoundationInterface; // the objective-c interface
+    FramePipeline pipeline; // software stages between the driver and cb_frame
 };
 
 } // namespace webcam_capture
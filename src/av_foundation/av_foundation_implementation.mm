@@ -1,6 +1,7 @@
 /* -*-C-*- */
 #import "av_foundation_implementation.h"
 #include <backend_implementation.h>
+#include <frame_layout.h>
 #include <pixel_format.h>
 #include "av_foundation_utils.h"
 #include "../utils.h"
@@ -285,14 +286,22 @@
         if (!is_frame_capabilities_set) {
             frame.width[0] = dims.width;
             frame.height[0] = dims.height;
-            frame.nbytes = total_length;
-            frame.pixel_format = webcam_capture::av_foundation_video_format_to_capture_format(pix_fmt);
+            frame.pixelFormat = webcam_capture::av_foundation_video_format_to_capture_format(pix_fmt);
             is_frame_capabilities_set = true;
         }
 
+        // compressed frames differ in size, decompressing them needs to know each one's
+        frame.bytes = total_length;
         frame.plane[0] = (uint8_t*)data_pointer;
 
+        /* The sample buffer holds the block buffer, it's kept for as long as a FrameRef holds the frame. */
+        CFRetain(sampleBuffer);
+        frame.owner = std::shared_ptr<void>((void*)sampleBuffer, [](void* sample) {
+            CFRelease((CMSampleBufferRef)sample);
+        });
+
         cb_frame(frame);
+        frame.owner.reset();
 
         return;
     }
@@ -308,6 +317,9 @@
 
 /* Fill the pixel_buffer member with some info that won't change per frame. */
     if (!is_frame_capabilities_set) {
+        frame.pixelFormat = webcam_capture::av_foundation_video_format_to_capture_format(pix_fmt);
+
+        /* Core Video tells the strides, the layout fills in the rest of what the planes look like. */
         if (true == CVPixelBufferIsPlanar(buffer)) {
             size_t plane_count = CVPixelBufferGetPlaneCount(buffer);
             if (plane_count > 3) {
@@ -315,52 +327,60 @@
                 return;
             }
             for (size_t i = 0; i < plane_count; ++i) {
-                frame.width[i] = CVPixelBufferGetWidthOfPlane(buffer, i);
-                frame.height[i] = CVPixelBufferGetHeightOfPlane(buffer, i);
                 frame.stride[i] = CVPixelBufferGetBytesPerRowOfPlane(buffer, i);
-                frame.nbytes += frame.stride[i] * frame.height[i];
             }
         } else {
-            frame.width[0] = CVPixelBufferGetWidth(buffer);
-            frame.height[0] = CVPixelBufferGetHeight(buffer);
             frame.stride[0] = CVPixelBufferGetBytesPerRow(buffer);
-            frame.nbytes = frame.stride[0] * frame.height[0];
         }
 
-        frame.pixel_format = webcam_capture::av_foundation_video_format_to_capture_format(pix_fmt);
+        if (0 == webcam_capture::FrameLayout::setLayout(frame, CVPixelBufferGetWidth(buffer), CVPixelBufferGetHeight(buffer))) {
+            DEBUG_PRINT("Error: unhandled or unknown pixel format.\n");
+            return;
+        }
+
+        /* The bi-planar formats tell the range, the matrix is attached to the buffer. */
+        if (kCVPixelFormatType_420YpCbCr8BiPlanarFullRange == pix_fmt) {
+            frame.colorRange = webcam_capture::ColorRange::Full;
+        } else if (kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange == pix_fmt) {
+            frame.colorRange = webcam_capture::ColorRange::Limited;
+        }
+
+        CFTypeRef matrix = CVBufferGetAttachment(buffer, kCVImageBufferYCbCrMatrixKey, NULL);
+        if (NULL != matrix) {
+            if (CFEqual(matrix, kCVImageBufferYCbCrMatrix_ITU_R_709_2)) {
+                frame.colorSpace = webcam_capture::ColorSpace::BT709;
+            } else if (CFEqual(matrix, kCVImageBufferYCbCrMatrix_ITU_R_601_4)) {
+                frame.colorSpace = webcam_capture::ColorSpace::BT601;
+            } else if (CFEqual(matrix, kCVImageBufferYCbCrMatrix_ITU_R_2020)) {
+                frame.colorSpace = webcam_capture::ColorSpace::BT2020;
+            }
+        }
 
         is_frame_capabilities_set = true;
     }
 
     CVPixelBufferLockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
     {
-        if (kCVPixelFormatType_422YpCbCr8_yuvs == pix_fmt ||
-            kCVPixelFormatType_422YpCbCr8 == pix_fmt ||
-            kCVPixelFormatType_4444YpCbCrA8 == pix_fmt ||
-            kCVPixelFormatType_32BGRA == pix_fmt ||
-            kCVPixelFormatType_32ABGR == pix_fmt ||
-            kCVPixelFormatType_24RGB == pix_fmt ||
-            kCVPixelFormatType_32ARGB == pix_fmt ||
-            kCVPixelFormatType_16BE565 == pix_fmt ||
-            kCVPixelFormatType_16LE555 == pix_fmt)
-        {
-            frame.plane[0] = (uint8_t*)CVPixelBufferGetBaseAddress(buffer);
-        }
-        else if (kCVPixelFormatType_420YpCbCr8BiPlanarFullRange == pix_fmt ||
-                kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange == pix_fmt)
-        {
-            frame.plane[0] = (uint8_t*)CVPixelBufferGetBaseAddressOfPlane(buffer, 0);
-            frame.plane[1] = (uint8_t*)CVPixelBufferGetBaseAddressOfPlane(buffer, 1);
+        /* The planes of planar buffers don't have to follow each other, so they are pointed to one by one. */
+        if (true == CVPixelBufferIsPlanar(buffer)) {
+            size_t plane_count = CVPixelBufferGetPlaneCount(buffer);
+            for (size_t i = 0; i < plane_count; ++i) {
+                frame.plane[i] = (uint8_t*)CVPixelBufferGetBaseAddressOfPlane(buffer, i);
+            }
         } else {
-            DEBUG_PRINT("Error: unhandled or unknown pixel format.\n");
-            CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
-            return;
+            frame.plane[0] = (uint8_t*)CVPixelBufferGetBaseAddress(buffer);
         }
 
+        /* The pixel buffer stays locked and out of the capture pool for as long as a FrameRef holds the frame. */
+        CVPixelBufferRetain(buffer);
+        frame.owner = std::shared_ptr<void>((void*)buffer, [](void* pixelBuffer) {
+            CVPixelBufferUnlockBaseAddress((CVPixelBufferRef)pixelBuffer, kCVPixelBufferLock_ReadOnly);
+            CVPixelBufferRelease((CVPixelBufferRef)pixelBuffer);
+        });
+
         cb_frame(frame);
+        frame.owner.reset();
     }
-
-    CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
 }
 
 // stop video capturing
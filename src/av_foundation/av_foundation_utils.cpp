@@ -1,5 +1,7 @@
 #include "av_foundation_utils.h"
 
+#include <CoreVideo/CVPixelBuffer.h>
+
 namespace webcam_capture {
 
 // Convert the MF format to one we can use.
@@ -22,6 +24,8 @@ PixelFormat av_foundation_video_format_to_capture_format(CMPixelFormatType avPix
         case kCMPixelFormat_422YpCbCr10 :               { return PixelFormat::v210; }
         case kCMPixelFormat_444YpCbCr10 :               { return PixelFormat::v410; }
         case kCMPixelFormat_8IndexedGray_WhiteIsZero :  { return PixelFormat::IndexedGray8_WhiteIsZero; }
+        case kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange : { return PixelFormat::NV12; }
+        case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange :  { return PixelFormat::NV12; }
         //video codec types
         case kCMVideoCodecType_Animation :              { return PixelFormat::rle; }
         case kCMVideoCodecType_Cinepak :                { return PixelFormat::cvid; }
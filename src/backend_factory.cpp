@@ -12,6 +12,10 @@
 #include "../src/av_foundation/av_foundation_backend.h"
 #endif
 
+#ifdef WEBCAM_CAPTURE_BACKEND_SYNTHETIC
+#include "../src/synthetic/synthetic_backend.h"
+#endif
+
 #ifdef V4L
 #endif
 
@@ -52,6 +56,14 @@ std::unique_ptr<BackendInterface> BackendFactory::getBackend(BackendImplementati
             return std::make_unique<AVFoundation_Backend>();
         }
 
+#endif
+
+#ifdef WEBCAM_CAPTURE_BACKEND_SYNTHETIC
+
+        case BackendImplementation::Synthetic : {
+            return std::unique_ptr<BackendInterface>(new Synthetic_Backend());
+        }
+
 #endif
 
         default:
@@ -79,6 +91,10 @@ std::vector<BackendImplementation> BackendFactory::getAvailableBackends()
         BackendImplementation::AVFoundation,
 #endif
 
+#ifdef WEBCAM_CAPTURE_BACKEND_SYNTHETIC
+        BackendImplementation::Synthetic,
+#endif
+
     };
 }
 
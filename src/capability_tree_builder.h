@@ -4,6 +4,7 @@
 #include <capability.h>
 #include <pixel_format.h>
 
+#include <cstddef>
 #include <functional>
 #include <unordered_map>
 #include <vector>
@@ -0,0 +1,31 @@
+#include "conversion_bayer.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_DemosaicRow Conversion_Kernels::getDemosaicRow(PixelFormat destination, bool edgeAware)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getDemosaicRowAvx2(destination, edgeAware);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getDemosaicRowSse2(destination, edgeAware);
+    }
+#endif
+
+    return getDemosaicRowC(destination, edgeAware);
+}
+
+Conversion_DemosaicRow Conversion_Kernels::getDemosaicRowC(PixelFormat destination, bool edgeAware)
+{
+    return Conversion_selectDemosaicRow<Conversion_DemosaicBilinearC, Conversion_DemosaicEdgeAwareC>(destination,
+            edgeAware);
+}
+
+} // namespace webcam_capture
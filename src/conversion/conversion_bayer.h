@@ -0,0 +1,149 @@
+#ifndef CONVERSION_BAYER_H
+#define CONVERSION_BAYER_H
+
+#include "conversion_layouts.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Demosaicing kernels interpolate the two colors a Bayer pixel is missing from its neighbors.
+ * Every row of a Bayer frame alternates green samples with samples of one other color, red or blue, called the row's
+ * own color below. The rows above and below have the remaining color in the columns of the row's own color.
+ * Kernels take the 5 rows centered on the row they demosaic, each readable 2 samples past both of its ends.
+ */
+
+/**
+ * Rounding average of two samples, the one pavgb computes, so that the SIMD kernels match the scalar ones exactly.
+ */
+inline int Conversion_averageSamples(int a, int b)
+{
+    return (a + b + 1) >> 1;
+}
+
+inline uint8_t Conversion_clampSample(int value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/**
+ * Scalar bilinear demosaicing: every missing color is the average of the closest samples of that color.
+ * SIMD kernels use convert() to finish the pixels that don't fill a whole vector.
+ */
+template<class Destination>
+struct Conversion_DemosaicBilinearC {
+    /**
+     * Demosaics pixels [begin, width) of a row.
+     * @param redRow true if the row's own color is red, false if it's blue.
+     * @param greenFirst true if the first pixel of the row is green.
+     */
+    static void convert(const uint8_t *const *rows, uint8_t *destination, size_t begin, size_t width, bool redRow,
+                        bool greenFirst)
+    {
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+
+        for (size_t x = begin; x < width; x ++) {
+            const int horizontal = Conversion_averageSamples(row[x - 1], row[x + 1]);
+            const int vertical = Conversion_averageSamples(up[x], down[x]);
+            int own;
+            int green;
+            int other;
+
+            if (((x & 1) == 0) == greenFirst) {
+                green = row[x];
+                own = horizontal;
+                other = vertical;
+            } else {
+                own = row[x];
+                green = Conversion_averageSamples(horizontal, vertical);
+                other = Conversion_averageSamples(Conversion_averageSamples(up[x - 1], up[x + 1]),
+                                                  Conversion_averageSamples(down[x - 1], down[x + 1]));
+            }
+
+            Conversion_storeRgb<Destination>(destination + x * Destination::BYTES, redRow ? own : other, green,
+                                             redRow ? other : own);
+        }
+    }
+
+    static void row(const uint8_t *const *rows, uint8_t *destination, size_t width, bool redRow, bool greenFirst)
+    {
+        convert(rows, destination, 0, width, redRow, greenFirst);
+    }
+};
+
+/**
+ * Scalar edge-aware demosaicing.
+ * Green is interpolated along the direction it changes the least in, telling the directions apart by the green
+ * gradient plus the second derivative of the pixel's own color (Hamilton-Adams), which keeps edges from getting the
+ * zipper pattern of bilinear demosaicing. Red and blue are bilinear averages corrected by the Laplacian of the samples
+ * around them (Malvar-He-Cutler), which keeps them from bleeding across the edges.
+ * All of the arithmetic fits 16 bits, which the SIMD kernels rely on.
+ */
+template<class Destination>
+struct Conversion_DemosaicEdgeAwareC {
+    static void convert(const uint8_t *const *rows, uint8_t *destination, size_t begin, size_t width, bool redRow,
+                        bool greenFirst)
+    {
+        const uint8_t *up2 = rows[0];
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+        const uint8_t *down2 = rows[4];
+
+        for (size_t x = begin; x < width; x ++) {
+            const int center = row[x];
+            const int left = row[x - 1];
+            const int right = row[x + 1];
+            const int above = up[x];
+            const int below = down[x];
+            const int diagonals = up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1];
+            int own;
+            int green;
+            int other;
+
+            if (((x & 1) == 0) == greenFirst) {
+                green = center;
+                own = Conversion_clampSample((8 * (left + right) + 10 * center - 2 * (row[x - 2] + row[x + 2]) -
+                                              2 * diagonals + up2[x] + down2[x] + 8) >> 4);
+                other = Conversion_clampSample((8 * (above + below) + 10 * center - 2 * (up2[x] + down2[x]) -
+                                                2 * diagonals + row[x - 2] + row[x + 2] + 8) >> 4);
+            } else {
+                const int laplacianH = 2 * center - row[x - 2] - row[x + 2];
+                const int laplacianV = 2 * center - up2[x] - down2[x];
+                const int gradientH = (left > right ? left - right : right - left) +
+                                      (laplacianH < 0 ? -laplacianH : laplacianH);
+                const int gradientV = (above > below ? above - below : below - above) +
+                                      (laplacianV < 0 ? -laplacianV : laplacianV);
+
+                if (gradientH < gradientV) {
+                    green = (2 * (left + right) + laplacianH + 2) >> 2;
+                } else if (gradientV < gradientH) {
+                    green = (2 * (above + below) + laplacianV + 2) >> 2;
+                } else {
+                    green = (2 * (left + right + above + below) + laplacianH + laplacianV + 4) >> 3;
+                }
+
+                own = center;
+                green = Conversion_clampSample(green);
+                other = Conversion_clampSample((4 * diagonals + 12 * center -
+                                                3 * (row[x - 2] + row[x + 2] + up2[x] + down2[x]) + 8) >> 4);
+            }
+
+            Conversion_storeRgb<Destination>(destination + x * Destination::BYTES, redRow ? own : other, green,
+                                             redRow ? other : own);
+        }
+    }
+
+    static void row(const uint8_t *const *rows, uint8_t *destination, size_t width, bool redRow, bool greenFirst)
+    {
+        convert(rows, destination, 0, width, redRow, greenFirst);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_BAYER_H
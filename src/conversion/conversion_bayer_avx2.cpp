@@ -0,0 +1,203 @@
+#include "conversion_bayer.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i loadAvx2(const uint8_t *samples)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(samples));
+}
+
+/**
+ * Picks the lanes of first where mask is set and the lanes of second elsewhere.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i selectAvx2(__m256i mask, __m256i first, __m256i second)
+{
+    return _mm256_or_si256(_mm256_and_si256(mask, first), _mm256_andnot_si256(mask, second));
+}
+
+template<class Destination>
+struct DemosaicBilinearAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *const *rows, uint8_t *destination, size_t width,
+            bool redRow, bool greenFirst)
+    {
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+
+        // vectors start at even columns, so green samples take either the even or the odd byte lanes
+        const __m256i greenLanes = _mm256_set1_epi16(greenFirst ? 0x00FF : static_cast<short>(0xFF00));
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            const __m256i center = loadAvx2(row + x);
+            const __m256i horizontal = _mm256_avg_epu8(loadAvx2(row + x - 1), loadAvx2(row + x + 1));
+            const __m256i vertical = _mm256_avg_epu8(loadAvx2(up + x), loadAvx2(down + x));
+            const __m256i diagonal = _mm256_avg_epu8(_mm256_avg_epu8(loadAvx2(up + x - 1), loadAvx2(up + x + 1)),
+                                                  _mm256_avg_epu8(loadAvx2(down + x - 1), loadAvx2(down + x + 1)));
+
+            const __m256i own = selectAvx2(greenLanes, horizontal, center);
+            const __m256i green = selectAvx2(greenLanes, center, _mm256_avg_epu8(horizontal, vertical));
+            const __m256i other = selectAvx2(greenLanes, vertical, diagonal);
+
+            Conversion_storeRgbAvx2<Destination>(destination + x * Destination::BYTES, redRow ? own : other, green,
+                                                 redRow ? other : own);
+        }
+
+        Conversion_DemosaicBilinearC<Destination>::convert(rows, destination, x, width, redRow, greenFirst);
+    }
+};
+
+/**
+ * 16-bit samples around 16 pixels, named as in Conversion_DemosaicEdgeAwareC.
+ */
+struct NeighborhoodAvx2 {
+    __m256i center;
+    __m256i left;
+    __m256i right;
+    __m256i above;
+    __m256i below;
+    __m256i sum2H; // samples 2 columns to the left and to the right
+    __m256i sum2V; // samples 2 rows above and below
+    __m256i diagonals;
+};
+
+/**
+ * Zero-extends the low (half 0) or high (half 1) 8 bytes of each 128-bit lane of a vector to 16-bit lanes.
+ * Unpacking works per 128-bit lane, so half 0 gets pixels 0-7 and 16-23, which _mm256_packus_epi16 puts back in order.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i widenAvx2(__m256i bytes, int half)
+{
+    return half ? _mm256_unpackhi_epi8(bytes, _mm256_setzero_si256()) :
+           _mm256_unpacklo_epi8(bytes, _mm256_setzero_si256());
+}
+
+/**
+ * Edge-aware demosaicing of 16 pixels, the results are 16-bit lanes to be saturated down to bytes by the caller.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline void demosaicEdgeAwareAvx2(const NeighborhoodAvx2 &n, __m256i greenLanes,
+        __m256i &own, __m256i &green, __m256i &other)
+{
+    const __m256i horizontal = _mm256_add_epi16(n.left, n.right);
+    const __m256i vertical = _mm256_add_epi16(n.above, n.below);
+    const __m256i tenCenter = _mm256_mullo_epi16(n.center, _mm256_set1_epi16(10));
+    const __m256i twoDiagonals = _mm256_slli_epi16(n.diagonals, 1);
+    const __m256i eight = _mm256_set1_epi16(8);
+
+    // green pixels, the colors are gradient-corrected averages of the samples on either side
+    __m256i ownAtGreen = _mm256_add_epi16(_mm256_slli_epi16(horizontal, 3), tenCenter);
+    ownAtGreen = _mm256_sub_epi16(ownAtGreen, _mm256_add_epi16(_mm256_slli_epi16(n.sum2H, 1), twoDiagonals));
+    ownAtGreen = _mm256_srai_epi16(_mm256_add_epi16(ownAtGreen, _mm256_add_epi16(n.sum2V, eight)), 4);
+
+    __m256i otherAtGreen = _mm256_add_epi16(_mm256_slli_epi16(vertical, 3), tenCenter);
+    otherAtGreen = _mm256_sub_epi16(otherAtGreen, _mm256_add_epi16(_mm256_slli_epi16(n.sum2V, 1), twoDiagonals));
+    otherAtGreen = _mm256_srai_epi16(_mm256_add_epi16(otherAtGreen, _mm256_add_epi16(n.sum2H, eight)), 4);
+
+    // own color pixels, green is interpolated along the direction of the smaller gradient
+    const __m256i twoCenter = _mm256_slli_epi16(n.center, 1);
+    const __m256i laplacianH = _mm256_sub_epi16(twoCenter, n.sum2H);
+    const __m256i laplacianV = _mm256_sub_epi16(twoCenter, n.sum2V);
+    const __m256i gradientH = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(n.left, n.right)),
+                              _mm256_abs_epi16(laplacianH));
+    const __m256i gradientV = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(n.above, n.below)),
+                              _mm256_abs_epi16(laplacianV));
+
+    const __m256i greenH = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(horizontal, 1),
+                           laplacianH), _mm256_set1_epi16(2)), 2);
+    const __m256i greenV = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(vertical, 1),
+                           laplacianV), _mm256_set1_epi16(2)), 2);
+    const __m256i greenBoth = _mm256_srai_epi16(_mm256_add_epi16(
+                                  _mm256_slli_epi16(_mm256_add_epi16(horizontal, vertical), 1),
+                                  _mm256_add_epi16(_mm256_add_epi16(laplacianH, laplacianV), _mm256_set1_epi16(4))), 3);
+    const __m256i greenAtOwn = selectAvx2(_mm256_cmpgt_epi16(gradientV, gradientH), greenH,
+                                          selectAvx2(_mm256_cmpgt_epi16(gradientH, gradientV), greenV, greenBoth));
+
+    __m256i otherAtOwn = _mm256_add_epi16(_mm256_slli_epi16(n.diagonals, 2),
+                                          _mm256_mullo_epi16(n.center, _mm256_set1_epi16(12)));
+    otherAtOwn = _mm256_sub_epi16(otherAtOwn, _mm256_mullo_epi16(_mm256_add_epi16(n.sum2H, n.sum2V),
+                                  _mm256_set1_epi16(3)));
+    otherAtOwn = _mm256_srai_epi16(_mm256_add_epi16(otherAtOwn, eight), 4);
+
+    own = selectAvx2(greenLanes, ownAtGreen, n.center);
+    green = selectAvx2(greenLanes, n.center, greenAtOwn);
+    other = selectAvx2(greenLanes, otherAtGreen, otherAtOwn);
+}
+
+template<class Destination>
+struct DemosaicEdgeAwareAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *const *rows, uint8_t *destination, size_t width,
+            bool redRow, bool greenFirst)
+    {
+        const uint8_t *up2 = rows[0];
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+        const uint8_t *down2 = rows[4];
+
+        // the samples are widened to 16-bit lanes, green samples take either the even or the odd ones
+        const __m256i greenLanes = _mm256_set1_epi32(greenFirst ? 0x0000FFFF : static_cast<int>(0xFFFF0000));
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            const __m256i center = loadAvx2(row + x);
+            const __m256i left = loadAvx2(row + x - 1);
+            const __m256i right = loadAvx2(row + x + 1);
+            const __m256i left2 = loadAvx2(row + x - 2);
+            const __m256i right2 = loadAvx2(row + x + 2);
+            const __m256i above = loadAvx2(up + x);
+            const __m256i below = loadAvx2(down + x);
+            const __m256i above2 = loadAvx2(up2 + x);
+            const __m256i below2 = loadAvx2(down2 + x);
+            const __m256i aboveLeft = loadAvx2(up + x - 1);
+            const __m256i aboveRight = loadAvx2(up + x + 1);
+            const __m256i belowLeft = loadAvx2(down + x - 1);
+            const __m256i belowRight = loadAvx2(down + x + 1);
+
+            __m256i own[2];
+            __m256i green[2];
+            __m256i other[2];
+
+            for (int half = 0; half < 2; half ++) {
+                NeighborhoodAvx2 n;
+                n.center = widenAvx2(center, half);
+                n.left = widenAvx2(left, half);
+                n.right = widenAvx2(right, half);
+                n.above = widenAvx2(above, half);
+                n.below = widenAvx2(below, half);
+                n.sum2H = _mm256_add_epi16(widenAvx2(left2, half), widenAvx2(right2, half));
+                n.sum2V = _mm256_add_epi16(widenAvx2(above2, half), widenAvx2(below2, half));
+                n.diagonals = _mm256_add_epi16(
+                                  _mm256_add_epi16(widenAvx2(aboveLeft, half), widenAvx2(aboveRight, half)),
+                                  _mm256_add_epi16(widenAvx2(belowLeft, half), widenAvx2(belowRight, half)));
+                demosaicEdgeAwareAvx2(n, greenLanes, own[half], green[half], other[half]);
+            }
+
+            const __m256i ownBytes = _mm256_packus_epi16(own[0], own[1]);
+            const __m256i otherBytes = _mm256_packus_epi16(other[0], other[1]);
+
+            Conversion_storeRgbAvx2<Destination>(destination + x * Destination::BYTES, redRow ? ownBytes : otherBytes,
+                                                 _mm256_packus_epi16(green[0], green[1]),
+                                                 redRow ? otherBytes : ownBytes);
+        }
+
+        Conversion_DemosaicEdgeAwareC<Destination>::convert(rows, destination, x, width, redRow, greenFirst);
+    }
+};
+
+} // namespace
+
+Conversion_DemosaicRow Conversion_Kernels::getDemosaicRowAvx2(PixelFormat destination, bool edgeAware)
+{
+    return Conversion_selectDemosaicRow<DemosaicBilinearAvx2, DemosaicEdgeAwareAvx2>(destination, edgeAware);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,199 @@
+#include "conversion_bayer.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i loadSse2(const uint8_t *samples)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples));
+}
+
+/**
+ * Picks the lanes of first where mask is set and the lanes of second elsewhere.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i selectSse2(__m128i mask, __m128i first, __m128i second)
+{
+    return _mm_or_si128(_mm_and_si128(mask, first), _mm_andnot_si128(mask, second));
+}
+
+template<class Destination>
+struct DemosaicBilinearSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *const *rows, uint8_t *destination, size_t width,
+            bool redRow, bool greenFirst)
+    {
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+
+        // vectors start at even columns, so green samples take either the even or the odd byte lanes
+        const __m128i greenLanes = _mm_set1_epi16(greenFirst ? 0x00FF : static_cast<short>(0xFF00));
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            const __m128i center = loadSse2(row + x);
+            const __m128i horizontal = _mm_avg_epu8(loadSse2(row + x - 1), loadSse2(row + x + 1));
+            const __m128i vertical = _mm_avg_epu8(loadSse2(up + x), loadSse2(down + x));
+            const __m128i diagonal = _mm_avg_epu8(_mm_avg_epu8(loadSse2(up + x - 1), loadSse2(up + x + 1)),
+                                                  _mm_avg_epu8(loadSse2(down + x - 1), loadSse2(down + x + 1)));
+
+            const __m128i own = selectSse2(greenLanes, horizontal, center);
+            const __m128i green = selectSse2(greenLanes, center, _mm_avg_epu8(horizontal, vertical));
+            const __m128i other = selectSse2(greenLanes, vertical, diagonal);
+
+            Conversion_storeRgbSse2<Destination>(destination + x * Destination::BYTES, redRow ? own : other, green,
+                                                 redRow ? other : own);
+        }
+
+        Conversion_DemosaicBilinearC<Destination>::convert(rows, destination, x, width, redRow, greenFirst);
+    }
+};
+
+/**
+ * 16-bit samples around 8 consecutive pixels, named as in Conversion_DemosaicEdgeAwareC.
+ */
+struct NeighborhoodSse2 {
+    __m128i center;
+    __m128i left;
+    __m128i right;
+    __m128i above;
+    __m128i below;
+    __m128i sum2H; // samples 2 columns to the left and to the right
+    __m128i sum2V; // samples 2 rows above and below
+    __m128i diagonals;
+};
+
+/**
+ * Zero-extends the low (half 0) or high (half 1) 8 bytes of a vector to 16-bit lanes.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i widenSse2(__m128i bytes, int half)
+{
+    return half ? _mm_unpackhi_epi8(bytes, _mm_setzero_si128()) : _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+}
+
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i absSse2(__m128i value)
+{
+    return _mm_max_epi16(value, _mm_sub_epi16(_mm_setzero_si128(), value));
+}
+
+/**
+ * Edge-aware demosaicing of 8 pixels, the results are 16-bit lanes to be saturated down to bytes by the caller.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline void demosaicEdgeAwareSse2(const NeighborhoodSse2 &n, __m128i greenLanes,
+        __m128i &own, __m128i &green, __m128i &other)
+{
+    const __m128i horizontal = _mm_add_epi16(n.left, n.right);
+    const __m128i vertical = _mm_add_epi16(n.above, n.below);
+    const __m128i tenCenter = _mm_mullo_epi16(n.center, _mm_set1_epi16(10));
+    const __m128i twoDiagonals = _mm_slli_epi16(n.diagonals, 1);
+    const __m128i eight = _mm_set1_epi16(8);
+
+    // green pixels, the colors are gradient-corrected averages of the samples on either side
+    __m128i ownAtGreen = _mm_add_epi16(_mm_slli_epi16(horizontal, 3), tenCenter);
+    ownAtGreen = _mm_sub_epi16(ownAtGreen, _mm_add_epi16(_mm_slli_epi16(n.sum2H, 1), twoDiagonals));
+    ownAtGreen = _mm_srai_epi16(_mm_add_epi16(ownAtGreen, _mm_add_epi16(n.sum2V, eight)), 4);
+
+    __m128i otherAtGreen = _mm_add_epi16(_mm_slli_epi16(vertical, 3), tenCenter);
+    otherAtGreen = _mm_sub_epi16(otherAtGreen, _mm_add_epi16(_mm_slli_epi16(n.sum2V, 1), twoDiagonals));
+    otherAtGreen = _mm_srai_epi16(_mm_add_epi16(otherAtGreen, _mm_add_epi16(n.sum2H, eight)), 4);
+
+    // own color pixels, green is interpolated along the direction of the smaller gradient
+    const __m128i twoCenter = _mm_slli_epi16(n.center, 1);
+    const __m128i laplacianH = _mm_sub_epi16(twoCenter, n.sum2H);
+    const __m128i laplacianV = _mm_sub_epi16(twoCenter, n.sum2V);
+    const __m128i gradientH = _mm_add_epi16(absSse2(_mm_sub_epi16(n.left, n.right)), absSse2(laplacianH));
+    const __m128i gradientV = _mm_add_epi16(absSse2(_mm_sub_epi16(n.above, n.below)), absSse2(laplacianV));
+
+    const __m128i greenH = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(horizontal, 1), laplacianH),
+                                          _mm_set1_epi16(2)), 2);
+    const __m128i greenV = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(vertical, 1), laplacianV),
+                                          _mm_set1_epi16(2)), 2);
+    const __m128i greenBoth = _mm_srai_epi16(_mm_add_epi16(_mm_slli_epi16(_mm_add_epi16(horizontal, vertical), 1),
+                              _mm_add_epi16(_mm_add_epi16(laplacianH, laplacianV), _mm_set1_epi16(4))), 3);
+    const __m128i greenAtOwn = selectSse2(_mm_cmplt_epi16(gradientH, gradientV), greenH,
+                                          selectSse2(_mm_cmplt_epi16(gradientV, gradientH), greenV, greenBoth));
+
+    __m128i otherAtOwn = _mm_add_epi16(_mm_slli_epi16(n.diagonals, 2), _mm_mullo_epi16(n.center, _mm_set1_epi16(12)));
+    otherAtOwn = _mm_sub_epi16(otherAtOwn, _mm_mullo_epi16(_mm_add_epi16(n.sum2H, n.sum2V), _mm_set1_epi16(3)));
+    otherAtOwn = _mm_srai_epi16(_mm_add_epi16(otherAtOwn, eight), 4);
+
+    own = selectSse2(greenLanes, ownAtGreen, n.center);
+    green = selectSse2(greenLanes, n.center, greenAtOwn);
+    other = selectSse2(greenLanes, otherAtGreen, otherAtOwn);
+}
+
+template<class Destination>
+struct DemosaicEdgeAwareSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *const *rows, uint8_t *destination, size_t width,
+            bool redRow, bool greenFirst)
+    {
+        const uint8_t *up2 = rows[0];
+        const uint8_t *up = rows[1];
+        const uint8_t *row = rows[2];
+        const uint8_t *down = rows[3];
+        const uint8_t *down2 = rows[4];
+
+        // the samples are widened to 16-bit lanes, green samples take either the even or the odd ones
+        const __m128i greenLanes = _mm_set1_epi32(greenFirst ? 0x0000FFFF : static_cast<int>(0xFFFF0000));
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            const __m128i center = loadSse2(row + x);
+            const __m128i left = loadSse2(row + x - 1);
+            const __m128i right = loadSse2(row + x + 1);
+            const __m128i left2 = loadSse2(row + x - 2);
+            const __m128i right2 = loadSse2(row + x + 2);
+            const __m128i above = loadSse2(up + x);
+            const __m128i below = loadSse2(down + x);
+            const __m128i above2 = loadSse2(up2 + x);
+            const __m128i below2 = loadSse2(down2 + x);
+            const __m128i aboveLeft = loadSse2(up + x - 1);
+            const __m128i aboveRight = loadSse2(up + x + 1);
+            const __m128i belowLeft = loadSse2(down + x - 1);
+            const __m128i belowRight = loadSse2(down + x + 1);
+
+            __m128i own[2];
+            __m128i green[2];
+            __m128i other[2];
+
+            for (int half = 0; half < 2; half ++) {
+                NeighborhoodSse2 n;
+                n.center = widenSse2(center, half);
+                n.left = widenSse2(left, half);
+                n.right = widenSse2(right, half);
+                n.above = widenSse2(above, half);
+                n.below = widenSse2(below, half);
+                n.sum2H = _mm_add_epi16(widenSse2(left2, half), widenSse2(right2, half));
+                n.sum2V = _mm_add_epi16(widenSse2(above2, half), widenSse2(below2, half));
+                n.diagonals = _mm_add_epi16(_mm_add_epi16(widenSse2(aboveLeft, half), widenSse2(aboveRight, half)),
+                                            _mm_add_epi16(widenSse2(belowLeft, half), widenSse2(belowRight, half)));
+                demosaicEdgeAwareSse2(n, greenLanes, own[half], green[half], other[half]);
+            }
+
+            const __m128i ownBytes = _mm_packus_epi16(own[0], own[1]);
+            const __m128i otherBytes = _mm_packus_epi16(other[0], other[1]);
+
+            Conversion_storeRgbSse2<Destination>(destination + x * Destination::BYTES, redRow ? ownBytes : otherBytes,
+                                                 _mm_packus_epi16(green[0], green[1]), redRow ? otherBytes : ownBytes);
+        }
+
+        Conversion_DemosaicEdgeAwareC<Destination>::convert(rows, destination, x, width, redRow, greenFirst);
+    }
+};
+
+} // namespace
+
+Conversion_DemosaicRow Conversion_Kernels::getDemosaicRowSse2(PixelFormat destination, bool edgeAware)
+{
+    return Conversion_selectDemosaicRow<DemosaicBilinearSse2, DemosaicEdgeAwareSse2>(destination, edgeAware);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,265 @@
+#ifndef CONVERSION_COLORIMETRY_H
+#define CONVERSION_COLORIMETRY_H
+
+#include <color_range.h>
+#include <color_space.h>
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * YUV to RGB coefficients are fixed point numbers with 6 fractional bits.
+ * 6 bits is what keeps every intermediate value within a signed 16-bit SIMD lane.
+ */
+struct Conversion_FixedPoint {
+    enum {
+        SHIFT = 6,
+        ROUNDING = 1 << (SHIFT - 1)
+    };
+};
+
+/**
+ * YUV to RGB coefficients of a matrix and range combination, specialized for every supported one.
+ * Being compile-time constants, they get folded into the kernels' instructions.
+ * https://en.wikipedia.org/wiki/YCbCr#ITU-R_BT.601_conversion
+ */
+template<ColorSpace Space, ColorRange Range>
+struct Conversion_Coefficients;
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT601, ColorRange::Limited> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_GAIN = 75,    // 1.164 * 64
+        V_TO_R = 102,   // 1.596 * 64
+        U_TO_G = 25,    // 0.392 * 64
+        V_TO_G = 52,    // 0.813 * 64
+        U_TO_B = 129    // 2.017 * 64
+    };
+};
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT601, ColorRange::Full> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_GAIN = 64,
+        V_TO_R = 90,    // 1.402 * 64
+        U_TO_G = 22,    // 0.344 * 64
+        V_TO_G = 46,    // 0.714 * 64
+        U_TO_B = 113    // 1.772 * 64
+    };
+};
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT709, ColorRange::Limited> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_GAIN = 75,    // 1.164 * 64
+        V_TO_R = 115,   // 1.793 * 64
+        U_TO_G = 14,    // 0.213 * 64
+        V_TO_G = 34,    // 0.533 * 64
+        U_TO_B = 135    // 2.112 * 64
+    };
+};
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT709, ColorRange::Full> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_GAIN = 64,
+        V_TO_R = 101,   // 1.575 * 64
+        U_TO_G = 12,    // 0.187 * 64
+        V_TO_G = 30,    // 0.468 * 64
+        U_TO_B = 119    // 1.856 * 64
+    };
+};
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT2020, ColorRange::Limited> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_GAIN = 75,    // 1.164 * 64
+        V_TO_R = 107,   // 1.679 * 64
+        U_TO_G = 12,    // 0.187 * 64
+        V_TO_G = 42,    // 0.650 * 64
+        U_TO_B = 137    // 2.142 * 64
+    };
+};
+
+template<>
+struct Conversion_Coefficients<ColorSpace::BT2020, ColorRange::Full> : Conversion_FixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_GAIN = 64,
+        V_TO_R = 94,    // 1.475 * 64
+        U_TO_G = 11,    // 0.165 * 64
+        V_TO_G = 37,    // 0.571 * 64
+        U_TO_B = 120    // 1.881 * 64
+    };
+};
+
+/**
+ * RGB to YUV coefficients are fixed point numbers with 13 fractional bits.
+ * The kernels sum the products up in 32-bit lanes with pmaddwd, which only needs the coefficients and the sums of 4
+ * pixels chroma is computed from to fit signed 16 bits.
+ */
+struct Conversion_ForwardFixedPoint {
+    enum {
+        SHIFT = 13,
+        ROUNDING = 1 << (SHIFT - 1)
+    };
+};
+
+/**
+ * RGB to YUV coefficients of a matrix and range combination, the inverse of Conversion_Coefficients.
+ * Rows are rounded to sum up exactly, to the luma gain for luma and to 0 for chroma, so that gray pixels stay gray.
+ */
+template<ColorSpace Space, ColorRange Range>
+struct Conversion_RgbToYuvCoefficients;
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT601, ColorRange::Limited> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_R = 2104,     // 0.257 * 8192
+        Y_G = 4129,     // 0.504 * 8192
+        Y_B = 802,      // 0.098 * 8192
+        U_R = -1214,    // -0.148 * 8192
+        U_G = -2384,    // -0.291 * 8192
+        U_B = 3598,     // 0.439 * 8192
+        V_R = 3598,     // 0.439 * 8192
+        V_G = -3013,    // -0.368 * 8192
+        V_B = -585      // -0.071 * 8192
+    };
+};
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT601, ColorRange::Full> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_R = 2449,     // 0.299 * 8192
+        Y_G = 4809,     // 0.587 * 8192
+        Y_B = 934,      // 0.114 * 8192
+        U_R = -1382,    // -0.169 * 8192
+        U_G = -2714,    // -0.331 * 8192
+        U_B = 4096,     // 0.500 * 8192
+        V_R = 4096,     // 0.500 * 8192
+        V_G = -3430,    // -0.419 * 8192
+        V_B = -666      // -0.081 * 8192
+    };
+};
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT709, ColorRange::Limited> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_R = 1496,     // 0.183 * 8192
+        Y_G = 5031,     // 0.614 * 8192
+        Y_B = 508,      // 0.062 * 8192
+        U_R = -824,     // -0.101 * 8192
+        U_G = -2774,    // -0.339 * 8192
+        U_B = 3598,     // 0.439 * 8192
+        V_R = 3598,     // 0.439 * 8192
+        V_G = -3268,    // -0.399 * 8192
+        V_B = -330      // -0.040 * 8192
+    };
+};
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT709, ColorRange::Full> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_R = 1742,     // 0.213 * 8192
+        Y_G = 5859,     // 0.715 * 8192
+        Y_B = 591,      // 0.072 * 8192
+        U_R = -939,     // -0.115 * 8192
+        U_G = -3157,    // -0.385 * 8192
+        U_B = 4096,     // 0.500 * 8192
+        V_R = 4096,     // 0.500 * 8192
+        V_G = -3720,    // -0.454 * 8192
+        V_B = -376      // -0.046 * 8192
+    };
+};
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT2020, ColorRange::Limited> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 16,
+        Y_R = 1848,     // 0.226 * 8192
+        Y_G = 4770,     // 0.582 * 8192
+        Y_B = 417,      // 0.051 * 8192
+        U_R = -1005,    // -0.123 * 8192
+        U_G = -2593,    // -0.317 * 8192
+        U_B = 3598,     // 0.439 * 8192
+        V_R = 3598,     // 0.439 * 8192
+        V_G = -3309,    // -0.404 * 8192
+        V_B = -289      // -0.035 * 8192
+    };
+};
+
+template<>
+struct Conversion_RgbToYuvCoefficients<ColorSpace::BT2020, ColorRange::Full> : Conversion_ForwardFixedPoint {
+    enum {
+        Y_OFFSET = 0,
+        Y_R = 2152,     // 0.263 * 8192
+        Y_G = 5554,     // 0.678 * 8192
+        Y_B = 486,      // 0.059 * 8192
+        U_R = -1144,    // -0.140 * 8192
+        U_G = -2952,    // -0.360 * 8192
+        U_B = 4096,     // 0.500 * 8192
+        V_R = 4096,     // 0.500 * 8192
+        V_G = -3767,    // -0.460 * 8192
+        V_B = -329      // -0.040 * 8192
+    };
+};
+
+inline uint8_t Conversion_clampToByte(int value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/**
+ * Scalar reference of the YUV to RGB math.
+ * SIMD kernels produce bit-exact results, saturating 16-bit arithmetic included.
+ */
+template<class Coefficients>
+inline void Conversion_yuvToRgb(int y, int u, int v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    const int luma = (y - Coefficients::Y_OFFSET) * Coefficients::Y_GAIN + Coefficients::ROUNDING;
+    const int du = u - 128;
+    const int dv = v - 128;
+
+    r = Conversion_clampToByte((luma + Coefficients::V_TO_R * dv) >> Coefficients::SHIFT);
+    g = Conversion_clampToByte((luma - Coefficients::U_TO_G * du - Coefficients::V_TO_G * dv) >> Coefficients::SHIFT);
+    b = Conversion_clampToByte((luma + Coefficients::U_TO_B * du) >> Coefficients::SHIFT);
+}
+
+/**
+ * Scalar reference of the RGB to luma math, which the SIMD kernels match exactly.
+ */
+template<class Coefficients>
+inline uint8_t Conversion_rgbToLuma(int r, int g, int b)
+{
+    return Conversion_clampToByte(((Coefficients::Y_R * r + Coefficients::Y_G * g + Coefficients::Y_B * b +
+                                    Coefficients::ROUNDING) >> Coefficients::SHIFT) + Coefficients::Y_OFFSET);
+}
+
+/**
+ * Scalar reference of the RGB to chroma math.
+ * Takes the sums of the channels of the 4 pixels a chroma sample covers, which get averaged by the final shift.
+ */
+template<class Coefficients>
+inline void Conversion_rgbSumToChroma(int r, int g, int b, uint8_t &u, uint8_t &v)
+{
+    const int rounding = 1 << (Coefficients::SHIFT + 1);
+
+    u = Conversion_clampToByte(((Coefficients::U_R * r + Coefficients::U_G * g + Coefficients::U_B * b + rounding) >>
+                                (Coefficients::SHIFT + 2)) + 128);
+    v = Conversion_clampToByte(((Coefficients::V_R * r + Coefficients::V_G * g + Coefficients::V_B * b + rounding) >>
+                                (Coefficients::SHIFT + 2)) + 128);
+}
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_COLORIMETRY_H
@@ -0,0 +1,101 @@
+#include "conversion_cpu_features.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #include <immintrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#include <algorithm>
+#include <atomic>
+
+namespace webcam_capture {
+
+namespace {
+
+std::atomic<int> maxSimdLevel(static_cast<int>(Conversion_CpuFeatures::SimdLevel::AVX2));
+
+#ifdef WEBCAM_CAPTURE_X86
+
+void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+    for (int i = 0; i < 4; i ++) {
+        regs[i] = static_cast<unsigned int>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+unsigned long long xgetbv(unsigned int index)
+{
+#ifdef _MSC_VER
+    return _xgetbv(index);
+#else
+    unsigned int eax;
+    unsigned int edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+#endif // WEBCAM_CAPTURE_X86
+
+} // namespace
+
+Conversion_CpuFeatures::SimdLevel Conversion_CpuFeatures::getSimdLevel()
+{
+    // detection has no side effects, so racing threads would just compute the same value
+    static const SimdLevel level = detectSimdLevel();
+    return static_cast<SimdLevel>(std::min(static_cast<int>(level), maxSimdLevel.load()));
+}
+
+void Conversion_CpuFeatures::setMaxSimdLevel(SimdLevel level)
+{
+    maxSimdLevel = static_cast<int>(level);
+}
+
+Conversion_CpuFeatures::SimdLevel Conversion_CpuFeatures::detectSimdLevel()
+{
+#ifdef WEBCAM_CAPTURE_X86
+    unsigned int regs[4];
+
+    cpuid(0, 0, regs);
+    const unsigned int maxLeaf = regs[0];
+
+    if (maxLeaf < 1) {
+        return SimdLevel::None;
+    }
+
+    cpuid(1, 0, regs);
+    const bool sse2 = (regs[3] & (1u << 26)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+
+    if (!sse2) {
+        return SimdLevel::None;
+    }
+
+    // AVX2 also needs the OS to save the upper halves of the YMM registers on context switches
+    if (maxLeaf >= 7 && osxsave && avx && (xgetbv(0) & 0x6) == 0x6) {
+        cpuid(7, 0, regs);
+
+        if (regs[1] & (1u << 5)) {
+            return SimdLevel::AVX2;
+        }
+    }
+
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::None;
+#endif
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,56 @@
+#ifndef CONVERSION_CPU_FEATURES_H
+#define CONVERSION_CPU_FEATURES_H
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    #define WEBCAM_CAPTURE_X86
+#endif
+
+// GCC and Clang refuse to inline intrinsics into functions that weren't compiled for the instruction set,
+// so SIMD kernels are marked per function instead of building whole translation units with -mavx2.
+// MSVC allows intrinsics anywhere, so nothing is needed there.
+#if defined(__GNUC__) || defined(__clang__)
+    #define WEBCAM_CAPTURE_TARGET_SSE2 __attribute__((target("sse2")))
+    #define WEBCAM_CAPTURE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define WEBCAM_CAPTURE_TARGET_SSE2
+    #define WEBCAM_CAPTURE_TARGET_AVX2
+#endif
+
+namespace webcam_capture {
+
+/**
+ * Detects which SIMD instruction sets the conversion kernels can use on the running CPU.
+ */
+class Conversion_CpuFeatures
+{
+public:
+    Conversion_CpuFeatures() = delete;
+
+    /**
+     * Instruction sets the kernels are written for, ordered from the slowest to the fastest.
+     */
+    enum class SimdLevel {
+        None,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @return The best instruction set supported by both the CPU and the OS, capped by setMaxSimdLevel(). Detected
+     * once and cached.
+     */
+    static SimdLevel getSimdLevel();
+
+    /**
+     * Caps the instruction set kernels get picked for, so that the slower kernels can be benchmarked and checked
+     * against the faster ones on the same CPU. Affects only the kernels picked after the call.
+     */
+    static void setMaxSimdLevel(SimdLevel level);
+
+private:
+    static SimdLevel detectSimdLevel();
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_CPU_FEATURES_H
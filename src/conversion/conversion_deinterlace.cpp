@@ -0,0 +1,60 @@
+#include "conversion_deinterlace.h"
+
+#include "conversion_cpu_features.h"
+
+namespace webcam_capture {
+
+Conversion_InterpolateRow Conversion_Deinterlacer::getInterpolateRow()
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getInterpolateRowAvx2();
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getInterpolateRowSse2();
+    }
+#endif
+
+    return &interpolateRowC;
+}
+
+Conversion_MotionAdaptiveRow Conversion_Deinterlacer::getMotionAdaptiveRow()
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getMotionAdaptiveRowAvx2();
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getMotionAdaptiveRowSse2();
+    }
+#endif
+
+    return &motionAdaptiveRowC;
+}
+
+void Conversion_Deinterlacer::interpolateRowC(const uint8_t *above, const uint8_t *below, uint8_t *destination,
+        size_t count)
+{
+    for (size_t x = 0; x < count; x ++) {
+        destination[x] = static_cast<uint8_t>((above[x] + below[x] + 1) >> 1);
+    }
+}
+
+void Conversion_Deinterlacer::motionAdaptiveRowC(const uint8_t *above, const uint8_t *below, const uint8_t *current,
+        const uint8_t *previous, uint8_t threshold, uint8_t *destination, size_t count)
+{
+    for (size_t x = 0; x < count; x ++) {
+        const int difference = current[x] - previous[x];
+
+        destination[x] = difference <= threshold && -difference <= threshold ? current[x] :
+                         static_cast<uint8_t>((above[x] + below[x] + 1) >> 1);
+    }
+}
+
+} // namespace webcam_capture
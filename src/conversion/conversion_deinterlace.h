@@ -0,0 +1,48 @@
+#ifndef CONVERSION_DEINTERLACE_H
+#define CONVERSION_DEINTERLACE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Computes count bytes of a row of the field being replaced as the rounded up average of the bytes of the rows of
+ * the kept field above and below it.
+ */
+typedef void (*Conversion_InterpolateRow)(const uint8_t *above, const uint8_t *below, uint8_t *destination,
+        size_t count);
+
+/**
+ * Motion-adaptive version of Conversion_InterpolateRow. Bytes of current, the row being replaced, that differ from
+ * previous, the same row one frame earlier, by at most threshold are kept, the others are interpolated.
+ */
+typedef void (*Conversion_MotionAdaptiveRow)(const uint8_t *above, const uint8_t *below, const uint8_t *current,
+        const uint8_t *previous, uint8_t threshold, uint8_t *destination, size_t count);
+
+/**
+ * Row kernels of FrameDeinterlacer. They work on bytes, whatever sample they hold, so one kernel serves packed and
+ * planar formats alike.
+ */
+class Conversion_Deinterlacer
+{
+public:
+    Conversion_Deinterlacer() = delete;
+
+    static Conversion_InterpolateRow getInterpolateRow();
+    static Conversion_MotionAdaptiveRow getMotionAdaptiveRow();
+
+    static void interpolateRowC(const uint8_t *above, const uint8_t *below, uint8_t *destination, size_t count);
+    static void motionAdaptiveRowC(const uint8_t *above, const uint8_t *below, const uint8_t *current,
+                                   const uint8_t *previous, uint8_t threshold, uint8_t *destination, size_t count);
+
+    static Conversion_InterpolateRow getInterpolateRowSse2();
+    static Conversion_MotionAdaptiveRow getMotionAdaptiveRowSse2();
+
+    static Conversion_InterpolateRow getInterpolateRowAvx2();
+    static Conversion_MotionAdaptiveRow getMotionAdaptiveRowAvx2();
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_DEINTERLACE_H
@@ -0,0 +1,64 @@
+#include "conversion_deinterlace.h"
+
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+WEBCAM_CAPTURE_TARGET_AVX2 void interpolateRowAvx2(const uint8_t *above, const uint8_t *below, uint8_t *destination,
+        size_t count)
+{
+    size_t x = 0;
+
+    for (; x + 32 <= count; x += 32) {
+        const __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + x));
+        const __m256i bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + x));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x), _mm256_avg_epu8(top, bottom));
+    }
+
+    Conversion_Deinterlacer::interpolateRowC(above + x, below + x, destination + x, count - x);
+}
+
+WEBCAM_CAPTURE_TARGET_AVX2 void motionAdaptiveRowAvx2(const uint8_t *above, const uint8_t *below,
+        const uint8_t *current, const uint8_t *previous, uint8_t threshold, uint8_t *destination, size_t count)
+{
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(threshold));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t x = 0;
+
+    for (; x + 32 <= count; x += 32) {
+        const __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + x));
+        const __m256i bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + x));
+        const __m256i now = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current + x));
+        const __m256i before = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(previous + x));
+
+        // unsigned absolute difference, which saturates to 0 where it's within the threshold
+        const __m256i difference = _mm256_or_si256(_mm256_subs_epu8(now, before), _mm256_subs_epu8(before, now));
+        const __m256i still = _mm256_cmpeq_epi8(_mm256_subs_epu8(difference, limit), zero);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x),
+                            _mm256_blendv_epi8(_mm256_avg_epu8(top, bottom), now, still));
+    }
+
+    Conversion_Deinterlacer::motionAdaptiveRowC(above + x, below + x, current + x, previous + x, threshold,
+            destination + x, count - x);
+}
+
+} // namespace
+
+Conversion_InterpolateRow Conversion_Deinterlacer::getInterpolateRowAvx2()
+{
+    return &interpolateRowAvx2;
+}
+
+Conversion_MotionAdaptiveRow Conversion_Deinterlacer::getMotionAdaptiveRowAvx2()
+{
+    return &motionAdaptiveRowAvx2;
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
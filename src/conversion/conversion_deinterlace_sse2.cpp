@@ -0,0 +1,65 @@
+#include "conversion_deinterlace.h"
+
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+WEBCAM_CAPTURE_TARGET_SSE2 void interpolateRowSse2(const uint8_t *above, const uint8_t *below, uint8_t *destination,
+        size_t count)
+{
+    size_t x = 0;
+
+    for (; x + 16 <= count; x += 16) {
+        const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + x));
+        const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x), _mm_avg_epu8(top, bottom));
+    }
+
+    Conversion_Deinterlacer::interpolateRowC(above + x, below + x, destination + x, count - x);
+}
+
+WEBCAM_CAPTURE_TARGET_SSE2 void motionAdaptiveRowSse2(const uint8_t *above, const uint8_t *below,
+        const uint8_t *current, const uint8_t *previous, uint8_t threshold, uint8_t *destination, size_t count)
+{
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    const __m128i zero = _mm_setzero_si128();
+    size_t x = 0;
+
+    for (; x + 16 <= count; x += 16) {
+        const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + x));
+        const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + x));
+        const __m128i now = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + x));
+        const __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i *>(previous + x));
+
+        // unsigned absolute difference, which saturates to 0 where it's within the threshold
+        const __m128i difference = _mm_or_si128(_mm_subs_epu8(now, before), _mm_subs_epu8(before, now));
+        const __m128i still = _mm_cmpeq_epi8(_mm_subs_epu8(difference, limit), zero);
+
+        const __m128i interpolated = _mm_avg_epu8(top, bottom);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x),
+                         _mm_or_si128(_mm_and_si128(still, now), _mm_andnot_si128(still, interpolated)));
+    }
+
+    Conversion_Deinterlacer::motionAdaptiveRowC(above + x, below + x, current + x, previous + x, threshold,
+            destination + x, count - x);
+}
+
+} // namespace
+
+Conversion_InterpolateRow Conversion_Deinterlacer::getInterpolateRowSse2()
+{
+    return &interpolateRowSse2;
+}
+
+Conversion_MotionAdaptiveRow Conversion_Deinterlacer::getMotionAdaptiveRowSse2()
+{
+    return &motionAdaptiveRowSse2;
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,123 @@
+#include "conversion_high_bit_depth.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_UnpackRow Conversion_Kernels::getUnpackRow(PixelFormat source)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getUnpackRowAvx2(source);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getUnpackRowSse2(source);
+    }
+#endif
+
+    return getUnpackRowC(source);
+}
+
+Conversion_UnpackRow Conversion_Kernels::getUnpackRowC(PixelFormat source)
+{
+    switch (source) {
+        case PixelFormat::P010:
+        case PixelFormat::P210:
+            return &Conversion_UnpackSemiPlanarC<10>::row;
+
+        case PixelFormat::P016:
+        case PixelFormat::P216:
+            return &Conversion_UnpackSemiPlanarC<16>::row;
+
+        case PixelFormat::v210:
+            return &Conversion_UnpackV210C::row;
+
+        case PixelFormat::Y210:
+            return &Conversion_UnpackY210C<10>::row;
+
+        case PixelFormat::Y216:
+            return &Conversion_UnpackY210C<16>::row;
+
+        case PixelFormat::Y410:
+            return &Conversion_UnpackY410C::row;
+
+        case PixelFormat::Y416:
+            return &Conversion_UnpackY416C::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+Conversion_NarrowRow Conversion_Kernels::getNarrowRow()
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getNarrowRowAvx2();
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getNarrowRowSse2();
+    }
+#endif
+
+    return getNarrowRowC();
+}
+
+Conversion_NarrowRow Conversion_Kernels::getNarrowRowC()
+{
+    return &Conversion_NarrowC::row;
+}
+
+Conversion_PackYuvRow Conversion_Kernels::getPackYuvRow(PixelFormat destination)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    // byte interleaving doesn't gain anything from the wider AVX2 registers
+    if (Conversion_CpuFeatures::getSimdLevel() >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getPackYuvRowSse2(destination);
+    }
+#endif
+
+    return getPackYuvRowC(destination);
+}
+
+Conversion_PackYuvRow Conversion_Kernels::getPackYuvRowC(PixelFormat destination)
+{
+    switch (destination) {
+        case PixelFormat::NV12:
+            return &Conversion_PackNv12C::row;
+
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            return &Conversion_PackYuy2C::row;
+
+        case PixelFormat::AYUV:
+            return &Conversion_PackAyuvC::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+Conversion_PackYuv16Row Conversion_Kernels::getPackYuv16Row(PixelFormat destination)
+{
+    switch (destination) {
+        case PixelFormat::P016:
+        case PixelFormat::P216:
+            return &Conversion_PackP016C::row;
+
+        case PixelFormat::Y416:
+            return &Conversion_PackY416C::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace webcam_capture
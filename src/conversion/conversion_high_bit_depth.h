@@ -0,0 +1,281 @@
+#ifndef CONVERSION_HIGH_BIT_DEPTH_H
+#define CONVERSION_HIGH_BIT_DEPTH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * High bit depth formats are unpacked into rows of 16-bit Y, U and V samples, chroma at its native resolution.
+ * Samples are scaled to the full 16-bit range, so 10-bit and 16-bit formats look the same after unpacking.
+ * Multi-byte samples are stored little-endian by all of the formats.
+ */
+inline uint16_t Conversion_load16(const uint8_t *bytes)
+{
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+inline uint32_t Conversion_load32(const uint8_t *bytes)
+{
+    return static_cast<uint32_t>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16)) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+/**
+ * Scales a sample stored in the Bits most significant bits of a 16-bit word to the full range,
+ * by replicating its top bits into the unused low ones.
+ */
+template<int Bits>
+inline uint16_t Conversion_expandMsb(uint16_t sample)
+{
+    return Bits >= 16 ? sample : static_cast<uint16_t>(sample | (sample >> (Bits >= 16 ? 0 : Bits)));
+}
+
+/**
+ * Scales a 10-bit sample stored in the low bits to the full range.
+ */
+inline uint16_t Conversion_expand10(uint32_t sample)
+{
+    sample &= 0x3FF;
+    return static_cast<uint16_t>((sample << 6) | (sample >> 4));
+}
+
+/**
+ * Narrows a 16-bit sample to 8 bits, adding threshold before dropping the low byte.
+ * A constant threshold of 128 rounds, a varying one dithers.
+ */
+inline uint8_t Conversion_narrow(uint16_t sample, uint16_t threshold)
+{
+    const unsigned sum = static_cast<unsigned>(sample) + threshold;
+    return static_cast<uint8_t>(sum > 0xFFFF ? 0xFF : sum >> 8);
+}
+
+/**
+ * P010, P016, P210 and P216: a plane of 16-bit luma samples and a plane of interleaved 16-bit U and V samples,
+ * holding Bits significant bits in the most significant bits.
+ */
+template<int Bits>
+struct Conversion_UnpackSemiPlanarC {
+    static void row(const uint8_t *luma, const uint8_t *chroma, size_t begin, size_t count, uint16_t *y, uint16_t *u,
+                    uint16_t *v)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            y[i] = Conversion_expandMsb<Bits>(Conversion_load16(luma + (begin + i) * 2));
+        }
+
+        // every UV pair takes 4 bytes and covers 2 pixels
+        for (size_t i = 0; i < (count + 1) / 2; i ++) {
+            u[i] = Conversion_expandMsb<Bits>(Conversion_load16(chroma + (begin + 2 * i) * 2));
+            v[i] = Conversion_expandMsb<Bits>(Conversion_load16(chroma + (begin + 2 * i) * 2 + 2));
+        }
+    }
+};
+
+/**
+ * Y210 and Y216: YUY2 with 16-bit samples, holding Bits significant bits in the most significant bits.
+ */
+template<int Bits>
+struct Conversion_UnpackY210C {
+    static void row(const uint8_t *source, const uint8_t *, size_t begin, size_t count, uint16_t *y, uint16_t *u,
+                    uint16_t *v)
+    {
+        const uint8_t *macropixel = source + begin / 2 * 8;
+
+        for (size_t i = 0; i < count; i += 2, macropixel += 8) {
+            y[i] = Conversion_expandMsb<Bits>(Conversion_load16(macropixel));
+            u[i / 2] = Conversion_expandMsb<Bits>(Conversion_load16(macropixel + 2));
+            v[i / 2] = Conversion_expandMsb<Bits>(Conversion_load16(macropixel + 6));
+
+            if (i + 1 < count) {
+                y[i + 1] = Conversion_expandMsb<Bits>(Conversion_load16(macropixel + 4));
+            }
+        }
+    }
+};
+
+/**
+ * v210: 6 pixels packed into 4 little-endian 32-bit words of 3 10-bit samples each,
+ * U0 Y0 V0 | Y1 U2 Y2 | V2 Y3 U4 | Y4 V4 Y5. begin has to be a multiple of 6.
+ */
+struct Conversion_UnpackV210C {
+    static void row(const uint8_t *source, const uint8_t *, size_t begin, size_t count, uint16_t *y, uint16_t *u,
+                    uint16_t *v)
+    {
+        const uint8_t *group = source + begin / 6 * 16;
+
+        for (size_t i = 0; i < count; i += 6, group += 16) {
+            uint16_t samples[12];
+
+            for (int word = 0; word < 4; word ++) {
+                const uint32_t packed = Conversion_load32(group + 4 * word);
+                samples[3 * word + 0] = Conversion_expand10(packed);
+                samples[3 * word + 1] = Conversion_expand10(packed >> 10);
+                samples[3 * word + 2] = Conversion_expand10(packed >> 20);
+            }
+
+            static const int LUMA[6] = {1, 3, 5, 7, 9, 11};
+            static const int U[3] = {0, 4, 8};
+            static const int V[3] = {2, 6, 10};
+
+            for (size_t j = 0; j < 6 && i + j < count; j ++) {
+                y[i + j] = samples[LUMA[j]];
+            }
+
+            for (size_t j = 0; j < 3 && i + 2 * j < count; j ++) {
+                u[i / 2 + j] = samples[U[j]];
+                v[i / 2 + j] = samples[V[j]];
+            }
+        }
+    }
+};
+
+/**
+ * Y410: a little-endian 32-bit word per pixel, U in bits 0-9, Y in 10-19, V in 20-29 and alpha in 30-31.
+ */
+struct Conversion_UnpackY410C {
+    static void row(const uint8_t *source, const uint8_t *, size_t begin, size_t count, uint16_t *y, uint16_t *u,
+                    uint16_t *v)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            const uint32_t packed = Conversion_load32(source + (begin + i) * 4);
+            u[i] = Conversion_expand10(packed);
+            y[i] = Conversion_expand10(packed >> 10);
+            v[i] = Conversion_expand10(packed >> 20);
+        }
+    }
+};
+
+/**
+ * Y416: 4 16-bit samples per pixel, in U, Y, V, A order.
+ */
+struct Conversion_UnpackY416C {
+    static void row(const uint8_t *source, const uint8_t *, size_t begin, size_t count, uint16_t *y, uint16_t *u,
+                    uint16_t *v)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            const uint8_t *pixel = source + (begin + i) * 8;
+            u[i] = Conversion_load16(pixel);
+            y[i] = Conversion_load16(pixel + 2);
+            v[i] = Conversion_load16(pixel + 4);
+        }
+    }
+};
+
+struct Conversion_NarrowC {
+    /**
+     * @param thresholds 4 thresholds, used in turn for consecutive samples.
+     */
+    static void row(const uint16_t *source, uint8_t *destination, size_t count, const uint16_t *thresholds)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            destination[i] = Conversion_narrow(source[i], thresholds[i % 4]);
+        }
+    }
+};
+
+inline void Conversion_store16(uint8_t *bytes, uint16_t sample)
+{
+    bytes[0] = static_cast<uint8_t>(sample);
+    bytes[1] = static_cast<uint8_t>(sample >> 8);
+}
+
+/**
+ * Packers of Y, U and V sample rows into the YUV destination formats, chroma given at the destination's resolution.
+ * Semi-planar destinations take their chroma row separately, null on the rows that don't have one.
+ */
+struct Conversion_PackNv12C {
+    static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma, uint8_t *chroma,
+                    size_t begin, size_t count)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            luma[begin + i] = y[i];
+        }
+
+        if (!chroma) {
+            return;
+        }
+
+        for (size_t i = 0; i < (count + 1) / 2; i ++) {
+            chroma[begin + 2 * i] = u[i];
+            chroma[begin + 2 * i + 1] = v[i];
+        }
+    }
+};
+
+struct Conversion_PackYuy2C {
+    static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma, uint8_t *, size_t begin,
+                    size_t count)
+    {
+        uint8_t *macropixel = luma + begin * 2;
+
+        for (size_t i = 0; i < count; i += 2, macropixel += 4) {
+            macropixel[0] = y[i];
+            macropixel[1] = u[i / 2];
+            // an odd width repeats the last luma sample into the padding
+            macropixel[2] = y[i + 1 < count ? i + 1 : i];
+            macropixel[3] = v[i / 2];
+        }
+    }
+};
+
+/**
+ * AYUV is stored as V, U, Y, A bytes.
+ */
+struct Conversion_PackAyuvC {
+    static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma, uint8_t *, size_t begin,
+                    size_t count)
+    {
+        uint8_t *pixel = luma + begin * 4;
+
+        for (size_t i = 0; i < count; i ++, pixel += 4) {
+            pixel[0] = v[i];
+            pixel[1] = u[i];
+            pixel[2] = y[i];
+            pixel[3] = 0xFF;
+        }
+    }
+};
+
+/**
+ * P016 and P216, the layout of NV12 with 16-bit samples.
+ */
+struct Conversion_PackP016C {
+    static void row(const uint16_t *y, const uint16_t *u, const uint16_t *v, uint8_t *luma, uint8_t *chroma,
+                    size_t begin, size_t count)
+    {
+        for (size_t i = 0; i < count; i ++) {
+            Conversion_store16(luma + (begin + i) * 2, y[i]);
+        }
+
+        if (!chroma) {
+            return;
+        }
+
+        for (size_t i = 0; i < (count + 1) / 2; i ++) {
+            Conversion_store16(chroma + (begin + 2 * i) * 2, u[i]);
+            Conversion_store16(chroma + (begin + 2 * i) * 2 + 2, v[i]);
+        }
+    }
+};
+
+/**
+ * Y416 is stored as U, Y, V, A 16-bit samples.
+ */
+struct Conversion_PackY416C {
+    static void row(const uint16_t *y, const uint16_t *u, const uint16_t *v, uint8_t *luma, uint8_t *, size_t begin,
+                    size_t count)
+    {
+        uint8_t *pixel = luma + begin * 8;
+
+        for (size_t i = 0; i < count; i ++, pixel += 8) {
+            Conversion_store16(pixel, u[i]);
+            Conversion_store16(pixel + 2, y[i]);
+            Conversion_store16(pixel + 4, v[i]);
+            Conversion_store16(pixel + 6, 0xFFFF);
+        }
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_HIGH_BIT_DEPTH_H
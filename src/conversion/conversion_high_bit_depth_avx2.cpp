@@ -0,0 +1,98 @@
+#include "conversion_high_bit_depth.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+struct UnpackV210Avx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, const uint8_t *chroma, size_t begin, size_t count,
+            uint16_t *y, uint16_t *u, uint16_t *v)
+    {
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+        // gathers Y0-Y5 and U0 U2 U4 _ V0 V2 V4 _ out of the two vectors of unpacked fields below
+        const __m128i lumaFromLow = _mm_setr_epi8(8, 9, 2, 3, -128, -128, 12, 13, 6, 7, -128, -128, -128, -128, -128, -128);
+        const __m128i lumaFromHigh = _mm_setr_epi8(-128, -128, -128, -128, 2, 3, -128, -128, -128, -128, 6, 7, -128, -128,
+                                     -128, -128);
+        const __m128i chromaFromLow = _mm_setr_epi8(0, 1, 10, 11, -128, -128, -128, -128, -128, -128, 4, 5, 14, 15, -128,
+                                      -128);
+        const __m128i chromaFromHigh = _mm_setr_epi8(-128, -128, -128, -128, 4, 5, -128, -128, 0, 1, -128, -128, -128, -128,
+                                       -128, -128);
+        size_t x = 0;
+
+        // a group of 6 pixels is stored as 8 luma and 4+4 chroma lanes, the lanes past the group's samples get
+        // overwritten by the next group, so the last group is left to the scalar code
+        for (; x + 12 <= count; x += 6) {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + (begin + x) / 6 * 16));
+
+            // first, second and third field of the 4 words: U0 Y1 V2 Y4 | Y0 U2 Y3 V4 | V0 Y2 U4 Y5
+            const __m128i first = _mm_and_si128(words, mask);
+            const __m128i second = _mm_and_si128(_mm_srli_epi32(words, 10), mask);
+            const __m128i third = _mm_and_si128(_mm_srli_epi32(words, 20), mask);
+
+            const __m128i low = _mm_packs_epi32(first, second);
+            const __m128i high = _mm_packs_epi32(third, third);
+
+            __m128i luma = _mm_or_si128(_mm_shuffle_epi8(low, lumaFromLow), _mm_shuffle_epi8(high, lumaFromHigh));
+            __m128i uv = _mm_or_si128(_mm_shuffle_epi8(low, chromaFromLow), _mm_shuffle_epi8(high, chromaFromHigh));
+
+            luma = _mm_or_si128(_mm_slli_epi16(luma, 6), _mm_srli_epi16(luma, 4));
+            uv = _mm_or_si128(_mm_slli_epi16(uv, 6), _mm_srli_epi16(uv, 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y + x), luma);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), uv);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), _mm_srli_si128(uv, 8));
+        }
+
+        Conversion_UnpackV210C::row(source, chroma, begin + x, count - x, y + x, u + x / 2, v + x / 2);
+    }
+};
+
+struct NarrowAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint16_t *source, uint8_t *destination, size_t count,
+            const uint16_t *thresholds)
+    {
+        const __m256i threshold = _mm256_setr_epi16(thresholds[0], thresholds[1], thresholds[2], thresholds[3],
+                                  thresholds[0], thresholds[1], thresholds[2], thresholds[3],
+                                  thresholds[0], thresholds[1], thresholds[2], thresholds[3],
+                                  thresholds[0], thresholds[1], thresholds[2], thresholds[3]);
+        size_t x = 0;
+
+        for (; x + 32 <= count; x += 32) {
+            const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x));
+            const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x + 16));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x),
+                                Conversion_packBytesAvx2(_mm256_srli_epi16(_mm256_adds_epu16(low, threshold), 8),
+                                        _mm256_srli_epi16(_mm256_adds_epu16(high, threshold), 8)));
+        }
+
+        Conversion_NarrowC::row(source + x, destination + x, count - x, thresholds);
+    }
+};
+
+} // namespace
+
+Conversion_UnpackRow Conversion_Kernels::getUnpackRowAvx2(PixelFormat source)
+{
+    if (source == PixelFormat::v210) {
+        return &UnpackV210Avx2::row;
+    }
+
+    // the rest are memory bound, wider registers don't make them any faster
+    return getUnpackRowSse2(source);
+}
+
+Conversion_NarrowRow Conversion_Kernels::getNarrowRowAvx2()
+{
+    return &NarrowAvx2::row;
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
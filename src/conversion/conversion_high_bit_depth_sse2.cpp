@@ -0,0 +1,309 @@
+#include "conversion_high_bit_depth.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Splits the 16 16-bit lanes of a and b into the 8 even and the 8 odd ones.
+ * Sign extending before the signed saturating pack keeps the values intact, SSE2 has no unsigned 32-bit pack.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline void deinterleave16Sse2(__m128i a, __m128i b, __m128i &even, __m128i &odd)
+{
+    even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+    odd = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+}
+
+/**
+ * Vector version of Conversion_expandMsb().
+ */
+template<int Bits>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i expandMsbSse2(__m128i samples)
+{
+    return Bits >= 16 ? samples : _mm_or_si128(samples, _mm_srli_epi16(samples, Bits >= 16 ? 0 : Bits));
+}
+
+/**
+ * Vector version of Conversion_expand10(), for samples already masked to 10 bits.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i expand10Sse2(__m128i samples)
+{
+    return _mm_or_si128(_mm_slli_epi16(samples, 6), _mm_srli_epi16(samples, 4));
+}
+
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i load128(const uint8_t *source)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+}
+
+WEBCAM_CAPTURE_TARGET_SSE2 inline void store128(uint16_t *destination, __m128i samples)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), samples);
+}
+
+template<int Bits>
+struct UnpackSemiPlanarSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *luma, const uint8_t *chroma, size_t begin, size_t count,
+            uint16_t *y, uint16_t *u, uint16_t *v)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= count; x += 16) {
+            const uint8_t *lumaSamples = luma + (begin + x) * 2;
+            const uint8_t *chromaSamples = chroma + (begin + x) * 2;
+
+            store128(y + x, expandMsbSse2<Bits>(load128(lumaSamples)));
+            store128(y + x + 8, expandMsbSse2<Bits>(load128(lumaSamples + 16)));
+
+            __m128i uSamples;
+            __m128i vSamples;
+            deinterleave16Sse2(load128(chromaSamples), load128(chromaSamples + 16), uSamples, vSamples);
+
+            store128(u + x / 2, expandMsbSse2<Bits>(uSamples));
+            store128(v + x / 2, expandMsbSse2<Bits>(vSamples));
+        }
+
+        Conversion_UnpackSemiPlanarC<Bits>::row(luma, chroma, begin + x, count - x, y + x, u + x / 2, v + x / 2);
+    }
+};
+
+template<int Bits>
+struct UnpackY210Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, const uint8_t *chroma, size_t begin, size_t count,
+            uint16_t *y, uint16_t *u, uint16_t *v)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= count; x += 16) {
+            const uint8_t *macropixels = source + (begin + x) * 4;
+            __m128i luma[2];
+            __m128i uv[2];
+
+            // Y0 U Y1 V: luma in the even lanes, interleaved chroma in the odd ones
+            deinterleave16Sse2(load128(macropixels), load128(macropixels + 16), luma[0], uv[0]);
+            deinterleave16Sse2(load128(macropixels + 32), load128(macropixels + 48), luma[1], uv[1]);
+
+            __m128i uSamples;
+            __m128i vSamples;
+            deinterleave16Sse2(uv[0], uv[1], uSamples, vSamples);
+
+            store128(y + x, expandMsbSse2<Bits>(luma[0]));
+            store128(y + x + 8, expandMsbSse2<Bits>(luma[1]));
+            store128(u + x / 2, expandMsbSse2<Bits>(uSamples));
+            store128(v + x / 2, expandMsbSse2<Bits>(vSamples));
+        }
+
+        Conversion_UnpackY210C<Bits>::row(source, chroma, begin + x, count - x, y + x, u + x / 2, v + x / 2);
+    }
+};
+
+struct UnpackY410Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, const uint8_t *chroma, size_t begin, size_t count,
+            uint16_t *y, uint16_t *u, uint16_t *v)
+    {
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+        size_t x = 0;
+
+        for (; x + 8 <= count; x += 8) {
+            const __m128i a = load128(source + (begin + x) * 4);
+            const __m128i b = load128(source + (begin + x) * 4 + 16);
+
+            // the 10-bit fields fit the signed saturating pack as they are
+            store128(u + x, expand10Sse2(_mm_packs_epi32(_mm_and_si128(a, mask), _mm_and_si128(b, mask))));
+            store128(y + x, expand10Sse2(_mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), mask),
+                                         _mm_and_si128(_mm_srli_epi32(b, 10), mask))));
+            store128(v + x, expand10Sse2(_mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), mask),
+                                         _mm_and_si128(_mm_srli_epi32(b, 20), mask))));
+        }
+
+        Conversion_UnpackY410C::row(source, chroma, begin + x, count - x, y + x, u + x, v + x);
+    }
+};
+
+struct UnpackY416Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, const uint8_t *chroma, size_t begin, size_t count,
+            uint16_t *y, uint16_t *u, uint16_t *v)
+    {
+        size_t x = 0;
+
+        for (; x + 8 <= count; x += 8) {
+            const uint8_t *pixels = source + (begin + x) * 8;
+            __m128i uv[2];
+            __m128i ya[2];
+
+            // U Y V A: U and V in the even lanes, Y and A in the odd ones
+            deinterleave16Sse2(load128(pixels), load128(pixels + 16), uv[0], ya[0]);
+            deinterleave16Sse2(load128(pixels + 32), load128(pixels + 48), uv[1], ya[1]);
+
+            __m128i uSamples;
+            __m128i vSamples;
+            __m128i ySamples;
+            __m128i alpha;
+            deinterleave16Sse2(uv[0], uv[1], uSamples, vSamples);
+            deinterleave16Sse2(ya[0], ya[1], ySamples, alpha);
+
+            store128(y + x, ySamples);
+            store128(u + x, uSamples);
+            store128(v + x, vSamples);
+        }
+
+        Conversion_UnpackY416C::row(source, chroma, begin + x, count - x, y + x, u + x, v + x);
+    }
+};
+
+struct NarrowSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint16_t *source, uint8_t *destination, size_t count,
+            const uint16_t *thresholds)
+    {
+        const __m128i threshold = _mm_setr_epi16(thresholds[0], thresholds[1], thresholds[2], thresholds[3],
+                                  thresholds[0], thresholds[1], thresholds[2], thresholds[3]);
+        size_t x = 0;
+
+        for (; x + 16 <= count; x += 16) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x + 8));
+
+            // the saturating add clamps to 0xFFFF, which is what Conversion_narrow() does
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x),
+                             _mm_packus_epi16(_mm_srli_epi16(_mm_adds_epu16(low, threshold), 8),
+                                              _mm_srli_epi16(_mm_adds_epu16(high, threshold), 8)));
+        }
+
+        // x is a multiple of 4, so the thresholds stay in phase
+        Conversion_NarrowC::row(source + x, destination + x, count - x, thresholds);
+    }
+};
+
+struct PackNv12Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma,
+            uint8_t *chroma, size_t begin, size_t count)
+    {
+        size_t x = 0;
+
+        for (; x + 32 <= count; x += 32) {
+            const __m128i uSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x / 2));
+            const __m128i vSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x / 2));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(luma + begin + x),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(luma + begin + x + 16),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x + 16)));
+
+            if (chroma) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(chroma + begin + x), _mm_unpacklo_epi8(uSamples, vSamples));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(chroma + begin + x + 16), _mm_unpackhi_epi8(uSamples, vSamples));
+            }
+        }
+
+        Conversion_PackNv12C::row(y + x, u + x / 2, v + x / 2, luma, chroma, begin + x, count - x);
+    }
+};
+
+struct PackYuy2Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma,
+            uint8_t *chroma, size_t begin, size_t count)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= count; x += 16) {
+            const __m128i ySamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x));
+            const __m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2)),
+                                                 _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2)));
+            uint8_t *macropixels = luma + (begin + x) * 2;
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(macropixels), _mm_unpacklo_epi8(ySamples, uv));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(macropixels + 16), _mm_unpackhi_epi8(ySamples, uv));
+        }
+
+        Conversion_PackYuy2C::row(y + x, u + x / 2, v + x / 2, luma, chroma, begin + x, count - x);
+    }
+};
+
+struct PackAyuvSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma,
+            uint8_t *chroma, size_t begin, size_t count)
+    {
+        const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        size_t x = 0;
+
+        for (; x + 16 <= count; x += 16) {
+            const __m128i ySamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x));
+            const __m128i uSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x));
+            const __m128i vSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x));
+            const __m128i vu[2] = {_mm_unpacklo_epi8(vSamples, uSamples), _mm_unpackhi_epi8(vSamples, uSamples)};
+            const __m128i ya[2] = {_mm_unpacklo_epi8(ySamples, alpha), _mm_unpackhi_epi8(ySamples, alpha)};
+            __m128i *pixels = reinterpret_cast<__m128i *>(luma + (begin + x) * 4);
+
+            for (int half = 0; half < 2; half ++) {
+                _mm_storeu_si128(pixels + 2 * half, _mm_unpacklo_epi16(vu[half], ya[half]));
+                _mm_storeu_si128(pixels + 2 * half + 1, _mm_unpackhi_epi16(vu[half], ya[half]));
+            }
+        }
+
+        Conversion_PackAyuvC::row(y + x, u + x, v + x, luma, chroma, begin + x, count - x);
+    }
+};
+
+} // namespace
+
+Conversion_UnpackRow Conversion_Kernels::getUnpackRowSse2(PixelFormat source)
+{
+    switch (source) {
+        case PixelFormat::P010:
+        case PixelFormat::P210:
+            return &UnpackSemiPlanarSse2<10>::row;
+
+        case PixelFormat::P016:
+        case PixelFormat::P216:
+            return &UnpackSemiPlanarSse2<16>::row;
+
+        case PixelFormat::Y210:
+            return &UnpackY210Sse2<10>::row;
+
+        case PixelFormat::Y216:
+            return &UnpackY210Sse2<16>::row;
+
+        case PixelFormat::Y410:
+            return &UnpackY410Sse2::row;
+
+        case PixelFormat::Y416:
+            return &UnpackY416Sse2::row;
+
+        default:
+            // v210 needs a byte shuffle to gather its samples, which SSE2 doesn't have
+            return getUnpackRowC(source);
+    }
+}
+
+Conversion_NarrowRow Conversion_Kernels::getNarrowRowSse2()
+{
+    return &NarrowSse2::row;
+}
+
+Conversion_PackYuvRow Conversion_Kernels::getPackYuvRowSse2(PixelFormat destination)
+{
+    switch (destination) {
+        case PixelFormat::NV12:
+            return &PackNv12Sse2::row;
+
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            return &PackYuy2Sse2::row;
+
+        case PixelFormat::AYUV:
+            return &PackAyuvSse2::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
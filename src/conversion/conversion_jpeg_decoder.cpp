@@ -0,0 +1,349 @@
+#include "conversion_jpeg_decoder.h"
+
+#include "../utils.h"
+
+#include <vector>
+
+#ifdef WEBCAM_CAPTURE_JPEG
+    // jpeglib.h expects FILE and size_t to be declared before it's included
+    #include <csetjmp>
+    #include <cstdio>
+    #include <jpeglib.h>
+#endif
+
+namespace webcam_capture {
+
+namespace {
+
+size_t getDenominator(DecompressionScale scale)
+{
+    switch (scale) {
+        case DecompressionScale::Half:
+            return 2;
+
+        case DecompressionScale::Quarter:
+            return 4;
+
+        case DecompressionScale::Eighth:
+            return 8;
+
+        default:
+            return 1;
+    }
+}
+
+#ifdef WEBCAM_CAPTURE_JPEG
+
+/**
+ * libjpeg exits the process on errors by default, this jumps back into decode() instead.
+ */
+struct ErrorManager {
+    jpeg_error_mgr manager; // has to be the first member, libjpeg passes a pointer to it around
+    jmp_buf jump;
+};
+
+void exitOnError(j_common_ptr info)
+{
+    char message[JMSG_LENGTH_MAX];
+    info->err->format_message(info, message);
+    DEBUG_PRINT("Error: Couldn't decode a JPEG image: " << message);
+
+    longjmp(reinterpret_cast<ErrorManager *>(info->err)->jump, 1);
+}
+
+// MJPEG streams are full of recoverable "corrupt data" warnings, which aren't worth printing per frame
+void ignoreMessage(j_common_ptr, int)
+{
+}
+
+/**
+ * Takes the Y samples and averages the chroma of pairs of YCbCr pixels of a row into YUY2 macropixels.
+ */
+void packYuy2Row(const uint8_t *pixels, uint8_t *destination, size_t width)
+{
+    for (size_t x = 0; x < width; x += 2, pixels += 6, destination += 4) {
+        // an odd width pairs the last pixel with itself
+        const uint8_t *next = x + 1 < width ? pixels + 3 : pixels;
+
+        destination[0] = pixels[0];
+        destination[1] = static_cast<uint8_t>((pixels[1] + next[1] + 1) / 2);
+        destination[2] = next[0];
+        destination[3] = static_cast<uint8_t>((pixels[2] + next[2] + 1) / 2);
+    }
+}
+
+/**
+ * Takes the Y samples of two rows of YCbCr pixels and averages their chroma in 2x2 blocks.
+ * @param pixels1 Second row, the first one again for the odd last row of a frame.
+ * @param luma1 Luma row of the second row, null for the odd last row.
+ * @param chromaStep 1 for separate U and V rows, 2 for an interleaved UV row.
+ */
+void packPlanarRows(const uint8_t *pixels0, const uint8_t *pixels1, uint8_t *luma0, uint8_t *luma1, uint8_t *u,
+                    uint8_t *v, size_t chromaStep, size_t width)
+{
+    for (size_t x = 0; x < width; x ++) {
+        luma0[x] = pixels0[3 * x];
+
+        if (luma1) {
+            luma1[x] = pixels1[3 * x];
+        }
+    }
+
+    for (size_t x = 0; x < width; x += 2) {
+        const size_t next = x + 1 < width ? x + 1 : x;
+
+        u[x / 2 * chromaStep] = static_cast<uint8_t>((pixels0[3 * x + 1] + pixels0[3 * next + 1] +
+                                pixels1[3 * x + 1] + pixels1[3 * next + 1] + 2) / 4);
+        v[x / 2 * chromaStep] = static_cast<uint8_t>((pixels0[3 * x + 2] + pixels0[3 * next + 2] +
+                                pixels1[3 * x + 2] + pixels1[3 * next + 2] + 2) / 4);
+    }
+}
+
+#ifndef JCS_EXTENSIONS
+
+/**
+ * Reorders R, G, B pixels into one of the RGB destination formats, for libjpeg versions that can't output them.
+ */
+void swizzleRgbRow(const uint8_t *pixels, uint8_t *destination, PixelFormat pixelFormat, size_t width)
+{
+    for (size_t x = 0; x < width; x ++, pixels += 3) {
+        if (pixelFormat == PixelFormat::RGB24) {
+            *destination++ = pixels[2];
+            *destination++ = pixels[1];
+            *destination++ = pixels[0];
+        } else if (pixelFormat == PixelFormat::ARGB32) {
+            *destination++ = 0xFF;
+            *destination++ = pixels[0];
+            *destination++ = pixels[1];
+            *destination++ = pixels[2];
+        } else {
+            *destination++ = pixels[2];
+            *destination++ = pixels[1];
+            *destination++ = pixels[0];
+            *destination++ = 0xFF;
+        }
+    }
+}
+
+#endif
+
+#endif // WEBCAM_CAPTURE_JPEG
+
+} // namespace
+
+#ifdef WEBCAM_CAPTURE_JPEG
+
+struct Conversion_JpegDecoder::State {
+    jpeg_decompress_struct info;
+    ErrorManager errors;
+    std::vector<uint8_t> rows; // rows libjpeg can't decode straight into the destination, grows to the largest frame
+};
+
+#else
+
+struct Conversion_JpegDecoder::State {
+};
+
+#endif
+
+Conversion_JpegDecoder::Conversion_JpegDecoder() :
+    state(new State())
+{
+#ifdef WEBCAM_CAPTURE_JPEG
+    state->info.err = jpeg_std_error(&state->errors.manager);
+    state->errors.manager.error_exit = &exitOnError;
+    state->errors.manager.emit_message = &ignoreMessage;
+
+    if (setjmp(state->errors.jump)) {
+        // out of memory, decode() fails from now on
+        state.reset();
+        return;
+    }
+
+    jpeg_create_decompress(&state->info);
+#endif
+}
+
+Conversion_JpegDecoder::~Conversion_JpegDecoder()
+{
+#ifdef WEBCAM_CAPTURE_JPEG
+    if (state) {
+        jpeg_destroy_decompress(&state->info);
+    }
+#endif
+}
+
+bool Conversion_JpegDecoder::isSupportedSource(PixelFormat pixelFormat)
+{
+#ifdef WEBCAM_CAPTURE_JPEG
+    return pixelFormat == PixelFormat::MJPG || pixelFormat == PixelFormat::jpeg || pixelFormat == PixelFormat::dmb1;
+#else
+    (void) pixelFormat;
+    return false;
+#endif
+}
+
+bool Conversion_JpegDecoder::isSupportedDestination(PixelFormat pixelFormat)
+{
+    switch (pixelFormat) {
+        case PixelFormat::RGB24:
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+        case PixelFormat::ARGB32:
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::NV12:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+size_t Conversion_JpegDecoder::getScaledSize(size_t size, DecompressionScale scale)
+{
+    // the same rounding libjpeg does
+    const size_t denominator = getDenominator(scale);
+
+    return (size + denominator - 1) / denominator;
+}
+
+bool Conversion_JpegDecoder::getScale(size_t width, size_t height, size_t scaledWidth, size_t scaledHeight,
+                                      DecompressionScale &scale)
+{
+    const DecompressionScale reducedScales[] = {
+        DecompressionScale::Half, DecompressionScale::Quarter, DecompressionScale::Eighth
+    };
+
+    for (DecompressionScale reduced : reducedScales) {
+        if (getScaledSize(width, reduced) == scaledWidth && getScaledSize(height, reduced) == scaledHeight) {
+            scale = reduced;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Conversion_JpegDecoder::decode(const uint8_t *data, size_t bytes, const Frame &destination,
+                                    DecompressionScale scale)
+{
+#ifdef WEBCAM_CAPTURE_JPEG
+    if (!state || !data || !bytes || !destination.plane[0] || !isSupportedDestination(destination.pixelFormat)) {
+        return false;
+    }
+
+    jpeg_decompress_struct &info = state->info;
+
+    if (setjmp(state->errors.jump)) {
+        jpeg_abort_decompress(&info);
+        return false;
+    }
+
+    // older libjpeg versions take a non-const pointer, though they don't write through it either
+    jpeg_mem_src(&info, const_cast<unsigned char *>(data), static_cast<unsigned long>(bytes));
+
+    // MJPEG frames usually omit the Huffman tables, libjpeg-turbo falls back to the standard ones then
+    if (jpeg_read_header(&info, TRUE) != JPEG_HEADER_OK) {
+        jpeg_abort_decompress(&info);
+        return false;
+    }
+
+    const PixelFormat pixelFormat = destination.pixelFormat;
+    const bool rgb = pixelFormat == PixelFormat::RGB24 || pixelFormat == PixelFormat::RGB32 ||
+                     pixelFormat == PixelFormat::BGRA32 || pixelFormat == PixelFormat::ARGB32;
+
+    info.scale_num = 1;
+    info.scale_denom = static_cast<unsigned int>(getDenominator(scale));
+    info.dct_method = JDCT_ISLOW;
+
+    if (rgb) {
+#ifdef JCS_EXTENSIONS
+        info.out_color_space = pixelFormat == PixelFormat::RGB24 ? JCS_EXT_BGR :
+                               pixelFormat == PixelFormat::ARGB32 ? JCS_EXT_ARGB : JCS_EXT_BGRA;
+#else
+        info.out_color_space = JCS_RGB;
+#endif
+    } else {
+        // the chroma gets averaged down again, so there is no point in interpolating it
+        info.out_color_space = JCS_YCbCr;
+        info.do_fancy_upsampling = FALSE;
+    }
+
+    jpeg_calc_output_dimensions(&info);
+
+    const size_t width = info.output_width;
+    const size_t height = info.output_height;
+
+    if (width != destination.width[0] || height != destination.height[0]) {
+        DEBUG_PRINT("Error: JPEG image is " << width << "x" << height << " at this scale, the destination is " <<
+                    destination.width[0] << "x" << destination.height[0] << ".");
+        jpeg_abort_decompress(&info);
+        return false;
+    }
+
+    if (state->rows.size() < 2 * width * 3) {
+        state->rows.resize(2 * width * 3);
+    }
+
+    jpeg_start_decompress(&info);
+
+    JSAMPROW scratch[2] = {&state->rows[0], &state->rows[width * 3]};
+
+    if (rgb) {
+        while (info.output_scanline < height) {
+            uint8_t *row = destination.plane[0] + info.output_scanline * destination.stride[0];
+#ifdef JCS_EXTENSIONS
+            jpeg_read_scanlines(&info, &row, 1);
+#else
+            jpeg_read_scanlines(&info, scratch, 1);
+            swizzleRgbRow(scratch[0], row, pixelFormat, width);
+#endif
+        }
+    } else if (pixelFormat == PixelFormat::YUY2 || pixelFormat == PixelFormat::YUYV) {
+        while (info.output_scanline < height) {
+            uint8_t *row = destination.plane[0] + info.output_scanline * destination.stride[0];
+            jpeg_read_scanlines(&info, scratch, 1);
+            packYuy2Row(scratch[0], row, width);
+        }
+    } else {
+        // I420, IYUV or NV12, two rows at a time
+        const bool nv12 = pixelFormat == PixelFormat::NV12;
+        uint8_t *u = destination.plane[1] ? destination.plane[1] : destination.plane[0] + destination.offset[1];
+        uint8_t *v = nv12 ? u + 1 : destination.plane[2] ? destination.plane[2] : destination.plane[0] +
+                     destination.offset[2];
+
+        while (info.output_scanline < height) {
+            const size_t y = info.output_scanline;
+            const bool pair = y + 1 < height;
+            uint8_t *luma0 = destination.plane[0] + y * destination.stride[0];
+
+            jpeg_read_scanlines(&info, &scratch[0], 1);
+
+            if (pair) {
+                jpeg_read_scanlines(&info, &scratch[1], 1);
+            }
+
+            packPlanarRows(scratch[0], pair ? scratch[1] : scratch[0], luma0, pair ? luma0 + destination.stride[0] : nullptr,
+                           u + y / 2 * destination.stride[1], v + y / 2 * destination.stride[nv12 ? 1 : 2],
+                           nv12 ? 2 : 1, width);
+        }
+    }
+
+    jpeg_finish_decompress(&info);
+
+    return true;
+#else
+    (void) data;
+    (void) bytes;
+    (void) destination;
+    (void) scale;
+
+    DEBUG_PRINT("Error: The library was built without a JPEG library.");
+    return false;
+#endif
+}
+
+} // namespace webcam_capture
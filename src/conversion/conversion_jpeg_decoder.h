@@ -0,0 +1,70 @@
+#ifndef CONVERSION_JPEG_DECODER_H
+#define CONVERSION_JPEG_DECODER_H
+
+#include <decompression_scale.h>
+#include <frame.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace webcam_capture {
+
+/**
+ * Decodes JPEG images, e.g. MJPEG frames, with libjpeg-turbo or another libjpeg implementation.
+ * Keeps the libjpeg state and its scratch memory between images, so decoding a stream doesn't allocate per frame.
+ * Available only if the library was built with WEBCAM_CAPTURE_JPEG, decoding fails otherwise.
+ */
+class Conversion_JpegDecoder
+{
+public:
+    Conversion_JpegDecoder();
+    ~Conversion_JpegDecoder();
+
+    Conversion_JpegDecoder(const Conversion_JpegDecoder &) = delete;
+    Conversion_JpegDecoder &operator=(const Conversion_JpegDecoder &) = delete;
+
+    /**
+     * @return true if pixelFormat holds JPEG images and the library was built with a JPEG library.
+     */
+    static bool isSupportedSource(PixelFormat pixelFormat);
+
+    /**
+     * @return true if images can be decoded into pixelFormat: RGB24, RGB32, BGRA32, ARGB32, YUY2, YUYV, I420, IYUV
+     * or NV12.
+     */
+    static bool isSupportedDestination(PixelFormat pixelFormat);
+
+    /**
+     * @return The size a side of size pixels is decoded at.
+     */
+    static size_t getScaledSize(size_t size, DecompressionScale scale);
+
+    /**
+     * Finds the scale images of a size get decoded at another size with, for resizes that are one.
+     * @param scale Receives the scale.
+     * @return true if one of the reduced scales decodes images of width x height at scaledWidth x scaledHeight.
+     */
+    static bool getScale(size_t width, size_t height, size_t scaledWidth, size_t scaledHeight,
+                         DecompressionScale &scale);
+
+    /**
+     * Decodes an image into destination, which has to have its layout filled in.
+     * Destination planes other than the first one that aren't set are taken to be at destination's offsets.
+     * YUV destinations get BT.601 full range values, the ones JPEG uses, with the chroma averaged down.
+     * @param data First byte of the JPEG image.
+     * @param bytes Size of the JPEG image.
+     * @param destination Frame receiving the decoded image.
+     * @param scale Scale to decode at.
+     * @return true on success, false if the data is not a JPEG image or its scaled size isn't destination's size.
+     */
+    bool decode(const uint8_t *data, size_t bytes, const Frame &destination, DecompressionScale scale);
+
+private:
+    struct State;
+    std::unique_ptr<State> state;
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_JPEG_DECODER_H
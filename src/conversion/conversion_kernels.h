@@ -0,0 +1,572 @@
+#ifndef CONVERSION_KERNELS_H
+#define CONVERSION_KERNELS_H
+
+#include "conversion_colorimetry.h"
+#include "conversion_layouts.h"
+
+#include <pixel_format.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Converts one row of packed 4:2:2 pixels into packed RGB pixels.
+ * @param source First macropixel of the row.
+ * @param destination First pixel of the row.
+ * @param width Number of pixels in the row. May be odd, in which case the last macropixel is read only half.
+ */
+typedef void (*Conversion_PackedYuvToRgbRow)(const uint8_t *source, uint8_t *destination, size_t width);
+
+/**
+ * Converts two rows of 4:2:0 pixels that share one row of chroma samples into packed RGB pixels.
+ * Reading the chroma row once for both luma rows halves the chroma memory traffic.
+ * @param luma0 First luma sample of the upper row.
+ * @param luma1 First luma sample of the lower row. Ignored if destination1 is null.
+ * @param u First U sample of the chroma row. For semi-planar formats the first sample of the interleaved UV row.
+ * @param v First V sample of the chroma row. For semi-planar formats u + 1.
+ * @param destination0 First pixel of the upper destination row.
+ * @param destination1 First pixel of the lower destination row, null when the frame has an odd row left over.
+ * @param width Number of pixels in a row.
+ */
+typedef void (*Conversion_PlanarYuvToRgbRows)(const uint8_t *luma0, const uint8_t *luma1, const uint8_t *u,
+        const uint8_t *v, uint8_t *destination0, uint8_t *destination1, size_t width);
+
+/**
+ * Converts one row of 4:4:4 pixels, given as separate rows of Y, U and V samples, into packed RGB pixels.
+ * Used for rows that had their samples computed on the fly, e.g. when scaling while converting.
+ */
+typedef void (*Conversion_Yuv444ToRgbRow)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *destination,
+        size_t width);
+
+/**
+ * Unpacks part of a row of a high bit depth YUV frame into 16-bit Y, U and V samples, see conversion_high_bit_depth.h.
+ * @param luma First byte of the row, for packed formats the only plane.
+ * @param chroma First byte of the chroma row of semi-planar formats, ignored by the packed ones.
+ * @param begin First pixel to unpack. A multiple of 6, so that v210 groups aren't split.
+ * @param count Number of pixels to unpack.
+ * @param y Receives count luma samples.
+ * @param u Receives the U samples of the pixels, (count + 1) / 2 of them for 4:2:x formats, count for 4:4:4 ones.
+ * @param v Receives the V samples, as many as u.
+ */
+typedef void (*Conversion_UnpackRow)(const uint8_t *luma, const uint8_t *chroma, size_t begin, size_t count,
+                                     uint16_t *y, uint16_t *u, uint16_t *v);
+
+/**
+ * Narrows 16-bit samples to 8 bits.
+ * @param thresholds 4 values added in turn to consecutive samples before dropping their low byte. 128 in all four
+ * rounds, a row of an ordered dither matrix dithers.
+ */
+typedef void (*Conversion_NarrowRow)(const uint16_t *source, uint8_t *destination, size_t count,
+                                     const uint16_t *thresholds);
+
+/**
+ * Packs 8-bit Y, U and V samples of part of a row into a YUV destination row.
+ * @param luma First byte of the destination row.
+ * @param chroma First byte of the chroma row of semi-planar destinations, null if the row has no chroma to write.
+ * @param begin First pixel of the destination row to write.
+ */
+typedef void (*Conversion_PackYuvRow)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *luma,
+                                      uint8_t *chroma, size_t begin, size_t count);
+
+/**
+ * Same as Conversion_PackYuvRow, for 16-bit samples.
+ */
+typedef void (*Conversion_PackYuv16Row)(const uint16_t *y, const uint16_t *u, const uint16_t *v, uint8_t *luma,
+                                        uint8_t *chroma, size_t begin, size_t count);
+
+/**
+ * Copies the luma samples of one row of a packed YUV frame into a row of 8-bit gray pixels.
+ * @param source First pixel of the row.
+ * @param destination First gray pixel of the row.
+ * @param width Number of pixels in the row.
+ */
+typedef void (*Conversion_LumaRow)(const uint8_t *source, uint8_t *destination, size_t width);
+
+/**
+ * Repacks one row of RGB pixels into another RGB format.
+ */
+typedef void (*Conversion_RgbRow)(const uint8_t *source, uint8_t *destination, size_t width);
+
+/**
+ * Demosaics one row of an 8-bit Bayer frame into packed RGB pixels, see conversion_bayer.h.
+ * @param rows First samples of the two rows above the row, the row itself and the two rows below it. Each has to be
+ * readable from 2 samples before its first one up to 2 samples past its last one.
+ * @param destination First pixel of the row.
+ * @param width Number of pixels in the row.
+ * @param redRow true if the row holds red samples between its green ones, false if it holds blue ones.
+ * @param greenFirst true if the first sample of the row is a green one.
+ */
+typedef void (*Conversion_DemosaicRow)(const uint8_t *const *rows, uint8_t *destination, size_t width, bool redRow,
+                                       bool greenFirst);
+
+/**
+ * Converts two rows of RGB pixels into two rows of luma samples and the row of 4:2:0 chroma samples they share, see
+ * conversion_rgb_to_yuv.h.
+ * @param source0 First pixel of the upper row.
+ * @param source1 First pixel of the lower row, null when the frame has an odd row left over.
+ * @param luma0 First luma sample of the upper row.
+ * @param luma1 First luma sample of the lower row, null along with source1.
+ * @param u First U sample of the chroma row. For semi-planar formats the first sample of the interleaved UV row.
+ * @param v First V sample of the chroma row. For semi-planar formats u + 1.
+ * @param width Number of pixels in a row.
+ */
+typedef void (*Conversion_RgbToPlanarYuvRows)(const uint8_t *source0, const uint8_t *source1, uint8_t *luma0,
+        uint8_t *luma1, uint8_t *u, uint8_t *v, size_t width);
+
+/**
+ * Converts one row of RGB pixels into packed 4:2:2 pixels.
+ * @param width Number of pixels in the row. May be odd, in which case the last macropixel gets the last pixel twice.
+ */
+typedef void (*Conversion_RgbToPackedYuvRow)(const uint8_t *source, uint8_t *destination, size_t width);
+
+/**
+ * Picks the fastest row kernels the running CPU supports.
+ */
+class Conversion_Kernels
+{
+public:
+    Conversion_Kernels() = delete;
+
+    /**
+     * Kernels are specialized for every color space and range, Unknown ones are taken as BT.601 and limited range.
+     * @return Row kernel converting source to destination, null if the pair of formats is not supported.
+     */
+    static Conversion_PackedYuvToRgbRow getPackedYuvToRgbRow(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    /**
+     * The kernel doesn't know about the order of chroma planes, the caller passes the U and V planes accordingly.
+     * @return Row pair kernel converting 4:2:0 source to destination, null if the pair of formats is not supported.
+     */
+    static Conversion_PlanarYuvToRgbRows getPlanarYuvToRgbRows(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    /**
+     * @return Row kernel converting 4:4:4 samples to destination, null if destination is not supported.
+     */
+    static Conversion_Yuv444ToRgbRow getYuv444ToRgbRow(PixelFormat destination, ColorSpace colorSpace,
+            ColorRange colorRange);
+
+    /**
+     * @return Unpacker of P010, P016, P210, P216, v210, Y210, Y216, Y410 or Y416 rows, null for other formats.
+     */
+    static Conversion_UnpackRow getUnpackRow(PixelFormat source);
+
+    static Conversion_NarrowRow getNarrowRow();
+
+    /**
+     * @return Packer of NV12, YUY2 or AYUV rows, null for other formats.
+     */
+    static Conversion_PackYuvRow getPackYuvRow(PixelFormat destination);
+
+    /**
+     * 16-bit packing is plain data movement the compiler vectorizes well enough, so there are no SIMD versions.
+     * @return Packer of P016, P216 or Y416 rows, null for other formats.
+     */
+    static Conversion_PackYuv16Row getPackYuv16Row(PixelFormat destination);
+
+    /**
+     * Planar formats keep their luma in a plane of its own, which needs no kernel to be copied.
+     * @return Luma extractor of YUY2, YUYV, UYVY, YVYU or AYUV rows, null for other formats.
+     */
+    static Conversion_LumaRow getLumaRow(PixelFormat source);
+
+    /**
+     * Repacking RGB is plain data movement, identical formats are copied with memcpy(), so there are no SIMD versions.
+     * 16-bit sources are handed to getExpandRgb16Row().
+     * @return Row kernel converting between RGB24, RGB32, BGRA32 and ARGB32, or from a 16-bit RGB format into one
+     * of them, null for other formats.
+     */
+    static Conversion_RgbRow getRgbRow(PixelFormat source, PixelFormat destination);
+
+    /**
+     * @return Row kernel expanding RGB555, RGB565, ARGB1555, ARGB4444, their little and big-endian variants and
+     * their Direct3D render target variants into RGB24, RGB32, BGRA32 or ARGB32, null for other formats.
+     */
+    static Conversion_RgbRow getExpandRgb16Row(PixelFormat source, PixelFormat destination);
+
+    /**
+     * @param edgeAware true for the edge-aware kernel, false for the bilinear one.
+     * @return Row kernel demosaicing into destination, null if destination is not an RGB format.
+     */
+    static Conversion_DemosaicRow getDemosaicRow(PixelFormat destination, bool edgeAware);
+
+    /**
+     * Kernels are specialized for every color space and range of the destination, Unknown ones are taken as BT.601
+     * and limited range.
+     * @return Row pair kernel converting RGB24, RGB32, BGRA32 or ARGB32 to NV12, I420 or IYUV, null for other formats.
+     */
+    static Conversion_RgbToPlanarYuvRows getRgbToPlanarYuvRows(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    /**
+     * @return Row kernel converting RGB24, RGB32, BGRA32 or ARGB32 to YUY2 or YUYV, null for other formats.
+     */
+    static Conversion_RgbToPackedYuvRow getRgbToPackedYuvRow(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+private:
+    static Conversion_PackedYuvToRgbRow getPackedYuvToRgbRowC(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_PackedYuvToRgbRow getPackedYuvToRgbRowSse2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_PackedYuvToRgbRow getPackedYuvToRgbRowAvx2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    static Conversion_PlanarYuvToRgbRows getPlanarYuvToRgbRowsC(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_PlanarYuvToRgbRows getPlanarYuvToRgbRowsSse2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_PlanarYuvToRgbRows getPlanarYuvToRgbRowsAvx2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    static Conversion_Yuv444ToRgbRow getYuv444ToRgbRowC(PixelFormat destination, ColorSpace colorSpace,
+            ColorRange colorRange);
+    static Conversion_Yuv444ToRgbRow getYuv444ToRgbRowSse2(PixelFormat destination, ColorSpace colorSpace,
+            ColorRange colorRange);
+    static Conversion_Yuv444ToRgbRow getYuv444ToRgbRowAvx2(PixelFormat destination, ColorSpace colorSpace,
+            ColorRange colorRange);
+
+    static Conversion_UnpackRow getUnpackRowC(PixelFormat source);
+    static Conversion_UnpackRow getUnpackRowSse2(PixelFormat source);
+    static Conversion_UnpackRow getUnpackRowAvx2(PixelFormat source);
+
+    static Conversion_NarrowRow getNarrowRowC();
+    static Conversion_NarrowRow getNarrowRowSse2();
+    static Conversion_NarrowRow getNarrowRowAvx2();
+
+    static Conversion_PackYuvRow getPackYuvRowC(PixelFormat destination);
+    static Conversion_PackYuvRow getPackYuvRowSse2(PixelFormat destination);
+
+    static Conversion_LumaRow getLumaRowC(PixelFormat source);
+    static Conversion_LumaRow getLumaRowSse2(PixelFormat source);
+    static Conversion_LumaRow getLumaRowAvx2(PixelFormat source);
+
+    static Conversion_RgbRow getExpandRgb16RowC(PixelFormat source, PixelFormat destination);
+    static Conversion_RgbRow getExpandRgb16RowSse2(PixelFormat source, PixelFormat destination);
+    static Conversion_RgbRow getExpandRgb16RowAvx2(PixelFormat source, PixelFormat destination);
+
+    static Conversion_DemosaicRow getDemosaicRowC(PixelFormat destination, bool edgeAware);
+    static Conversion_DemosaicRow getDemosaicRowSse2(PixelFormat destination, bool edgeAware);
+    static Conversion_DemosaicRow getDemosaicRowAvx2(PixelFormat destination, bool edgeAware);
+
+    static Conversion_RgbToPlanarYuvRows getRgbToPlanarYuvRowsC(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_RgbToPlanarYuvRows getRgbToPlanarYuvRowsSse2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_RgbToPlanarYuvRows getRgbToPlanarYuvRowsAvx2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+
+    static Conversion_RgbToPackedYuvRow getRgbToPackedYuvRowC(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_RgbToPackedYuvRow getRgbToPackedYuvRowSse2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+    static Conversion_RgbToPackedYuvRow getRgbToPackedYuvRowAvx2(PixelFormat source, PixelFormat destination,
+            ColorSpace colorSpace, ColorRange colorRange);
+};
+
+/**
+ * Maps a color space and range onto an instantiation of Kernel<Source, Destination, Coefficients>::row.
+ */
+template<template<class, class, class> class Kernel, class Source, class Destination, typename Row>
+Row Conversion_selectCoefficients(ColorSpace colorSpace, ColorRange colorRange)
+{
+    const bool full = colorRange == ColorRange::Full;
+
+    switch (colorSpace) {
+        case ColorSpace::BT709:
+            return full ? &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT709, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT709, ColorRange::Limited> >::row;
+
+        case ColorSpace::BT2020:
+            return full ? &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT2020, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT2020, ColorRange::Limited> >::row;
+
+        default:
+            return full ? &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT601, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_Coefficients<ColorSpace::BT601, ColorRange::Limited> >::row;
+    }
+}
+
+/**
+ * Maps a destination pixel format, color space and range onto an instantiation of Kernel.
+ * Every instruction set file instantiates its own kernels through this, so they all support the same formats.
+ */
+template<template<class, class, class> class Kernel, class Source, typename Row>
+Row Conversion_selectRgbDestination(PixelFormat destination, ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (destination) {
+        case PixelFormat::RGB24:
+            return Conversion_selectCoefficients<Kernel, Source, Conversion_Rgb24Layout, Row>(colorSpace, colorRange);
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+            return Conversion_selectCoefficients<Kernel, Source, Conversion_Bgra32Layout, Row>(colorSpace, colorRange);
+
+        case PixelFormat::ARGB32:
+            return Conversion_selectCoefficients<Kernel, Source, Conversion_Argb32Layout, Row>(colorSpace, colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+template<template<class, class, class> class Kernel>
+Conversion_PackedYuvToRgbRow Conversion_selectPackedYuvToRgbRow(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (source) {
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            return Conversion_selectRgbDestination<Kernel, Conversion_Yuy2Layout, Conversion_PackedYuvToRgbRow>(destination,
+                    colorSpace, colorRange);
+
+        case PixelFormat::UYVY:
+            return Conversion_selectRgbDestination<Kernel, Conversion_UyvyLayout, Conversion_PackedYuvToRgbRow>(destination,
+                    colorSpace, colorRange);
+
+        case PixelFormat::YVYU:
+            return Conversion_selectRgbDestination<Kernel, Conversion_YvyuLayout, Conversion_PackedYuvToRgbRow>(destination,
+                    colorSpace, colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+template<template<class, class, class> class Kernel>
+Conversion_PlanarYuvToRgbRows Conversion_selectPlanarYuvToRgbRows(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (source) {
+        case PixelFormat::NV12:
+            return Conversion_selectRgbDestination<Kernel, Conversion_SemiPlanarChroma, Conversion_PlanarYuvToRgbRows>(
+                       destination, colorSpace, colorRange);
+
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::YV12:
+        case PixelFormat::IMC1:
+        case PixelFormat::IMC2:
+        case PixelFormat::IMC3:
+        case PixelFormat::IMC4:
+            return Conversion_selectRgbDestination<Kernel, Conversion_PlanarChroma, Conversion_PlanarYuvToRgbRows>(
+                       destination, colorSpace, colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * 4:4:4 kernels are parametrized like the 4:2:0 ones, with the chroma step of separate planes.
+ */
+template<template<class, class, class> class Kernel>
+Conversion_Yuv444ToRgbRow Conversion_selectYuv444ToRgbRow(PixelFormat destination, ColorSpace colorSpace,
+        ColorRange colorRange)
+{
+    return Conversion_selectRgbDestination<Kernel, Conversion_PlanarChroma, Conversion_Yuv444ToRgbRow>(destination,
+            colorSpace, colorRange);
+}
+
+/**
+ * Maps a packed YUV format onto an instantiation of Kernel<Offset, Step>, see Conversion_ExtractLumaC.
+ */
+template<template<int, int> class Kernel>
+Conversion_LumaRow Conversion_selectLumaRow(PixelFormat source)
+{
+    switch (source) {
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            return &Kernel<Conversion_Yuy2Layout::Y0, 2>::row;
+
+        case PixelFormat::UYVY:
+            return &Kernel<Conversion_UyvyLayout::Y0, 2>::row;
+
+        case PixelFormat::YVYU:
+            return &Kernel<Conversion_YvyuLayout::Y0, 2>::row;
+
+        case PixelFormat::AYUV:
+            return &Kernel<Conversion_AyuvLayout::Y, 4>::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+template<template<class, class> class Kernel, class Source>
+Conversion_RgbRow Conversion_selectExpandRgb16Destination(PixelFormat destination)
+{
+    switch (destination) {
+        case PixelFormat::RGB24:
+            return &Kernel<Source, Conversion_Rgb24Layout>::row;
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+            return &Kernel<Source, Conversion_Bgra32Layout>::row;
+
+        case PixelFormat::ARGB32:
+            return &Kernel<Source, Conversion_Argb32Layout>::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Maps a 16-bit RGB format and an RGB destination format onto an instantiation of Kernel<Source, Destination>, see
+ * Conversion_ExpandRgb16C.
+ */
+template<template<class, class> class Kernel>
+Conversion_RgbRow Conversion_selectExpandRgb16Row(PixelFormat source, PixelFormat destination)
+{
+    switch (source) {
+        case PixelFormat::RGB555:
+        case PixelFormat::LE16_555:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Rgb555Layout>(destination);
+
+        case PixelFormat::BE16_555:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Rgb555BeLayout>(destination);
+
+        // Direct3D's 16-bit render targets are D3DFMT_R5G6B5
+        case PixelFormat::RGB565:
+        case PixelFormat::LE16_565:
+        case PixelFormat::RGB16_D3D_DX7_RT:
+        case PixelFormat::RGB16_D3D_DX9_RT:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Rgb565Layout>(destination);
+
+        case PixelFormat::BE16_565:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Rgb565BeLayout>(destination);
+
+        case PixelFormat::ARGB1555:
+        case PixelFormat::ARGB1555_D3D_DX7_RT:
+        case PixelFormat::ARGB1555_D3D_DX9_RT:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Argb1555Layout>(destination);
+
+        case PixelFormat::ARGB4444:
+        case PixelFormat::ARGB4444_D3D_DX7_RT:
+        case PixelFormat::ARGB4444_D3D_DX9_RT:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Argb4444Layout>(destination);
+
+        case PixelFormat::LE16_5551:
+            return Conversion_selectExpandRgb16Destination<Kernel, Conversion_Rgba5551Layout>(destination);
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Maps an RGB destination format onto an instantiation of the bilinear or the edge-aware demosaicing kernel.
+ */
+template<template<class> class Bilinear, template<class> class EdgeAware>
+Conversion_DemosaicRow Conversion_selectDemosaicRow(PixelFormat destination, bool edgeAware)
+{
+    switch (destination) {
+        case PixelFormat::RGB24:
+            return edgeAware ? &EdgeAware<Conversion_Rgb24Layout>::row : &Bilinear<Conversion_Rgb24Layout>::row;
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+            return edgeAware ? &EdgeAware<Conversion_Bgra32Layout>::row : &Bilinear<Conversion_Bgra32Layout>::row;
+
+        case PixelFormat::ARGB32:
+            return edgeAware ? &EdgeAware<Conversion_Argb32Layout>::row : &Bilinear<Conversion_Argb32Layout>::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Maps a color space and range onto an instantiation of Kernel<Source, Destination, Coefficients>::row, with RGB to
+ * YUV coefficients.
+ */
+template<template<class, class, class> class Kernel, class Source, class Destination, typename Row>
+Row Conversion_selectRgbToYuvCoefficients(ColorSpace colorSpace, ColorRange colorRange)
+{
+    const bool full = colorRange == ColorRange::Full;
+
+    switch (colorSpace) {
+        case ColorSpace::BT709:
+            return full ?
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT709, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT709, ColorRange::Limited> >::row;
+
+        case ColorSpace::BT2020:
+            return full ?
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT2020, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT2020, ColorRange::Limited> >::row;
+
+        default:
+            return full ?
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT601, ColorRange::Full> >::row :
+                   &Kernel<Source, Destination, Conversion_RgbToYuvCoefficients<ColorSpace::BT601, ColorRange::Limited> >::row;
+    }
+}
+
+/**
+ * Maps an RGB source pixel format, color space and range onto an instantiation of Kernel.
+ */
+template<template<class, class, class> class Kernel, class Destination, typename Row>
+Row Conversion_selectRgbSource(PixelFormat source, ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (source) {
+        case PixelFormat::RGB24:
+            return Conversion_selectRgbToYuvCoefficients<Kernel, Conversion_Rgb24Layout, Destination, Row>(colorSpace,
+                    colorRange);
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+            // alpha is ignored, so RGB32 can share the BGRA32 kernels
+            return Conversion_selectRgbToYuvCoefficients<Kernel, Conversion_Bgra32Layout, Destination, Row>(colorSpace,
+                    colorRange);
+
+        case PixelFormat::ARGB32:
+            return Conversion_selectRgbToYuvCoefficients<Kernel, Conversion_Argb32Layout, Destination, Row>(colorSpace,
+                    colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+template<template<class, class, class> class Kernel>
+Conversion_RgbToPlanarYuvRows Conversion_selectRgbToPlanarYuvRows(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (destination) {
+        case PixelFormat::NV12:
+            return Conversion_selectRgbSource<Kernel, Conversion_SemiPlanarChroma, Conversion_RgbToPlanarYuvRows>(
+                       source, colorSpace, colorRange);
+
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+            return Conversion_selectRgbSource<Kernel, Conversion_PlanarChroma, Conversion_RgbToPlanarYuvRows>(
+                       source, colorSpace, colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+template<template<class, class, class> class Kernel>
+Conversion_RgbToPackedYuvRow Conversion_selectRgbToPackedYuvRow(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    switch (destination) {
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            return Conversion_selectRgbSource<Kernel, Conversion_Yuy2Layout, Conversion_RgbToPackedYuvRow>(source,
+                    colorSpace, colorRange);
+
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_KERNELS_H
@@ -0,0 +1,122 @@
+#ifndef CONVERSION_LAYOUTS_H
+#define CONVERSION_LAYOUTS_H
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Byte positions of the samples within a packed 4:2:2 macropixel, i.e. 2 pixels sharing a U and V sample.
+ */
+struct Conversion_Yuy2Layout {
+    enum { Y0 = 0, U = 1, Y1 = 2, V = 3 };
+};
+
+struct Conversion_UyvyLayout {
+    enum { Y0 = 1, U = 0, Y1 = 3, V = 2 };
+};
+
+struct Conversion_YvyuLayout {
+    enum { Y0 = 0, U = 3, Y1 = 2, V = 1 };
+};
+
+/**
+ * Byte positions of the samples within a packed 4:4:4 pixel.
+ */
+struct Conversion_AyuvLayout {
+    enum { V = 0, U = 1, Y = 2, A = 3 };
+};
+
+/**
+ * Distance between two consecutive U (or V) samples of a 4:2:0 chroma row.
+ * Planar formats keep U and V in separate planes, semi-planar ones interleave them in a single plane.
+ */
+struct Conversion_PlanarChroma {
+    enum { STEP = 1 };
+};
+
+struct Conversion_SemiPlanarChroma {
+    enum { STEP = 2 };
+};
+
+/**
+ * Byte positions of the channels within a packed RGB pixel, as they are laid out in memory.
+ * A is -1 for formats without an alpha channel. Formats with an unused fourth byte have it set to 0xFF.
+ * RGB24 and RGB32 follow the Windows DIB convention of storing blue first.
+ */
+struct Conversion_Rgb24Layout {
+    enum { BYTES = 3, R = 2, G = 1, B = 0, A = -1 };
+};
+
+/**
+ * RGB32 read as a source, its fourth byte isn't alpha and may hold anything.
+ */
+struct Conversion_Rgb32Layout {
+    enum { BYTES = 4, R = 2, G = 1, B = 0, A = -1 };
+};
+
+struct Conversion_Bgra32Layout {
+    enum { BYTES = 4, R = 2, G = 1, B = 0, A = 3 };
+};
+
+struct Conversion_Argb32Layout {
+    enum { BYTES = 4, R = 1, G = 2, B = 3, A = 0 };
+};
+
+/**
+ * Bit fields of the channels within a 16-bit packed RGB pixel. The pixel is a little-endian word unless
+ * BIG_ENDIAN_PIXEL is set, and each channel takes the BITS bits starting at its SHIFT. Formats without alpha have
+ * A_BITS set to 0.
+ */
+template<bool BigEndian, int RShift, int RBits, int GShift, int GBits, int BShift, int BBits, int AShift, int ABits>
+struct Conversion_Rgb16Layout {
+    enum {
+        BIG_ENDIAN_PIXEL = BigEndian,
+        R_SHIFT = RShift, R_BITS = RBits,
+        G_SHIFT = GShift, G_BITS = GBits,
+        B_SHIFT = BShift, B_BITS = BBits,
+        A_SHIFT = AShift, A_BITS = ABits
+    };
+};
+
+// x1r5g5b5, the top bit is unused
+typedef Conversion_Rgb16Layout<false, 10, 5, 5, 5, 0, 5, 0, 0> Conversion_Rgb555Layout;
+typedef Conversion_Rgb16Layout<true, 10, 5, 5, 5, 0, 5, 0, 0> Conversion_Rgb555BeLayout;
+typedef Conversion_Rgb16Layout<false, 11, 5, 5, 6, 0, 5, 0, 0> Conversion_Rgb565Layout;
+typedef Conversion_Rgb16Layout<true, 11, 5, 5, 6, 0, 5, 0, 0> Conversion_Rgb565BeLayout;
+typedef Conversion_Rgb16Layout<false, 10, 5, 5, 5, 0, 5, 15, 1> Conversion_Argb1555Layout;
+typedef Conversion_Rgb16Layout<false, 8, 4, 4, 4, 0, 4, 12, 4> Conversion_Argb4444Layout;
+// r5g5b5a1, alpha in the lowest bit
+typedef Conversion_Rgb16Layout<false, 11, 5, 6, 5, 1, 5, 0, 1> Conversion_Rgba5551Layout;
+
+/**
+ * Widens a Bits bit channel to 8 bits by replicating its bits into the low ones, so that 0 and the largest value map
+ * to 0 and 0xFF exactly and the steps in between stay even.
+ */
+template<int Bits>
+inline uint8_t Conversion_expandBits(unsigned value)
+{
+    value <<= 8 - Bits;
+
+    for (int filled = Bits; filled < 8; filled *= 2) {
+        value |= value >> filled;
+    }
+
+    return static_cast<uint8_t>(value);
+}
+
+template<class Layout>
+inline void Conversion_storeRgb(uint8_t *pixel, uint8_t r, uint8_t g, uint8_t b)
+{
+    pixel[Layout::R] = r;
+    pixel[Layout::G] = g;
+    pixel[Layout::B] = b;
+
+    if (Layout::A >= 0) {
+        pixel[Layout::A < 0 ? 0 : Layout::A] = 0xFF;
+    }
+}
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_LAYOUTS_H
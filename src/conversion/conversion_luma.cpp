@@ -0,0 +1,30 @@
+#include "conversion_luma.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_LumaRow Conversion_Kernels::getLumaRow(PixelFormat source)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getLumaRowAvx2(source);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getLumaRowSse2(source);
+    }
+#endif
+
+    return getLumaRowC(source);
+}
+
+Conversion_LumaRow Conversion_Kernels::getLumaRowC(PixelFormat source)
+{
+    return Conversion_selectLumaRow<Conversion_ExtractLumaC>(source);
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,35 @@
+#ifndef CONVERSION_LUMA_H
+#define CONVERSION_LUMA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Scalar kernel copying the luma samples of a packed YUV row into a row of 8-bit gray pixels.
+ * Offset is the byte position of the first luma sample, Step the distance between consecutive ones, 2 for packed
+ * 4:2:2 formats and 4 for AYUV.
+ * SIMD kernels use convert() to finish the pixels that don't fill a whole vector.
+ */
+template<int Offset, int Step>
+struct Conversion_ExtractLumaC {
+    /**
+     * Copies pixels [begin, width) of a row.
+     */
+    static void convert(const uint8_t *source, uint8_t *destination, size_t begin, size_t width)
+    {
+        for (size_t x = begin; x < width; x ++) {
+            destination[x] = source[x * Step + Offset];
+        }
+    }
+
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        convert(source, destination, 0, width);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_LUMA_H
@@ -0,0 +1,74 @@
+#include "conversion_luma.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Builds the byte shuffle moving the 16 / Step luma samples of each 128-bit lane of the index-th vector of a loop
+ * iteration into the index-th group of 16 / Step bytes of the lane, zeroing the other bytes.
+ */
+template<int Offset, int Step>
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i lumaShuffleAvx2(int index)
+{
+    const int samples = 16 / Step;
+    int8_t shuffle[32];
+
+    for (int i = 0; i < 32; i ++) {
+        const int position = i % 16;
+        shuffle[i] = static_cast<int8_t>(position / samples == index ? Offset + Step * (position % samples) : -128);
+    }
+
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(shuffle));
+}
+
+template<int Offset, int Step>
+struct ExtractLumaAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        // 32 pixels take Step vectors
+        enum { VECTORS = Step };
+
+        __m256i shuffles[VECTORS];
+
+        for (int i = 0; i < VECTORS; i ++) {
+            shuffles[i] = lumaShuffleAvx2<Offset, Step>(i);
+        }
+
+        // byte shuffles don't cross 128-bit lanes, so the low lane collects the samples of the low halves of the
+        // vectors and the high lane those of the high halves, the permute puts the groups back into pixel order
+        const __m256i order = Step == 2 ? _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7) :
+                              _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t x = 0;
+
+        for (; x + 32 <= width; x += 32) {
+            const __m256i *pixels = reinterpret_cast<const __m256i *>(source + x * Step);
+            __m256i luma = _mm256_shuffle_epi8(_mm256_loadu_si256(pixels), shuffles[0]);
+
+            for (int i = 1; i < VECTORS; i ++) {
+                luma = _mm256_or_si256(luma, _mm256_shuffle_epi8(_mm256_loadu_si256(pixels + i), shuffles[i]));
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x), _mm256_permutevar8x32_epi32(luma, order));
+        }
+
+        Conversion_ExtractLumaC<Offset, Step>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_LumaRow Conversion_Kernels::getLumaRowAvx2(PixelFormat source)
+{
+    return Conversion_selectLumaRow<ExtractLumaAvx2>(source);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
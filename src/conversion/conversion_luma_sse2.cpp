@@ -0,0 +1,67 @@
+#include "conversion_luma.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Moves the luma byte of every Step byte group of a vector into the low byte of its group, zeroing the rest.
+ */
+template<int Offset, int Step>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i isolateLumaSse2(__m128i pixels)
+{
+    if (Step == 2) {
+        return Offset == 0 ? _mm_and_si128(pixels, _mm_set1_epi16(0x00FF)) : _mm_srli_epi16(pixels, 8);
+    }
+
+    return _mm_and_si128(_mm_srli_epi32(pixels, 8 * Offset), _mm_set1_epi32(0xFF));
+}
+
+/**
+ * SSE2 has no byte shuffle, so the luma bytes get masked out and gathered with saturating packs instead.
+ */
+template<int Offset, int Step>
+struct ExtractLumaSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            const __m128i *pixels = reinterpret_cast<const __m128i *>(source + x * Step);
+            __m128i luma;
+
+            if (Step == 2) {
+                luma = _mm_packus_epi16(isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels)),
+                                        isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels + 1)));
+            } else {
+                // 32-bit lanes hold values below 256, so the signed pack can't saturate them
+                const __m128i low = _mm_packs_epi32(isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels)),
+                                                    isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels + 1)));
+                const __m128i high = _mm_packs_epi32(isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels + 2)),
+                                                     isolateLumaSse2<Offset, Step>(_mm_loadu_si128(pixels + 3)));
+                luma = _mm_packus_epi16(low, high);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x), luma);
+        }
+
+        Conversion_ExtractLumaC<Offset, Step>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_LumaRow Conversion_Kernels::getLumaRowSse2(PixelFormat source)
+{
+    return Conversion_selectLumaRow<ExtractLumaSse2>(source);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
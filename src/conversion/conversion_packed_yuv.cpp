@@ -0,0 +1,32 @@
+#include "conversion_packed_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_PackedYuvToRgbRow Conversion_Kernels::getPackedYuvToRgbRow(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getPackedYuvToRgbRowAvx2(source, destination, colorSpace, colorRange);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getPackedYuvToRgbRowSse2(source, destination, colorSpace, colorRange);
+    }
+#endif
+
+    return getPackedYuvToRgbRowC(source, destination, colorSpace, colorRange);
+}
+
+Conversion_PackedYuvToRgbRow Conversion_Kernels::getPackedYuvToRgbRowC(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPackedYuvToRgbRow<Conversion_PackedYuvToRgbC>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
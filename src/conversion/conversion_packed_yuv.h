@@ -0,0 +1,60 @@
+#ifndef CONVERSION_PACKED_YUV_H
+#define CONVERSION_PACKED_YUV_H
+
+#include "conversion_colorimetry.h"
+#include "conversion_layouts.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Scalar packed 4:2:2 to RGB kernel.
+ * SIMD kernels use convert() to finish the pixels that don't fill a whole vector.
+ */
+template<class Source, class Destination, class Coefficients>
+struct Conversion_PackedYuvToRgbC {
+    /**
+     * Converts pixels [begin, width) of a row. begin has to be even.
+     */
+    static void convert(const uint8_t *source, uint8_t *destination, size_t begin, size_t width)
+    {
+        const uint8_t *macropixel = source + begin * 2;
+        uint8_t *pixel = destination + begin * Destination::BYTES;
+        size_t x = begin;
+
+        for (; x + 2 <= width; x += 2, macropixel += 4, pixel += 2 * Destination::BYTES) {
+            const int u = macropixel[Source::U];
+            const int v = macropixel[Source::V];
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+
+            Conversion_yuvToRgb<Coefficients>(macropixel[Source::Y0], u, v, r, g, b);
+            Conversion_storeRgb<Destination>(pixel, r, g, b);
+            Conversion_yuvToRgb<Coefficients>(macropixel[Source::Y1], u, v, r, g, b);
+            Conversion_storeRgb<Destination>(pixel + Destination::BYTES, r, g, b);
+        }
+
+        // odd width, the second luma sample of the last macropixel is padding
+        if (x < width) {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+
+            Conversion_yuvToRgb<Coefficients>(macropixel[Source::Y0], macropixel[Source::U],
+                    macropixel[Source::V], r, g, b);
+            Conversion_storeRgb<Destination>(pixel, r, g, b);
+        }
+    }
+
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        convert(source, destination, 0, width);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_PACKED_YUV_H
@@ -0,0 +1,77 @@
+#include "conversion_packed_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Splits 16 packed 4:2:2 pixels into luma and per-pixel replicated chroma.
+ */
+template<class Source>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void unpackPackedYuvAvx2(__m256i pixels, __m256i &y, __m256i &u, __m256i &v)
+{
+    const __m256i lowBytes = _mm256_set1_epi16(0x00FF);
+    __m256i chroma;
+
+    if (Source::Y0 % 2 == 0) {
+        y = _mm256_and_si256(pixels, lowBytes);
+        chroma = _mm256_srli_epi16(pixels, 8);
+    } else {
+        y = _mm256_srli_epi16(pixels, 8);
+        chroma = _mm256_and_si256(pixels, lowBytes);
+    }
+
+    const __m256i first = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(chroma, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    const __m256i second = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(chroma, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+    u = Source::U < Source::V ? first : second;
+    v = Source::U < Source::V ? second : first;
+}
+
+template<class Source, class Destination, class Coefficients>
+struct PackedYuvToRgbAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            __m256i y;
+            __m256i u;
+            __m256i v;
+            __m256i r[2];
+            __m256i g[2];
+            __m256i b[2];
+
+            for (int half = 0; half < 2; half ++) {
+                const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x * 2 + 32 * half));
+                unpackPackedYuvAvx2<Source>(pixels, y, u, v);
+                Conversion_yuvToRgbAvx2<Coefficients>(y, u, v, r[half], g[half], b[half]);
+            }
+
+            Conversion_storeRgbAvx2<Destination>(destination + x * Destination::BYTES,
+                                                 Conversion_packBytesAvx2(r[0], r[1]),
+                                                 Conversion_packBytesAvx2(g[0], g[1]),
+                                                 Conversion_packBytesAvx2(b[0], b[1]));
+        }
+
+        Conversion_PackedYuvToRgbC<Source, Destination, Coefficients>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_PackedYuvToRgbRow Conversion_Kernels::getPackedYuvToRgbRowAvx2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPackedYuvToRgbRow<PackedYuvToRgbAvx2>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,78 @@
+#include "conversion_packed_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Splits 8 packed 4:2:2 pixels into luma and per-pixel replicated chroma.
+ */
+template<class Source>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void unpackPackedYuvSse2(__m128i pixels, __m128i &y, __m128i &u, __m128i &v)
+{
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    __m128i chroma;
+
+    if (Source::Y0 % 2 == 0) {
+        y = _mm_and_si128(pixels, lowBytes);
+        chroma = _mm_srli_epi16(pixels, 8);
+    } else {
+        y = _mm_srli_epi16(pixels, 8);
+        chroma = _mm_and_si128(pixels, lowBytes);
+    }
+
+    // chroma holds c0 c1 c0 c1 ..., one pair per macropixel, replicate each of them over both pixels
+    const __m128i first = _mm_shufflehi_epi16(_mm_shufflelo_epi16(chroma, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128i second = _mm_shufflehi_epi16(_mm_shufflelo_epi16(chroma, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+    u = Source::U < Source::V ? first : second;
+    v = Source::U < Source::V ? second : first;
+}
+
+template<class Source, class Destination, class Coefficients>
+struct PackedYuvToRgbSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            __m128i y;
+            __m128i u;
+            __m128i v;
+            __m128i r[2];
+            __m128i g[2];
+            __m128i b[2];
+
+            for (int half = 0; half < 2; half ++) {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 2 + 16 * half));
+                unpackPackedYuvSse2<Source>(pixels, y, u, v);
+                Conversion_yuvToRgbSse2<Coefficients>(y, u, v, r[half], g[half], b[half]);
+            }
+
+            Conversion_storeRgbSse2<Destination>(destination + x * Destination::BYTES,
+                                                 _mm_packus_epi16(r[0], r[1]),
+                                                 _mm_packus_epi16(g[0], g[1]),
+                                                 _mm_packus_epi16(b[0], b[1]));
+        }
+
+        Conversion_PackedYuvToRgbC<Source, Destination, Coefficients>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_PackedYuvToRgbRow Conversion_Kernels::getPackedYuvToRgbRowSse2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPackedYuvToRgbRow<PackedYuvToRgbSse2>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
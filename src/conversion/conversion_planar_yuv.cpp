@@ -0,0 +1,56 @@
+#include "conversion_planar_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_PlanarYuvToRgbRows Conversion_Kernels::getPlanarYuvToRgbRows(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getPlanarYuvToRgbRowsAvx2(source, destination, colorSpace, colorRange);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getPlanarYuvToRgbRowsSse2(source, destination, colorSpace, colorRange);
+    }
+#endif
+
+    return getPlanarYuvToRgbRowsC(source, destination, colorSpace, colorRange);
+}
+
+Conversion_PlanarYuvToRgbRows Conversion_Kernels::getPlanarYuvToRgbRowsC(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPlanarYuvToRgbRows<Conversion_PlanarYuvToRgbC>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_Yuv444ToRgbRow Conversion_Kernels::getYuv444ToRgbRow(PixelFormat destination, ColorSpace colorSpace,
+        ColorRange colorRange)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getYuv444ToRgbRowAvx2(destination, colorSpace, colorRange);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getYuv444ToRgbRowSse2(destination, colorSpace, colorRange);
+    }
+#endif
+
+    return getYuv444ToRgbRowC(destination, colorSpace, colorRange);
+}
+
+Conversion_Yuv444ToRgbRow Conversion_Kernels::getYuv444ToRgbRowC(PixelFormat destination, ColorSpace colorSpace,
+        ColorRange colorRange)
+{
+    return Conversion_selectYuv444ToRgbRow<Conversion_Yuv444ToRgbC>(destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
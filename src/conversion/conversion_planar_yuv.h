@@ -0,0 +1,73 @@
+#ifndef CONVERSION_PLANAR_YUV_H
+#define CONVERSION_PLANAR_YUV_H
+
+#include "conversion_colorimetry.h"
+#include "conversion_layouts.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Scalar 4:2:0 to RGB kernel.
+ * SIMD kernels use convert() to finish the pixels that don't fill a whole vector.
+ */
+template<class Chroma, class Destination, class Coefficients>
+struct Conversion_PlanarYuvToRgbC {
+    /**
+     * Converts pixels [begin, width) of a row pair. begin has to be even.
+     */
+    static void convert(const uint8_t *luma0, const uint8_t *luma1, const uint8_t *u, const uint8_t *v,
+                        uint8_t *destination0, uint8_t *destination1, size_t begin, size_t width)
+    {
+        for (size_t x = begin; x < width; x ++) {
+            const size_t chroma = x / 2 * Chroma::STEP;
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+
+            Conversion_yuvToRgb<Coefficients>(luma0[x], u[chroma], v[chroma], r, g, b);
+            Conversion_storeRgb<Destination>(destination0 + x * Destination::BYTES, r, g, b);
+
+            if (destination1) {
+                Conversion_yuvToRgb<Coefficients>(luma1[x], u[chroma], v[chroma], r, g, b);
+                Conversion_storeRgb<Destination>(destination1 + x * Destination::BYTES, r, g, b);
+            }
+        }
+    }
+
+    static void row(const uint8_t *luma0, const uint8_t *luma1, const uint8_t *u, const uint8_t *v,
+                    uint8_t *destination0, uint8_t *destination1, size_t width)
+    {
+        convert(luma0, luma1, u, v, destination0, destination1, 0, width);
+    }
+};
+
+/**
+ * Scalar 4:4:4 to RGB kernel, every pixel having its own chroma samples.
+ */
+template<class Chroma, class Destination, class Coefficients>
+struct Conversion_Yuv444ToRgbC {
+    static void convert(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *destination, size_t begin,
+                        size_t width)
+    {
+        for (size_t x = begin; x < width; x ++) {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+
+            Conversion_yuvToRgb<Coefficients>(y[x], u[x * Chroma::STEP], v[x * Chroma::STEP], r, g, b);
+            Conversion_storeRgb<Destination>(destination + x * Destination::BYTES, r, g, b);
+        }
+    }
+
+    static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *destination, size_t width)
+    {
+        convert(y, u, v, destination, 0, width);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_PLANAR_YUV_H
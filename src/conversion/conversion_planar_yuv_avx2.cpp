@@ -0,0 +1,121 @@
+#include "conversion_planar_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Loads the 16 U and 16 V samples of 32 pixels, replicated over both pixels each of them covers, into 16-bit lanes.
+ */
+template<class Chroma>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void loadChromaAvx2(const uint8_t *u, const uint8_t *v, __m256i uPixels[2], __m256i vPixels[2])
+{
+    if (Chroma::STEP == 1) {
+        const __m128i uSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u));
+        const __m128i vSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v));
+
+        uPixels[0] = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(uSamples, uSamples));
+        uPixels[1] = _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(uSamples, uSamples));
+        vPixels[0] = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(vSamples, vSamples));
+        vPixels[1] = _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(vSamples, vSamples));
+    } else {
+        const __m128i evenBytes = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+        const __m128i oddBytes = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15);
+
+        for (int half = 0; half < 2; half ++) {
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + 16 * half));
+            uPixels[half] = _mm256_cvtepu8_epi16(_mm_shuffle_epi8(samples, evenBytes));
+            vPixels[half] = _mm256_cvtepu8_epi16(_mm_shuffle_epi8(samples, oddBytes));
+        }
+    }
+}
+
+template<class Chroma, class Destination, class Coefficients>
+struct PlanarYuvToRgbAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *luma0, const uint8_t *luma1, const uint8_t *u,
+            const uint8_t *v, uint8_t *destination0, uint8_t *destination1, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            __m256i uPixels[2];
+            __m256i vPixels[2];
+            loadChromaAvx2<Chroma>(u + x / 2 * Chroma::STEP, v + x / 2 * Chroma::STEP, uPixels, vPixels);
+
+            const uint8_t *luma[2] = {luma0, luma1};
+            uint8_t *destination[2] = {destination0, destination1};
+
+            for (int line = 0; line < (destination1 ? 2 : 1); line ++) {
+                __m256i r[2];
+                __m256i g[2];
+                __m256i b[2];
+
+                for (int half = 0; half < 2; half ++) {
+                    const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(luma[line] + x + 16 * half)));
+                    Conversion_yuvToRgbAvx2<Coefficients>(y, uPixels[half], vPixels[half], r[half], g[half], b[half]);
+                }
+
+                Conversion_storeRgbAvx2<Destination>(destination[line] + x * Destination::BYTES,
+                                                     Conversion_packBytesAvx2(r[0], r[1]),
+                                                     Conversion_packBytesAvx2(g[0], g[1]),
+                                                     Conversion_packBytesAvx2(b[0], b[1]));
+            }
+        }
+
+        Conversion_PlanarYuvToRgbC<Chroma, Destination, Coefficients>::convert(luma0, luma1, u, v, destination0, destination1, x, width);
+    }
+};
+
+template<class Chroma, class Destination, class Coefficients>
+struct Yuv444ToRgbAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+            uint8_t *destination, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            __m256i r[2];
+            __m256i g[2];
+            __m256i b[2];
+
+            for (int half = 0; half < 2; half ++) {
+                const size_t offset = x + 16 * half;
+                const __m256i ySamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + offset)));
+                const __m256i uSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u + offset)));
+                const __m256i vSamples = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(v + offset)));
+                Conversion_yuvToRgbAvx2<Coefficients>(ySamples, uSamples, vSamples, r[half], g[half], b[half]);
+            }
+
+            Conversion_storeRgbAvx2<Destination>(destination + x * Destination::BYTES,
+                                                 Conversion_packBytesAvx2(r[0], r[1]),
+                                                 Conversion_packBytesAvx2(g[0], g[1]),
+                                                 Conversion_packBytesAvx2(b[0], b[1]));
+        }
+
+        Conversion_Yuv444ToRgbC<Chroma, Destination, Coefficients>::convert(y, u, v, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_PlanarYuvToRgbRows Conversion_Kernels::getPlanarYuvToRgbRowsAvx2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPlanarYuvToRgbRows<PlanarYuvToRgbAvx2>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_Yuv444ToRgbRow Conversion_Kernels::getYuv444ToRgbRowAvx2(PixelFormat destination, ColorSpace colorSpace,
+        ColorRange colorRange)
+{
+    return Conversion_selectYuv444ToRgbRow<Yuv444ToRgbAvx2>(destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,119 @@
+#include "conversion_planar_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Loads the 8 U and 8 V samples of 16 pixels into 16-bit lanes.
+ */
+template<class Chroma>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void loadChromaSse2(const uint8_t *u, const uint8_t *v, __m128i &uSamples, __m128i &vSamples)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    if (Chroma::STEP == 1) {
+        uSamples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u)), zero);
+        vSamples = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v)), zero);
+    } else {
+        // u and v point into the same interleaved row, v being one byte past u
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u));
+        uSamples = _mm_and_si128(samples, _mm_set1_epi16(0x00FF));
+        vSamples = _mm_srli_epi16(samples, 8);
+    }
+}
+
+template<class Chroma, class Destination, class Coefficients>
+struct PlanarYuvToRgbSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *luma0, const uint8_t *luma1, const uint8_t *u,
+            const uint8_t *v, uint8_t *destination0, uint8_t *destination1, size_t width)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            __m128i uSamples;
+            __m128i vSamples;
+            loadChromaSse2<Chroma>(u + x / 2 * Chroma::STEP, v + x / 2 * Chroma::STEP, uSamples, vSamples);
+
+            // every chroma sample covers two horizontally adjacent pixels
+            const __m128i uPixels[2] = {_mm_unpacklo_epi16(uSamples, uSamples), _mm_unpackhi_epi16(uSamples, uSamples)};
+            const __m128i vPixels[2] = {_mm_unpacklo_epi16(vSamples, vSamples), _mm_unpackhi_epi16(vSamples, vSamples)};
+
+            const uint8_t *luma[2] = {luma0, luma1};
+            uint8_t *destination[2] = {destination0, destination1};
+
+            for (int line = 0; line < (destination1 ? 2 : 1); line ++) {
+                const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(luma[line] + x));
+                __m128i r[2];
+                __m128i g[2];
+                __m128i b[2];
+
+                Conversion_yuvToRgbSse2<Coefficients>(_mm_unpacklo_epi8(y, zero), uPixels[0], vPixels[0], r[0], g[0], b[0]);
+                Conversion_yuvToRgbSse2<Coefficients>(_mm_unpackhi_epi8(y, zero), uPixels[1], vPixels[1], r[1], g[1], b[1]);
+
+                Conversion_storeRgbSse2<Destination>(destination[line] + x * Destination::BYTES,
+                                                     _mm_packus_epi16(r[0], r[1]),
+                                                     _mm_packus_epi16(g[0], g[1]),
+                                                     _mm_packus_epi16(b[0], b[1]));
+            }
+        }
+
+        Conversion_PlanarYuvToRgbC<Chroma, Destination, Coefficients>::convert(luma0, luma1, u, v, destination0, destination1, x, width);
+    }
+};
+
+template<class Chroma, class Destination, class Coefficients>
+struct Yuv444ToRgbSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+            uint8_t *destination, size_t width)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            const __m128i ySamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x));
+            const __m128i uSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x));
+            const __m128i vSamples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x));
+            __m128i r[2];
+            __m128i g[2];
+            __m128i b[2];
+
+            Conversion_yuvToRgbSse2<Coefficients>(_mm_unpacklo_epi8(ySamples, zero),
+                    _mm_unpacklo_epi8(uSamples, zero), _mm_unpacklo_epi8(vSamples, zero), r[0], g[0], b[0]);
+            Conversion_yuvToRgbSse2<Coefficients>(_mm_unpackhi_epi8(ySamples, zero),
+                    _mm_unpackhi_epi8(uSamples, zero), _mm_unpackhi_epi8(vSamples, zero), r[1], g[1], b[1]);
+
+            Conversion_storeRgbSse2<Destination>(destination + x * Destination::BYTES,
+                                                 _mm_packus_epi16(r[0], r[1]),
+                                                 _mm_packus_epi16(g[0], g[1]),
+                                                 _mm_packus_epi16(b[0], b[1]));
+        }
+
+        Conversion_Yuv444ToRgbC<Chroma, Destination, Coefficients>::convert(y, u, v, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_PlanarYuvToRgbRows Conversion_Kernels::getPlanarYuvToRgbRowsSse2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectPlanarYuvToRgbRows<PlanarYuvToRgbSse2>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_Yuv444ToRgbRow Conversion_Kernels::getYuv444ToRgbRowSse2(PixelFormat destination, ColorSpace colorSpace,
+        ColorRange colorRange)
+{
+    return Conversion_selectYuv444ToRgbRow<Yuv444ToRgbSse2>(destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,476 @@
+#include "conversion_planner.h"
+
+#include "conversion_jpeg_decoder.h"
+
+#include <frame_layout.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+#ifdef WEBCAM_CAPTURE_JPEG
+    // jpeglib.h expects FILE and size_t to be declared before it's included
+    #include <csetjmp>
+    #include <cstdio>
+    #include <jpeglib.h>
+#endif
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Formats conversions write, the only ones that can be in the middle of a chain.
+ */
+const PixelFormat INTERMEDIATE_FORMATS[] = {
+    PixelFormat::RGB24, PixelFormat::RGB32, PixelFormat::BGRA32, PixelFormat::ARGB32, PixelFormat::I420,
+    PixelFormat::IYUV, PixelFormat::NV12, PixelFormat::YUY2, PixelFormat::YUYV, PixelFormat::Y800, PixelFormat::AYUV,
+    PixelFormat::P016, PixelFormat::P216, PixelFormat::Y416
+};
+
+// conversions are measured at a size large enough not to fit the caches, like the frames of a camera don't
+const size_t CALIBRATION_WIDTH = 640;
+const size_t CALIBRATION_HEIGHT = 480;
+
+// the first run warms the caches up and only the fastest of the others counts, which filters out preemption
+const int CALIBRATION_RUNS = 4;
+
+// edges not measured yet are estimated from the bytes they read and write, at roughly what a conversion kernel moves
+// through memory per nanosecond, and compressed frames are taken for the few bytes per pixel MJPEG frames have
+const double ESTIMATED_COST_PER_BYTE = 0.25;
+const double COMPRESSED_BYTES_PER_PIXEL = 0.5;
+
+const double NO_PATH = std::numeric_limits<double>::infinity();
+
+/**
+ * @return Number of bytes a pixel of a format takes, on average over its planes.
+ */
+double getBytesPerPixel(PixelFormat pixelFormat)
+{
+    Frame layout = Frame();
+    layout.pixelFormat = pixelFormat;
+    const size_t bytes = FrameLayout::setLayout(layout, 64, 64);
+
+    return bytes ? bytes / (64.0 * 64.0) : COMPRESSED_BYTES_PER_PIXEL;
+}
+
+#ifdef WEBCAM_CAPTURE_JPEG
+
+/**
+ * libjpeg exits the process on errors by default, this jumps back into encodeCalibrationImage() instead.
+ */
+struct ErrorManager {
+    jpeg_error_mgr manager; // has to be the first member, libjpeg passes a pointer to it around
+    jmp_buf jump;
+};
+
+void exitOnError(j_common_ptr info)
+{
+    longjmp(reinterpret_cast<ErrorManager *>(info->err)->jump, 1);
+}
+
+#endif
+
+/**
+ * Encodes an image to time MJPEG decompression with, the way webcams send their frames, 4:2:2 at a moderate quality.
+ * Decompression takes longer the more detail there is to decode, so the image has smooth gradients with some fine
+ * texture on top, like a camera's picture, rather than noise or flat colors.
+ * @return true on success, false if encoding failed or the library was built without a JPEG library.
+ */
+bool encodeCalibrationImage(size_t width, size_t height, std::vector<uint8_t> &image)
+{
+#ifdef WEBCAM_CAPTURE_JPEG
+    // libjpeg writes into the image as long as it fits, which it always does at this quality
+    image.resize(width * height * 3 + 4096);
+    unsigned char *buffer = image.data();
+    unsigned long bytes = static_cast<unsigned long>(image.size());
+
+    std::vector<uint8_t> row(width * 3);
+    jpeg_compress_struct info;
+    ErrorManager errorManager;
+    info.err = jpeg_std_error(&errorManager.manager);
+    errorManager.manager.error_exit = &exitOnError;
+
+    if (setjmp(errorManager.jump)) {
+        jpeg_destroy_compress(&info);
+        return false;
+    }
+
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, &buffer, &bytes);
+
+    info.image_width = static_cast<JDIMENSION>(width);
+    info.image_height = static_cast<JDIMENSION>(height);
+    info.input_components = 3;
+    info.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, 85, TRUE);
+    info.comp_info[0].h_samp_factor = 2;
+    info.comp_info[0].v_samp_factor = 1;
+
+    jpeg_start_compress(&info, TRUE);
+
+    while (info.next_scanline < info.image_height) {
+        const size_t y = info.next_scanline;
+
+        for (size_t x = 0; x < width; x ++) {
+            const size_t texture = (x * 7 ^ y * 13) & 0x1F;
+            row[x * 3] = static_cast<uint8_t>(x * 192 / width + texture);
+            row[x * 3 + 1] = static_cast<uint8_t>(y * 192 / height + texture);
+            row[x * 3 + 2] = static_cast<uint8_t>((x + y) * 96 / (width + height) + texture * 2);
+        }
+
+        JSAMPROW rowPointer = row.data();
+        jpeg_write_scanlines(&info, &rowPointer, 1);
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+
+    // a buffer libjpeg had to grow is one it allocated
+    if (buffer != image.data()) {
+        image.assign(buffer, buffer + bytes);
+        free(buffer);
+    } else {
+        image.resize(bytes);
+    }
+
+    return true;
+#else
+    (void) width;
+    (void) height;
+    (void) image;
+
+    return false;
+#endif
+}
+
+} // namespace
+
+Conversion_Planner::Conversion_Planner() :
+    calibrating(false),
+    revision(0),
+    calibrationWidth(0),
+    calibrationHeight(0)
+{
+    // empty
+}
+
+Conversion_Planner &Conversion_Planner::getInstance()
+{
+    // intentionally leaked, like the thread pool, so that it outlives the cameras using it
+    static Conversion_Planner *instance = new Conversion_Planner();
+
+    return *instance;
+}
+
+bool Conversion_Planner::findPath(PixelFormat source, PixelFormat destination, size_t width, size_t height,
+                                  std::vector<PixelFormat> &path)
+{
+    std::vector<Conversion_Step> steps;
+    path.clear();
+
+    if (!findPlan(source, width, height, destination, width, height, ScaleFilter::Box, steps)) {
+        return false;
+    }
+
+    for (const Conversion_Step &step : steps) {
+        path.push_back(step.pixelFormat);
+    }
+
+    return true;
+}
+
+bool Conversion_Planner::findPlan(PixelFormat source, size_t width, size_t height, PixelFormat destination,
+                                  size_t scaledWidth, size_t scaledHeight, ScaleFilter filter,
+                                  std::vector<Conversion_Step> &steps)
+{
+    const bool resize = scaledWidth != width || scaledHeight != height;
+    const Conversion_Step first = {source, width, height};
+    steps.assign(1, first);
+
+    if (source == destination && !resize) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const Edge key(source, destination, resize ? filter : ScaleFilter::Box, width, height, scaledWidth, scaledHeight);
+    const auto cached = plans.find(key);
+
+    if (cached != plans.end()) {
+        steps = cached->second;
+        return !steps.empty();
+    }
+
+    // the formats at the source size, then the ones at the destination size when resizing, few enough for Dijkstra's
+    // algorithm over a plain array
+    std::vector<PixelFormat> formats(1, source);
+
+    for (PixelFormat format : INTERMEDIATE_FORMATS) {
+        if (format != source) {
+            formats.push_back(format);
+        }
+    }
+
+    if (std::find(formats.begin(), formats.end(), destination) == formats.end()) {
+        formats.push_back(destination);
+    }
+
+    std::vector<Conversion_Step> nodes;
+
+    for (PixelFormat format : formats) {
+        const Conversion_Step node = {format, width, height};
+        nodes.push_back(node);
+    }
+
+    if (resize) {
+        for (PixelFormat format : formats) {
+            const Conversion_Step node = {format, scaledWidth, scaledHeight};
+            nodes.push_back(node);
+        }
+    }
+
+    const size_t target = std::find(formats.begin(), formats.end(), destination) - formats.begin() +
+                          (resize ? formats.size() : 0);
+
+    std::vector<double> distance(nodes.size(), NO_PATH);
+    std::vector<size_t> previous(nodes.size(), 0);
+    std::vector<bool> settled(nodes.size(), false);
+    distance[0] = 0;
+    bool estimated = false;
+
+    for (;;) {
+        size_t current = nodes.size();
+
+        for (size_t i = 0; i < nodes.size(); i ++) {
+            if (!settled[i] && distance[i] != NO_PATH && (current == nodes.size() || distance[i] < distance[current])) {
+                current = i;
+            }
+        }
+
+        if (current == nodes.size() || current == target) {
+            break;
+        }
+
+        settled[current] = true;
+
+        const Conversion_Step &from = nodes[current];
+        Frame frame = Frame();
+        frame.pixelFormat = from.pixelFormat;
+        frame.width[0] = from.width;
+        frame.height[0] = from.height;
+
+        // resizes only go from the source size to the destination one
+        const bool sourceSize = from.width == width && from.height == height;
+
+        for (size_t next = 1; next < nodes.size(); next ++) {
+            const Conversion_Step &to = nodes[next];
+            const bool resizing = to.width != from.width || to.height != from.height;
+
+            Frame converted = Frame();
+            converted.pixelFormat = to.pixelFormat;
+
+            if (settled[next] || (resizing && !sourceSize) || (!resizing && to.pixelFormat == from.pixelFormat) ||
+                !getStepLayout(frame, converted, to.width, to.height)) {
+                continue;
+            }
+
+            const Edge edge = resizing ?
+                              Edge(from.pixelFormat, to.pixelFormat, filter, from.width, from.height, to.width,
+                                   to.height) :
+                              Edge(from.pixelFormat, to.pixelFormat, ScaleFilter::Box, 0, 0, 0, 0);
+            const double candidate = distance[current] + getCost(edge, to.width * to.height, estimated);
+
+            if (candidate < distance[next]) {
+                distance[next] = candidate;
+                previous[next] = current;
+            }
+        }
+    }
+
+    steps.clear();
+
+    if (distance[target] != NO_PATH) {
+        for (size_t i = target; i != 0; i = previous[i]) {
+            steps.push_back(nodes[i]);
+        }
+
+        steps.push_back(first);
+        std::reverse(steps.begin(), steps.end());
+    }
+
+    // plans made with estimates are made again once the edges are measured
+    if (!estimated) {
+        plans[key] = steps;
+    }
+
+    if (!queue.empty() && !calibrating) {
+        calibrating = true;
+        std::thread(&Conversion_Planner::calibrate, this).detach();
+    }
+
+    return !steps.empty();
+}
+
+unsigned Conversion_Planner::getRevision() const
+{
+    return revision.load(std::memory_order_relaxed);
+}
+
+size_t Conversion_Planner::getStepLayout(const Frame &source, Frame &converted, size_t width, size_t height)
+{
+    if (width == source.width[0] && height == source.height[0]) {
+        return PixelFormatConverter::getDestinationLayout(source, converted);
+    }
+
+    DecompressionScale scale;
+
+    if (Conversion_JpegDecoder::isSupportedSource(source.pixelFormat)) {
+        return Conversion_JpegDecoder::getScale(source.width[0], source.height[0], width, height, scale) ?
+               PixelFormatConverter::getDestinationLayout(source, converted, scale) :
+               0;
+    }
+
+    return PixelFormatConverter::getDestinationLayout(source, converted, width, height);
+}
+
+bool Conversion_Planner::convertStep(const Frame &source, Frame &converted, size_t width, size_t height,
+                                     ScaleFilter filter, Conversion_JpegDecoder &decoder)
+{
+    const bool resize = width != source.width[0] || height != source.height[0];
+
+    if (Conversion_JpegDecoder::isSupportedSource(source.pixelFormat)) {
+        DecompressionScale scale = DecompressionScale::Full;
+
+        if ((resize && !Conversion_JpegDecoder::getScale(source.width[0], source.height[0], width, height, scale)) ||
+            !decoder.decode(source.plane[0], source.bytes, converted, scale)) {
+            return false;
+        }
+
+        // the colorimetry of JPEG images
+        converted.colorSpace = ColorSpace::BT601;
+        converted.colorRange = ColorRange::Full;
+
+        return true;
+    }
+
+    if (!resize) {
+        return PixelFormatConverter::convertInto(source, converted);
+    }
+
+    return source.pixelFormat == converted.pixelFormat ?
+           PixelFormatConverter::scaleInto(source, converted, width, height, filter) :
+           PixelFormatConverter::convertAndScaleInto(source, converted, width, height, filter);
+}
+
+double Conversion_Planner::getCost(const Edge &edge, size_t pixels, bool &estimated)
+{
+    const bool resize = std::get<3>(edge) != 0;
+    const auto measured = costs.find(edge);
+
+    if (measured != costs.end()) {
+        return resize ? measured->second : measured->second * pixels;
+    }
+
+    if (queued.insert(edge).second) {
+        queue.push_back(edge);
+    }
+
+    estimated = true;
+
+    const double sourceBytes = getBytesPerPixel(std::get<0>(edge)) *
+                               (resize ? std::get<3>(edge) * std::get<4>(edge) : pixels);
+    const double destinationBytes = getBytesPerPixel(std::get<1>(edge)) * pixels;
+
+    return (sourceBytes + destinationBytes) * ESTIMATED_COST_PER_BYTE;
+}
+
+void Conversion_Planner::calibrate()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // the lock is left while measuring, so that planning goes on with the estimates meanwhile
+    while (!queue.empty()) {
+        const Edge edge = queue.front();
+        lock.unlock();
+
+        const double cost = measureCost(edge);
+
+        lock.lock();
+        queue.pop_front();
+        queued.erase(edge);
+        costs[edge] = cost;
+    }
+
+    calibrating = false;
+    revision ++;
+}
+
+double Conversion_Planner::measureCost(const Edge &edge)
+{
+    const PixelFormat source = std::get<0>(edge);
+    const bool resize = std::get<3>(edge) != 0;
+    const size_t width = resize ? std::get<3>(edge) : CALIBRATION_WIDTH;
+    const size_t height = resize ? std::get<4>(edge) : CALIBRATION_HEIGHT;
+    const size_t scaledWidth = resize ? std::get<5>(edge) : width;
+    const size_t scaledHeight = resize ? std::get<6>(edge) : height;
+
+    Frame frame = Frame();
+    frame.pixelFormat = source;
+    frame.width[0] = width;
+    frame.height[0] = height;
+
+    std::vector<uint8_t> sourceBuffer;
+
+    if (Conversion_JpegDecoder::isSupportedSource(source)) {
+        if (calibrationWidth != width || calibrationHeight != height) {
+            calibrationWidth = 0;
+
+            if (!encodeCalibrationImage(width, height, calibrationImage)) {
+                return NO_PATH;
+            }
+
+            calibrationWidth = width;
+            calibrationHeight = height;
+        }
+
+        frame.plane[0] = calibrationImage.data();
+        frame.bytes = calibrationImage.size();
+    } else {
+        // 8 zero bytes per pixel hold a tightly packed frame of any uncompressed format
+        sourceBuffer.resize(width * height * 8);
+        frame.plane[0] = sourceBuffer.data();
+    }
+
+    Frame converted = Frame();
+    converted.pixelFormat = std::get<1>(edge);
+
+    std::vector<uint8_t> destinationBuffer(getStepLayout(frame, converted, scaledWidth, scaledHeight));
+    converted.plane[0] = destinationBuffer.data();
+
+    Conversion_JpegDecoder decoder;
+    double fastest = NO_PATH;
+
+    for (int run = 0; run < CALIBRATION_RUNS; run ++) {
+        Frame target = converted;
+        const auto start = std::chrono::steady_clock::now();
+
+        if (destinationBuffer.empty() ||
+            !convertStep(frame, target, scaledWidth, scaledHeight, std::get<2>(edge), decoder)) {
+            return NO_PATH;
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (run) {
+            fastest = std::min(fastest, elapsed.count());
+        }
+    }
+
+    return resize ? fastest : fastest / (width * height);
+}
+
+} // namespace webcam_capture
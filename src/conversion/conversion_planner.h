@@ -0,0 +1,142 @@
+#ifndef CONVERSION_PLANNER_H
+#define CONVERSION_PLANNER_H
+
+#include <frame.h>
+#include <pixel_format.h>
+#include <pixel_format_converter.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace webcam_capture {
+
+class Conversion_JpegDecoder;
+
+/**
+ * Frame a conversion chain goes through, the source, an intermediate or the destination one.
+ * A step of another size than the one before it is resized from it, with PixelFormatConverter::scaleInto() if it's
+ * of the same pixel format, with convertAndScaleInto() or a scaled MJPEG decompression otherwise. A step of the same
+ * size is converted from it with convertInto() or decompressed.
+ */
+struct Conversion_Step
+{
+    PixelFormat pixelFormat;
+    size_t width;
+    size_t height;
+};
+
+/**
+ * Finds the cheapest chain of conversions and resizes between two pixel formats and sizes.
+ * Pixel formats at the source size, and at the destination size if it's another one, are the nodes of a graph. Every
+ * conversion PixelFormatConverter can do in one call is an edge, MJPEG decompression included, and so is every resize
+ * from the source size to the destination one. Edges are weighted by their cost, and the cheapest path is found with
+ * Dijkstra's algorithm.
+ * Costs are measured on this CPU by a thread of the planner, in the background, once for every edge a search comes
+ * across, conversions per pixel at a fixed size and resizes at the sizes they resize between. Until an edge is
+ * measured, its cost is estimated from the bytes it reads and writes, and plans made with estimates get replaced once
+ * the measurements are in, which getRevision() tells. Planning itself never measures anything, so it's cheap enough
+ * for start() and the capture thread.
+ * Plans are cached per pair of formats and sizes, and per filter for the ones that resize.
+ */
+class Conversion_Planner
+{
+public:
+    /**
+     * @return The planner used by the library, which keeps the measured costs for the lifetime of the process.
+     */
+    static Conversion_Planner &getInstance();
+
+    /**
+     * Plans the cheapest chain converting frames of the given size from source to destination, at the same size.
+     * @param path Receives the formats of the chain, source first and destination last. Just source if the formats
+     * are the same.
+     * @return true on success, false if there is no chain between the formats.
+     */
+    bool findPath(PixelFormat source, PixelFormat destination, size_t width, size_t height,
+                  std::vector<PixelFormat> &path);
+
+    /**
+     * Plans the cheapest chain converting frames of a format and size into another format and size.
+     * @param filter Filter to resize with.
+     * @param steps Receives the frames of the chain, the source first and the destination last. Just the source if the
+     * formats and sizes are the same.
+     * @return true on success, false if there is no chain between them.
+     */
+    bool findPlan(PixelFormat source, size_t width, size_t height, PixelFormat destination, size_t scaledWidth,
+                  size_t scaledHeight, ScaleFilter filter, std::vector<Conversion_Step> &steps);
+
+    /**
+     * @return Number of times measured costs came in, which replace the estimates plans were made with. Callers
+     * holding on to a plan make it again when it changed.
+     */
+    unsigned getRevision() const;
+
+    /**
+     * Lays out the frame of a step made from source, as PixelFormatConverter::getDestinationLayout() does.
+     * @param converted Frame with pixelFormat set to the step's format.
+     * @return Number of bytes the frame takes, 0 if the step can't be made from source.
+     */
+    static size_t getStepLayout(const Frame &source, Frame &converted, size_t width, size_t height);
+
+    /**
+     * Makes the frame of a step from source, by converting, resizing or decompressing it.
+     * @param converted Frame laid out by getStepLayout(), with its buffer set.
+     * @param filter Filter to resize with.
+     * @param decoder Decoder of MJPEG sources, kept between frames so that decompression doesn't allocate.
+     * @return true on success.
+     */
+    static bool convertStep(const Frame &source, Frame &converted, size_t width, size_t height, ScaleFilter filter,
+                            Conversion_JpegDecoder &decoder);
+
+private:
+    Conversion_Planner();
+
+    /**
+     * Source, destination and filter of an edge, and the sizes it resizes between, 0 for conversions, whose cost is
+     * per pixel.
+     */
+    typedef std::tuple<PixelFormat, PixelFormat, ScaleFilter, size_t, size_t, size_t, size_t> Edge;
+
+    /**
+     * @return Cost of an edge in nanoseconds per frame of pixels pixels, its estimate if it wasn't measured yet, in
+     * which case estimated is set and the edge is queued to be measured.
+     */
+    double getCost(const Edge &edge, size_t pixels, bool &estimated);
+
+    /**
+     * Measures the edges queued until there is none left. Runs on the planner's thread.
+     */
+    void calibrate();
+
+    /**
+     * @return Cost of an edge in nanoseconds, per pixel for conversions and per frame for resizes.
+     */
+    double measureCost(const Edge &edge);
+
+    std::mutex mutex;
+    std::map<Edge, double> costs;
+    std::set<Edge> queued;
+    std::deque<Edge> queue;
+    bool calibrating;
+    std::atomic<unsigned> revision;
+
+    // owned by the planner's thread, encoded for the MJPEG decompressions it measures, of the size they are measured at
+    std::vector<uint8_t> calibrationImage;
+    size_t calibrationWidth;
+    size_t calibrationHeight;
+
+    // keyed like edges, by the formats, the filter and the sizes planned between. Empty plans stand for ones that
+    // can't be converted, plans made with estimated costs aren't cached
+    std::map<Edge, std::vector<Conversion_Step> > plans;
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_PLANNER_H
@@ -0,0 +1,336 @@
+#include "conversion_resize.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace webcam_capture {
+
+namespace {
+
+const int WEIGHT_BITS = 14;
+const int32_t WEIGHT_ONE = 1 << WEIGHT_BITS;
+
+// SIMD kernels read a few bytes past the last tap, see Conversion_ResizeRow
+const size_t BUFFER_PADDING = 16;
+
+// a process resizing to ever changing sizes, e.g. to fit a window being resized, doesn't get to keep them all
+const size_t MAX_TABLES = 64;
+
+/**
+ * Computes the taps of destination sample position, out of destinationSize, as the first source sample they read and
+ * their weights, which add up to 1.
+ */
+void getTaps(size_t position, size_t sourceSize, size_t destinationSize, ScaleFilter filter, size_t &first,
+             std::vector<double> &weights)
+{
+    weights.clear();
+
+    switch (filter) {
+        case ScaleFilter::Nearest:
+            first = std::min<size_t>((2 * static_cast<uint64_t>(position) + 1) * sourceSize / (2 * destinationSize),
+                                     sourceSize - 1);
+            weights.push_back(1);
+            break;
+
+        case ScaleFilter::Bilinear: {
+            // the centers of the destination samples are spread evenly over the source, edges clamp
+            const double center = (position + 0.5) * sourceSize / destinationSize - 0.5;
+
+            if (center <= 0 || center >= sourceSize - 1) {
+                first = center <= 0 ? 0 : sourceSize - 1;
+                weights.push_back(1);
+                break;
+            }
+
+            first = static_cast<size_t>(center);
+            const double fraction = center - first;
+
+            weights.push_back(1 - fraction);
+            weights.push_back(fraction);
+            break;
+        }
+
+        case ScaleFilter::Box: {
+            // the destination sample covers [position, position + 1) * sourceSize, source sample i covers
+            // [i, i + 1) * destinationSize, in units of 1 / destinationSize source samples
+            const uint64_t begin = static_cast<uint64_t>(position) * sourceSize;
+            const uint64_t end = begin + sourceSize;
+            first = static_cast<size_t>(begin / destinationSize);
+
+            for (uint64_t i = first; i * destinationSize < end; i ++) {
+                const uint64_t covered = std::min(end, (i + 1) * destinationSize) -
+                                         std::max(begin, i * destinationSize);
+                weights.push_back(static_cast<double>(covered) / sourceSize);
+            }
+
+            break;
+        }
+    }
+}
+
+/**
+ * Rounds weights to fixed point, keeping their sum exact, and drops the taps left with no weight at either end.
+ */
+void quantizeTaps(size_t &first, const std::vector<double> &weights, std::vector<int32_t> &quantized)
+{
+    quantized.clear();
+    int32_t sum = 0;
+
+    for (double weight : weights) {
+        quantized.push_back(static_cast<int32_t>(weight * WEIGHT_ONE + 0.5));
+        sum += quantized.back();
+    }
+
+    *std::max_element(quantized.begin(), quantized.end()) += WEIGHT_ONE - sum;
+
+    while (quantized.back() == 0) {
+        quantized.pop_back();
+    }
+
+    while (quantized.front() == 0) {
+        quantized.erase(quantized.begin());
+        first ++;
+    }
+}
+
+std::shared_ptr<Conversion_ResizeTable> makeTable(size_t sourceSize, size_t destinationSize, ScaleFilter filter,
+        size_t channels)
+{
+    std::vector<size_t> firsts(destinationSize);
+    std::vector<std::vector<int32_t> > taps(destinationSize);
+    std::vector<double> weights;
+    size_t tapCount = 1;
+
+    for (size_t position = 0; position < destinationSize; position ++) {
+        getTaps(position, sourceSize, destinationSize, filter, firsts[position], weights);
+        quantizeTaps(firsts[position], weights, taps[position]);
+        tapCount = std::max(tapCount, taps[position].size());
+    }
+
+    if (tapCount * channels > Conversion_Resizer::BUFFER_SIZE) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Conversion_ResizeTable> table = std::make_shared<Conversion_ResizeTable>();
+    table->sourceSize = sourceSize;
+    table->destinationSize = destinationSize;
+    table->channels = channels;
+    table->taps = tapCount;
+    table->pairs = (tapCount + 1) / 2;
+    table->elements = destinationSize * channels;
+    table->offsets.resize(table->elements);
+    table->weights.resize(table->elements * table->pairs);
+    table->weightsByPair.resize(table->elements * table->pairs);
+    table->identity = sourceSize == destinationSize && tapCount == 1;
+
+    for (size_t position = 0; position < destinationSize; position ++) {
+        // every sample gets as many taps, the ones of samples near the end are moved back so they stay in the source
+        const size_t start = std::min(firsts[position], sourceSize - tapCount);
+        const size_t shift = firsts[position] - start;
+        const std::vector<int32_t> &sampleTaps = taps[position];
+
+        for (size_t channel = 0; channel < channels; channel ++) {
+            const size_t element = position * channels + channel;
+            table->offsets[element] = static_cast<int32_t>(start * channels + channel);
+
+            for (size_t pair = 0; pair < table->pairs; pair ++) {
+                int32_t packed[2] = {0, 0};
+
+                for (size_t i = 0; i < 2; i ++) {
+                    const size_t tap = pair * 2 + i;
+
+                    if (tap >= shift && tap - shift < sampleTaps.size()) {
+                        packed[i] = sampleTaps[tap - shift];
+                    }
+                }
+
+                const int32_t word = static_cast<int32_t>(static_cast<uint32_t>(packed[0]) |
+                                                          static_cast<uint32_t>(packed[1]) << 16);
+                table->weights[element * table->pairs + pair] = word;
+                table->weightsByPair[pair * table->elements + element] = word;
+            }
+        }
+    }
+
+    // chunks of elements whose taps fit in the buffer of the vertical pass
+    const size_t reach = (tapCount - 1) * channels + 1;
+
+    for (size_t element = 0; element < table->elements;) {
+        const size_t sourceBegin = table->offsets[element];
+        table->chunks.push_back(element);
+
+        do {
+            element ++;
+        } while (element < table->elements &&
+                 table->offsets[element] + reach - sourceBegin <= Conversion_Resizer::BUFFER_SIZE);
+    }
+
+    table->chunks.push_back(table->elements);
+
+    return table;
+}
+
+} // namespace
+
+Conversion_Resizer &Conversion_Resizer::getInstance()
+{
+    // intentionally leaked, like the thread pool, so that it outlives the cameras using it
+    static Conversion_Resizer *instance = new Conversion_Resizer();
+
+    return *instance;
+}
+
+std::shared_ptr<const Conversion_ResizeTable> Conversion_Resizer::getTable(size_t sourceSize,
+        size_t destinationSize, ScaleFilter filter, size_t channels)
+{
+    Conversion_Resizer &resizer = getInstance();
+    std::lock_guard<std::mutex> lock(resizer.mutex);
+
+    const std::tuple<size_t, size_t, ScaleFilter, size_t> key(sourceSize, destinationSize, filter, channels);
+    const auto cached = resizer.tables.find(key);
+
+    if (cached != resizer.tables.end()) {
+        return cached->second;
+    }
+
+    if (resizer.tables.size() >= MAX_TABLES) {
+        resizer.tables.clear();
+    }
+
+    // tables too large to use get cached too, as null, so that they aren't computed for every frame
+    const std::shared_ptr<const Conversion_ResizeTable> table = makeTable(sourceSize, destinationSize, filter,
+            channels);
+    resizer.tables[key] = table;
+
+    return table;
+}
+
+bool Conversion_Resizer::resize(const Conversion_ResizePlane &source, const Conversion_ResizePlane &destination,
+                                size_t channels, ScaleFilter filter)
+{
+    const std::shared_ptr<const Conversion_ResizeTable> columns = getTable(source.width, destination.width, filter,
+            channels);
+    const std::shared_ptr<const Conversion_ResizeTable> rows = getTable(source.height, destination.height, filter, 1);
+
+    if (!columns || !rows) {
+        return false;
+    }
+
+    const Conversion_ResizeColumnsRow columnsRow = getResizeColumnsRow();
+    const Conversion_ResizeRow row = getResizeRow(channels);
+    const size_t sourceRowBytes = source.width * channels;
+
+    Conversion_ThreadPool::getInstance().runStripes(destination.height, 1, [&](size_t rowBegin, size_t rowEnd) {
+        uint8_t buffer[BUFFER_SIZE + BUFFER_PADDING];
+        bool cleared = false;
+
+        for (size_t y = rowBegin; y < rowEnd; y ++) {
+            const uint8_t *first = source.data + rows->offsets[y] * source.stride;
+            const int32_t *weights = &rows->weights[y * rows->pairs];
+            uint8_t *target = destination.data + y * destination.stride;
+
+            if (rows->taps == 1) {
+                if (columns->identity) {
+                    memcpy(target, first, sourceRowBytes);
+                } else {
+                    row(first, 0, sourceRowBytes, *columns, 0, columns->elements, target);
+                }
+
+                continue;
+            }
+
+            if (columns->identity) {
+                columnsRow(first, source.stride, rows->taps, weights, target, sourceRowBytes);
+                continue;
+            }
+
+            // the bytes past the taps are only ever multiplied by 0, but better not read them uninitialized
+            if (!cleared) {
+                memset(buffer, 0, sizeof(buffer));
+                cleared = true;
+            }
+
+            for (size_t chunk = 0; chunk + 1 < columns->chunks.size(); chunk ++) {
+                const size_t begin = columns->chunks[chunk];
+                const size_t end = columns->chunks[chunk + 1];
+                const size_t sourceBegin = columns->offsets[begin];
+                const size_t sourceEnd = columns->offsets[end - 1] + (columns->taps - 1) * channels + 1;
+
+                columnsRow(first + sourceBegin, source.stride, rows->taps, weights, buffer, sourceEnd - sourceBegin);
+                row(buffer, sourceBegin, sourceBegin + sizeof(buffer), *columns, begin, end, target + begin);
+            }
+        }
+    });
+
+    return true;
+}
+
+Conversion_ResizeColumnsRow Conversion_Resizer::getResizeColumnsRow()
+{
+#ifdef WEBCAM_CAPTURE_X86
+
+    if (Conversion_CpuFeatures::getSimdLevel() >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getResizeColumnsRowAvx2();
+    }
+
+#endif
+
+    return &resizeColumnsRowC;
+}
+
+Conversion_ResizeRow Conversion_Resizer::getResizeRow(size_t channels)
+{
+#ifdef WEBCAM_CAPTURE_X86
+
+    if (Conversion_CpuFeatures::getSimdLevel() >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getResizeRowAvx2(channels);
+    }
+
+#endif
+
+    (void) channels;
+
+    return &resizeRowC;
+}
+
+void Conversion_Resizer::resizeColumnsRowC(const uint8_t *source, size_t stride, size_t taps, const int32_t *weights,
+        uint8_t *destination, size_t count)
+{
+    for (size_t x = 0; x < count; x ++) {
+        int32_t sum = WEIGHT_ONE / 2;
+
+        for (size_t tap = 0; tap < taps; tap ++) {
+            const int32_t word = weights[tap / 2];
+            const int32_t weight = tap % 2 ? word >> 16 : static_cast<int16_t>(word & 0xFFFF);
+            sum += source[tap * stride + x] * weight;
+        }
+
+        destination[x] = static_cast<uint8_t>(sum >> WEIGHT_BITS);
+    }
+}
+
+void Conversion_Resizer::resizeRowC(const uint8_t *source, size_t bias, size_t length,
+                                    const Conversion_ResizeTable &table, size_t begin, size_t end,
+                                    uint8_t *destination)
+{
+    (void) length;
+
+    for (size_t element = begin; element < end; element ++) {
+        const uint8_t *samples = source + table.offsets[element] - bias;
+        const int32_t *weights = &table.weights[element * table.pairs];
+        int32_t sum = WEIGHT_ONE / 2;
+
+        for (size_t tap = 0; tap < table.taps; tap ++) {
+            const int32_t word = weights[tap / 2];
+            const int32_t weight = tap % 2 ? word >> 16 : static_cast<int16_t>(word & 0xFFFF);
+            sum += samples[tap * table.channels] * weight;
+        }
+
+        destination[element - begin] = static_cast<uint8_t>(sum >> WEIGHT_BITS);
+    }
+}
+
+} // namespace webcam_capture
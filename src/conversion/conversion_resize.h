@@ -0,0 +1,142 @@
+#ifndef CONVERSION_RESIZE_H
+#define CONVERSION_RESIZE_H
+
+#include <pixel_format_converter.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace webcam_capture {
+
+/**
+ * Weights of a filter resampling a row or column of sourceSize samples to destinationSize ones, precomputed so that
+ * resizing is only multiplications and additions.
+ * Samples are made of channels interleaved bytes, and the filter is applied to every channel, so destination element
+ * e, channel e % channels of sample e / channels, is the sum of the source elements offsets[e] + t * channels, for
+ * taps t in [0, taps), weighted by 14-bit fixed point weights that add up to 1 << 14.
+ * The weights of two consecutive taps share a 32-bit word, the even tap's in the low half, which is the layout
+ * _mm256_madd_epi16 takes. Filters of an odd number of taps have a last tap of weight 0.
+ */
+struct Conversion_ResizeTable {
+    size_t sourceSize;
+    size_t destinationSize;
+    size_t channels;
+    size_t taps;
+    size_t pairs; // (taps + 1) / 2
+    size_t elements; // destinationSize * channels
+
+    /**
+     * Element of the first tap of every destination element. Never decreasing, and taps never reach past the end.
+     */
+    std::vector<int32_t> offsets;
+
+    /**
+     * Weights of the pairs of taps of every destination element, weights[e * pairs + p].
+     */
+    std::vector<int32_t> weights;
+
+    /**
+     * Same weights, grouped by pair of taps, weightsByPair[p * elements + e], so that SIMD kernels load the weights
+     * of consecutive elements at once.
+     */
+    std::vector<int32_t> weightsByPair;
+
+    /**
+     * First destination element of every chunk of a row whose taps fit in Conversion_Resizer::BUFFER_SIZE bytes,
+     * and elements last.
+     */
+    std::vector<size_t> chunks;
+
+    /**
+     * The filter copies the samples, sizes are the same.
+     */
+    bool identity;
+};
+
+/**
+ * Computes part of a row of resized columns: count bytes, each the sum of the bytes at the same position in taps
+ * rows stride bytes apart, weighted by the pairs of weights of a Conversion_ResizeTable.
+ */
+typedef void (*Conversion_ResizeColumnsRow)(const uint8_t *source, size_t stride, size_t taps, const int32_t *weights,
+        uint8_t *destination, size_t count);
+
+/**
+ * Computes elements [begin, end) of a resized row into destination, reading the source elements of the table minus
+ * bias. Source elements are read only below length, SIMD kernels leave elements whose vectors would read past it to
+ * the scalar code.
+ */
+typedef void (*Conversion_ResizeRow)(const uint8_t *source, size_t bias, size_t length,
+                                     const Conversion_ResizeTable &table, size_t begin, size_t end,
+                                     uint8_t *destination);
+
+/**
+ * Plane of interleaved bytes resized by Conversion_Resizer.
+ */
+struct Conversion_ResizePlane {
+    uint8_t *data;
+    size_t stride;
+    size_t width; // in samples of channels bytes
+    size_t height;
+};
+
+/**
+ * Resizes planes of 8-bit samples in two separable passes. Each destination row first gets the source rows its
+ * vertical taps cover summed into a row on the stack, a chunk at a time, which is then resampled horizontally
+ * straight into the destination. The vertical pass is skipped when a row has a single tap, the horizontal one when
+ * the width doesn't change.
+ * Filter tables are cached per pair of sizes, filter and number of channels, so that a stream of frames of the same
+ * size computes them only once.
+ */
+class Conversion_Resizer
+{
+public:
+    /**
+     * Size of the row the vertical pass sums source rows into, which limits how much a row can be downscaled with
+     * ScaleFilter::Box, as all the samples a destination sample covers have to fit in it.
+     */
+    static const size_t BUFFER_SIZE = 16384;
+
+    /**
+     * @return The table of a filter, computed on the first call for its sizes and kept for later ones. Null if the
+     * filter takes more than BUFFER_SIZE bytes of taps.
+     */
+    static std::shared_ptr<const Conversion_ResizeTable> getTable(size_t sourceSize, size_t destinationSize,
+            ScaleFilter filter, size_t channels);
+
+    /**
+     * Resizes source into destination, each plane taking their sizes, with several threads if the thread pool has
+     * them.
+     * @param channels Number of interleaved bytes a sample takes, 1 to 4.
+     * @return true on success, false if the sizes take too large tables, see getTable().
+     */
+    static bool resize(const Conversion_ResizePlane &source, const Conversion_ResizePlane &destination,
+                       size_t channels, ScaleFilter filter);
+
+    static Conversion_ResizeColumnsRow getResizeColumnsRow();
+    static Conversion_ResizeRow getResizeRow(size_t channels);
+
+    static void resizeColumnsRowC(const uint8_t *source, size_t stride, size_t taps, const int32_t *weights,
+                                  uint8_t *destination, size_t count);
+    static void resizeRowC(const uint8_t *source, size_t bias, size_t length, const Conversion_ResizeTable &table,
+                           size_t begin, size_t end, uint8_t *destination);
+
+    static Conversion_ResizeColumnsRow getResizeColumnsRowAvx2();
+    static Conversion_ResizeRow getResizeRowAvx2(size_t channels);
+
+private:
+    Conversion_Resizer() = default;
+
+    static Conversion_Resizer &getInstance();
+
+    std::mutex mutex;
+    std::map<std::tuple<size_t, size_t, ScaleFilter, size_t>, std::shared_ptr<const Conversion_ResizeTable> > tables;
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_RESIZE_H
@@ -0,0 +1,145 @@
+#include "conversion_resize.h"
+
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+#include <cstring>
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Rounds sums of 14-bit fixed point weighted samples to integers.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i roundWeightedAvx2(__m256i sum)
+{
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1 << 13)), 14);
+}
+
+WEBCAM_CAPTURE_TARGET_AVX2 void resizeColumnsRowAvx2(const uint8_t *source, size_t stride, size_t taps,
+        const int32_t *weights, uint8_t *destination, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t x = 0;
+
+    for (; x + 32 <= count; x += 32) {
+        __m256i sums[4] = {zero, zero, zero, zero};
+
+        for (size_t tap = 0; tap < taps; tap += 2) {
+            // a pair of rows gets its bytes interleaved as 16-bit values, which madd multiplies by the pair of weights
+            // and adds up. The odd tap left at the end pairs with its own row, at a weight of 0
+            const __m256i even = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + tap * stride + x));
+            const __m256i odd = tap + 1 < taps ?
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + (tap + 1) * stride + x)) :
+                                even;
+            const __m256i weight = _mm256_set1_epi32(weights[tap / 2]);
+
+            const __m256i evenLow = _mm256_unpacklo_epi8(even, zero);
+            const __m256i evenHigh = _mm256_unpackhi_epi8(even, zero);
+            const __m256i oddLow = _mm256_unpacklo_epi8(odd, zero);
+            const __m256i oddHigh = _mm256_unpackhi_epi8(odd, zero);
+
+            sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi16(evenLow, oddLow), weight));
+            sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi16(evenLow, oddLow), weight));
+            sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi16(evenHigh, oddHigh), weight));
+            sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi16(evenHigh, oddHigh), weight));
+        }
+
+        // packing works per 128-bit lane like the unpacking did, which puts the bytes back in their order
+        const __m256i low = _mm256_packs_epi32(roundWeightedAvx2(sums[0]), roundWeightedAvx2(sums[1]));
+        const __m256i high = _mm256_packs_epi32(roundWeightedAvx2(sums[2]), roundWeightedAvx2(sums[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x), _mm256_packus_epi16(low, high));
+    }
+
+    Conversion_Resizer::resizeColumnsRowC(source + x, stride, taps, weights, destination + x, count - x);
+}
+
+/**
+ * Resamples a row of samples of Channels bytes, 8 elements at a time. Each pair of taps of the 8 elements gets
+ * gathered as 32-bit words starting at the even tap, which hold the odd tap too for samples of less than 4 bytes.
+ */
+template<int Channels>
+struct ResizeRowAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, size_t bias, size_t length,
+            const Conversion_ResizeTable &table, size_t begin, size_t end, uint8_t *destination)
+    {
+        const int *words = reinterpret_cast<const int *>(source);
+        const __m256i lowBytes = _mm256_set1_epi32(0xFF);
+        // moves bytes 0 and Channels of every word into its two 16-bit halves
+        const __m256i pairBytes = _mm256_setr_epi8(0, -1, Channels, -1, 4, -1, 4 + Channels, -1,
+                                  8, -1, 8 + Channels, -1, 12, -1, 12 + Channels, -1,
+                                  0, -1, Channels, -1, 4, -1, 4 + Channels, -1,
+                                  8, -1, 8 + Channels, -1, 12, -1, 12 + Channels, -1);
+        const __m256i biasVector = _mm256_set1_epi32(static_cast<int>(bias));
+        const size_t reach = (2 * table.pairs - 1) * Channels + 4;
+        size_t element = begin;
+
+        for (; element + 8 <= end && table.offsets[element + 7] + reach <= length; element += 8) {
+            const __m256i offsets = _mm256_sub_epi32(
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&table.offsets[element])), biasVector);
+            __m256i sum = _mm256_setzero_si256();
+
+            for (size_t pair = 0; pair < table.pairs; pair ++) {
+                const __m256i even = _mm256_add_epi32(offsets, _mm256_set1_epi32(static_cast<int>(pair * 2 * Channels)));
+                __m256i samples;
+
+                if (Channels < 4) {
+                    samples = _mm256_shuffle_epi8(_mm256_i32gather_epi32(words, even, 1), pairBytes);
+                } else {
+                    const __m256i odd = _mm256_add_epi32(even, _mm256_set1_epi32(Channels));
+                    samples = _mm256_or_si256(_mm256_and_si256(_mm256_i32gather_epi32(words, even, 1), lowBytes),
+                                              _mm256_slli_epi32(_mm256_and_si256(_mm256_i32gather_epi32(words, odd, 1),
+                                                      lowBytes), 16));
+                }
+
+                const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                                            &table.weightsByPair[pair * table.elements + element]));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(samples, weights));
+            }
+
+            // the 8 results end up in the first 4 bytes of each 128-bit lane
+            const __m256i rounded = roundWeightedAvx2(sum);
+            const __m256i words16 = _mm256_packs_epi32(rounded, rounded);
+            const __m256i packed = _mm256_packus_epi16(words16, words16);
+            const int32_t low = _mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+            const int32_t high = _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+            memcpy(destination + element - begin, &low, 4);
+            memcpy(destination + element - begin + 4, &high, 4);
+        }
+
+        Conversion_Resizer::resizeRowC(source, bias, length, table, element, end, destination + element - begin);
+    }
+};
+
+} // namespace
+
+Conversion_ResizeColumnsRow Conversion_Resizer::getResizeColumnsRowAvx2()
+{
+    return &resizeColumnsRowAvx2;
+}
+
+Conversion_ResizeRow Conversion_Resizer::getResizeRowAvx2(size_t channels)
+{
+    switch (channels) {
+        case 1:
+            return &ResizeRowAvx2<1>::row;
+
+        case 2:
+            return &ResizeRowAvx2<2>::row;
+
+        case 3:
+            return &ResizeRowAvx2<3>::row;
+
+        case 4:
+            return &ResizeRowAvx2<4>::row;
+
+        default:
+            return &resizeRowC;
+    }
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
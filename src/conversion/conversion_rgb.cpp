@@ -0,0 +1,89 @@
+#include "conversion_rgb.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+namespace {
+
+template<class Source>
+Conversion_RgbRow selectRgbRow(PixelFormat destination)
+{
+    switch (destination) {
+        case PixelFormat::RGB24:
+            return &Conversion_RepackRgbC<Source, Conversion_Rgb24Layout>::row;
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+            return &Conversion_RepackRgbC<Source, Conversion_Bgra32Layout>::row;
+
+        case PixelFormat::ARGB32:
+            return &Conversion_RepackRgbC<Source, Conversion_Argb32Layout>::row;
+
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+Conversion_RgbRow Conversion_Kernels::getRgbRow(PixelFormat source, PixelFormat destination)
+{
+    if (source == destination) {
+        switch (source) {
+            case PixelFormat::RGB24:
+                return &Conversion_CopyRowC<3>::row;
+
+            case PixelFormat::RGB32:
+            case PixelFormat::BGRA32:
+            case PixelFormat::ARGB32:
+                return &Conversion_CopyRowC<4>::row;
+
+            default:
+                return nullptr;
+        }
+    }
+
+    switch (source) {
+        case PixelFormat::RGB24:
+            return selectRgbRow<Conversion_Rgb24Layout>(destination);
+
+        case PixelFormat::RGB32:
+            // the fourth byte is unused, so it's not taken as alpha
+            return selectRgbRow<Conversion_Rgb32Layout>(destination);
+
+        case PixelFormat::BGRA32:
+            return selectRgbRow<Conversion_Bgra32Layout>(destination);
+
+        case PixelFormat::ARGB32:
+            return selectRgbRow<Conversion_Argb32Layout>(destination);
+
+        default:
+            return getExpandRgb16Row(source, destination);
+    }
+}
+
+Conversion_RgbRow Conversion_Kernels::getExpandRgb16Row(PixelFormat source, PixelFormat destination)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getExpandRgb16RowAvx2(source, destination);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getExpandRgb16RowSse2(source, destination);
+    }
+#endif
+
+    return getExpandRgb16RowC(source, destination);
+}
+
+Conversion_RgbRow Conversion_Kernels::getExpandRgb16RowC(PixelFormat source, PixelFormat destination)
+{
+    return Conversion_selectExpandRgb16Row<Conversion_ExpandRgb16C>(source, destination);
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,72 @@
+#ifndef CONVERSION_RGB_H
+#define CONVERSION_RGB_H
+
+#include "conversion_layouts.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace webcam_capture {
+
+/**
+ * Scalar kernel repacking a row of RGB pixels into another RGB layout.
+ * Alpha is kept if both layouts have it, destinations with an alpha channel get 0xFF otherwise.
+ */
+template<class Source, class Destination>
+struct Conversion_RepackRgbC {
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        for (size_t x = 0; x < width; x ++, source += Source::BYTES, destination += Destination::BYTES) {
+            Conversion_storeRgb<Destination>(destination, source[Source::R], source[Source::G], source[Source::B]);
+
+            if (Source::A >= 0 && Destination::A >= 0) {
+                destination[Destination::A < 0 ? 0 : Destination::A] = source[Source::A < 0 ? 0 : Source::A];
+            }
+        }
+    }
+};
+
+/**
+ * Scalar kernel expanding a row of 16-bit RGB pixels into a 24 or 32-bit RGB layout, see Conversion_Rgb16Layout.
+ * Alpha is kept if both layouts have it, destinations with an alpha channel get 0xFF otherwise.
+ */
+template<class Source, class Destination>
+struct Conversion_ExpandRgb16C {
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        for (size_t x = 0; x < width; x ++, source += 2, destination += Destination::BYTES) {
+            const unsigned pixel = Source::BIG_ENDIAN_PIXEL ? source[0] << 8 | source[1] : source[0] | source[1] << 8;
+
+            Conversion_storeRgb<Destination>(destination,
+                                             Conversion_expandBits<Source::R_BITS>(pixel >> Source::R_SHIFT &
+                                                     ((1 << Source::R_BITS) - 1)),
+                                             Conversion_expandBits<Source::G_BITS>(pixel >> Source::G_SHIFT &
+                                                     ((1 << Source::G_BITS) - 1)),
+                                             Conversion_expandBits<Source::B_BITS>(pixel >> Source::B_SHIFT &
+                                                     ((1 << Source::B_BITS) - 1)));
+
+            if (Source::A_BITS > 0 && Destination::A >= 0) {
+                // formats without alpha never get here, but still instantiate this with a valid number of bits
+                const int aBits = Source::A_BITS > 0 ? Source::A_BITS : 1;
+                destination[Destination::A < 0 ? 0 : Destination::A] =
+                    Conversion_expandBits<aBits>(pixel >> Source::A_SHIFT & ((1 << aBits) - 1));
+            }
+        }
+    }
+};
+
+/**
+ * Copies a row of pixels of Bytes bytes each, for conversions between identical layouts.
+ */
+template<size_t Bytes>
+struct Conversion_CopyRowC {
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        memcpy(destination, source, width * Bytes);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_RGB_H
@@ -0,0 +1,75 @@
+#include "conversion_rgb.h"
+
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Widens the Bits bit channel at Shift of every 16-bit pixel to 8 bits, see Conversion_expandBits().
+ */
+template<int Shift, int Bits>
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i expandChannelAvx2(__m256i pixels)
+{
+    // shifting the field to the top of the word and back down leaves the 8-bit value with its top bits in place
+    __m256i value = _mm256_srli_epi16(_mm256_slli_epi16(pixels, 16 - Shift - Bits), 16 - Bits);
+    value = _mm256_slli_epi16(value, 8 - Bits);
+
+    for (int filled = Bits; filled < 8; filled *= 2) {
+        value = _mm256_or_si256(value, _mm256_srli_epi16(value, filled));
+    }
+
+    return value;
+}
+
+template<class Source, class Destination>
+struct ExpandRgb16Avx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        // formats without alpha never use it, but still instantiate expandChannelAvx2() with a valid number of bits
+        enum { A_BITS = Source::A_BITS > 0 ? Source::A_BITS : 1 };
+
+        size_t x = 0;
+
+        for (; x + 32 + Conversion_StoreRgbAvx2Overrun<Destination>::PIXELS <= width; x += 32) {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 2 * x));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 2 * x + 32));
+
+            if (Source::BIG_ENDIAN_PIXEL) {
+                low = _mm256_or_si256(_mm256_slli_epi16(low, 8), _mm256_srli_epi16(low, 8));
+                high = _mm256_or_si256(_mm256_slli_epi16(high, 8), _mm256_srli_epi16(high, 8));
+            }
+
+            const __m256i r = Conversion_packBytesAvx2(expandChannelAvx2<Source::R_SHIFT, Source::R_BITS>(low),
+                                                       expandChannelAvx2<Source::R_SHIFT, Source::R_BITS>(high));
+            const __m256i g = Conversion_packBytesAvx2(expandChannelAvx2<Source::G_SHIFT, Source::G_BITS>(low),
+                                                       expandChannelAvx2<Source::G_SHIFT, Source::G_BITS>(high));
+            const __m256i b = Conversion_packBytesAvx2(expandChannelAvx2<Source::B_SHIFT, Source::B_BITS>(low),
+                                                       expandChannelAvx2<Source::B_SHIFT, Source::B_BITS>(high));
+            const __m256i a = Source::A_BITS > 0 && Destination::A >= 0 ?
+                              Conversion_packBytesAvx2(expandChannelAvx2<Source::A_SHIFT, A_BITS>(low),
+                                                       expandChannelAvx2<Source::A_SHIFT, A_BITS>(high)) :
+                              _mm256_set1_epi8(-1);
+
+            Conversion_storeRgbaAvx2<Destination>(destination + x * Destination::BYTES, r, g, b, a);
+        }
+
+        Conversion_ExpandRgb16C<Source, Destination>::row(source + 2 * x, destination + x * Destination::BYTES,
+                width - x);
+    }
+};
+
+} // namespace
+
+Conversion_RgbRow Conversion_Kernels::getExpandRgb16RowAvx2(PixelFormat source, PixelFormat destination)
+{
+    return Conversion_selectExpandRgb16Row<ExpandRgb16Avx2>(source, destination);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,75 @@
+#include "conversion_rgb.h"
+
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Widens the Bits bit channel at Shift of every 16-bit pixel to 8 bits, see Conversion_expandBits().
+ */
+template<int Shift, int Bits>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i expandChannelSse2(__m128i pixels)
+{
+    // shifting the field to the top of the word and back down leaves the 8-bit value with its top bits in place
+    __m128i value = _mm_srli_epi16(_mm_slli_epi16(pixels, 16 - Shift - Bits), 16 - Bits);
+    value = _mm_slli_epi16(value, 8 - Bits);
+
+    for (int filled = Bits; filled < 8; filled *= 2) {
+        value = _mm_or_si128(value, _mm_srli_epi16(value, filled));
+    }
+
+    return value;
+}
+
+template<class Source, class Destination>
+struct ExpandRgb16Sse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        // formats without alpha never use it, but still instantiate expandChannelSse2() with a valid number of bits
+        enum { A_BITS = Source::A_BITS > 0 ? Source::A_BITS : 1 };
+
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * x));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * x + 16));
+
+            if (Source::BIG_ENDIAN_PIXEL) {
+                low = _mm_or_si128(_mm_slli_epi16(low, 8), _mm_srli_epi16(low, 8));
+                high = _mm_or_si128(_mm_slli_epi16(high, 8), _mm_srli_epi16(high, 8));
+            }
+
+            const __m128i r = _mm_packus_epi16(expandChannelSse2<Source::R_SHIFT, Source::R_BITS>(low),
+                                               expandChannelSse2<Source::R_SHIFT, Source::R_BITS>(high));
+            const __m128i g = _mm_packus_epi16(expandChannelSse2<Source::G_SHIFT, Source::G_BITS>(low),
+                                               expandChannelSse2<Source::G_SHIFT, Source::G_BITS>(high));
+            const __m128i b = _mm_packus_epi16(expandChannelSse2<Source::B_SHIFT, Source::B_BITS>(low),
+                                               expandChannelSse2<Source::B_SHIFT, Source::B_BITS>(high));
+            const __m128i a = Source::A_BITS > 0 && Destination::A >= 0 ?
+                              _mm_packus_epi16(expandChannelSse2<Source::A_SHIFT, A_BITS>(low),
+                                               expandChannelSse2<Source::A_SHIFT, A_BITS>(high)) :
+                              _mm_set1_epi8(-1);
+
+            Conversion_storeRgbaSse2<Destination>(destination + x * Destination::BYTES, r, g, b, a);
+        }
+
+        Conversion_ExpandRgb16C<Source, Destination>::row(source + 2 * x, destination + x * Destination::BYTES,
+                width - x);
+    }
+};
+
+} // namespace
+
+Conversion_RgbRow Conversion_Kernels::getExpandRgb16RowSse2(PixelFormat source, PixelFormat destination)
+{
+    return Conversion_selectExpandRgb16Row<ExpandRgb16Sse2>(source, destination);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,56 @@
+#include "conversion_rgb_to_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+
+namespace webcam_capture {
+
+Conversion_RgbToPlanarYuvRows Conversion_Kernels::getRgbToPlanarYuvRows(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getRgbToPlanarYuvRowsAvx2(source, destination, colorSpace, colorRange);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getRgbToPlanarYuvRowsSse2(source, destination, colorSpace, colorRange);
+    }
+#endif
+
+    return getRgbToPlanarYuvRowsC(source, destination, colorSpace, colorRange);
+}
+
+Conversion_RgbToPackedYuvRow Conversion_Kernels::getRgbToPackedYuvRow(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+#ifdef WEBCAM_CAPTURE_X86
+    const Conversion_CpuFeatures::SimdLevel level = Conversion_CpuFeatures::getSimdLevel();
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::AVX2) {
+        return getRgbToPackedYuvRowAvx2(source, destination, colorSpace, colorRange);
+    }
+
+    if (level >= Conversion_CpuFeatures::SimdLevel::SSE2) {
+        return getRgbToPackedYuvRowSse2(source, destination, colorSpace, colorRange);
+    }
+#endif
+
+    return getRgbToPackedYuvRowC(source, destination, colorSpace, colorRange);
+}
+
+Conversion_RgbToPlanarYuvRows Conversion_Kernels::getRgbToPlanarYuvRowsC(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPlanarYuvRows<Conversion_RgbToPlanarYuvC>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_RgbToPackedYuvRow Conversion_Kernels::getRgbToPackedYuvRowC(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPackedYuvRow<Conversion_RgbToPackedYuvC>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,98 @@
+#ifndef CONVERSION_RGB_TO_YUV_H
+#define CONVERSION_RGB_TO_YUV_H
+
+#include "conversion_colorimetry.h"
+#include "conversion_layouts.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Scalar RGB to 4:2:0 kernel.
+ * Every chroma sample is computed from the sum of the 2x2 pixels it covers. The last pixel of an odd width row and the
+ * upper row of an odd row left over count twice, so that the sum always is of 4 pixels.
+ * SIMD kernels use convert() to finish the pixels that don't fill a whole vector.
+ */
+template<class Source, class Chroma, class Coefficients>
+struct Conversion_RgbToPlanarYuvC {
+    /**
+     * Converts pixels [begin, width) of a row pair. begin has to be even.
+     */
+    static void convert(const uint8_t *source0, const uint8_t *source1, uint8_t *luma0, uint8_t *luma1, uint8_t *u,
+                        uint8_t *v, size_t begin, size_t width)
+    {
+        const uint8_t *rows[2] = {source0, source1 ? source1 : source0};
+        uint8_t *luma[2] = {luma0, luma1};
+
+        for (size_t x = begin; x < width; x += 2) {
+            const size_t columns[2] = {x, x + 1 < width ? x + 1 : x};
+            int r = 0;
+            int g = 0;
+            int b = 0;
+
+            for (int line = 0; line < 2; line ++) {
+                for (int column = 0; column < 2; column ++) {
+                    const uint8_t *pixel = rows[line] + columns[column] * Source::BYTES;
+
+                    r += pixel[Source::R];
+                    g += pixel[Source::G];
+                    b += pixel[Source::B];
+
+                    if (luma[line] && (column == 0 || x + 1 < width)) {
+                        luma[line][x + column] = Conversion_rgbToLuma<Coefficients>(pixel[Source::R], pixel[Source::G],
+                                                 pixel[Source::B]);
+                    }
+                }
+            }
+
+            const size_t chroma = x / 2 * Chroma::STEP;
+            Conversion_rgbSumToChroma<Coefficients>(r, g, b, u[chroma], v[chroma]);
+        }
+    }
+
+    static void row(const uint8_t *source0, const uint8_t *source1, uint8_t *luma0, uint8_t *luma1, uint8_t *u,
+                    uint8_t *v, size_t width)
+    {
+        convert(source0, source1, luma0, luma1, u, v, 0, width);
+    }
+};
+
+/**
+ * Scalar RGB to packed 4:2:2 kernel.
+ * Every chroma sample is computed from the pixel pair it covers, counted twice to make for the sum of 4 pixels the
+ * chroma math takes. The last pixel of an odd width row fills both halves of its macropixel.
+ */
+template<class Source, class Destination, class Coefficients>
+struct Conversion_RgbToPackedYuvC {
+    /**
+     * Converts pixels [begin, width) of a row. begin has to be even.
+     */
+    static void convert(const uint8_t *source, uint8_t *destination, size_t begin, size_t width)
+    {
+        for (size_t x = begin; x < width; x += 2) {
+            const uint8_t *first = source + x * Source::BYTES;
+            const uint8_t *second = x + 1 < width ? first + Source::BYTES : first;
+            uint8_t *macropixel = destination + x / 2 * 4;
+
+            macropixel[Destination::Y0] = Conversion_rgbToLuma<Coefficients>(first[Source::R], first[Source::G],
+                                          first[Source::B]);
+            macropixel[Destination::Y1] = Conversion_rgbToLuma<Coefficients>(second[Source::R], second[Source::G],
+                                          second[Source::B]);
+            Conversion_rgbSumToChroma<Coefficients>(2 * (first[Source::R] + second[Source::R]),
+                                                    2 * (first[Source::G] + second[Source::G]),
+                                                    2 * (first[Source::B] + second[Source::B]),
+                                                    macropixel[Destination::U], macropixel[Destination::V]);
+        }
+    }
+
+    static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        convert(source, destination, 0, width);
+    }
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_RGB_TO_YUV_H
@@ -0,0 +1,244 @@
+#include "conversion_rgb_to_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_avx2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * 32 pixels, as two vectors of 16 pixels per channel in 16-bit lanes.
+ */
+struct PixelsAvx2 {
+    __m256i r[2];
+    __m256i g[2];
+    __m256i b[2];
+};
+
+/**
+ * Number of pixels past the 32 loaded by loadPixelsAvx2() the row has to have.
+ * 3-byte pixels are read with overlapping 16-byte loads, the last of which reads 4 bytes too many.
+ */
+template<class Source>
+struct LoadPixelsAvx2Overrun {
+    enum { PIXELS = Source::BYTES == 3 ? 2 : 0 };
+};
+
+template<int Position>
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i isolateChannelAvx2(__m256i pixels)
+{
+    return _mm256_and_si256(_mm256_srli_epi32(pixels, 8 * Position), _mm256_set1_epi32(0xFF));
+}
+
+/**
+ * Loads 8 pixels into each 128-bit lane of two vectors, spreading 3-byte pixels to 4 bytes.
+ */
+template<class Source>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void loadVectorsAvx2(const uint8_t *source, __m256i &low, __m256i &high)
+{
+    if (Source::BYTES == 4) {
+        low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source));
+        high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 32));
+        return;
+    }
+
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m256i *vectors[2] = {&low, &high};
+
+    for (int i = 0; i < 2; i ++) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 24 * i));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 24 * i + 12));
+
+        *vectors[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), spread);
+    }
+}
+
+template<class Source>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void loadPixelsAvx2(const uint8_t *source, PixelsAvx2 &pixels)
+{
+    for (int half = 0; half < 2; half ++) {
+        __m256i low;
+        __m256i high;
+        loadVectorsAvx2<Source>(source + 16 * half * Source::BYTES, low, high);
+
+        // packing works per 128-bit lane, the permute puts the groups of 4 pixels back in order
+        pixels.r[half] = _mm256_permute4x64_epi64(_mm256_packs_epi32(isolateChannelAvx2<Source::R>(low),
+                         isolateChannelAvx2<Source::R>(high)), _MM_SHUFFLE(3, 1, 2, 0));
+        pixels.g[half] = _mm256_permute4x64_epi64(_mm256_packs_epi32(isolateChannelAvx2<Source::G>(low),
+                         isolateChannelAvx2<Source::G>(high)), _MM_SHUFFLE(3, 1, 2, 0));
+        pixels.b[half] = _mm256_permute4x64_epi64(_mm256_packs_epi32(isolateChannelAvx2<Source::B>(low),
+                         isolateChannelAvx2<Source::B>(high)), _MM_SHUFFLE(3, 1, 2, 0));
+    }
+}
+
+/**
+ * Same as weightSse2(), for 16 values. Unpacking and packing within the 128-bit lanes cancel each other out, so the
+ * values stay in order.
+ */
+template<int Shift, int Bias, int R, int G, int B>
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i weightAvx2(__m256i r, __m256i g, __m256i b)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rgWeights = _mm256_setr_epi16(R, G, R, G, R, G, R, G, R, G, R, G, R, G, R, G);
+    const __m256i bWeights = _mm256_setr_epi16(B, 0, B, 0, B, 0, B, 0, B, 0, B, 0, B, 0, B, 0);
+    const __m256i bias = _mm256_set1_epi32(Bias);
+
+    __m256i low = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(r, g), rgWeights),
+                                   _mm256_madd_epi16(_mm256_unpacklo_epi16(b, zero), bWeights));
+    __m256i high = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(r, g), rgWeights),
+                                    _mm256_madd_epi16(_mm256_unpackhi_epi16(b, zero), bWeights));
+
+    low = _mm256_srai_epi32(_mm256_add_epi32(low, bias), Shift);
+    high = _mm256_srai_epi32(_mm256_add_epi32(high, bias), Shift);
+
+    return _mm256_packs_epi32(low, high);
+}
+
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i lumaAvx2(const PixelsAvx2 &pixels)
+{
+    enum { BIAS = Coefficients::ROUNDING + (Coefficients::Y_OFFSET << Coefficients::SHIFT) };
+
+    __m256i y[2];
+
+    for (int half = 0; half < 2; half ++) {
+        y[half] = weightAvx2<Coefficients::SHIFT, BIAS, Coefficients::Y_R, Coefficients::Y_G, Coefficients::Y_B>(
+                      pixels.r[half], pixels.g[half], pixels.b[half]);
+    }
+
+    return Conversion_packBytesAvx2(y[0], y[1]);
+}
+
+/**
+ * @return 16 sums of 2x2 blocks in 16-bit lanes.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i sumBlocksAvx2(const __m256i top[2], const __m256i bottom[2])
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i sums = _mm256_packs_epi32(_mm256_madd_epi16(_mm256_add_epi16(top[0], bottom[0]), ones),
+                                            _mm256_madd_epi16(_mm256_add_epi16(top[1], bottom[1]), ones));
+
+    return _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/**
+ * @param u Receives the 16 U samples of the 2x2 blocks of the pixels of two rows.
+ * @param v Receives the 16 V samples.
+ */
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void chromaAvx2(const PixelsAvx2 &top, const PixelsAvx2 &bottom, __m128i &u,
+        __m128i &v)
+{
+    enum {
+        SHIFT = Coefficients::SHIFT + 2,
+        BIAS = (1 << (SHIFT - 1)) + (128 << SHIFT)
+    };
+
+    const __m256i r = sumBlocksAvx2(top.r, bottom.r);
+    const __m256i g = sumBlocksAvx2(top.g, bottom.g);
+    const __m256i b = sumBlocksAvx2(top.b, bottom.b);
+
+    const __m256i uWords = weightAvx2<SHIFT, BIAS, Coefficients::U_R, Coefficients::U_G, Coefficients::U_B>(r, g, b);
+    const __m256i vWords = weightAvx2<SHIFT, BIAS, Coefficients::V_R, Coefficients::V_G, Coefficients::V_B>(r, g, b);
+    const __m256i samples = Conversion_packBytesAvx2(uWords, vWords);
+
+    u = _mm256_castsi256_si128(samples);
+    v = _mm256_extracti128_si256(samples, 1);
+}
+
+template<class Source, class Chroma, class Coefficients>
+struct RgbToPlanarYuvAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source0, const uint8_t *source1, uint8_t *luma0,
+            uint8_t *luma1, uint8_t *u, uint8_t *v, size_t width)
+    {
+        const uint8_t *second = source1 ? source1 : source0;
+        size_t x = 0;
+
+        for (; x + 32 + LoadPixelsAvx2Overrun<Source>::PIXELS <= width; x += 32) {
+            PixelsAvx2 top;
+            PixelsAvx2 bottom;
+            loadPixelsAvx2<Source>(source0 + x * Source::BYTES, top);
+            loadPixelsAvx2<Source>(second + x * Source::BYTES, bottom);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(luma0 + x), lumaAvx2<Coefficients>(top));
+
+            if (luma1) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(luma1 + x), lumaAvx2<Coefficients>(bottom));
+            }
+
+            __m128i uSamples;
+            __m128i vSamples;
+            chromaAvx2<Coefficients>(top, bottom, uSamples, vSamples);
+
+            if (Chroma::STEP == 1) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x / 2), uSamples);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(v + x / 2), vSamples);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x), _mm_unpacklo_epi8(uSamples, vSamples));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x + 16), _mm_unpackhi_epi8(uSamples, vSamples));
+            }
+        }
+
+        Conversion_RgbToPlanarYuvC<Source, Chroma, Coefficients>::convert(source0, source1, luma0, luma1, u, v, x,
+                width);
+    }
+};
+
+template<class Source, class Destination, class Coefficients>
+struct RgbToPackedYuvAvx2 {
+    WEBCAM_CAPTURE_TARGET_AVX2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        size_t x = 0;
+
+        for (; x + 32 + LoadPixelsAvx2Overrun<Source>::PIXELS <= width; x += 32) {
+            PixelsAvx2 pixels;
+            loadPixelsAvx2<Source>(source + x * Source::BYTES, pixels);
+
+            const __m256i y = lumaAvx2<Coefficients>(pixels);
+            __m128i uSamples;
+            __m128i vSamples;
+            chromaAvx2<Coefficients>(pixels, pixels, uSamples, vSamples);
+
+            const __m128i first = Destination::U < Destination::V ? uSamples : vSamples;
+            const __m128i last = Destination::U < Destination::V ? vSamples : uSamples;
+            const __m128i pairs[2] = {_mm_unpacklo_epi8(first, last), _mm_unpackhi_epi8(first, last)};
+            const __m128i luma[2] = {_mm256_castsi256_si128(y), _mm256_extracti128_si256(y, 1)};
+            __m128i *macropixels = reinterpret_cast<__m128i *>(destination + x * 2);
+
+            for (int half = 0; half < 2; half ++) {
+                if (Destination::Y0 == 0) {
+                    _mm_storeu_si128(macropixels + 2 * half, _mm_unpacklo_epi8(luma[half], pairs[half]));
+                    _mm_storeu_si128(macropixels + 2 * half + 1, _mm_unpackhi_epi8(luma[half], pairs[half]));
+                } else {
+                    _mm_storeu_si128(macropixels + 2 * half, _mm_unpacklo_epi8(pairs[half], luma[half]));
+                    _mm_storeu_si128(macropixels + 2 * half + 1, _mm_unpackhi_epi8(pairs[half], luma[half]));
+                }
+            }
+        }
+
+        Conversion_RgbToPackedYuvC<Source, Destination, Coefficients>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_RgbToPlanarYuvRows Conversion_Kernels::getRgbToPlanarYuvRowsAvx2(PixelFormat source,
+        PixelFormat destination, ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPlanarYuvRows<RgbToPlanarYuvAvx2>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_RgbToPackedYuvRow Conversion_Kernels::getRgbToPackedYuvRowAvx2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPackedYuvRow<RgbToPackedYuvAvx2>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,220 @@
+#include "conversion_rgb_to_yuv.h"
+
+#include "conversion_cpu_features.h"
+#include "conversion_kernels.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * 16 pixels, as two vectors of 8 pixels per channel in 16-bit lanes.
+ */
+struct PixelsSse2 {
+    __m128i r[2];
+    __m128i g[2];
+    __m128i b[2];
+};
+
+/**
+ * Moves the byte at Position of every 4-byte pixel of a vector into the low byte of its 32-bit lane.
+ */
+template<int Position>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i isolateChannelSse2(__m128i pixels)
+{
+    return _mm_and_si128(_mm_srli_epi32(pixels, 8 * Position), _mm_set1_epi32(0xFF));
+}
+
+/**
+ * Loads 16 pixels, deinterleaving their channels with masks and packs.
+ * SSE2 has no byte shuffle, so 3-byte pixels get spread to 4 bytes the plain way first, through buffer.
+ */
+template<class Source>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void loadPixelsSse2(const uint8_t *source, uint8_t *buffer, PixelsSse2 &pixels)
+{
+    if (Source::BYTES == 3) {
+        for (int i = 0; i < 16; i ++) {
+            buffer[4 * i + 0] = source[3 * i + 0];
+            buffer[4 * i + 1] = source[3 * i + 1];
+            buffer[4 * i + 2] = source[3 * i + 2];
+        }
+
+        source = buffer;
+    }
+
+    const __m128i *vectors = reinterpret_cast<const __m128i *>(source);
+
+    for (int half = 0; half < 2; half ++) {
+        const __m128i low = _mm_loadu_si128(vectors + 2 * half);
+        const __m128i high = _mm_loadu_si128(vectors + 2 * half + 1);
+
+        // 32-bit lanes hold values below 256, so the signed pack can't saturate them
+        pixels.r[half] = _mm_packs_epi32(isolateChannelSse2<Source::R>(low), isolateChannelSse2<Source::R>(high));
+        pixels.g[half] = _mm_packs_epi32(isolateChannelSse2<Source::G>(low), isolateChannelSse2<Source::G>(high));
+        pixels.b[half] = _mm_packs_epi32(isolateChannelSse2<Source::B>(low), isolateChannelSse2<Source::B>(high));
+    }
+}
+
+/**
+ * Computes ((R * r + G * g + B * b + Bias) >> Shift) for 8 values in 16-bit lanes.
+ * pmaddwd multiplies and sums the interleaved channel pairs in 32-bit lanes, the signed pack brings the results back to
+ * 16 bits and the caller's unsigned pack clamps them to bytes, like Conversion_clampToByte().
+ */
+template<int Shift, int Bias, int R, int G, int B>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i weightSse2(__m128i r, __m128i g, __m128i b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgWeights = _mm_setr_epi16(R, G, R, G, R, G, R, G);
+    const __m128i bWeights = _mm_setr_epi16(B, 0, B, 0, B, 0, B, 0);
+    const __m128i bias = _mm_set1_epi32(Bias);
+
+    __m128i low = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(r, g), rgWeights),
+                                _mm_madd_epi16(_mm_unpacklo_epi16(b, zero), bWeights));
+    __m128i high = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(r, g), rgWeights),
+                                 _mm_madd_epi16(_mm_unpackhi_epi16(b, zero), bWeights));
+
+    low = _mm_srai_epi32(_mm_add_epi32(low, bias), Shift);
+    high = _mm_srai_epi32(_mm_add_epi32(high, bias), Shift);
+
+    return _mm_packs_epi32(low, high);
+}
+
+/**
+ * @return 16 luma samples of the pixels.
+ */
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i lumaSse2(const PixelsSse2 &pixels)
+{
+    enum { BIAS = Coefficients::ROUNDING + (Coefficients::Y_OFFSET << Coefficients::SHIFT) };
+
+    __m128i y[2];
+
+    for (int half = 0; half < 2; half ++) {
+        y[half] = weightSse2<Coefficients::SHIFT, BIAS, Coefficients::Y_R, Coefficients::Y_G, Coefficients::Y_B>(
+                      pixels.r[half], pixels.g[half], pixels.b[half]);
+    }
+
+    return _mm_packus_epi16(y[0], y[1]);
+}
+
+/**
+ * Sums the pixels of two rows in 2x2 blocks.
+ * @return 8 sums in 16-bit lanes.
+ */
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i sumBlocksSse2(const __m128i top[2], const __m128i bottom[2])
+{
+    const __m128i ones = _mm_set1_epi16(1);
+
+    return _mm_packs_epi32(_mm_madd_epi16(_mm_add_epi16(top[0], bottom[0]), ones),
+                           _mm_madd_epi16(_mm_add_epi16(top[1], bottom[1]), ones));
+}
+
+/**
+ * @return 8 U samples followed by 8 V samples of the 2x2 blocks of the pixels of two rows.
+ */
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_SSE2 inline __m128i chromaSse2(const PixelsSse2 &top, const PixelsSse2 &bottom)
+{
+    enum {
+        SHIFT = Coefficients::SHIFT + 2,
+        BIAS = (1 << (SHIFT - 1)) + (128 << SHIFT)
+    };
+
+    const __m128i r = sumBlocksSse2(top.r, bottom.r);
+    const __m128i g = sumBlocksSse2(top.g, bottom.g);
+    const __m128i b = sumBlocksSse2(top.b, bottom.b);
+
+    return _mm_packus_epi16(weightSse2<SHIFT, BIAS, Coefficients::U_R, Coefficients::U_G, Coefficients::U_B>(r, g, b),
+                            weightSse2<SHIFT, BIAS, Coefficients::V_R, Coefficients::V_G, Coefficients::V_B>(r, g, b));
+}
+
+template<class Source, class Chroma, class Coefficients>
+struct RgbToPlanarYuvSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source0, const uint8_t *source1, uint8_t *luma0,
+            uint8_t *luma1, uint8_t *u, uint8_t *v, size_t width)
+    {
+        const uint8_t *second = source1 ? source1 : source0;
+        uint8_t buffer[64];
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            PixelsSse2 top;
+            PixelsSse2 bottom;
+            loadPixelsSse2<Source>(source0 + x * Source::BYTES, buffer, top);
+            loadPixelsSse2<Source>(second + x * Source::BYTES, buffer, bottom);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(luma0 + x), lumaSse2<Coefficients>(top));
+
+            if (luma1) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(luma1 + x), lumaSse2<Coefficients>(bottom));
+            }
+
+            const __m128i chroma = chromaSse2<Coefficients>(top, bottom);
+            const __m128i vSamples = _mm_srli_si128(chroma, 8);
+
+            if (Chroma::STEP == 1) {
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), chroma);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), vSamples);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x), _mm_unpacklo_epi8(chroma, vSamples));
+            }
+        }
+
+        Conversion_RgbToPlanarYuvC<Source, Chroma, Coefficients>::convert(source0, source1, luma0, luma1, u, v, x,
+                width);
+    }
+};
+
+template<class Source, class Destination, class Coefficients>
+struct RgbToPackedYuvSse2 {
+    WEBCAM_CAPTURE_TARGET_SSE2 static void row(const uint8_t *source, uint8_t *destination, size_t width)
+    {
+        uint8_t buffer[64];
+        size_t x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            PixelsSse2 pixels;
+            loadPixelsSse2<Source>(source + x * Source::BYTES, buffer, pixels);
+
+            // a pixel pair summed with itself is the sum of 4 pixels the chroma math takes
+            const __m128i y = lumaSse2<Coefficients>(pixels);
+            const __m128i chroma = chromaSse2<Coefficients>(pixels, pixels);
+            const __m128i vSamples = _mm_srli_si128(chroma, 8);
+            const __m128i pairs = Destination::U < Destination::V ? _mm_unpacklo_epi8(chroma, vSamples) :
+                                  _mm_unpacklo_epi8(vSamples, chroma);
+
+            __m128i *macropixels = reinterpret_cast<__m128i *>(destination + x * 2);
+
+            if (Destination::Y0 == 0) {
+                _mm_storeu_si128(macropixels, _mm_unpacklo_epi8(y, pairs));
+                _mm_storeu_si128(macropixels + 1, _mm_unpackhi_epi8(y, pairs));
+            } else {
+                _mm_storeu_si128(macropixels, _mm_unpacklo_epi8(pairs, y));
+                _mm_storeu_si128(macropixels + 1, _mm_unpackhi_epi8(pairs, y));
+            }
+        }
+
+        Conversion_RgbToPackedYuvC<Source, Destination, Coefficients>::convert(source, destination, x, width);
+    }
+};
+
+} // namespace
+
+Conversion_RgbToPlanarYuvRows Conversion_Kernels::getRgbToPlanarYuvRowsSse2(PixelFormat source,
+        PixelFormat destination, ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPlanarYuvRows<RgbToPlanarYuvSse2>(source, destination, colorSpace, colorRange);
+}
+
+Conversion_RgbToPackedYuvRow Conversion_Kernels::getRgbToPackedYuvRowSse2(PixelFormat source, PixelFormat destination,
+        ColorSpace colorSpace, ColorRange colorRange)
+{
+    return Conversion_selectRgbToPackedYuvRow<RgbToPackedYuvSse2>(source, destination, colorSpace, colorRange);
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
@@ -0,0 +1,109 @@
+#include "conversion_scale.h"
+
+#include <algorithm>
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Source interval [first, last) covered by scaled sample position out of scaledSize.
+ * Never empty, so upscaling picks the nearest sample.
+ */
+inline void getBox(size_t position, size_t size, size_t scaledSize, size_t &first, size_t &last)
+{
+    first = static_cast<size_t>(static_cast<uint64_t>(position) * size / scaledSize);
+    last = static_cast<size_t>(static_cast<uint64_t>(position + 1) * size / scaledSize);
+    last = std::max(last, first + 1);
+}
+
+/**
+ * Source position of the center of scaled sample position, as the index of the sample before it and the
+ * 8-bit fraction of the distance to the next one.
+ */
+inline void getCenter(size_t position, size_t size, size_t scaledSize, size_t &index, unsigned &fraction)
+{
+    // (position + 0.5) * size / scaledSize - 0.5 in 24.8 fixed point
+    const int64_t center = static_cast<int64_t>((2 * static_cast<uint64_t>(position) + 1) * size * 256 /
+                                                (2 * scaledSize)) - 128;
+
+    if (center <= 0) {
+        index = 0;
+        fraction = 0;
+    } else if (static_cast<uint64_t>(center) >= (size - 1) * 256) {
+        index = size - 1;
+        fraction = 0;
+    } else {
+        index = static_cast<size_t>(center >> 8);
+        fraction = static_cast<unsigned>(center & 0xFF);
+    }
+}
+
+} // namespace
+
+void Conversion_Scaler::scaleRowBox(const Conversion_SamplePlane &plane, size_t width, size_t height, size_t row,
+                                    size_t begin, size_t count, uint8_t *destination)
+{
+    size_t firstRow;
+    size_t lastRow;
+    getBox(row, plane.height, height, firstRow, lastRow);
+
+    for (size_t i = 0; i < count; i ++) {
+        size_t firstColumn;
+        size_t lastColumn;
+        getBox(begin + i, plane.width, width, firstColumn, lastColumn);
+
+        unsigned sum = 0;
+
+        for (size_t y = firstRow; y < lastRow; y ++) {
+            const uint8_t *samples = plane.data + y * plane.stride;
+
+            for (size_t x = firstColumn; x < lastColumn; x ++) {
+                sum += samples[x * plane.step];
+            }
+        }
+
+        const unsigned area = static_cast<unsigned>((lastRow - firstRow) * (lastColumn - firstColumn));
+        destination[i] = static_cast<uint8_t>((sum + area / 2) / area);
+    }
+}
+
+void Conversion_Scaler::scaleRowBilinear(const Conversion_SamplePlane &plane, size_t width, size_t height,
+        size_t row, size_t begin, size_t count, uint8_t *destination)
+{
+    size_t y;
+    unsigned yFraction;
+    getCenter(row, plane.height, height, y, yFraction);
+
+    const uint8_t *top = plane.data + y * plane.stride;
+    const uint8_t *bottom = yFraction ? top + plane.stride : top;
+
+    for (size_t i = 0; i < count; i ++) {
+        size_t x;
+        unsigned xFraction;
+        getCenter(begin + i, plane.width, width, x, xFraction);
+
+        const size_t left = x * plane.step;
+        const size_t right = xFraction ? left + plane.step : left;
+
+        const unsigned upper = top[left] * (256 - xFraction) + top[right] * xFraction;
+        const unsigned lower = bottom[left] * (256 - xFraction) + bottom[right] * xFraction;
+
+        destination[i] = static_cast<uint8_t>((upper * (256 - yFraction) + lower * yFraction + (1 << 15)) >> 16);
+    }
+}
+
+void Conversion_Scaler::scaleRowNearest(const Conversion_SamplePlane &plane, size_t width, size_t height,
+        size_t row, size_t begin, size_t count, uint8_t *destination)
+{
+    // source samples the centers of the scaled ones fall in
+    const size_t y = static_cast<size_t>((2 * static_cast<uint64_t>(row) + 1) * plane.height / (2 * height));
+    const uint8_t *samples = plane.data + y * plane.stride;
+
+    for (size_t i = 0; i < count; i ++) {
+        const size_t x = static_cast<size_t>((2 * static_cast<uint64_t>(begin + i) + 1) * plane.width / (2 * width));
+        destination[i] = samples[x * plane.step];
+    }
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,63 @@
+#ifndef CONVERSION_SCALE_H
+#define CONVERSION_SCALE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * One kind of samples (Y, U or V) of a frame, wherever and however interleaved they are stored.
+ * Sample (x, y) is at data[y * stride + x * step].
+ */
+struct Conversion_SamplePlane {
+    const uint8_t *data;
+    size_t stride;
+    size_t step;
+    size_t width;
+    size_t height;
+};
+
+/**
+ * Computes a row of a sample plane scaled to width x height samples.
+ * @param plane Plane to scale.
+ * @param width Width of the scaled plane.
+ * @param height Height of the scaled plane.
+ * @param row Row of the scaled plane to compute.
+ * @param begin First sample of the row to compute.
+ * @param count Number of samples to compute.
+ * @param destination Receives count samples.
+ */
+typedef void (*Conversion_ScaleRow)(const Conversion_SamplePlane &plane, size_t width, size_t height, size_t row,
+                                    size_t begin, size_t count, uint8_t *destination);
+
+/**
+ * Scalers that work on single rows, so they can be fused with the conversion of the rows they produce.
+ */
+class Conversion_Scaler
+{
+public:
+    Conversion_Scaler() = delete;
+
+    /**
+     * Averages the area of the plane each scaled sample covers. Every source sample is read once when downscaling.
+     */
+    static void scaleRowBox(const Conversion_SamplePlane &plane, size_t width, size_t height, size_t row,
+                            size_t begin, size_t count, uint8_t *destination);
+
+    /**
+     * Interpolates between the 4 source samples closest to the center of each scaled sample.
+     */
+    static void scaleRowBilinear(const Conversion_SamplePlane &plane, size_t width, size_t height, size_t row,
+                                 size_t begin, size_t count, uint8_t *destination);
+
+    /**
+     * Takes the source sample closest to the center of each scaled sample.
+     */
+    static void scaleRowNearest(const Conversion_SamplePlane &plane, size_t width, size_t height, size_t row,
+                                size_t begin, size_t count, uint8_t *destination);
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_SCALE_H
@@ -0,0 +1,115 @@
+#ifndef CONVERSION_SIMD_AVX2_H
+#define CONVERSION_SIMD_AVX2_H
+
+#include "conversion_cpu_features.h"
+#include "conversion_simd_sse2.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * AVX2 version of Conversion_yuvToRgbSse2(), 16 pixels at a time.
+ */
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void Conversion_yuvToRgbAvx2(__m256i y, __m256i u, __m256i v,
+        __m256i &r, __m256i &g, __m256i &b)
+{
+    const __m256i luma = _mm256_mullo_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(Coefficients::Y_OFFSET)),
+                                            _mm256_set1_epi16(Coefficients::Y_GAIN));
+    const __m256i du = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+    const __m256i dv = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+    const __m256i rounding = _mm256_set1_epi16(Coefficients::ROUNDING);
+
+    r = _mm256_adds_epi16(luma, _mm256_mullo_epi16(dv, _mm256_set1_epi16(Coefficients::V_TO_R)));
+    g = _mm256_subs_epi16(luma, _mm256_mullo_epi16(du, _mm256_set1_epi16(Coefficients::U_TO_G)));
+    g = _mm256_subs_epi16(g, _mm256_mullo_epi16(dv, _mm256_set1_epi16(Coefficients::V_TO_G)));
+    b = _mm256_adds_epi16(luma, _mm256_mullo_epi16(du, _mm256_set1_epi16(Coefficients::U_TO_B)));
+
+    r = _mm256_srai_epi16(_mm256_adds_epi16(r, rounding), Coefficients::SHIFT);
+    g = _mm256_srai_epi16(_mm256_adds_epi16(g, rounding), Coefficients::SHIFT);
+    b = _mm256_srai_epi16(_mm256_adds_epi16(b, rounding), Coefficients::SHIFT);
+}
+
+/**
+ * Saturates two vectors of 16 consecutive 16-bit values into 32 consecutive bytes.
+ * _mm256_packus_epi16 works per 128-bit lane, the permute puts the 64-bit quarters back in order.
+ */
+WEBCAM_CAPTURE_TARGET_AVX2 inline __m256i Conversion_packBytesAvx2(__m256i first, __m256i second)
+{
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/**
+ * Number of pixels past the 32 stored by Conversion_storeRgbAvx2() and Conversion_storeRgbaAvx2() the row has to
+ * have room for.
+ * 3-byte layouts are written with overlapping 16-byte stores, the last of which spills 4 bytes.
+ */
+template<class Layout>
+struct Conversion_StoreRgbAvx2Overrun {
+    enum { PIXELS = Layout::BYTES == 3 ? 2 : 0 };
+};
+
+/**
+ * Stores 32 pixels given as one byte vector per channel. a is ignored by layouts without alpha.
+ */
+template<class Layout>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void Conversion_storeRgbaAvx2(uint8_t *destination, __m256i r, __m256i g, __m256i b,
+        __m256i a)
+{
+    const __m256i c0 = Conversion_channelAt<Layout, 0>(r, g, b, a);
+    const __m256i c1 = Conversion_channelAt<Layout, 1>(r, g, b, a);
+    const __m256i c2 = Conversion_channelAt<Layout, 2>(r, g, b, a);
+    const __m256i c3 = Conversion_channelAt<Layout, 3>(r, g, b, a);
+
+    // unpacking works per 128-bit lane: the low halves get pixels 0-7 and 16-23, the high halves 8-15 and 24-31
+    const __m256i c01Low = _mm256_unpacklo_epi8(c0, c1);
+    const __m256i c01High = _mm256_unpackhi_epi8(c0, c1);
+    const __m256i c23Low = _mm256_unpacklo_epi8(c2, c3);
+    const __m256i c23High = _mm256_unpackhi_epi8(c2, c3);
+
+    const __m256i p0 = _mm256_unpacklo_epi16(c01Low, c23Low);    // 0-3, 16-19
+    const __m256i p1 = _mm256_unpackhi_epi16(c01Low, c23Low);    // 4-7, 20-23
+    const __m256i p2 = _mm256_unpacklo_epi16(c01High, c23High);  // 8-11, 24-27
+    const __m256i p3 = _mm256_unpackhi_epi16(c01High, c23High);  // 12-15, 28-31
+
+    __m256i pixels[4];
+    pixels[0] = _mm256_permute2x128_si256(p0, p1, 0x20);
+    pixels[1] = _mm256_permute2x128_si256(p2, p3, 0x20);
+    pixels[2] = _mm256_permute2x128_si256(p0, p1, 0x31);
+    pixels[3] = _mm256_permute2x128_si256(p2, p3, 0x31);
+
+    if (Layout::BYTES == 4) {
+        for (int i = 0; i < 4; i ++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + 32 * i), pixels[i]);
+        }
+    } else {
+        const __m256i dropFourth = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+        for (int i = 0; i < 4; i ++) {
+            const __m256i packed = _mm256_shuffle_epi8(pixels[i], dropFourth);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 24 * i), _mm256_castsi256_si128(packed));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 24 * i + 12), _mm256_extracti128_si256(packed, 1));
+        }
+    }
+}
+
+/**
+ * Stores 32 opaque pixels given as one byte vector per channel.
+ */
+template<class Layout>
+WEBCAM_CAPTURE_TARGET_AVX2 inline void Conversion_storeRgbAvx2(uint8_t *destination, __m256i r, __m256i g, __m256i b)
+{
+    Conversion_storeRgbaAvx2<Layout>(destination, r, g, b, _mm256_set1_epi8(-1));
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
+
+#endif // CONVERSION_SIMD_AVX2_H
@@ -0,0 +1,113 @@
+#ifndef CONVERSION_SIMD_SSE2_H
+#define CONVERSION_SIMD_SSE2_H
+
+#include "conversion_cpu_features.h"
+
+#ifdef WEBCAM_CAPTURE_X86
+
+#include <emmintrin.h>
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Converts 8 pixels held in signed 16-bit lanes, with chroma already replicated for every pixel.
+ * Results are 16-bit lanes to be saturated down to bytes by the caller.
+ */
+template<class Coefficients>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void Conversion_yuvToRgbSse2(__m128i y, __m128i u, __m128i v,
+        __m128i &r, __m128i &g, __m128i &b)
+{
+    const __m128i luma = _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(Coefficients::Y_OFFSET)),
+                                         _mm_set1_epi16(Coefficients::Y_GAIN));
+    const __m128i du = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i dv = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i rounding = _mm_set1_epi16(Coefficients::ROUNDING);
+
+    r = _mm_adds_epi16(luma, _mm_mullo_epi16(dv, _mm_set1_epi16(Coefficients::V_TO_R)));
+    g = _mm_subs_epi16(luma, _mm_mullo_epi16(du, _mm_set1_epi16(Coefficients::U_TO_G)));
+    g = _mm_subs_epi16(g, _mm_mullo_epi16(dv, _mm_set1_epi16(Coefficients::V_TO_G)));
+    b = _mm_adds_epi16(luma, _mm_mullo_epi16(du, _mm_set1_epi16(Coefficients::U_TO_B)));
+
+    r = _mm_srai_epi16(_mm_adds_epi16(r, rounding), Coefficients::SHIFT);
+    g = _mm_srai_epi16(_mm_adds_epi16(g, rounding), Coefficients::SHIFT);
+    b = _mm_srai_epi16(_mm_adds_epi16(b, rounding), Coefficients::SHIFT);
+}
+
+/**
+ * Picks the channel that goes into byte Position of a pixel of the given layout.
+ * Resolved at compile time, positions not used by the layout get alpha.
+ */
+template<class Layout, int Position, typename Vector>
+inline const Vector &Conversion_channelAt(const Vector &r, const Vector &g, const Vector &b, const Vector &a)
+{
+    return Layout::R == Position ? r : (Layout::G == Position ? g : (Layout::B == Position ? b : a));
+}
+
+/**
+ * Stores 16 pixels given as one byte vector per channel. a is ignored by layouts without alpha.
+ */
+template<class Layout>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void Conversion_storeRgbaSse2(uint8_t *destination, __m128i r, __m128i g, __m128i b,
+        __m128i a)
+{
+    const __m128i c0 = Conversion_channelAt<Layout, 0>(r, g, b, a);
+    const __m128i c1 = Conversion_channelAt<Layout, 1>(r, g, b, a);
+    const __m128i c2 = Conversion_channelAt<Layout, 2>(r, g, b, a);
+    const __m128i c3 = Conversion_channelAt<Layout, 3>(r, g, b, a);
+
+    const __m128i c01Low = _mm_unpacklo_epi8(c0, c1);
+    const __m128i c01High = _mm_unpackhi_epi8(c0, c1);
+    const __m128i c23Low = _mm_unpacklo_epi8(c2, c3);
+    const __m128i c23High = _mm_unpackhi_epi8(c2, c3);
+
+    __m128i pixels[4];
+    pixels[0] = _mm_unpacklo_epi16(c01Low, c23Low);
+    pixels[1] = _mm_unpackhi_epi16(c01Low, c23Low);
+    pixels[2] = _mm_unpacklo_epi16(c01High, c23High);
+    pixels[3] = _mm_unpackhi_epi16(c01High, c23High);
+
+    if (Layout::BYTES == 4) {
+        for (int i = 0; i < 4; i ++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 16 * i), pixels[i]);
+        }
+    } else {
+        // SSE2 has no byte shuffle, so every fourth byte is dropped with masks and shifts: each 64-bit half packs its
+        // two pixels into 6 bytes, the upper half moves next to the lower one, and the 12 bytes of each vector are
+        // spliced into three full stores
+        const __m128i firstPixel = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+        const int second = static_cast<int>(0xFF000000);
+        const __m128i secondPixel = _mm_set_epi32(0x0000FFFF, second, 0x0000FFFF, second);
+        const __m128i lowHalf = _mm_set_epi32(0, 0, -1, -1);
+
+        __m128i packed[4];
+
+        for (int i = 0; i < 4; i ++) {
+            const __m128i halves = _mm_or_si128(_mm_and_si128(pixels[i], firstPixel),
+                                                _mm_and_si128(_mm_srli_epi64(pixels[i], 8), secondPixel));
+            const __m128i upper = _mm_srli_si128(_mm_andnot_si128(lowHalf, halves), 2);
+            packed[i] = _mm_or_si128(_mm_and_si128(halves, lowHalf), upper);
+        }
+
+        __m128i *out = reinterpret_cast<__m128i *>(destination);
+        _mm_storeu_si128(out, _mm_or_si128(packed[0], _mm_slli_si128(packed[1], 12)));
+        _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(packed[1], 4), _mm_slli_si128(packed[2], 8)));
+        _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(packed[2], 8), _mm_slli_si128(packed[3], 4)));
+    }
+}
+
+/**
+ * Stores 16 opaque pixels given as one byte vector per channel.
+ */
+template<class Layout>
+WEBCAM_CAPTURE_TARGET_SSE2 inline void Conversion_storeRgbSse2(uint8_t *destination, __m128i r, __m128i g, __m128i b)
+{
+    Conversion_storeRgbaSse2<Layout>(destination, r, g, b, _mm_set1_epi8(-1));
+}
+
+} // namespace webcam_capture
+
+#endif // WEBCAM_CAPTURE_X86
+
+#endif // CONVERSION_SIMD_SSE2_H
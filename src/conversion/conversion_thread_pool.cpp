@@ -0,0 +1,167 @@
+#include "conversion_thread_pool.h"
+
+#include <algorithm>
+
+namespace webcam_capture {
+
+namespace {
+
+// fewer rows than that per stripe aren't worth waking a thread up for
+const size_t MIN_STRIPE_ROWS = 16;
+
+} // namespace
+
+Conversion_ThreadPool::Conversion_ThreadPool() :
+    threadCount(1),
+    stopping(false),
+    generation(0),
+    task(nullptr),
+    taskCount(0),
+    busyWorkers(0),
+    nextTask(0)
+{
+}
+
+Conversion_ThreadPool::~Conversion_ThreadPool()
+{
+    stopWorkers();
+}
+
+Conversion_ThreadPool &Conversion_ThreadPool::getInstance()
+{
+    // intentionally leaked, joining threads while the library is being unloaded can deadlock on Windows
+    static Conversion_ThreadPool *instance = new Conversion_ThreadPool();
+
+    return *instance;
+}
+
+void Conversion_ThreadPool::setThreadCount(size_t count)
+{
+    if (count == 0) {
+        count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::lock_guard<std::mutex> runLock(runMutex);
+
+    if (count == threadCount) {
+        return;
+    }
+
+    stopWorkers();
+    threadCount = count;
+    startWorkers(count - 1);
+}
+
+size_t Conversion_ThreadPool::getThreadCount()
+{
+    return threadCount.load();
+}
+
+void Conversion_ThreadPool::run(size_t taskCount, const Task &task)
+{
+    // the workers are either not needed or busy with the run of another caller, which this one doesn't wait for
+    std::unique_lock<std::mutex> runLock(runMutex, std::defer_lock);
+
+    if (taskCount < 2 || threadCount.load() < 2 || !runLock.try_lock() || workers.empty()) {
+        for (size_t i = 0; i < taskCount; i ++) {
+            task(i);
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->taskCount = taskCount;
+        nextTask = 0;
+        busyWorkers = workers.size();
+        generation ++;
+    }
+
+    wakeUp.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] {
+        return busyWorkers == 0;
+    });
+    this->task = nullptr;
+}
+
+void Conversion_ThreadPool::runStripes(size_t height, size_t alignment, const StripeTask &task)
+{
+    const size_t maxStripes = std::max<size_t>(height / MIN_STRIPE_ROWS, 1);
+    const size_t stripeCount = std::min(getThreadCount(), maxStripes);
+    const size_t stripeRows = ((height + stripeCount - 1) / stripeCount + alignment - 1) / alignment * alignment;
+
+    run(stripeCount, [&](size_t stripe) {
+        const size_t rowBegin = stripe * stripeRows;
+        const size_t rowEnd = std::min(rowBegin + stripeRows, height);
+
+        if (rowBegin < rowEnd) {
+            task(rowBegin, rowEnd);
+        }
+    });
+}
+
+void Conversion_ThreadPool::startWorkers(size_t count)
+{
+    stopping = false;
+
+    for (size_t i = 0; i < count; i ++) {
+        // pass the generation explicitly, a worker that gets scheduled late mustn't miss the run started meanwhile
+        workers.push_back(std::thread(&Conversion_ThreadPool::workerLoop, this, generation));
+    }
+}
+
+void Conversion_ThreadPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i ++) {
+        workers[i].join();
+    }
+
+    workers.clear();
+}
+
+void Conversion_ThreadPool::workerLoop(unsigned long seenGeneration)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        wakeUp.wait(lock, [&] {
+            return stopping || generation != seenGeneration;
+        });
+
+        if (stopping) {
+            return;
+        }
+
+        seenGeneration = generation;
+
+        lock.unlock();
+        runTasks();
+        lock.lock();
+
+        if (-- busyWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void Conversion_ThreadPool::runTasks()
+{
+    for (size_t i = nextTask ++; i < taskCount; i = nextTask ++) {
+        (*task)(i);
+    }
+}
+
+} // namespace webcam_capture
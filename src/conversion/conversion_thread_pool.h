@@ -0,0 +1,81 @@
+#ifndef CONVERSION_THREAD_POOL_H
+#define CONVERSION_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace webcam_capture {
+
+/**
+ * Persistent pool of worker threads shared by all conversions.
+ * Work is split into tasks that the workers and the calling thread pick up one by one, so the caller always helps.
+ * The workers take one run at a time. Runs of a single thread or task, and runs that come in while the workers are
+ * busy with another one, are done on the calling thread without waiting, so that cameras converting on threads of their
+ * own never queue behind each other.
+ */
+class Conversion_ThreadPool
+{
+public:
+    typedef std::function<void(size_t task)> Task;
+    typedef std::function<void(size_t rowBegin, size_t rowEnd)> StripeTask;
+
+    /**
+     * @return The pool used by the library. It's never destroyed, its idle workers simply end with the process.
+     */
+    static Conversion_ThreadPool &getInstance();
+
+    /**
+     * Sets the number of threads a run uses, including the calling one. Idle workers are restarted to match it.
+     * @param count Number of threads, 0 picks one thread per CPU core.
+     */
+    void setThreadCount(size_t count);
+
+    size_t getThreadCount();
+
+    /**
+     * Runs task for every index in [0, taskCount) and returns once all of them are done.
+     */
+    void run(size_t taskCount, const Task &task);
+
+    /**
+     * Splits height rows into horizontal stripes, one per thread, and runs task on each of them.
+     * Stripes start at multiples of alignment, so subsampled chroma rows never get split between two stripes.
+     * Small frames are split into fewer stripes, as waking threads up costs more than converting a few rows.
+     */
+    void runStripes(size_t height, size_t alignment, const StripeTask &task);
+
+private:
+    Conversion_ThreadPool();
+    ~Conversion_ThreadPool();
+
+    void startWorkers(size_t count);
+    void stopWorkers();
+    void workerLoop(unsigned long seenGeneration);
+    void runTasks();
+
+    // serializes the runs of the workers and thread count changes
+    std::mutex runMutex;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> threadCount; // read without runMutex by the runs that don't need the workers
+    bool stopping;
+
+    // the current run, guarded by mutex
+    unsigned long generation;
+    const Task *task;
+    size_t taskCount;
+    size_t busyWorkers;
+    std::atomic<size_t> nextTask;
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_THREAD_POOL_H
@@ -0,0 +1,78 @@
+#include "conversion_transform.h"
+
+#include <cstring>
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Copies the pixels of a tile one at a time, with Bytes known at compile time so that the copies become single
+ * loads and stores.
+ */
+template<size_t Bytes>
+void writeTileOf(const uint8_t *tile, size_t tileStride, size_t rowBegin, size_t rows, size_t columnBegin,
+                 size_t columns, const Conversion_Transform &transform, uint8_t *destination,
+                 size_t destinationStride, size_t width, size_t height)
+{
+    if (!transform.transpose) {
+        const ptrdiff_t step = transform.mirrorX ? -static_cast<ptrdiff_t>(Bytes) : static_cast<ptrdiff_t>(Bytes);
+        const size_t firstColumn = transform.mirrorX ? width - 1 - columnBegin : columnBegin;
+
+        for (size_t y = 0; y < rows; y ++) {
+            const size_t row = transform.flipY ? height - 1 - (rowBegin + y) : rowBegin + y;
+            const uint8_t *pixel = tile + y * tileStride;
+            uint8_t *target = destination + row * destinationStride + firstColumn * Bytes;
+
+            for (size_t x = 0; x < columns; x ++, pixel += Bytes, target += step) {
+                memcpy(target, pixel, Bytes);
+            }
+        }
+
+        return;
+    }
+
+    // every column of the tile becomes a run of rows pixels of a destination row
+    const ptrdiff_t step = transform.flipY ? -static_cast<ptrdiff_t>(Bytes) : static_cast<ptrdiff_t>(Bytes);
+    const size_t firstColumn = transform.flipY ? height - 1 - rowBegin : rowBegin;
+
+    for (size_t x = 0; x < columns; x ++) {
+        const size_t row = transform.mirrorX ? width - 1 - (columnBegin + x) : columnBegin + x;
+        const uint8_t *pixel = tile + x * Bytes;
+        uint8_t *target = destination + row * destinationStride + firstColumn * Bytes;
+
+        for (size_t y = 0; y < rows; y ++, pixel += tileStride, target += step) {
+            memcpy(target, pixel, Bytes);
+        }
+    }
+}
+
+} // namespace
+
+void Conversion_Transformer::writeTile(const uint8_t *tile, size_t tileStride, size_t pixelBytes, size_t rowBegin,
+                                       size_t rows, size_t columnBegin, size_t columns,
+                                       const Conversion_Transform &transform, uint8_t *destination,
+                                       size_t destinationStride, size_t width, size_t height)
+{
+    switch (pixelBytes) {
+        case 1:
+            writeTileOf<1>(tile, tileStride, rowBegin, rows, columnBegin, columns, transform, destination,
+                           destinationStride, width, height);
+            break;
+
+        case 3:
+            writeTileOf<3>(tile, tileStride, rowBegin, rows, columnBegin, columns, transform, destination,
+                           destinationStride, width, height);
+            break;
+
+        case 4:
+            writeTileOf<4>(tile, tileStride, rowBegin, rows, columnBegin, columns, transform, destination,
+                           destinationStride, width, height);
+            break;
+
+        default:
+            break;
+    }
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,70 @@
+#ifndef CONVERSION_TRANSFORM_H
+#define CONVERSION_TRANSFORM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Flips and rotations as the steps that map source pixel (x, y) of a width x height frame onto the destination:
+ * y becomes height - 1 - y if flipY is set, x becomes width - 1 - x if mirrorX is set, and x and y get swapped if
+ * transpose is set. The 8 combinations cover all flips and rotations by multiples of 90 degrees.
+ */
+struct Conversion_Transform {
+    bool flipY;
+    bool mirrorX;
+    bool transpose;
+};
+
+/**
+ * Rows of a destination addressed with a signed stride, so that vertically flipped frames can be written bottom to
+ * top without any extra work.
+ */
+struct Conversion_RowTarget {
+    uint8_t *first; // first pixel written of row firstRow
+    ptrdiff_t stride;
+    size_t firstRow;
+
+    uint8_t *row(size_t y) const
+    {
+        return first + (static_cast<ptrdiff_t>(y) - static_cast<ptrdiff_t>(firstRow)) * stride;
+    }
+};
+
+/**
+ * Writes tiles of converted pixels mirrored or transposed into the destination.
+ * Conversions that mirror or rotate convert a tile of the frame at a time into a buffer small enough to stay in the
+ * cache and write it transformed from there, so the frame still takes a single pass through memory.
+ */
+class Conversion_Transformer
+{
+public:
+    Conversion_Transformer() = delete;
+
+    enum {
+        // 16 destination pixels per row of a transposed tile fill a cache line of 4-byte pixels
+        TILE_ROWS = 16,
+        // a multiple of the SIMD kernels' widths and of v210's 6 pixel groups
+        TILE_COLUMNS = 384,
+        MAX_PIXEL_BYTES = 4
+    };
+
+    /**
+     * @param tile First pixel of the tile, holding pixels [columnBegin, columnBegin + columns) of rows
+     * [rowBegin, rowBegin + rows) of the source.
+     * @param tileStride Distance between the rows of the tile in bytes.
+     * @param pixelBytes Size of a pixel, 1, 3 or 4.
+     * @param destination First byte of the destination.
+     * @param destinationStride Distance between the rows of the destination in bytes.
+     * @param width Width of the source.
+     * @param height Height of the source.
+     */
+    static void writeTile(const uint8_t *tile, size_t tileStride, size_t pixelBytes, size_t rowBegin, size_t rows,
+                          size_t columnBegin, size_t columns, const Conversion_Transform &transform,
+                          uint8_t *destination, size_t destinationStride, size_t width, size_t height);
+};
+
+} // namespace webcam_capture
+
+#endif // CONVERSION_TRANSFORM_H
@@ -1,5 +1,6 @@
 #include "direct_show_camera.h"
 #include "direct_show_callback.h"
+#include "../winapi_shared/winapi_shared_frame_layout.h"
 
 
 namespace webcam_capture {
@@ -12,9 +13,21 @@ DirectShow_Callback::DirectShow_Callback(DirectShow_Camera *cam) :
 STDMETHODIMP DirectShow_Callback::SampleCB(double SampleTime, IMediaSample *pSample) {
     BYTE            *sampleBuffer;
     pSample->GetPointer(&sampleBuffer);
-    ds_camera->frame.bytes = pSample->GetActualDataLength();
-    ds_camera->frame.plane[0] = sampleBuffer;
+
+    // DirectShow samples are laid out like bitmaps, with no stride of their own
+    if (!WinapiShared_FrameLayout::setLayout(ds_camera->frame, sampleBuffer, pSample->GetActualDataLength(), 0)) {
+        DEBUG_PRINT("Error: The sample is too short for the frame.");
+        return S_OK;
+    }
+
+    // the sample stays out of the allocator's pool for as long as a FrameRef holds the frame
+    pSample->AddRef();
+    ds_camera->frame.owner = std::shared_ptr<void>(pSample, [](void *sample) {
+        static_cast<IMediaSample *>(sample)->Release();
+    });
+
     ds_camera->cb_frame(ds_camera->frame);
+    ds_camera->frame.owner.reset();
 
     return S_OK;
 }
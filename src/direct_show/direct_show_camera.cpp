@@ -1,5 +1,6 @@
 #include "direct_show_camera.h"
 #include "../capability_tree_builder.h"
+#include "../software_proc_amp.h"
 
 #include "../winapi_shared/winapi_shared_unique_id.h"
 #include "direct_show_utils.h"
@@ -22,6 +23,7 @@ DirectShow_Camera::DirectShow_Camera(std::shared_ptr<void> mfDeinitializer,
         const CameraInformation &information)
     : information(information)
     , mfDeinitializer(mfDeinitializer)
+    , frame()
     , state(CA_STATE_NONE)
     , ds_callback(NULL)
 {
@@ -48,7 +50,10 @@ int DirectShow_Camera::start(PixelFormat pixelFormat,
                               int height, float fps,
                               FrameCallback cb,
                               PixelFormat decodeFormat,
-                              PixelFormat decompressFormat)
+                              PixelFormat decompressFormat,
+                              DecompressionScale decompressScale,
+                              FrameDelivery delivery,
+                              BackpressurePolicy backpressure)
 {
     if (!cb) {
         DEBUG_PRINT("Error: The callback function is empty. Capturing was not started.");
@@ -60,9 +65,6 @@ int DirectShow_Camera::start(PixelFormat pixelFormat,
         return -2;      //TODO Err code
     }
 
-    cb_frame = cb;
-
-
     frame.width[0] = width;
     frame.height[0] = height;
     frame.pixelFormat = pixelFormat;
@@ -91,7 +93,7 @@ int DirectShow_Camera::start(PixelFormat pixelFormat,
     }
 
     /// 4 step Set capabilities
-    int setCapRes = setCapabilities(pVCap, pixelFormat, width, height, fps);
+    int setCapRes = setCapabilities(pVCap, pixelFormat, width, height, fps, frame.orientation);
     if ( setCapRes < 0 ) {
         pBuild->Release();
         pVCap->Release();
@@ -254,6 +256,27 @@ int DirectShow_Camera::start(PixelFormat pixelFormat,
         return -99;
     }
 
+    // DirectShow delivers frames as they are, so compressed ones get decompressed and converted in software, and the
+    // properties the device has no controls for are applied in software too. The pipeline starts once the graph is
+    // built, so that none of the failures above leaves its queue's thread running
+    const int result = pipeline.start(cb, pixelFormat, width, height, decompressFormat, decompressScale, decodeFormat,
+                                      delivery, backpressure);
+
+    if (result < 0) {
+        pNullRenderer->Release();
+        pGrabberCB->Release();
+        pGrabberFilter->Release();
+        pEvent->Release();
+        pControl->Release();
+        pGraph->Release();
+        pBuild->Release();
+        pVCap->Release();
+        pVideoSel->Release();
+        return result;
+    }
+
+    cb_frame = cb;
+
     pControl->Run();    
 
     state |= CA_STATE_CAPTURING;
@@ -271,6 +294,9 @@ int DirectShow_Camera::stop()
 
     pControl->Stop();
 
+    // frames still queued are dropped, so that the callback isn't called once stop() returned
+    pipeline.stop();
+
     pNullRenderer->Release();
     pGrabberCB->Release();
     pGrabberFilter->Release();
@@ -286,8 +312,12 @@ int DirectShow_Camera::stop()
 
 std::unique_ptr<Frame> DirectShow_Camera::captureFrame()
 {
-    //TODO to realise method
-    return nullptr;
+    return pipeline.captureFrame();
+}
+
+FrameDropStatistics DirectShow_Camera::getDropStatistics()
+{
+    return pipeline.getDropStatistics();
 }
 
 bool DirectShow_Camera::enumerateCapabilities(IBaseFilter *videoCaptureFilter, EnumEntryCallback enumEntryCallback)
@@ -444,12 +474,12 @@ bool DirectShow_Camera::getPropertyRange(VideoProperty property, VideoPropertyRa
         return false;
     }
 
+    // devices without image controls get them in software
     hr = pBaseFilter->QueryInterface(IID_IAMVideoProcAmp, (void**)&pProcAmp);
     if (FAILED(hr)) {
-        DEBUG_PRINT("Can't get IAMVideoProcAmp object. GetPropertyRange failed.");
         pBaseFilter->Release();
         pMoniker->Release();
-        return false;
+        return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
     }
 
     switch (property) {
@@ -468,6 +498,11 @@ bool DirectShow_Camera::getPropertyRange(VideoProperty property, VideoPropertyRa
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             DEBUG_PRINT("Unsupported VideoPropertyValue. GetPropertyRange failed.");
             pProcAmp->Release();
@@ -479,12 +514,12 @@ bool DirectShow_Camera::getPropertyRange(VideoProperty property, VideoPropertyRa
 
     hr = pProcAmp->GetRange(ampProperty, &lMin, &lMax, &lStep, &lDefault, &lCaps);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT("Unsupported VideoPropertyValue. GetPropertyRange failed.");
         pProcAmp->Release();
         pBaseFilter->Release();
         pMoniker->Release();
-        return false;
+        return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
     }
 
     videoPropRange = VideoPropertyRange(lMin, lMax, lStep, lDefault);
@@ -517,12 +552,12 @@ int DirectShow_Camera::getProperty(VideoProperty property)
         return -111;
     }
 
+    // devices without image controls get them in software
     hr = pBaseFilter->QueryInterface(IID_IAMVideoProcAmp, (void**)&pProcAmp);
     if (FAILED(hr)) {
-        DEBUG_PRINT("Can't get IAMVideoProcAmp object. GetPropertyRange failed.");
         pBaseFilter->Release();
         pMoniker->Release();
-        return -111;
+        return pipeline.getSoftwareProcAmp().getProperty(property);
     }
 
     switch (property) {
@@ -541,6 +576,11 @@ int DirectShow_Camera::getProperty(VideoProperty property)
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             DEBUG_PRINT("Unsupported VideoPropertyValue. GetPropertyRange failed.");
             pProcAmp->Release();
@@ -553,12 +593,12 @@ int DirectShow_Camera::getProperty(VideoProperty property)
 
     hr = pProcAmp->Get(ampProperty, &value, &flags);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT("Error during IAMVideoProcAmp->Get. SetProperty failed.");
         pProcAmp->Release();
         pBaseFilter->Release();
         pMoniker->Release();
-        return -99999;
+        return pipeline.getSoftwareProcAmp().getProperty(property);
     }
 
     pProcAmp->Release();
@@ -589,12 +629,12 @@ bool DirectShow_Camera::setProperty(const VideoProperty property, const int valu
         return false;
     }
 
+    // devices without image controls get them in software
     hr = pBaseFilter->QueryInterface(IID_IAMVideoProcAmp, (void**)&pProcAmp);
     if (FAILED(hr)) {
-        DEBUG_PRINT("Can't get IAMVideoProcAmp object. GetPropertyRange failed.");
         pBaseFilter->Release();
         pMoniker->Release();
-        return false;
+        return pipeline.getSoftwareProcAmp().setProperty(property, value);
     }
 
     switch (property) {
@@ -613,6 +653,11 @@ bool DirectShow_Camera::setProperty(const VideoProperty property, const int valu
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             DEBUG_PRINT("Unsupported VideoPropertyValue. GetPropertyRange failed.");
             pProcAmp->Release();
@@ -625,12 +670,12 @@ bool DirectShow_Camera::setProperty(const VideoProperty property, const int valu
 
     hr = pProcAmp->Get(ampProperty, &val, &flags);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT("Error during IAMVideoProcAmp->Get. SetProperty failed.");
         pProcAmp->Release();
         pBaseFilter->Release();
         pMoniker->Release();
-        return false;
+        return pipeline.getSoftwareProcAmp().setProperty(property, value);
     }
 
     hr = pProcAmp->Set(ampProperty, value, flags);
@@ -701,11 +746,30 @@ IMoniker* DirectShow_Camera::getIMonikerByUniqueId(const std::shared_ptr<UniqueI
     return pResult;
 }
 
-int DirectShow_Camera::setCapabilities(IBaseFilter *videoCaptureFilter, PixelFormat pixelFormat, int width, int height, float fps)
+Orientation DirectShow_Camera::getOrientation(AM_MEDIA_TYPE *mediaType)
+{
+    const BITMAPINFOHEADER *bitmapInfoHeader = nullptr;
+
+    if (mediaType->formattype == FORMAT_VideoInfo) {
+        bitmapInfoHeader = &reinterpret_cast<VIDEOINFOHEADER*>(mediaType->pbFormat)->bmiHeader;
+    } else if (mediaType->formattype == FORMAT_VideoInfo2) {
+        bitmapInfoHeader = &reinterpret_cast<VIDEOINFOHEADER2*>(mediaType->pbFormat)->bmiHeader;
+    }
+
+    // uncompressed RGB bitmaps are bottom-up unless the height is negative, YUV ones are always top-down
+    if (bitmapInfoHeader && (bitmapInfoHeader->biCompression == BI_RGB || bitmapInfoHeader->biCompression == BI_BITFIELDS) &&
+            bitmapInfoHeader->biHeight > 0) {
+        return Orientation::BottomUp;
+    }
+
+    return Orientation::TopDown;
+}
+
+int DirectShow_Camera::setCapabilities(IBaseFilter *videoCaptureFilter, PixelFormat pixelFormat, int width, int height, float fps, Orientation &orientation)
 {
     int result = -1;
 
-    enumerateCapabilities(videoCaptureFilter, [&result, &pixelFormat, &width, &height, &fps](IAMStreamConfig *streamConfig, AM_MEDIA_TYPE* mediaType, PixelFormat pixelFormatEnum, int widthEnum, int heightEnum, std::vector<float> &fpsEnum)
+    enumerateCapabilities(videoCaptureFilter, [&result, &pixelFormat, &width, &height, &fps, &orientation](IAMStreamConfig *streamConfig, AM_MEDIA_TYPE* mediaType, PixelFormat pixelFormatEnum, int widthEnum, int heightEnum, std::vector<float> &fpsEnum)
     {
         if (pixelFormat != pixelFormatEnum || width != widthEnum || height != heightEnum) {
             return false;
@@ -727,6 +791,7 @@ int DirectShow_Camera::setCapabilities(IBaseFilter *videoCaptureFilter, PixelFor
 
         if (foundFps) {
             streamConfig->SetFormat(mediaType);
+            orientation = getOrientation(mediaType);
             result = 1;
             return true;
         }
@@ -10,6 +10,7 @@
 #include <vector>
 #include <memory>  //std::shared_ptr include
 
+#include "../frame_pipeline.h"
 #include "../utils.h"
 #include "../include/camera_interface.h"
 #include "../include/camera_information.h"
@@ -29,9 +30,10 @@ public:
     ~DirectShow_Camera();
     static std::unique_ptr<CameraInterface> createCamera(std::shared_ptr<void> mfDeinitializer, const CameraInformation &information);
 
-    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN);
+    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN, DecompressionScale decompressScale = DecompressionScale::Full, FrameDelivery delivery = FrameDelivery::Direct, BackpressurePolicy backpressure = BackpressurePolicy::DropNewest);
     int stop();
     std::unique_ptr<Frame> captureFrame();
+    FrameDropStatistics getDropStatistics();
     // ---- Capabilities ----
     bool getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange);
     int getProperty(VideoProperty property);
@@ -43,7 +45,11 @@ private:
 
     /***** SDK FUNCTIONS *****/
     IMoniker* getIMonikerByUniqueId(const std::shared_ptr<UniqueId> &uniqueId);
-    int setCapabilities(IBaseFilter *videoCaptureFilter, PixelFormat pixelFormat, int width, int height, float fps);
+    /**
+     * Sets the capture format and reports the order the rows of its frames are stored in.
+     */
+    int setCapabilities(IBaseFilter *videoCaptureFilter, PixelFormat pixelFormat, int width, int height, float fps, Orientation &orientation);
+    static Orientation getOrientation(AM_MEDIA_TYPE *mediaType);
     /**
      * Return true to stop enumerating further, otherwise return false.
      */
@@ -110,6 +116,8 @@ public:
     IBaseFilter *pNullRenderer;
 
     FrameCallback cb_frame;
+
+    FramePipeline pipeline; // software stages between the sample grabber and cb_frame
 };
 
 } // namespace webcam_capture
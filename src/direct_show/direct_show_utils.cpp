@@ -1,5 +1,7 @@
 #include "direct_show_utils.h"
 
+#include "../winapi_shared/winapi_shared_bayer_subtypes.h"
+
 #include <pixel_format.h>
 
 #include <dshow.h>
@@ -222,8 +224,9 @@ PixelFormat direct_show_video_format_to_capture_format(GUID guid)
         return PixelFormat::WAKE;
     }
 
+    /// Raw Bayer Subtypes, not defined by DirectShow
     else {
-        return PixelFormat::UNKNOWN;
+        return WinapiShared_BayerSubtypes::toPixelFormat(guid);
     }
 }
 
@@ -0,0 +1,122 @@
+#include "frame_buffer.h"
+
+#include <frame_layout.h>
+
+#include "utils.h"
+
+#include <cstring>
+#include <vector>
+
+namespace webcam_capture {
+
+FrameBuffer::FrameBuffer(size_t prewarmed) :
+    prewarmed(prewarmed),
+    pixelFormat(PixelFormat::UNKNOWN),
+    width(0),
+    height(0)
+{
+    // empty
+}
+
+uint8_t *FrameBuffer::get(const Frame &frame, size_t bytes)
+{
+    // the last frame's buffer goes back to the pool first, so that it's the one handed out again if it's free
+    buffer.reset();
+
+    if (!pool || frame.pixelFormat != pixelFormat || frame.width[0] != width || frame.height[0] != height) {
+        prepare(frame.pixelFormat, frame.width[0], frame.height[0]);
+    }
+
+    if (pool && pool->getBufferSize() >= bytes) {
+        buffer = pool->acquire();
+
+        if (!buffer) {
+            DEBUG_PRINT("Error: All buffers of the pool are held by retained frames.");
+        }
+
+        return buffer.get();
+    }
+
+    // layouts the pool doesn't know of get a buffer of their own
+    buffer = std::shared_ptr<uint8_t>(new uint8_t[bytes], std::default_delete<uint8_t[]>());
+
+    return buffer.get();
+}
+
+void FrameBuffer::prepare(PixelFormat pixelFormat, size_t width, size_t height)
+{
+    this->pixelFormat = pixelFormat;
+    this->width = width;
+    this->height = height;
+    pool = FrameBufferPool::getPool(pixelFormat, width, height);
+
+    if (pool) {
+        pool->prewarm(prewarmed);
+    }
+}
+
+bool FrameBuffer::copy(const Frame &frame, Frame &copy)
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+
+    copy = frame;
+
+    // compressed frames are a single run of bytes
+    if (!traits) {
+        if (!frame.bytes) {
+            DEBUG_PRINT("Error: The compressed frame has no size.");
+            return false;
+        }
+
+        const std::shared_ptr<std::vector<uint8_t> > storage =
+            std::make_shared<std::vector<uint8_t> >(frame.plane[0], frame.plane[0] + frame.bytes);
+        copy.plane[0] = storage->data();
+        copy.owner = storage;
+
+        return true;
+    }
+
+    // strides and offsets of the frame, with the ones it leaves unset derived from its luma stride
+    Frame layout = frame;
+    FrameLayout::setLayout(layout, frame.width[0], frame.height[0]);
+
+    for (int i = 0; i < 3; i ++) {
+        copy.plane[i] = nullptr;
+        copy.stride[i] = 0;
+        copy.offset[i] = 0;
+    }
+
+    const size_t bytes = FrameLayout::setLayout(copy, frame.width[0], frame.height[0]);
+    uint8_t *base = get(copy, bytes);
+
+    if (!base) {
+        return false;
+    }
+
+    FrameLayout::setLayout(copy, frame.width[0], frame.height[0], base);
+    copy.owner = buffer;
+
+    // a chroma plane of a semi-planar format holds a pair of samples per subsampled pixel
+    const size_t chromaBytes = traits->packing == PixelPacking::SemiPlanar ? traits->blockBytes * 2 :
+                               traits->blockBytes;
+
+    for (int i = 0; i < traits->planes; i ++) {
+        const uint8_t *source = frame.plane[i] ? frame.plane[i] : frame.plane[0] + layout.offset[i];
+        const size_t rowBytes = i == 0 ?
+                                (copy.width[0] + traits->blockWidth - 1) / traits->blockWidth * traits->blockBytes :
+                                copy.width[i] * chromaBytes;
+
+        for (size_t y = 0; y < copy.height[i]; y ++) {
+            memcpy(copy.plane[i] + y * copy.stride[i], source + y * layout.stride[i], rowBytes);
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<void> FrameBuffer::getOwner() const
+{
+    return buffer;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,67 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <frame.h>
+#include <frame_buffer_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace webcam_capture {
+
+/**
+ * Buffer a software stage writes the frames it passes on into.
+ * Buffers come from the FrameBufferPool of the frames' pixel format and size, and the one of the last frame goes back
+ * to the pool when the next frame is written, unless a FrameRef still holds it, so a consumer that doesn't retain
+ * frames gets the same buffer every time.
+ */
+class FrameBuffer
+{
+public:
+    /**
+     * @param prewarmed Number of buffers to prewarm the pools with, 1 for one-off copies.
+     */
+    explicit FrameBuffer(size_t prewarmed = FrameBufferPool::DEFAULT_PREWARMED_BUFFERS);
+
+    /**
+     * Gets a buffer to write the next frame into.
+     * @param frame Frame to be written, of which only the pixel format and size are taken.
+     * @param bytes Size of the frame.
+     * @return The buffer, of at least bytes bytes, nullptr if the pool is at its cap and no buffer is free.
+     */
+    uint8_t *get(const Frame &frame, size_t bytes);
+
+    /**
+     * Prewarms the pool of frames of a pixel format and size, for stages that know what they'll output before
+     * capturing starts.
+     */
+    void prepare(PixelFormat pixelFormat, size_t width, size_t height);
+
+    /**
+     * Copies the pixel data of a frame, e.g. one whose buffer is valid only during the callback, into one owned by
+     * the copy, with tightly packed rows. Uncompressed frames are copied into a buffer got from get().
+     * @param frame Frame to copy.
+     * @param copy Frame to set to the copy, with its owner holding the buffer.
+     * @return true on success, false if the frame can't be copied, e.g. because the pool is at its cap.
+     */
+    bool copy(const Frame &frame, Frame &copy);
+
+    /**
+     * @return Handle keeping the buffer last returned by get() alive, for Frame::owner.
+     */
+    std::shared_ptr<void> getOwner() const;
+
+private:
+    const size_t prewarmed;
+    std::shared_ptr<FrameBufferPool> pool;
+    PixelFormat pixelFormat;
+    size_t width;
+    size_t height;
+
+    std::shared_ptr<uint8_t> buffer;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_BUFFER_H
@@ -0,0 +1,167 @@
+#include <frame_buffer_pool.h>
+
+#include <frame_layout.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace webcam_capture {
+
+namespace {
+
+typedef std::tuple<PixelFormat, size_t, size_t, size_t> PoolKey;
+
+/**
+ * Pools in use, by pixel format, size and row alignment. Pools nothing uses any more get dropped.
+ */
+struct PoolRegistry {
+    std::mutex mutex;
+    std::map<PoolKey, std::weak_ptr<FrameBufferPool> > pools;
+};
+
+PoolRegistry &getRegistry()
+{
+    // intentionally leaked, like the thread pool, so that it outlives the cameras using it
+    static PoolRegistry *registry = new PoolRegistry();
+
+    return *registry;
+}
+
+} // namespace
+
+FrameBufferPool::FrameBufferPool(size_t bufferSize) :
+    bufferSize(bufferSize),
+    maxBuffers(DEFAULT_MAX_BUFFERS),
+    allocating(0),
+    statistics()
+{
+    // empty
+}
+
+std::shared_ptr<FrameBufferPool> FrameBufferPool::getPool(PixelFormat pixelFormat, size_t width, size_t height,
+        size_t rowAlignment)
+{
+    rowAlignment = std::max<size_t>(rowAlignment, 1);
+
+    Frame layout = Frame();
+    layout.pixelFormat = pixelFormat;
+    const size_t bytes = FrameLayout::setLayout(layout, width, height, nullptr, rowAlignment);
+
+    if (!bytes) {
+        return nullptr;
+    }
+
+    PoolRegistry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    const PoolKey key(pixelFormat, width, height, rowAlignment);
+    std::shared_ptr<FrameBufferPool> pool = registry.pools[key].lock();
+
+    if (!pool) {
+        for (auto i = registry.pools.begin(); i != registry.pools.end();) {
+            i = i->second.expired() ? registry.pools.erase(i) : std::next(i);
+        }
+
+        pool = std::shared_ptr<FrameBufferPool>(new FrameBufferPool(bytes));
+        registry.pools[key] = pool;
+    }
+
+    return pool;
+}
+
+size_t FrameBufferPool::getBufferSize() const
+{
+    return bufferSize;
+}
+
+void FrameBufferPool::prewarm(size_t count)
+{
+    size_t missing = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const size_t target = std::min(count, maxBuffers);
+        missing = target > buffers.size() + allocating ? target - buffers.size() - allocating : 0;
+        allocating += missing;
+    }
+
+    // the buffers are zero-filled, which faults their pages in, outside of the lock so that frames keep flowing
+    std::vector<std::shared_ptr<std::vector<uint8_t> > > allocated;
+
+    while (allocated.size() < missing) {
+        allocated.push_back(std::make_shared<std::vector<uint8_t> >(bufferSize));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    allocating -= missing;
+    buffers.insert(buffers.end(), allocated.begin(), allocated.end());
+}
+
+void FrameBufferPool::setMaxBuffers(size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    maxBuffers = std::max<size_t>(count, 1);
+}
+
+size_t FrameBufferPool::getMaxBuffers() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return maxBuffers;
+}
+
+std::shared_ptr<uint8_t> FrameBufferPool::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // a buffer only the pool references can't be referenced by anyone else until the pool hands it out, buffers
+    // handed out last are kept first, as they are the likeliest to be in the cache
+    auto free = std::find_if(buffers.begin(), buffers.end(),
+    [](const std::shared_ptr<std::vector<uint8_t> > &buffer) {
+        return buffer.use_count() == 1;
+    });
+
+    if (free != buffers.end()) {
+        statistics.hits ++;
+        std::rotate(buffers.begin(), free, free + 1);
+    } else {
+        statistics.misses ++;
+
+        if (buffers.size() + allocating >= maxBuffers) {
+            return nullptr;
+        }
+
+        // the buffer counts against the cap while it's allocated, which happens outside of the lock, so that other
+        // threads releasing or acquiring buffers don't wait for the allocation and its page faults
+        statistics.grows ++;
+        allocating ++;
+        lock.unlock();
+
+        std::shared_ptr<std::vector<uint8_t> > allocated = std::make_shared<std::vector<uint8_t> >(bufferSize);
+
+        lock.lock();
+        allocating --;
+        buffers.insert(buffers.begin(), allocated);
+    }
+
+    // shares the buffer's reference count, so handing it out allocates nothing
+    const std::shared_ptr<std::vector<uint8_t> > &buffer = buffers.front();
+
+    return std::shared_ptr<uint8_t>(buffer, buffer->data());
+}
+
+FrameBufferPoolStatistics FrameBufferPool::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    FrameBufferPoolStatistics current = statistics;
+    current.buffers = buffers.size();
+    current.inUse = std::count_if(buffers.begin(), buffers.end(),
+    [](const std::shared_ptr<std::vector<uint8_t> > &buffer) {
+        return buffer.use_count() > 1;
+    });
+
+    return current;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,238 @@
+#include "frame_converter.h"
+
+#include "conversion/conversion_jpeg_decoder.h"
+#include "conversion/conversion_planner.h"
+#include "frame_buffer.h"
+#include "frame_drop_counter.h"
+#include "software_proc_amp.h"
+#include "utils.h"
+
+#include <frame_layout.h>
+#include <pixel_format_converter.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace webcam_capture {
+
+namespace {
+
+struct ConversionStage {
+    PixelFormat convertFormat; // PixelFormat::UNKNOWN to keep the format of the frames
+    size_t scaledWidth; // 0 to keep the size of the frames
+    size_t scaledHeight;
+    ScaleFilter scaleFilter;
+    FrameCallback callback;
+    std::shared_ptr<FrameDropCounter> drops;
+    std::unique_ptr<SoftwareProcAmpFilter> filter;
+    Conversion_JpegDecoder decoder;
+
+    // chain planned for the format and size of the last frame, with the costs of the planner's revision
+    PixelFormat pixelFormat;
+    size_t width;
+    size_t height;
+    unsigned revision;
+    std::vector<Conversion_Step> steps;
+
+    // intermediate frames alternate between the buffers, which grow to the largest frame and stay so
+    std::vector<uint8_t> buffers[2];
+    FrameBuffer output;
+
+    bool plan(PixelFormat format, size_t frameWidth, size_t frameHeight)
+    {
+        Conversion_Planner &planner = Conversion_Planner::getInstance();
+        pixelFormat = format;
+        width = frameWidth;
+        height = frameHeight;
+
+        // taken before planning, so that costs measured meanwhile get the chain planned again
+        revision = planner.getRevision();
+
+        return planner.findPlan(pixelFormat, width, height, convertFormat == PixelFormat::UNKNOWN ? pixelFormat :
+                                convertFormat, scaledWidth ? scaledWidth : width, scaledHeight ? scaledHeight : height,
+                                scaleFilter, steps);
+    }
+
+    void convert(Frame &frame)
+    {
+        // chains planned with estimated costs get planned again once the planner measured them
+        if ((frame.pixelFormat != pixelFormat || frame.width[0] != width || frame.height[0] != height ||
+             Conversion_Planner::getInstance().getRevision() != revision) &&
+            !plan(frame.pixelFormat, frame.width[0], frame.height[0])) {
+            DEBUG_PRINT("Error: Can't convert a frame of this format.");
+        }
+
+        if (steps.empty()) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+            return;
+        }
+
+        // properties the camera applies in software, none if they are all at their defaults
+        const PixelFormat destinationFormat = steps.back().pixelFormat;
+        const bool adjust = filter && !filter->update() && SoftwareProcAmpFilter::isSupported(destinationFormat);
+
+        Frame source = frame;
+
+        // frames already in the format are adjusted into a buffer of the stage, the driver's one is read only
+        if (adjust && steps.size() == 1) {
+            Frame adjusted = Frame();
+            adjusted.pixelFormat = destinationFormat;
+            const size_t bytes = FrameLayout::setLayout(adjusted, width, height);
+            uint8_t *base = bytes ? output.get(adjusted, bytes) : nullptr;
+
+            if (!base) {
+                FrameDropCounter::count(drops, FrameDropCounter::Reason::PoolExhausted);
+                return;
+            }
+
+            FrameLayout::setLayout(adjusted, width, height, base);
+            adjusted.owner = output.getOwner();
+            adjusted.colorSpace = frame.colorSpace;
+            adjusted.colorRange = frame.colorRange;
+            adjusted.orientation = frame.orientation;
+
+            filter->apply(frame, adjusted);
+            source = adjusted;
+        }
+
+        for (size_t step = 1; step < steps.size(); step ++) {
+            const Conversion_Step &next = steps[step];
+            Frame converted = Frame();
+            converted.pixelFormat = next.pixelFormat;
+
+            const size_t bytes = Conversion_Planner::getStepLayout(source, converted, next.width, next.height);
+
+            if (!bytes) {
+                DEBUG_PRINT("Error: Can't convert a frame of this format.");
+                FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+                return;
+            }
+
+            // the last frame is the one passed on, which consumers may retain
+            const bool last = step + 1 == steps.size();
+
+            if (last) {
+                converted.plane[0] = output.get(converted, bytes);
+                converted.owner = output.getOwner();
+
+                if (!converted.plane[0]) {
+                    FrameDropCounter::count(drops, FrameDropCounter::Reason::PoolExhausted);
+                    return;
+                }
+            } else {
+                std::vector<uint8_t> &buffer = buffers[step % 2];
+
+                if (buffer.size() < bytes) {
+                    buffer.resize(bytes);
+                }
+
+                converted.plane[0] = buffer.data();
+            }
+
+            // YUV into RGB is mapped through the tables of the properties while converting, the rest after it
+            const bool resize = next.width != source.width[0] || next.height != source.height[0];
+            bool mapped = false;
+
+            if (last && adjust && !resize && filter->convertInto(source, converted)) {
+                mapped = true;
+            } else if (!Conversion_Planner::convertStep(source, converted, next.width, next.height, scaleFilter,
+                       decoder)) {
+                FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+                return;
+            }
+
+            FrameLayout::setPlanes(converted);
+
+            if (last && adjust && !mapped) {
+                filter->apply(converted, converted);
+            }
+
+            source = converted;
+        }
+
+        callback(source);
+    }
+
+    /**
+     * Allocates the buffers of the intermediate and converted frames of the chain planned.
+     */
+    void prepare()
+    {
+        for (size_t step = 1; step + 1 < steps.size(); step ++) {
+            Frame intermediate = Frame();
+            intermediate.pixelFormat = steps[step].pixelFormat;
+            std::vector<uint8_t> &buffer = buffers[step % 2];
+            buffer.resize(std::max(buffer.size(), FrameLayout::setLayout(intermediate, steps[step].width,
+                                   steps[step].height)));
+        }
+
+        if (steps.size() > 1 || filter) {
+            output.prepare(steps.back().pixelFormat, steps.back().width, steps.back().height);
+        }
+    }
+};
+
+} // namespace
+
+FrameCallback FrameConverter::wrapCallback(PixelFormat pixelFormat, PixelFormat convertFormat, int width, int height,
+        FrameCallback callback, std::shared_ptr<FrameDropCounter> drops, std::shared_ptr<SoftwareProcAmp> procAmp)
+{
+    if (!callback || width <= 0 || height <= 0) {
+        return FrameCallback();
+    }
+
+    std::shared_ptr<ConversionStage> stage = std::make_shared<ConversionStage>();
+    stage->convertFormat = convertFormat;
+    stage->scaledWidth = 0;
+    stage->scaledHeight = 0;
+    stage->scaleFilter = ScaleFilter::Box;
+    stage->callback = callback;
+    stage->drops = drops;
+
+    if (procAmp) {
+        stage->filter.reset(new SoftwareProcAmpFilter(procAmp));
+    }
+
+    if (!stage->plan(pixelFormat, width, height)) {
+        return FrameCallback();
+    }
+
+    // capturing starts with the buffers of the intermediate and converted frames allocated
+    stage->prepare();
+
+    return [stage](Frame & frame) {
+        stage->convert(frame);
+    };
+}
+
+FrameCallback FrameConverter::wrapScalingCallback(size_t width, size_t height, ScaleFilter filter,
+        PixelFormat convertFormat, FrameCallback callback, PixelFormat pixelFormat)
+{
+    if (!callback || !width || !height) {
+        return FrameCallback();
+    }
+
+    std::shared_ptr<ConversionStage> stage = std::make_shared<ConversionStage>();
+    stage->convertFormat = convertFormat;
+    stage->scaledWidth = width;
+    stage->scaledHeight = height;
+    stage->scaleFilter = filter;
+    stage->callback = callback;
+
+    // the chain gets planned for the first frame, whose size isn't known before
+    stage->pixelFormat = PixelFormat::UNKNOWN;
+    stage->width = 0;
+    stage->height = 0;
+    stage->revision = 0;
+
+    if (pixelFormat != PixelFormat::UNKNOWN) {
+        stage->output.prepare(convertFormat == PixelFormat::UNKNOWN ? pixelFormat : convertFormat, width, height);
+    }
+
+    return [stage](Frame & frame) {
+        stage->convert(frame);
+    };
+}
+
+} // namespace webcam_capture
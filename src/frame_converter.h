@@ -0,0 +1,72 @@
+#ifndef FRAME_CONVERTER_H
+#define FRAME_CONVERTER_H
+
+#include <camera_interface.h>
+#include <pixel_format.h>
+#include <pixel_format_converter.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace webcam_capture {
+
+class FrameDropCounter;
+class SoftwareProcAmp;
+
+/**
+ * Software conversion stage backends put in front of the frame callback, for the decodeFormat start() takes.
+ * Converts along the cheapest chain of conversions Conversion_Planner plans, so that formats no single conversion
+ * handles still get to the consumer, and the ones that do take the fastest route. Also resizes frames for FrameScaler,
+ * along the cheapest chain of conversions and resizes.
+ */
+class FrameConverter
+{
+public:
+    FrameConverter() = delete;
+
+    /**
+     * Wraps a callback into one converting every frame before passing it on.
+     * The conversion chain is planned here, for the resolution the camera was started with, so that capturing starts
+     * with its buffers allocated. Frames of another format or size get a chain planned for them on arrival, and so do
+     * all frames once the planner measured the costs it planned with estimates of.
+     * The converted frame is valid only during the callback, unless retained with FrameRef. Its buffers are reused
+     * between frames, the one it's in while no FrameRef holds it, so the wrapping callback has to be called from one
+     * thread at a time.
+     * Frames that fail to convert are dropped.
+     * With procAmp, the properties it holds are applied in the same pass as the last conversion where it maps YUV into
+     * RGB, and on the converted frame otherwise, so that no stage after this one has to copy the frame.
+     * @param pixelFormat Format the frames come in.
+     * @param convertFormat Format to convert into.
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @param callback Callback to pass converted frames to.
+     * @param drops Counter of the camera to count dropped frames into, if any.
+     * @param procAmp Properties to apply in software to the converted frames, if any.
+     * @return The wrapping callback, an empty one if there is no conversion chain between the formats.
+     */
+    static FrameCallback wrapCallback(PixelFormat pixelFormat, PixelFormat convertFormat, int width, int height,
+                                      FrameCallback callback, std::shared_ptr<FrameDropCounter> drops = nullptr,
+                                      std::shared_ptr<SoftwareProcAmp> procAmp = nullptr);
+
+    /**
+     * Wraps a callback into one resizing every frame, and converting it if convertFormat is set, before passing it on.
+     * Frames go along the cheapest chain of conversions and resizes Conversion_Planner plans, e.g. through a format
+     * PixelFormatConverter::scaleInto() supports for the ones it doesn't, or through a scaled MJPEG decompression.
+     * The chain is planned for the first frame, and again for frames of another format or size. Otherwise the
+     * wrapping callback is the one of wrapCallback().
+     * @param width Width to resize frames to.
+     * @param height Height to resize frames to.
+     * @param filter Filter to resize with.
+     * @param convertFormat Format to convert into, PixelFormat::UNKNOWN to keep the format of the frames.
+     * @param callback Callback to pass resized frames to.
+     * @param pixelFormat Format the frames come in, if known, so that the buffers of the resized frames get allocated
+     * here rather than on the first frame.
+     * @return The wrapping callback, an empty one if the size is 0 or the callback is empty.
+     */
+    static FrameCallback wrapScalingCallback(size_t width, size_t height, ScaleFilter filter, PixelFormat convertFormat,
+            FrameCallback callback, PixelFormat pixelFormat = PixelFormat::UNKNOWN);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_CONVERTER_H
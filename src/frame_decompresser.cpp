@@ -0,0 +1,90 @@
+#include "frame_decompresser.h"
+
+#include "conversion/conversion_jpeg_decoder.h"
+#include "frame_buffer.h"
+#include "frame_drop_counter.h"
+#include "utils.h"
+
+#include <frame_layout.h>
+#include <pixel_format_converter.h>
+
+#include <memory>
+
+namespace webcam_capture {
+
+namespace {
+
+struct DecompressionStage {
+    PixelFormat decompressFormat;
+    DecompressionScale scale;
+    FrameCallback callback;
+    std::shared_ptr<FrameDropCounter> drops;
+    Conversion_JpegDecoder decoder;
+    FrameBuffer buffer;
+
+    void decompress(Frame &frame)
+    {
+        Frame decompressed = Frame();
+        decompressed.pixelFormat = decompressFormat;
+
+        const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, decompressed, scale);
+
+        if (!bytes) {
+            DEBUG_PRINT("Error: Can't decompress a frame of this format.");
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+            return;
+        }
+
+        decompressed.plane[0] = buffer.get(decompressed, bytes);
+        decompressed.owner = buffer.getOwner();
+
+        if (!decompressed.plane[0]) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::PoolExhausted);
+            return;
+        }
+
+        if (!decoder.decode(frame.plane[0], frame.bytes, decompressed, scale)) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+            return;
+        }
+
+        FrameLayout::setPlanes(decompressed);
+
+        decompressed.colorSpace = ColorSpace::BT601;
+        decompressed.colorRange = ColorRange::Full;
+
+        callback(decompressed);
+    }
+};
+
+} // namespace
+
+bool FrameDecompresser::isSupported(PixelFormat pixelFormat, PixelFormat decompressFormat)
+{
+    return Conversion_JpegDecoder::isSupportedSource(pixelFormat) &&
+           Conversion_JpegDecoder::isSupportedDestination(decompressFormat);
+}
+
+FrameCallback FrameDecompresser::wrapCallback(PixelFormat pixelFormat, PixelFormat decompressFormat, int width,
+        int height, DecompressionScale scale, FrameCallback callback, std::shared_ptr<FrameDropCounter> drops)
+{
+    if (!isSupported(pixelFormat, decompressFormat) || !callback || width <= 0 || height <= 0) {
+        return FrameCallback();
+    }
+
+    std::shared_ptr<DecompressionStage> stage = std::make_shared<DecompressionStage>();
+    stage->decompressFormat = decompressFormat;
+    stage->scale = scale;
+    stage->callback = callback;
+    stage->drops = drops;
+
+    // capturing starts with the buffers of the decompressed frames allocated
+    stage->buffer.prepare(decompressFormat, Conversion_JpegDecoder::getScaledSize(width, scale),
+                          Conversion_JpegDecoder::getScaledSize(height, scale));
+
+    return [stage](Frame & frame) {
+        stage->decompress(frame);
+    };
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,48 @@
+#ifndef FRAME_DECOMPRESSER_H
+#define FRAME_DECOMPRESSER_H
+
+#include <camera_interface.h>
+#include <decompression_scale.h>
+#include <pixel_format.h>
+
+namespace webcam_capture {
+
+class FrameDropCounter;
+
+/**
+ * Software decompression stage backends put in front of the frame callback, for the decompressFormat start() takes.
+ * Works the same on every backend, as it only needs the compressed frames the backend already delivers.
+ */
+class FrameDecompresser
+{
+public:
+    FrameDecompresser() = delete;
+
+    /**
+     * @return true if frames of pixelFormat can be decompressed into decompressFormat.
+     */
+    static bool isSupported(PixelFormat pixelFormat, PixelFormat decompressFormat);
+
+    /**
+     * Wraps a callback into one decompressing every frame before passing it on.
+     * The decompressed frame is valid only during the callback, unless retained with FrameRef. Its buffer, while no
+     * FrameRef holds it, and the decoder state are reused between frames, so the wrapping callback has to be called
+     * from one thread at a time.
+     * Frames that fail to decompress are dropped.
+     * @param pixelFormat Compressed format the camera captures in.
+     * @param decompressFormat Format to decompress into.
+     * @param width Width of the frames, as captured.
+     * @param height Height of the frames, as captured.
+     * @param scale Scale to decompress at.
+     * @param callback Callback to pass decompressed frames to.
+     * @param drops Counter of the camera to count dropped frames into, if any.
+     * @return The wrapping callback, an empty one if the pair of formats is not supported.
+     */
+    static FrameCallback wrapCallback(PixelFormat pixelFormat, PixelFormat decompressFormat, int width, int height,
+                                      DecompressionScale scale, FrameCallback callback,
+                                      std::shared_ptr<FrameDropCounter> drops = nullptr);
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_DECOMPRESSER_H
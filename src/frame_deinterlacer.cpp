@@ -0,0 +1,196 @@
+#include <frame_deinterlacer.h>
+
+#include <frame_layout.h>
+
+#include "conversion/conversion_deinterlace.h"
+#include "conversion/conversion_thread_pool.h"
+#include "frame_buffer.h"
+#include "utils.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace webcam_capture {
+
+namespace {
+
+// bytes of the second field that changed by no more than this since the previous frame are taken as still. Analog
+// video is noisy enough for a few steps of difference not to mean anything
+const uint8_t MOTION_THRESHOLD = 10;
+
+bool isSupported(PixelFormat pixelFormat)
+{
+    switch (pixelFormat) {
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+        case PixelFormat::UYVY:
+        case PixelFormat::YVYU:
+        case PixelFormat::NV12:
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::YV12:
+        case PixelFormat::Y800:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+struct DeinterlacingStage {
+    DeinterlaceMode mode;
+    FieldOrder fieldOrder;
+    FrameCallback callback;
+    FrameBuffer buffer;
+
+    // rows of the second field of the previous frame, plane after plane, for MotionAdaptive
+    std::vector<uint8_t> previous;
+    bool hasPrevious;
+    PixelFormat previousFormat;
+    size_t previousWidth;
+    size_t previousHeight;
+
+    /**
+     * Deinterlaces a plane of height rows of rowBytes bytes. The rows of the second field are the ones whose index in
+     * memory order has the parity secondParity.
+     * @param previousRows Rows of the second field of the previous frame, updated to this frame's, or null for Bob.
+     */
+    void deinterlacePlane(const uint8_t *source, size_t sourceStride, uint8_t *destination, size_t destinationStride,
+                          size_t rowBytes, size_t height, size_t secondParity, uint8_t *previousRows)
+    {
+        const Conversion_InterpolateRow interpolate = Conversion_Deinterlacer::getInterpolateRow();
+        const Conversion_MotionAdaptiveRow motionAdaptive = Conversion_Deinterlacer::getMotionAdaptiveRow();
+        const bool compare = previousRows && hasPrevious;
+
+        Conversion_ThreadPool::getInstance().runStripes(height, 2, [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t y = rowBegin; y < rowEnd; y ++) {
+                const uint8_t *row = source + y * sourceStride;
+                uint8_t *target = destination + y * destinationStride;
+
+                if (y % 2 != secondParity || height == 1) {
+                    memcpy(target, row, rowBytes);
+                    continue;
+                }
+
+                // rows on the edge of the frame have a row of the first field on one side only
+                const uint8_t *above = source + (y > 0 ? y - 1 : y + 1) * sourceStride;
+                const uint8_t *below = source + (y + 1 < height ? y + 1 : y - 1) * sourceStride;
+
+                if (compare) {
+                    motionAdaptive(above, below, row, previousRows + y / 2 * rowBytes, MOTION_THRESHOLD, target,
+                                   rowBytes);
+                } else {
+                    interpolate(above, below, target, rowBytes);
+                }
+
+                if (previousRows) {
+                    memcpy(previousRows + y / 2 * rowBytes, row, rowBytes);
+                }
+            }
+        });
+    }
+
+    void deinterlace(Frame &frame)
+    {
+        const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+        const size_t width = frame.width[0];
+        const size_t height = frame.height[0];
+
+        Frame deinterlaced = Frame();
+        deinterlaced.pixelFormat = frame.pixelFormat;
+        const size_t bytes = FrameLayout::setLayout(deinterlaced, width, height);
+
+        if (!isSupported(frame.pixelFormat) || !frame.plane[0] || !bytes) {
+            DEBUG_PRINT("Error: Can't deinterlace a frame of this format.");
+            return;
+        }
+
+        // strides and offsets of the frame, with the ones it leaves unset derived from its luma stride
+        Frame layout = frame;
+        FrameLayout::setLayout(layout, width, height);
+
+        uint8_t *base = buffer.get(deinterlaced, bytes);
+
+        if (!base) {
+            return;
+        }
+
+        FrameLayout::setLayout(deinterlaced, width, height, base);
+        deinterlaced.owner = buffer.getOwner();
+        deinterlaced.colorSpace = frame.colorSpace;
+        deinterlaced.colorRange = frame.colorRange;
+        deinterlaced.orientation = frame.orientation;
+
+        size_t rowBytes[3];
+        size_t previousBytes = 0;
+
+        for (int i = 0; i < traits->planes; i ++) {
+            // a chroma plane of a semi-planar format holds a pair of samples per subsampled pixel
+            rowBytes[i] = i == 0 ? (width + traits->blockWidth - 1) / traits->blockWidth * traits->blockBytes :
+                          layout.width[i] * (traits->packing == PixelPacking::SemiPlanar ? 2 : 1);
+            previousBytes += (layout.height[i] + 1) / 2 * rowBytes[i];
+        }
+
+        const bool motionAdaptive = mode == DeinterlaceMode::MotionAdaptive;
+
+        if (motionAdaptive && (!hasPrevious || frame.pixelFormat != previousFormat || width != previousWidth ||
+                               height != previousHeight)) {
+            previous.resize(previousBytes);
+            hasPrevious = false;
+            previousFormat = frame.pixelFormat;
+            previousWidth = width;
+            previousHeight = height;
+        }
+
+        uint8_t *previousRows = motionAdaptive ? previous.data() : nullptr;
+
+        for (int i = 0; i < traits->planes; i ++) {
+            const size_t planeHeight = layout.height[i];
+            const uint8_t *plane = frame.plane[i] ? frame.plane[i] : frame.plane[0] + layout.offset[i];
+
+            // the top field is made of the even rows counting from the top, which are the odd ones in memory order
+            // for bottom-up frames of an even height
+            const size_t secondField = fieldOrder == FieldOrder::TopFirst ? 1 : 0;
+            const size_t secondParity = frame.orientation == Orientation::BottomUp ?
+                                        (planeHeight - 1 - secondField) % 2 : secondField;
+
+            deinterlacePlane(plane, layout.stride[i], deinterlaced.plane[i], deinterlaced.stride[i], rowBytes[i],
+                             planeHeight, secondParity, previousRows);
+
+            if (previousRows) {
+                previousRows += (planeHeight + 1) / 2 * rowBytes[i];
+            }
+        }
+
+        hasPrevious = motionAdaptive;
+
+        callback(deinterlaced);
+    }
+};
+
+} // namespace
+
+FrameCallback FrameDeinterlacer::wrapCallback(DeinterlaceMode mode, FieldOrder fieldOrder, FrameCallback callback,
+        PixelFormat pixelFormat, size_t width, size_t height)
+{
+    if (!callback || mode == DeinterlaceMode::Weave) {
+        return callback;
+    }
+
+    std::shared_ptr<DeinterlacingStage> stage = std::make_shared<DeinterlacingStage>();
+    stage->mode = mode;
+    stage->fieldOrder = fieldOrder;
+    stage->callback = callback;
+    stage->hasPrevious = false;
+
+    if (pixelFormat != PixelFormat::UNKNOWN && width && height) {
+        stage->buffer.prepare(pixelFormat, width, height);
+    }
+
+    return [stage](Frame & frame) {
+        stage->deinterlace(frame);
+    };
+}
+
+} // namespace webcam_capture
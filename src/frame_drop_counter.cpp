@@ -0,0 +1,62 @@
+#include "frame_drop_counter.h"
+
+namespace webcam_capture {
+
+FrameDropCounter::FrameDropCounter() :
+    delivered(0),
+    queueFull(0),
+    poolExhausted(0),
+    decodeFailed(0)
+{
+    // empty
+}
+
+void FrameDropCounter::count(const std::shared_ptr<FrameDropCounter> &counter, Reason reason)
+{
+    if (!counter) {
+        return;
+    }
+
+    switch (reason) {
+        case Reason::QueueFull:
+            counter->queueFull.fetch_add(1, std::memory_order_relaxed);
+            break;
+
+        case Reason::PoolExhausted:
+            counter->poolExhausted.fetch_add(1, std::memory_order_relaxed);
+            break;
+
+        case Reason::DecodeFailed:
+            counter->decodeFailed.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+}
+
+FrameCallback FrameDropCounter::wrapCallback(std::shared_ptr<FrameDropCounter> counter, FrameCallback callback)
+{
+    return [counter, callback](Frame & frame) {
+        counter->delivered.fetch_add(1, std::memory_order_relaxed);
+        callback(frame);
+    };
+}
+
+FrameDropStatistics FrameDropCounter::getStatistics() const
+{
+    FrameDropStatistics statistics;
+    statistics.delivered = delivered.load(std::memory_order_relaxed);
+    statistics.queueFull = queueFull.load(std::memory_order_relaxed);
+    statistics.poolExhausted = poolExhausted.load(std::memory_order_relaxed);
+    statistics.decodeFailed = decodeFailed.load(std::memory_order_relaxed);
+
+    return statistics;
+}
+
+void FrameDropCounter::reset()
+{
+    delivered = 0;
+    queueFull = 0;
+    poolExhausted = 0;
+    decodeFailed = 0;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,56 @@
+#ifndef FRAME_DROP_COUNTER_H
+#define FRAME_DROP_COUNTER_H
+
+#include <camera_interface.h>
+#include <frame_drop_statistics.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace webcam_capture {
+
+/**
+ * Counts the frames a camera delivers and drops, for CameraInterface::getDropStatistics().
+ * Each camera keeps one, which the stages it puts in front of the callback count the frames they drop into. Counting
+ * is a relaxed atomic increment, so stages on different threads can share it.
+ */
+class FrameDropCounter
+{
+public:
+    enum class Reason {
+        QueueFull,
+        PoolExhausted,
+        DecodeFailed
+    };
+
+    FrameDropCounter();
+
+    /**
+     * Counts a dropped frame into counter, if it's set, so that stages can take an optional one.
+     */
+    static void count(const std::shared_ptr<FrameDropCounter> &counter, Reason reason);
+
+    /**
+     * Wraps a callback into one counting the frames delivered to it.
+     * @return The wrapping callback.
+     */
+    static FrameCallback wrapCallback(std::shared_ptr<FrameDropCounter> counter, FrameCallback callback);
+
+    FrameDropStatistics getStatistics() const;
+
+    /**
+     * Zeroes the counters, when the camera starts.
+     */
+    void reset();
+
+private:
+    std::atomic<uint64_t> delivered;
+    std::atomic<uint64_t> queueFull;
+    std::atomic<uint64_t> poolExhausted;
+    std::atomic<uint64_t> decodeFailed;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_DROP_COUNTER_H
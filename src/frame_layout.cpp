@@ -0,0 +1,205 @@
+#include <frame_layout.h>
+
+#include <algorithm>
+
+namespace webcam_capture {
+
+namespace {
+
+// uncompressed formats, in the order PixelFormat declares them
+// pixel format, color model, packing, planes, bits per sample, chroma shifts, block width and bytes, row alignment
+const PixelFormatTraits TRAITS[] = {
+    {PixelFormat::RGB1, ColorModel::RGB, PixelPacking::Packed, 1, 1, 0, 0, 8, 1, 1},
+    {PixelFormat::RGB4, ColorModel::RGB, PixelPacking::Packed, 1, 4, 0, 0, 2, 1, 1},
+    {PixelFormat::RGB8, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::RGB555, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::RGB565, ColorModel::RGB, PixelPacking::Packed, 1, 6, 0, 0, 1, 2, 1},
+    {PixelFormat::RGB24, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 3, 1},
+    {PixelFormat::RGB32, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::BGRA32, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::BE16_555, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::BE16_565, ColorModel::RGB, PixelPacking::Packed, 1, 6, 0, 0, 1, 2, 1},
+    {PixelFormat::LE16_555, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::LE16_565, ColorModel::RGB, PixelPacking::Packed, 1, 6, 0, 0, 1, 2, 1},
+    {PixelFormat::LE16_5551, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB1555, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB32, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::ARGB4444, ColorModel::RGB, PixelPacking::Packed, 1, 4, 0, 0, 1, 2, 1},
+    {PixelFormat::A2R10G10B10, ColorModel::RGB, PixelPacking::Packed, 1, 10, 0, 0, 1, 4, 1},
+    {PixelFormat::A2B10G10R10, ColorModel::RGB, PixelPacking::Packed, 1, 10, 0, 0, 1, 4, 1},
+    // palettized, a 4-bit index and 4 bits of alpha
+    {PixelFormat::IA44, ColorModel::YUV, PixelPacking::Packed, 1, 4, 0, 0, 1, 1, 1},
+    {PixelFormat::AI44, ColorModel::YUV, PixelPacking::Packed, 1, 4, 0, 0, 1, 1, 1},
+    {PixelFormat::AYUV, ColorModel::YUV, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::I420, ColorModel::YUV, PixelPacking::Planar, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::IYUV, ColorModel::YUV, PixelPacking::Planar, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::NV11, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 8, 2, 0, 1, 1, 1},
+    {PixelFormat::NV12, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::UYVY, ColorModel::YUV, PixelPacking::Packed, 1, 8, 1, 0, 2, 4, 1},
+    {PixelFormat::YUYV, ColorModel::YUV, PixelPacking::Packed, 1, 8, 1, 0, 2, 4, 1},
+    // every other luma sample of 4 pixels and a chroma pair in 4 bytes
+    {PixelFormat::Y211, ColorModel::YUV, PixelPacking::Packed, 1, 8, 2, 0, 4, 4, 1},
+    {PixelFormat::Y411, ColorModel::YUV, PixelPacking::Packed, 1, 8, 2, 0, 4, 6, 1},
+    {PixelFormat::Y41P, ColorModel::YUV, PixelPacking::Packed, 1, 8, 2, 0, 8, 12, 1},
+    {PixelFormat::Y41T, ColorModel::YUV, PixelPacking::Packed, 1, 8, 2, 0, 8, 12, 1},
+    {PixelFormat::Y42T, ColorModel::YUV, PixelPacking::Packed, 1, 8, 1, 0, 2, 4, 1},
+    {PixelFormat::YUY2, ColorModel::YUV, PixelPacking::Packed, 1, 8, 1, 0, 2, 4, 1},
+    {PixelFormat::YV12, ColorModel::YUV, PixelPacking::Planar, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::IMC1, ColorModel::YUV, PixelPacking::PlanarLumaStride, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::IMC2, ColorModel::YUV, PixelPacking::PlanarSharedRows, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::IMC3, ColorModel::YUV, PixelPacking::PlanarLumaStride, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::IMC4, ColorModel::YUV, PixelPacking::PlanarSharedRows, 3, 8, 1, 1, 1, 1, 1},
+    // the motion information following IF09's planes is not part of the layout
+    {PixelFormat::IF09, ColorModel::YUV, PixelPacking::Planar, 3, 8, 2, 2, 1, 1, 1},
+    {PixelFormat::YVU9, ColorModel::YUV, PixelPacking::Planar, 3, 8, 2, 2, 1, 1, 1},
+    {PixelFormat::YVYU, ColorModel::YUV, PixelPacking::Packed, 1, 8, 1, 0, 2, 4, 1},
+    {PixelFormat::Y800, ColorModel::YUV, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::P010, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 10, 1, 1, 1, 2, 1},
+    {PixelFormat::P016, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 16, 1, 1, 1, 2, 1},
+    {PixelFormat::P210, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 10, 1, 0, 1, 2, 1},
+    {PixelFormat::P216, ColorModel::YUV, PixelPacking::SemiPlanar, 2, 16, 1, 0, 1, 2, 1},
+    // 6 pixels in 4 32-bit words, rows padded to 48 pixels
+    {PixelFormat::v210, ColorModel::YUV, PixelPacking::Packed, 1, 10, 1, 0, 6, 16, 128},
+    {PixelFormat::v216, ColorModel::YUV, PixelPacking::Packed, 1, 16, 1, 0, 2, 8, 1},
+    {PixelFormat::v308, ColorModel::YUV, PixelPacking::Packed, 1, 8, 0, 0, 1, 3, 1},
+    {PixelFormat::v408, ColorModel::YUV, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::v410, ColorModel::YUV, PixelPacking::Packed, 1, 10, 0, 0, 1, 4, 1},
+    {PixelFormat::Y210, ColorModel::YUV, PixelPacking::Packed, 1, 10, 1, 0, 2, 8, 1},
+    {PixelFormat::Y216, ColorModel::YUV, PixelPacking::Packed, 1, 16, 1, 0, 2, 8, 1},
+    {PixelFormat::Y410, ColorModel::YUV, PixelPacking::Packed, 1, 10, 0, 0, 1, 4, 1},
+    {PixelFormat::Y416, ColorModel::YUV, PixelPacking::Packed, 1, 16, 0, 0, 1, 8, 1},
+    {PixelFormat::BayerRGGB8, ColorModel::Bayer, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::BayerGRBG8, ColorModel::Bayer, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::BayerGBRG8, ColorModel::Bayer, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::BayerBGGR8, ColorModel::Bayer, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1},
+    {PixelFormat::BayerRGGB10, ColorModel::Bayer, PixelPacking::Packed, 1, 10, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerGRBG10, ColorModel::Bayer, PixelPacking::Packed, 1, 10, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerGBRG10, ColorModel::Bayer, PixelPacking::Packed, 1, 10, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerBGGR10, ColorModel::Bayer, PixelPacking::Packed, 1, 10, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerRGGB12, ColorModel::Bayer, PixelPacking::Packed, 1, 12, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerGRBG12, ColorModel::Bayer, PixelPacking::Packed, 1, 12, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerGBRG12, ColorModel::Bayer, PixelPacking::Packed, 1, 12, 0, 0, 1, 2, 1},
+    {PixelFormat::BayerBGGR12, ColorModel::Bayer, PixelPacking::Packed, 1, 12, 0, 0, 1, 2, 1},
+    {PixelFormat::O420, ColorModel::YUV, PixelPacking::Planar, 3, 8, 1, 1, 1, 1, 1},
+    {PixelFormat::RGB32_D3D_DX7_RT, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::RGB16_D3D_DX7_RT, ColorModel::RGB, PixelPacking::Packed, 1, 6, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB32_D3D_DX7_RT, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::ARGB4444_D3D_DX7_RT, ColorModel::RGB, PixelPacking::Packed, 1, 4, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB1555_D3D_DX7_RT, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    {PixelFormat::RGB32_D3D_DX9_RT, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::RGB16_D3D_DX9_RT, ColorModel::RGB, PixelPacking::Packed, 1, 6, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB32_D3D_DX9_RT, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 4, 1},
+    {PixelFormat::ARGB4444_D3D_DX9_RT, ColorModel::RGB, PixelPacking::Packed, 1, 4, 0, 0, 1, 2, 1},
+    {PixelFormat::ARGB1555_D3D_DX9_RT, ColorModel::RGB, PixelPacking::Packed, 1, 5, 0, 0, 1, 2, 1},
+    // 4 pixels in a 32-bit word, 5-bit luma and 6-bit chroma
+    {PixelFormat::CLJR, ColorModel::YUV, PixelPacking::Packed, 1, 6, 2, 0, 4, 4, 1},
+    {PixelFormat::IndexedGray8_WhiteIsZero, ColorModel::RGB, PixelPacking::Packed, 1, 8, 0, 0, 1, 1, 1}
+};
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+const PixelFormatTraits *FrameLayout::getTraits(PixelFormat pixelFormat)
+{
+    for (const PixelFormatTraits &traits : TRAITS) {
+        if (traits.pixelFormat == pixelFormat) {
+            return &traits;
+        }
+    }
+
+    return nullptr;
+}
+
+size_t FrameLayout::setLayout(Frame &frame, size_t width, size_t height, uint8_t *base, size_t rowAlignment)
+{
+    const PixelFormatTraits *traits = getTraits(frame.pixelFormat);
+
+    if (!traits || !width || !height) {
+        return 0;
+    }
+
+    frame.width[0] = width;
+    frame.height[0] = height;
+
+    if (!frame.stride[0]) {
+        frame.stride[0] = alignUp((width + traits->blockWidth - 1) / traits->blockWidth * traits->blockBytes,
+                                  std::max<size_t>(std::max<size_t>(rowAlignment, traits->rowAlignment), 1));
+    }
+
+    const size_t lumaStride = frame.stride[0];
+    const size_t chromaWidth = (width + (1 << traits->chromaShiftX) - 1) >> traits->chromaShiftX;
+    const size_t chromaHeight = (height + (1 << traits->chromaShiftY) - 1) >> traits->chromaShiftY;
+    size_t bytes = lumaStride * height;
+
+    switch (traits->packing) {
+        case PixelPacking::Packed:
+            break;
+
+        case PixelPacking::SemiPlanar: {
+            // a chroma row holds a chroma pair per subsampled luma sample, rounded up for widths that don't divide
+            const size_t sampleBytes = traits->blockBytes;
+
+            frame.stride[1] = frame.stride[1] ? frame.stride[1] :
+                              (lumaStride + (sampleBytes << traits->chromaShiftX) - 1) /
+                              (sampleBytes << traits->chromaShiftX) * 2 * sampleBytes;
+            frame.offset[1] = bytes;
+            bytes += frame.stride[1] * chromaHeight;
+            break;
+        }
+
+        case PixelPacking::Planar:
+        case PixelPacking::PlanarLumaStride: {
+            const size_t chromaStride = traits->packing == PixelPacking::Planar ?
+                                        (lumaStride + (1 << traits->chromaShiftX) - 1) >> traits->chromaShiftX :
+                                        lumaStride;
+
+            for (int i = 1; i < 3; i ++) {
+                frame.stride[i] = frame.stride[i] ? frame.stride[i] : chromaStride;
+                frame.offset[i] = bytes;
+                bytes += frame.stride[i] * chromaHeight;
+            }
+
+            break;
+        }
+
+        case PixelPacking::PlanarSharedRows:
+            frame.stride[1] = frame.stride[1] ? frame.stride[1] : lumaStride;
+            frame.stride[2] = frame.stride[1];
+            frame.offset[1] = bytes;
+            frame.offset[2] = bytes + frame.stride[1] / 2;
+            bytes += frame.stride[1] * chromaHeight;
+            break;
+    }
+
+    for (int i = 1; i < traits->planes; i ++) {
+        frame.width[i] = chromaWidth;
+        frame.height[i] = chromaHeight;
+    }
+
+    if (base) {
+        frame.plane[0] = base;
+
+        for (int i = 1; i < traits->planes; i ++) {
+            frame.plane[i] = base + frame.offset[i];
+        }
+    }
+
+    frame.bytes = bytes;
+
+    return bytes;
+}
+
+void FrameLayout::setPlanes(Frame &frame)
+{
+    for (int i = 1; i < 3; i ++) {
+        if (frame.offset[i]) {
+            frame.plane[i] = frame.plane[0] + frame.offset[i];
+        }
+    }
+}
+
+} // namespace webcam_capture
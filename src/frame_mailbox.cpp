@@ -0,0 +1,101 @@
+#include "frame_mailbox.h"
+
+namespace webcam_capture {
+
+FrameMailbox::FrameMailbox() :
+    slots(),
+    middle(1),
+    polled(false),
+    back(0),
+    front(2),
+    pixelFormat(PixelFormat::UNKNOWN),
+    width(0),
+    height(0)
+{
+    // empty
+}
+
+FrameCallback FrameMailbox::wrapCallback(std::shared_ptr<FrameMailbox> mailbox, FrameCallback callback)
+{
+    return [mailbox, callback](Frame & frame) {
+        mailbox->post(frame);
+        callback(frame);
+    };
+}
+
+void FrameMailbox::post(const Frame &frame)
+{
+    // the acquire pairs with the release of the first take(), after which the buffers are the capture thread's
+    if (!frame.plane[0] || !polled.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    Frame &slot = slots[back];
+
+    // the slot's last frame goes back to the pool before the copy asks for a buffer, unless the reader kept it
+    slot.owner.reset();
+
+    // frames are copied even if the library owns their buffer, as holding on to platform buffers would starve the
+    // small pools of the drivers
+    if (!buffer.copy(frame, slot)) {
+        slot = Frame();
+        return;
+    }
+
+    // the release half publishes the copy to the reader, the acquire half gets the slot it released
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+}
+
+void FrameMailbox::reset()
+{
+    std::lock_guard<std::mutex> lock(readerMutex);
+
+    for (Frame &slot : slots) {
+        slot = Frame();
+    }
+
+    back = 0;
+    middle.store(1, std::memory_order_relaxed);
+    front = 2;
+}
+
+void FrameMailbox::prepare(PixelFormat pixelFormat, size_t width, size_t height)
+{
+    std::lock_guard<std::mutex> lock(readerMutex);
+
+    this->pixelFormat = pixelFormat;
+    this->width = width;
+    this->height = height;
+
+    if (polled.load(std::memory_order_relaxed)) {
+        buffer.prepare(pixelFormat, width, height);
+    }
+}
+
+std::unique_ptr<Frame> FrameMailbox::take()
+{
+    std::lock_guard<std::mutex> lock(readerMutex);
+
+    // the capture thread doesn't touch the buffers until it sees the flag, so they can be prewarmed here
+    if (!polled.load(std::memory_order_relaxed)) {
+        if (width > 0 && height > 0) {
+            buffer.prepare(pixelFormat, width, height);
+        }
+
+        polled.store(true, std::memory_order_release);
+    }
+
+    // the slot given back keeps its frame until the capture thread writes over it, so a frame the reader didn't
+    // keep goes back to the pool only then
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    }
+
+    if (!slots[front].plane[0]) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<Frame>(new Frame(slots[front]));
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,94 @@
+#ifndef FRAME_MAILBOX_H
+#define FRAME_MAILBOX_H
+
+#include <camera_interface.h>
+#include <frame.h>
+
+#include "frame_buffer.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace webcam_capture {
+
+/**
+ * Holds the newest frame of a camera for CameraInterface::captureFrame(), so that it can be polled, e.g. once per
+ * redraw of a UI, instead of taking frames in the callback.
+ * It's a triple buffer: the capture thread copies every frame into the slot it owns and swaps it for the middle one
+ * with a single atomic exchange, and the reader swaps the middle slot for the one it owns the same way when a newer
+ * frame is in it. Neither side ever waits on the other, the capture thread can't stall on a slow reader, and the
+ * reader can't see a frame that is half written, as the slot being written is never the one it reads.
+ * Every backend puts the mailbox's stage right in front of the frame callback, so polled frames are the ones the
+ * callback gets, converted, decompressed and with the properties applied.
+ * The reader keeps the slot it took last, so polls between two frames get that frame again instead of nothing.
+ * Frames are copied only once the reader polled for the first time, so cameras nobody polls don't pay for a copy of
+ * every frame.
+ */
+class FrameMailbox
+{
+public:
+    FrameMailbox();
+
+    /**
+     * Wraps a callback into one posting every frame to mailbox before passing it on, once take() was first called.
+     * @return The wrapping callback.
+     */
+    static FrameCallback wrapCallback(std::shared_ptr<FrameMailbox> mailbox, FrameCallback callback);
+
+    /**
+     * Drops the frames held, so that take() doesn't hand out a frame of an earlier capture. To be called before the
+     * capture thread starts posting frames.
+     */
+    void reset();
+
+    /**
+     * Sets the format and size of the frames to be posted, for their buffers to be prewarmed, right away if take() was
+     * called already and on its first call otherwise. To be called before the capture thread starts posting frames.
+     */
+    void prepare(PixelFormat pixelFormat, size_t width, size_t height);
+
+    /**
+     * Gets the newest frame. Can be called from any thread, calls from several threads take turns.
+     * The first call starts the posting of frames, which goes on until the mailbox is destroyed.
+     * @return Copy of the newest frame, with its owner keeping the pixel data alive, the same frame again if none came
+     * since the last call, nullptr if no frame was posted since reset() or the first call.
+     */
+    std::unique_ptr<Frame> take();
+
+private:
+    FrameMailbox(const FrameMailbox &) = delete;
+    FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+    /**
+     * Copies a frame into the back slot and makes it the middle one. Called on the capture thread only.
+     */
+    void post(const Frame &frame);
+
+    // the middle slot's index is in the low bits of middle, with FRESH set while the reader hasn't taken its frame
+    static const unsigned INDEX = 3;
+    static const unsigned FRESH = 4;
+
+    Frame slots[3];
+    std::atomic<unsigned> middle;
+
+    // set by the first take(), with the buffers prewarmed, frames aren't posted before
+    std::atomic<bool> polled;
+
+    // owned by the capture thread
+    unsigned back;
+    FrameBuffer buffer;
+
+    // owned by the reader
+    unsigned front;
+    std::mutex readerMutex;
+
+    // format and size of the frames to be posted, guarded by readerMutex
+    PixelFormat pixelFormat;
+    size_t width;
+    size_t height;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_MAILBOX_H
@@ -0,0 +1,120 @@
+#include "frame_pipeline.h"
+
+#include "conversion/conversion_jpeg_decoder.h"
+#include "frame_converter.h"
+#include "frame_decompresser.h"
+#include "frame_drop_counter.h"
+#include "frame_mailbox.h"
+#include "frame_queue.h"
+#include "software_proc_amp.h"
+#include "utils.h"
+
+namespace webcam_capture {
+
+FramePipeline::FramePipeline() :
+    softwareProcAmp(std::make_shared<SoftwareProcAmp>()),
+    mailbox(std::make_shared<FrameMailbox>()),
+    drops(std::make_shared<FrameDropCounter>())
+{
+    // empty
+}
+
+FramePipeline::~FramePipeline()
+{
+    stop();
+}
+
+int FramePipeline::start(FrameCallback &callback, PixelFormat pixelFormat, int width, int height,
+                         PixelFormat decompressFormat, DecompressionScale decompressScale, PixelFormat convertFormat,
+                         FrameDelivery delivery, BackpressurePolicy backpressure)
+{
+    const bool decompress = decompressFormat != PixelFormat::UNKNOWN;
+    const bool convert = convertFormat != PixelFormat::UNKNOWN;
+
+    // format and size of the frames past each stage, for the stages to allocate their buffers before capturing starts
+    const PixelFormat decompressedFormat = decompress ? decompressFormat : pixelFormat;
+    const PixelFormat outputFormat = convert ? convertFormat : decompressedFormat;
+    const size_t scaledWidth = Conversion_JpegDecoder::getScaledSize(width, decompressScale);
+    const size_t scaledHeight = Conversion_JpegDecoder::getScaledSize(height, decompressScale);
+    const int outputWidth = decompress ? static_cast<int>(scaledWidth) : width;
+    const int outputHeight = decompress ? static_cast<int>(scaledHeight) : height;
+
+    // the stages wrap the callback innermost first, so the frames go through them in the opposite order
+    drops->reset();
+    FrameCallback cb = FrameDropCounter::wrapCallback(drops, callback);
+
+    // the newest frame is kept for captureFrame() as the callback gets it, none of an earlier capture, once
+    // captureFrame() was first called
+    mailbox->reset();
+    mailbox->prepare(outputFormat, outputWidth, outputHeight);
+    cb = FrameMailbox::wrapCallback(mailbox, cb);
+
+    // the converter applies the properties while converting, otherwise they are applied in place on the frames of the
+    // decompresser and the queue, and only the driver's frames are copied for it
+    if (!convert) {
+        cb = SoftwareProcAmp::wrapCallback(softwareProcAmp, outputFormat, outputWidth, outputHeight,
+                                           decompress || delivery == FrameDelivery::Queued, cb, drops);
+    }
+
+    // along the cheapest chain of conversions
+    if (convert) {
+        cb = FrameConverter::wrapCallback(decompressedFormat, convertFormat, outputWidth, outputHeight, cb, drops,
+                                          softwareProcAmp);
+
+        if (!cb) {
+            DEBUG_PRINT("Error: Can't convert the pixel format into decodeFormat.");
+            return -10;      //TODO Err code
+        }
+    }
+
+    if (decompress) {
+        cb = FrameDecompresser::wrapCallback(pixelFormat, decompressFormat, width, height, decompressScale, cb, drops);
+
+        if (!cb) {
+            DEBUG_PRINT("Error: Can't decompress the pixel format into decompressFormat.");
+            return -6;      //TODO Err code
+        }
+    }
+
+    // the driver's thread only queues the frames, the stages above and the callback run on the queue's thread
+    queue = delivery == FrameDelivery::Queued ? std::make_shared<FrameQueue>(cb, backpressure, drops) : nullptr;
+
+    if (queue) {
+        queue->prepare(pixelFormat, width, height);
+        cb = FrameQueue::wrapCallback(queue);
+    }
+
+    callback = cb;
+
+    return 1;
+}
+
+void FramePipeline::stop()
+{
+    if (queue) {
+        queue->stop();
+        queue.reset();
+    }
+}
+
+std::unique_ptr<Frame> FramePipeline::captureFrame()
+{
+    return mailbox->take();
+}
+
+FrameDropStatistics FramePipeline::getDropStatistics() const
+{
+    return drops->getStatistics();
+}
+
+SoftwareProcAmp &FramePipeline::getSoftwareProcAmp()
+{
+    return *softwareProcAmp;
+}
+
+std::shared_ptr<FrameDropCounter> FramePipeline::getDropCounter() const
+{
+    return drops;
+}
+
+} // namespace webcam_capture
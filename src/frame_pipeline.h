@@ -0,0 +1,92 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <backpressure_policy.h>
+#include <camera_interface.h>
+#include <decompression_scale.h>
+#include <frame.h>
+#include <frame_delivery.h>
+#include <frame_drop_statistics.h>
+#include <pixel_format.h>
+
+#include <memory>
+
+namespace webcam_capture {
+
+class FrameDropCounter;
+class FrameMailbox;
+class FrameQueue;
+class SoftwareProcAmp;
+
+/**
+ * Software stages a camera puts between the frames its driver delivers and the frame callback, the same on every
+ * backend: decompression and conversion the driver doesn't do, the properties the device has no controls for, the
+ * mailbox of captureFrame(), the queue of FrameDelivery::Queued and the counters of getDropStatistics().
+ * Each camera keeps one for as long as it exists, so captureFrame(), getDropStatistics() and the properties can be
+ * used from any thread whether the camera is capturing or not.
+ */
+class FramePipeline
+{
+public:
+    FramePipeline();
+    ~FramePipeline();
+
+    /**
+     * Wraps a callback into the stages, for the driver to call with every frame.
+     * @param callback Callback of the consumer, replaced by the wrapping one on success.
+     * @param pixelFormat Format the driver delivers the frames in.
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @param decompressFormat Format to decompress the frames into in software, PixelFormat::UNKNOWN if the driver
+     * decompresses them or they aren't compressed.
+     * @param decompressScale Scale to decompress at.
+     * @param convertFormat Format to convert the frames into in software, after decompressing them, PixelFormat::UNKNOWN
+     * if the driver converts them or no conversion was asked for.
+     * @param delivery Thread to call the callback on.
+     * @param backpressure What happens to frames that come in while the queue of FrameDelivery::Queued is full.
+     * @return 1 on success, -6 if the frames can't be decompressed into decompressFormat, -10 if they can't be converted
+     * into convertFormat.
+     */
+    int start(FrameCallback &callback, PixelFormat pixelFormat, int width, int height, PixelFormat decompressFormat,
+              DecompressionScale decompressScale, PixelFormat convertFormat, FrameDelivery delivery,
+              BackpressurePolicy backpressure);
+
+    /**
+     * Drops the frames still queued, so that the callback isn't called once it returns. To be called once the driver
+     * stopped delivering frames.
+     */
+    void stop();
+
+    /**
+     * @return The newest frame, see CameraInterface::captureFrame().
+     */
+    std::unique_ptr<Frame> captureFrame();
+
+    /**
+     * @return The counters since start() was last called, see CameraInterface::getDropStatistics().
+     */
+    FrameDropStatistics getDropStatistics() const;
+
+    /**
+     * @return Properties applied in software, for the ones the device doesn't support.
+     */
+    SoftwareProcAmp &getSoftwareProcAmp();
+
+    /**
+     * @return Counters of getDropStatistics(), for the drops of stages a backend runs itself.
+     */
+    std::shared_ptr<FrameDropCounter> getDropCounter() const;
+
+private:
+    FramePipeline(const FramePipeline &) = delete;
+    FramePipeline &operator=(const FramePipeline &) = delete;
+
+    std::shared_ptr<SoftwareProcAmp> softwareProcAmp; // brightness, contrast, saturation and gamma of the frames
+    std::shared_ptr<FrameMailbox> mailbox; // newest frame, for captureFrame()
+    std::shared_ptr<FrameDropCounter> drops; // frames delivered and dropped since start(), for getDropStatistics()
+    std::shared_ptr<FrameQueue> queue; // frames on their way to the callback, for FrameDelivery::Queued
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_PIPELINE_H
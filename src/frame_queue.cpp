@@ -0,0 +1,307 @@
+#include "frame_queue.h"
+
+#include "frame_drop_counter.h"
+
+#include <cstdint>
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Tells keyframes of compressed streams apart, by the first picture of the frame: H.264 frames with an IDR slice,
+ * MPEG-1 and MPEG-2 frames with an intra coded picture and MPEG-4 part 2 frames with an intra coded VOP.
+ * Frames of other formats, uncompressed or intra-only ones like MJPEG, and frames whose bitstream isn't recognized
+ * are all taken for keyframes.
+ */
+bool isKeyframe(const Frame &frame)
+{
+    switch (frame.pixelFormat) {
+        case PixelFormat::H264:
+        case PixelFormat::H264_ES:
+        case PixelFormat::MPEG2:
+        case PixelFormat::MPG1:
+        case PixelFormat::M4S2:
+        case PixelFormat::MP4S:
+        case PixelFormat::MP4V:
+            break;
+
+        default:
+            return true;
+    }
+
+    const uint8_t *data = frame.plane[0];
+
+    for (size_t i = 0; i + 5 < frame.bytes; i ++) {
+        // start codes of all three are 0x000001
+        if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+            continue;
+        }
+
+        switch (frame.pixelFormat) {
+            case PixelFormat::H264:
+            case PixelFormat::H264_ES: {
+                const int type = data[i + 3] & 0x1F;
+
+                // an IDR slice, or a non-IDR one
+                if (type == 5 || type == 1) {
+                    return type == 5;
+                }
+
+                break;
+            }
+
+            case PixelFormat::MPEG2:
+            case PixelFormat::MPG1:
+                // picture header, the coding type follows the 10-bit temporal reference
+                if (data[i + 3] == 0x00) {
+                    return ((data[i + 5] >> 3) & 0x07) == 1;
+                }
+
+                break;
+
+            default:
+                // VOP header, the coding type is in the top two bits
+                if (data[i + 3] == 0xB6) {
+                    return (data[i + 4] >> 6) == 0;
+                }
+
+                break;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+FrameQueue::FrameQueue(FrameCallback callback, BackpressurePolicy policy, std::shared_ptr<FrameDropCounter> drops,
+                       size_t capacity) :
+    callback(callback),
+    policy(policy),
+    drops(drops),
+    slots(capacity),
+    head(0),
+    tail(0),
+    awaitingKeyframe(false),
+    running(true),
+    sleeping(false),
+    blocked(false)
+{
+    for (size_t i = 0; i < slots.size(); i ++) {
+        slots[i].sequence = i;
+    }
+
+    thread = std::thread(&FrameQueue::run, this);
+}
+
+FrameQueue::~FrameQueue()
+{
+    stop();
+}
+
+FrameCallback FrameQueue::wrapCallback(std::shared_ptr<FrameQueue> queue)
+{
+    return [queue](Frame & frame) {
+        queue->push(frame);
+    };
+}
+
+void FrameQueue::prepare(PixelFormat pixelFormat, size_t width, size_t height)
+{
+    buffer.prepare(pixelFormat, width, height);
+}
+
+void FrameQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+
+    wakeUp.notify_one();
+    slotFreed.notify_one();
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void FrameQueue::push(const Frame &frame)
+{
+    if (!frame.plane[0]) {
+        return;
+    }
+
+    if (!running.load(std::memory_order_relaxed)) {
+        FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+        return;
+    }
+
+    const bool keyframe = policy != BackpressurePolicy::KeyframesOnly || isKeyframe(frame);
+
+    // frames following a dropped one reference it, up to the next keyframe
+    if (awaitingKeyframe && !keyframe) {
+        FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+        return;
+    }
+
+    Slot *slot = getFreeSlot();
+
+    if (!slot) {
+        Frame dropped;
+
+        switch (policy) {
+            case BackpressurePolicy::DropNewest:
+                break;
+
+            case BackpressurePolicy::DropOldest:
+                if (take(dropped)) {
+                    FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+                }
+
+                slot = getFreeSlot();
+                break;
+
+            case BackpressurePolicy::Block:
+                slot = waitForFreeSlot();
+                break;
+
+            case BackpressurePolicy::KeyframesOnly:
+                if (!keyframe) {
+                    awaitingKeyframe = true;
+                    break;
+                }
+
+                // the queued frames are older than the keyframe and the callback doesn't need them to decode it
+                while (take(dropped)) {
+                    dropped = Frame();
+                    FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+                }
+
+                slot = getFreeSlot();
+                break;
+        }
+
+        // also when the queue's thread is still taking the frame out of the slot freed for this one
+        if (!slot) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+            return;
+        }
+    }
+
+    if (!buffer.copy(frame, slot->frame)) {
+        slot->frame = Frame();
+        FrameDropCounter::count(drops, FrameDropCounter::Reason::PoolExhausted);
+        awaitingKeyframe = policy == BackpressurePolicy::KeyframesOnly;
+        return;
+    }
+
+    awaitingKeyframe = false;
+
+    const size_t position = tail.load(std::memory_order_relaxed);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // sequentially consistent, so that either the queue's thread sees the frame before going to sleep, or this
+    // thread sees it sleeping
+    tail.store(position + 1);
+
+    if (sleeping.load()) {
+        // taking the lock makes sure the queue's thread is waiting already, and not about to
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeUp.notify_one();
+    }
+}
+
+FrameQueue::Slot *FrameQueue::getFreeSlot()
+{
+    const size_t position = tail.load(std::memory_order_relaxed);
+    Slot &slot = slots[position % slots.size()];
+
+    return slot.sequence.load() == position ? &slot : nullptr;
+}
+
+FrameQueue::Slot *FrameQueue::waitForFreeSlot()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // sequentially consistent, so that either the queue's thread sees this thread blocked, or this thread sees the
+    // slot it freed
+    blocked = true;
+    Slot *slot = getFreeSlot();
+
+    while (!slot && running) {
+        slotFreed.wait(lock);
+        slot = getFreeSlot();
+    }
+
+    blocked = false;
+
+    return slot;
+}
+
+bool FrameQueue::take(Frame &frame)
+{
+    size_t position = head.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot &slot = slots[position % slots.size()];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence == position + 1) {
+            // claims the frame, unless the other thread took it first, which moves position on to the next one
+            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                frame = slot.frame;
+                slot.frame = Frame();
+
+                // the slot gets filled next a lap ahead
+                slot.sequence.store(position + slots.size());
+
+                return true;
+            }
+        } else if (sequence == position) {
+            // the slot was never filled at this position, the ring is empty
+            return false;
+        } else {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void FrameQueue::run()
+{
+    // the acquire makes the capture thread's last writes, which happened before stop(), visible to the cleanup below
+    while (running.load(std::memory_order_acquire)) {
+        Frame frame;
+
+        if (!take(frame)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            sleeping = true;
+
+            if (running && head.load() == tail.load()) {
+                wakeUp.wait(lock);
+            }
+
+            sleeping = false;
+            continue;
+        }
+
+        if (blocked.load()) {
+            // taking the lock makes sure the capture thread is waiting already, and not about to
+            std::lock_guard<std::mutex> lock(mutex);
+            slotFreed.notify_one();
+        }
+
+        callback(frame);
+    }
+
+    // the frames left in the ring go back to the pool, dropped as the callback didn't get to them
+    Frame frame;
+
+    while (take(frame)) {
+        frame = Frame();
+        FrameDropCounter::count(drops, FrameDropCounter::Reason::QueueFull);
+    }
+}
+
+} // namespace webcam_capture
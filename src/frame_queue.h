@@ -0,0 +1,133 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <backpressure_policy.h>
+#include <camera_interface.h>
+#include <frame.h>
+
+#include "frame_buffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace webcam_capture {
+
+class FrameDropCounter;
+
+/**
+ * Bounded queue handing frames from the capture thread of a backend over to a thread of its own, which passes them to
+ * the callback, for FrameDelivery::Queued.
+ * It's a ring of slots with a sequence number each, which tells whether the slot is free or holds a frame: the capture
+ * thread copies the frame into a buffer of the FrameBufferPool and publishes it with an atomic store, and the queue's
+ * thread takes it with another, so the capture thread never waits on the callback and keeps asking the driver for
+ * frames at its rate. Frames are copied rather than holding on to the driver's buffers, which would starve the small
+ * pools of the drivers just the same.
+ * The queue's thread claims frames with a compare and swap on the head of the ring, so that the capture thread can
+ * drop the oldest frames too when the ring is full, as the BackpressurePolicy has it.
+ * The only locks are taken to wake up a thread that went to sleep, the queue's thread on an empty ring, or the capture
+ * thread on a full one with BackpressurePolicy::Block.
+ */
+class FrameQueue
+{
+public:
+    /**
+     * Number of frames the ring holds, enough to absorb a callback that is late by a few frames without adding much
+     * latency.
+     */
+    static const size_t DEFAULT_CAPACITY = 4;
+
+    /**
+     * Starts the queue's thread.
+     * @param callback Callback to pass the frames to, on the queue's thread.
+     * @param policy What to do with frames that come in while the ring is full.
+     * @param drops Counter of the camera to count dropped frames into, if any.
+     */
+    FrameQueue(FrameCallback callback, BackpressurePolicy policy, std::shared_ptr<FrameDropCounter> drops,
+               size_t capacity = DEFAULT_CAPACITY);
+    ~FrameQueue();
+
+    /**
+     * Wraps the queue into a callback that queues every frame, to be called on the capture thread.
+     * @return The wrapping callback.
+     */
+    static FrameCallback wrapCallback(std::shared_ptr<FrameQueue> queue);
+
+    /**
+     * Prewarms the buffers of the frames to be queued. To be called before the capture thread queues the first one.
+     */
+    void prepare(PixelFormat pixelFormat, size_t width, size_t height);
+
+    /**
+     * Stops the queue's thread, dropping the frames still in the ring. To be called once the capture thread stopped
+     * delivering frames, frames that come in anyway are dropped. Both count as FrameDropCounter::Reason::QueueFull.
+     * Waits for the callback to return, so it must not be called from the callback.
+     */
+    void stop();
+
+private:
+    FrameQueue(const FrameQueue &) = delete;
+    FrameQueue &operator=(const FrameQueue &) = delete;
+
+    struct Slot {
+        Frame frame;
+
+        // position the slot gets filled at next while it's free, one past the position of its frame while it's not
+        std::atomic<size_t> sequence;
+    };
+
+    /**
+     * Copies a frame into the ring, or drops it. Called on the capture thread only.
+     */
+    void push(const Frame &frame);
+
+    /**
+     * @return The slot at the tail if it's free, nullptr if the ring is full.
+     */
+    Slot *getFreeSlot();
+
+    /**
+     * Waits for the queue's thread to free a slot, for BackpressurePolicy::Block.
+     * @return The slot at the tail, nullptr if the queue was stopped while waiting.
+     */
+    Slot *waitForFreeSlot();
+
+    /**
+     * Takes the frame at the head, on the queue's thread to pass it on, or on the capture thread to drop it.
+     * @return true if there was one.
+     */
+    bool take(Frame &frame);
+
+    /**
+     * Passes the frames in the ring to the callback until stop() is called. Runs on the queue's thread.
+     */
+    void run();
+
+    const FrameCallback callback;
+    const BackpressurePolicy policy;
+    const std::shared_ptr<FrameDropCounter> drops;
+
+    std::vector<Slot> slots;
+    std::atomic<size_t> head; // position of the next frame to take
+    std::atomic<size_t> tail; // position of the next slot to fill, written by the capture thread
+
+    // owned by the capture thread
+    FrameBuffer buffer;
+    bool awaitingKeyframe;
+
+    std::atomic<bool> running;
+    std::atomic<bool> sleeping; // the queue's thread waits for a frame
+    std::atomic<bool> blocked; // the capture thread waits for a free slot
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable slotFreed;
+    std::thread thread;
+};
+
+} // namespace webcam_capture
+
+#endif // FRAME_QUEUE_H
@@ -0,0 +1,88 @@
+#include <frame_ref.h>
+
+#include "frame_buffer.h"
+#include "utils.h"
+
+namespace webcam_capture {
+
+namespace {
+
+std::shared_ptr<const Frame> retainFrame(const Frame &frame, FrameBuffer &buffer)
+{
+    if (!frame.plane[0]) {
+        DEBUG_PRINT("Error: The frame has no pixel data.");
+        return nullptr;
+    }
+
+    std::shared_ptr<Frame> retained = std::make_shared<Frame>(frame);
+
+    // frames whose buffer the library owns are shared, the rest get copied
+    if (!frame.owner && !buffer.copy(frame, *retained)) {
+        return nullptr;
+    }
+
+    return retained;
+}
+
+} // namespace
+
+FrameRef::FrameRef()
+{
+    // empty
+}
+
+FrameRef FrameRef::retain(const Frame &frame)
+{
+    // a single frame is copied, so the pool isn't prewarmed with buffers for more
+    FrameBuffer buffer(1);
+    FrameRef ref;
+    ref.frame = retainFrame(frame, buffer);
+
+    return ref;
+}
+
+FrameCallback FrameRef::wrapCallback(FrameRefCallback callback)
+{
+    if (!callback) {
+        return FrameCallback();
+    }
+
+    // keeps the pool copies come from for as long as the camera delivers frames
+    std::shared_ptr<FrameBuffer> buffer = std::make_shared<FrameBuffer>();
+
+    return [callback, buffer](Frame & frame) {
+        FrameRef ref;
+        ref.frame = retainFrame(frame, *buffer);
+
+        if (ref) {
+            callback(ref);
+        }
+    };
+}
+
+const Frame *FrameRef::get() const
+{
+    return frame.get();
+}
+
+const Frame &FrameRef::operator*() const
+{
+    return *frame;
+}
+
+const Frame *FrameRef::operator->() const
+{
+    return frame.get();
+}
+
+FrameRef::operator bool() const
+{
+    return frame != nullptr;
+}
+
+void FrameRef::reset()
+{
+    frame.reset();
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,13 @@
+#include <frame_scaler.h>
+
+#include "frame_converter.h"
+
+namespace webcam_capture {
+
+FrameCallback FrameScaler::wrapCallback(size_t width, size_t height, ScaleFilter filter, FrameCallback callback,
+        PixelFormat pixelFormat)
+{
+    return FrameConverter::wrapScalingCallback(width, height, filter, PixelFormat::UNKNOWN, callback, pixelFormat);
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,105 @@
+#include <frame_view.h>
+
+#include <frame_layout.h>
+
+#include "utils.h"
+
+#include <algorithm>
+
+namespace webcam_capture {
+
+namespace {
+
+/**
+ * Interval [begin, end) of rows or columns, grown outwards to multiples of alignment and clipped to size.
+ */
+void alignInterval(size_t &begin, size_t &end, size_t alignment, size_t size)
+{
+    begin = begin / alignment * alignment;
+    end = std::min((end + alignment - 1) / alignment * alignment, size);
+}
+
+} // namespace
+
+Rect FrameView::alignRect(const Frame &frame, const Rect &rect)
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+    Rect aligned = Rect();
+
+    if (!traits || rect.x >= width || rect.y >= height || !rect.width || !rect.height) {
+        return aligned;
+    }
+
+    // Bayer cells are 2x2 whatever the traits say, otherwise a crop would change the color of the first sample
+    const bool bayer = traits->colorModel == ColorModel::Bayer;
+    const size_t columns = bayer ? 2 : std::max<size_t>(traits->blockWidth, size_t(1) << traits->chromaShiftX);
+    const size_t rows = bayer ? 2 : size_t(1) << traits->chromaShiftY;
+
+    size_t left = rect.x;
+    size_t right = rect.width < width - rect.x ? rect.x + rect.width : width;
+    alignInterval(left, right, columns, width);
+
+    // chroma rows pair up with luma rows in memory order, so bottom-up frames get their rows aligned from the bottom
+    const bool bottomUp = frame.orientation == Orientation::BottomUp;
+    const size_t bottom = rect.height < height - rect.y ? rect.y + rect.height : height;
+    size_t first = bottomUp ? height - bottom : rect.y;
+    size_t last = bottomUp ? height - rect.y : bottom;
+    alignInterval(first, last, rows, height);
+
+    aligned.x = left;
+    aligned.y = bottomUp ? height - last : first;
+    aligned.width = right - left;
+    aligned.height = last - first;
+
+    return aligned;
+}
+
+bool FrameView::crop(const Frame &frame, const Rect &rect, Frame &view)
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+    const Rect aligned = alignRect(frame, rect);
+
+    if (!frame.plane[0] || !aligned.width) {
+        DEBUG_PRINT("Error: The frame has no pixel data, is compressed or doesn't contain the rectangle.");
+        return false;
+    }
+
+    // strides and offsets of the whole frame, with the ones it leaves unset derived from its luma stride
+    Frame layout = frame;
+    FrameLayout::setLayout(layout, frame.width[0], frame.height[0]);
+
+    // first row of the rectangle in memory
+    const size_t top = frame.orientation == Orientation::BottomUp ? frame.height[0] - aligned.y - aligned.height :
+                       aligned.y;
+
+    view = layout;
+    FrameLayout::setLayout(view, aligned.width, aligned.height);
+
+    view.plane[0] = frame.plane[0] + top * layout.stride[0] + aligned.x / traits->blockWidth * traits->blockBytes;
+
+    const size_t rowBytes = (aligned.width + traits->blockWidth - 1) / traits->blockWidth * traits->blockBytes;
+    const uint8_t *end = view.plane[0] + (aligned.height - 1) * view.stride[0] + rowBytes;
+
+    // a chroma plane of a semi-planar format holds a pair of samples per subsampled pixel
+    const size_t chromaBytes = traits->packing == PixelPacking::SemiPlanar ? traits->blockBytes * 2 :
+                               traits->blockBytes;
+
+    for (int i = 1; i < traits->planes; i ++) {
+        const uint8_t *plane = frame.plane[i] ? frame.plane[i] : frame.plane[0] + layout.offset[i];
+
+        view.plane[i] = const_cast<uint8_t *>(plane) + (top >> traits->chromaShiftY) * layout.stride[i] +
+                        (aligned.x >> traits->chromaShiftX) * chromaBytes;
+        view.offset[i] = view.plane[i] > view.plane[0] ? view.plane[i] - view.plane[0] : 0;
+
+        end = std::max<const uint8_t *>(end, view.plane[i] + (view.height[i] - 1) * view.stride[i] +
+                                        view.width[i] * chromaBytes);
+    }
+
+    view.bytes = end - view.plane[0];
+
+    return true;
+}
+
+} // namespace webcam_capture
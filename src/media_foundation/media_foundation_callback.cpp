@@ -5,7 +5,9 @@
   */
 
 #include <atlbase.h>
+#include "../frame_drop_counter.h"
 #include "../utils.h"
+#include "../winapi_shared/winapi_shared_frame_layout.h"
 #include "media_foundation_utils.h"
 #include "media_foundation_callback.h"
 #include "media_foundation_camera.h"
@@ -21,6 +23,7 @@ namespace webcam_capture {
 MediaFoundation_Callback::MediaFoundation_Callback(int width, int height, PixelFormat pixelFormat, FrameCallback &frameCallback, std::unique_ptr<MediaFoundation_DecompresserTransform> decompresser, std::unique_ptr<MediaFoundation_ColorConverterTransform> colorConverter) :
     referenceCount(1),
     sourceReader(nullptr),
+    frame(),
     frameCallback(frameCallback),
     decompresser(std::move(decompresser)),
     colorConverter(std::move(colorConverter)),
@@ -43,6 +46,22 @@ void MediaFoundation_Callback::setSourceReader(IMFSourceReader *sourceReader)
     this->sourceReader = sourceReader;
 }
 
+void MediaFoundation_Callback::setColorimetry(ColorSpace colorSpace, ColorRange colorRange)
+{
+    frame.colorSpace = colorSpace;
+    frame.colorRange = colorRange;
+}
+
+void MediaFoundation_Callback::setOrientation(Orientation orientation)
+{
+    frame.orientation = orientation;
+}
+
+void MediaFoundation_Callback::setDropCounter(std::shared_ptr<FrameDropCounter> drops)
+{
+    this->drops = drops;
+}
+
 HRESULT MediaFoundation_Callback::QueryInterface(REFIID iid, void **v)
 {
     static const QITAB qit[] = { QITABENT(MediaFoundation_Callback, IMFSourceReaderCallback), 0 };
@@ -73,22 +92,38 @@ HRESULT MediaFoundation_Callback::OnReadSample(HRESULT hr, DWORD streamIndex, DW
     if (SUCCEEDED(hr) && sample) {
         IMFSample *finalSample = sample;
 
+        // buffers the next sample gets written into can't be handed out past the callback, FrameRef copies them
+        bool retainable = true;
+        bool converted = true;
+
         if (decompresser) {
             if (!decompresser->convert(sample, &finalSample)) {
                 DEBUG_PRINT("Failed to decompress.");
+                converted = false;
             } else {
                 sample = finalSample;
+                retainable = !decompresser->reusesOutputSample();
             }
         }
 
-        if (colorConverter) {
+        if (converted && colorConverter) {
             if (!colorConverter->convert(sample, &finalSample)) {
                 DEBUG_PRINT("Failed to convert color.");
+                converted = false;
+            } else {
+                retainable = !colorConverter->reusesOutputSample();
             }
         }
 
         DWORD count = 0;
-        HRESULT hr = finalSample->GetBufferCount(&count);
+        HRESULT hr = S_OK;
+
+        // the sample isn't in the format the callback expects, so it gets dropped, and the next one read
+        if (!converted) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::DecodeFailed);
+        } else {
+            hr = finalSample->GetBufferCount(&count);
+        }
 
         for (DWORD i = 0; i < count; ++i) {
             CComPtr<IMFMediaBuffer> buffer;
@@ -99,19 +134,68 @@ HRESULT MediaFoundation_Callback::OnReadSample(HRESULT hr, DWORD streamIndex, DW
             }
 
             DWORD length = 0;
+
+#if (WINVER >= _WIN32_WINNT_WIN8)
+            // 2D buffers hand out their rows in place, with the pitch they have. Locking them as 1D buffers would copy
+            // them into a contiguous one first
+            CComQIPtr<IMF2DBuffer2> buffer2d(buffer);
+            BYTE *scanline = nullptr;
+            LONG pitch = 0;
+            BYTE *start = nullptr;
+
+            if (buffer2d && SUCCEEDED(buffer2d->Lock2DSize(MF2DBuffer_LockFlags_Read, &scanline, &pitch, &start, &length))) {
+                // bottom-up buffers have a negative pitch, those get locked as 1D ones, which have the rows in order
+                if (pitch > 0 && WinapiShared_FrameLayout::setLayout(frame, scanline, length - (scanline - start), pitch)) {
+                    // the buffer stays locked for as long as a FrameRef holds the frame
+                    if (retainable) {
+                        frame.owner = std::shared_ptr<void>(buffer2d.Detach(), [](void *buffer) {
+                            static_cast<IMF2DBuffer2 *>(buffer)->Unlock2D();
+                            static_cast<IMF2DBuffer2 *>(buffer)->Release();
+                        });
+                    }
+
+                    frameCallback(frame);
+
+                    if (retainable) {
+                        frame.owner.reset();
+                    } else {
+                        buffer2d->Unlock2D();
+                    }
+
+                    continue;
+                }
+
+                buffer2d->Unlock2D();
+            }
+#endif
+
             DWORD max_length = 0;
             BYTE *data = nullptr;
-            buffer->Lock(&data, &max_length, &length);
-
-            frame.bytes = static_cast<size_t>(length);
-            frame.plane[0] = data;
-            /* TODO(nurupo): figure out how to deal with planar images
-            frame.plane[1] = data + frame.offset[1];
-            frame.plane[2] = data + frame.offset[2];
-            */
-            frameCallback(frame);
 
-            buffer->Unlock();
+            if (FAILED(buffer->Lock(&data, &max_length, &length))) {
+                break;
+            }
+
+            if (!WinapiShared_FrameLayout::setLayout(frame, data, length, 0)) {
+                DEBUG_PRINT("Error: The buffer is too short for the frame.");
+                buffer->Unlock();
+                continue;
+            }
+
+            if (!retainable) {
+                frameCallback(frame);
+                buffer->Unlock();
+                continue;
+            }
+
+            // the buffer stays locked for as long as a FrameRef holds the frame
+            frame.owner = std::shared_ptr<void>(buffer.Detach(), [](void *buffer) {
+                static_cast<IMFMediaBuffer *>(buffer)->Unlock();
+                static_cast<IMFMediaBuffer *>(buffer)->Release();
+            });
+
+            frameCallback(frame);
+            frame.owner.reset();
         }
     }
 
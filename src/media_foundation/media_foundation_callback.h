@@ -26,6 +26,7 @@
 
 namespace webcam_capture {
 
+class FrameDropCounter;
 class MediaFoundation_Camera;
 
 class MediaFoundation_Callback : public IMFSourceReaderCallback
@@ -34,6 +35,21 @@ public:
     MediaFoundation_Callback(int width, int height, PixelFormat pixelFormat, FrameCallback &frameCallback, std::unique_ptr<MediaFoundation_DecompresserTransform> decompresser, std::unique_ptr<MediaFoundation_ColorConverterTransform> colorConverter);
     void setSourceReader(IMFSourceReader *sourceReader);
 
+    /**
+     * Sets the colorimetry frames are reported with.
+     */
+    void setColorimetry(ColorSpace colorSpace, ColorRange colorRange);
+
+    /**
+     * Sets the order the rows of the frames are reported to be stored in.
+     */
+    void setOrientation(Orientation orientation);
+
+    /**
+     * Sets the counter to count the samples the transforms fail to convert into.
+     */
+    void setDropCounter(std::shared_ptr<FrameDropCounter> drops);
+
     STDMETHODIMP QueryInterface(REFIID iid, void **v);
     STDMETHODIMP_(ULONG) AddRef();
     STDMETHODIMP_(ULONG) Release();
@@ -56,6 +72,7 @@ private:
     FrameCallback frameCallback;
     std::unique_ptr<MediaFoundation_DecompresserTransform> decompresser;
     std::unique_ptr<MediaFoundation_ColorConverterTransform> colorConverter;
+    std::shared_ptr<FrameDropCounter> drops;
     long referenceCount;
     CRITICAL_SECTION criticalSection;
     std::atomic<bool> keepRunning;
@@ -1,7 +1,10 @@
 #include <atlbase.h>
 #include "media_foundation_camera.h"
 
+#include <pixel_format_converter.h>
+
 #include "../capability_tree_builder.h"
+#include "../software_proc_amp.h"
 #include "../utils.h"
 #include "../winapi_shared/winapi_shared_unique_id.h"
 #include "media_foundation_callback.h"
@@ -60,7 +63,7 @@ MediaFoundation_Camera::~MediaFoundation_Camera()
     MediaFoundation_Utils::safeRelease(&imfMediaSource);
 }
 
-int MediaFoundation_Camera::start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat, PixelFormat decompressFormat)
+int MediaFoundation_Camera::start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat, PixelFormat decompressFormat, DecompressionScale decompressScale, FrameDelivery delivery, BackpressurePolicy backpressure)
 {
     if (!cb) {
         DEBUG_PRINT("Error: The callback function is empty. Capturing was not started.");
@@ -106,37 +109,60 @@ int MediaFoundation_Camera::start(PixelFormat pixelFormat, int width, int height
     }
 
     std::unique_ptr<MediaFoundation_DecompresserTransform> decompresser;
+    bool softwareDecompression = false;
 
     // Set Decoder formats
     if (decompressFormat != PixelFormat::UNKNOWN) {
-        MediaFoundation_DecompresserTransform::RESULT res;
-        decompresser = MediaFoundation_DecompresserTransform::getInstance(width, height, pixelFormat, decompressFormat, res);
-        if (res != MediaFoundation_DecompresserTransform::RESULT::OK) {
-            DEBUG_PRINT("Error: Can't set the decompressor formats.");
-            return -6;      //TODO Err code
+        MediaFoundation_DecompresserTransform::RESULT res = MediaFoundation_DecompresserTransform::RESULT::OK;
+
+        // the transform can't scale, and might not be there at all, so fall back to the software decompression then
+        if (decompressScale == DecompressionScale::Full) {
+            decompresser = MediaFoundation_DecompresserTransform::getInstance(width, height, pixelFormat, decompressFormat, res);
+        }
+
+        if (decompressScale != DecompressionScale::Full || res != MediaFoundation_DecompresserTransform::RESULT::OK) {
+            decompresser.reset();
+            softwareDecompression = true;
         }
     }
 
     std::unique_ptr<MediaFoundation_ColorConverterTransform> colorConvertor;
 
+    const PixelFormat convertFormat = decompressFormat == PixelFormat::UNKNOWN ? pixelFormat : decompressFormat;
+
     // Set Decoder formats
-    if (decodeFormat != PixelFormat::UNKNOWN) {
+    // the color converter transform takes samples, which the software decompression doesn't produce, and is only
+    // needed for conversions the planner has no software chain for, it picks the cheapest one otherwise
+    if (decodeFormat != PixelFormat::UNKNOWN && !softwareDecompression &&
+            PixelFormatConverter::getConversionPath(convertFormat, decodeFormat, width, height).empty()) {
         MediaFoundation_ColorConverterTransform::RESULT res;
-        if (decompressFormat == PixelFormat::UNKNOWN ) {
-            colorConvertor = MediaFoundation_ColorConverterTransform::getInstance(width, height, pixelFormat, decodeFormat, res);
-        } else {
-            colorConvertor = MediaFoundation_ColorConverterTransform::getInstance(width, height, decompressFormat, decodeFormat, res);
-        }
+        colorConvertor = MediaFoundation_ColorConverterTransform::getInstance(width, height, convertFormat, decodeFormat, res);
+
         if (res != MediaFoundation_ColorConverterTransform::RESULT::OK) {
-            DEBUG_PRINT("Error: Can't set the decoder formats.");
-            return -10;      //TODO Err code
+            colorConvertor.reset();
         }
     }
 
+    const bool softwareConversion = decodeFormat != PixelFormat::UNKNOWN && !colorConvertor;
+
+    // the transforms hand over the frames they output, the software stages do what they can't, and the pipeline is
+    // stopped on every failure below, so that its queue's thread doesn't outlive a failed start()
+    const int result = pipeline.start(cb, decompresser ? decompressFormat : pixelFormat, width, height,
+                                      softwareDecompression ? decompressFormat : PixelFormat::UNKNOWN, decompressScale,
+                                      softwareConversion ? decodeFormat : PixelFormat::UNKNOWN, delivery, backpressure);
+
+    if (result < 0) {
+        return result;
+    }
+
     //Create mfCallback
-    mfCallback = new MediaFoundation_Callback(width, height, decodeFormat == PixelFormat::UNKNOWN ? (decompressFormat == PixelFormat::UNKNOWN ? pixelFormat : decompressFormat) : decodeFormat, cb, std::move(decompresser), std::move(colorConvertor));
+    // the callback gets the frames as the transforms output them, software stages in cb do the rest
+    const PixelFormat callbackFormat = colorConvertor ? decodeFormat : (decompresser ? decompressFormat : pixelFormat);
+    const bool transformed = decompresser || colorConvertor;
+    mfCallback = new MediaFoundation_Callback(width, height, callbackFormat, cb, std::move(decompresser), std::move(colorConvertor));
     if (!mfCallback) {
         DEBUG_PRINT("Error: Couldn't create callback.");
+        pipeline.stop();
         return -14;
     }
 
@@ -144,19 +170,37 @@ int MediaFoundation_Camera::start(PixelFormat pixelFormat, int width, int height
     if (createSourceReader(imfMediaSource, mfCallback, &imfSourceReader) < 0) {
         DEBUG_PRINT("Error: Can't create the source reader.");
         MediaFoundation_Utils::safeRelease(&mfCallback);
+        pipeline.stop();
         return -11;      //TODO Err code
     }
 
     mfCallback->setSourceReader(imfSourceReader);
+    mfCallback->setDropCounter(pipeline.getDropCounter());
 
     // Set the source reader format
     if (setReaderFormat(imfSourceReader, width, height, pixelFormat, fps) < 0) {
         DEBUG_PRINT("Error: Can't set the reader format.");
         MediaFoundation_Utils::safeRelease(&mfCallback);
         MediaFoundation_Utils::safeRelease(&imfSourceReader);
+        pipeline.stop();
         return -12;      //TODO Err code
     }
 
+    // the colorimetry and orientation are known only once the reader has negotiated the format
+    CComPtr<IMFMediaType> currentMediaType;
+
+    if (SUCCEEDED(imfSourceReader->GetCurrentMediaType(MF_SOURCE_READER_FIRST_VIDEO_STREAM, &currentMediaType))) {
+        ColorSpace colorSpace;
+        ColorRange colorRange;
+        MediaFoundation_Utils::mediaTypeToColorimetry(currentMediaType, colorSpace, colorRange);
+        mfCallback->setColorimetry(colorSpace, colorRange);
+
+        // the transforms output top-down frames, only the frames delivered as read can be bottom-up
+        if (!transformed) {
+            mfCallback->setOrientation(MediaFoundation_Utils::mediaTypeToOrientation(currentMediaType));
+        }
+    }
+
     // Kick off the capture stream.
     HRESULT hr = imfSourceReader->ReadSample(MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, NULL, NULL, NULL, NULL);
 
@@ -179,6 +223,7 @@ int MediaFoundation_Camera::start(PixelFormat pixelFormat, int width, int height
 
         MediaFoundation_Utils::safeRelease(&mfCallback);
         MediaFoundation_Utils::safeRelease(&imfSourceReader);
+        pipeline.stop();
 
         return -4;      //TODO Err code
     }
@@ -198,6 +243,9 @@ int MediaFoundation_Camera::stop()
 
     mfCallback->stop();
 
+    // frames still queued are dropped, so that the callback isn't called once stop() returned
+    pipeline.stop();
+
     MediaFoundation_Utils::safeRelease(&imfSourceReader);
     MediaFoundation_Utils::safeRelease(&mfCallback);
 
@@ -206,8 +254,12 @@ int MediaFoundation_Camera::stop()
 
 std::unique_ptr<Frame> MediaFoundation_Camera::captureFrame()
 {
-    //TODO to realise method
-    return nullptr;
+    return pipeline.captureFrame();
+}
+
+FrameDropStatistics MediaFoundation_Camera::getDropStatistics()
+{
+    return pipeline.getDropStatistics();
 }
 
 // ---- Capabilities ----
@@ -241,9 +293,9 @@ bool MediaFoundation_Camera::getPropertyRange(VideoProperty property, VideoPrope
 
     HRESULT hr = imfMediaSource->QueryInterface(IID_PPV_ARGS(&pProcAmp));
 
+    // devices without image controls get them in software
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Can't get IAMVideoProcAmp object.", hr);
-        return false;
+        return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
     }
 
     switch (property) {
@@ -262,6 +314,11 @@ bool MediaFoundation_Camera::getPropertyRange(VideoProperty property, VideoPrope
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             DEBUG_PRINT("Error: Unsupported VideoProperty.");
             return false;
@@ -270,9 +327,10 @@ bool MediaFoundation_Camera::getPropertyRange(VideoProperty property, VideoPrope
 
     hr = pProcAmp->GetRange(ampProperty, &lMin, &lMax, &lStep, &lDefault, &lCaps);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Couldn't get range of the VideoProperty.", hr);
-        return false;
+        pProcAmp->Release();
+        return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
     }
 
     videoPropRange = VideoPropertyRange(lMin, lMax, lStep, lDefault);
@@ -289,9 +347,9 @@ int MediaFoundation_Camera::getProperty(VideoProperty property)
     VideoProcAmpProperty ampProperty;
     HRESULT hr = imfMediaSource->QueryInterface(IID_PPV_ARGS(&pProcAmp));
 
+    // devices without image controls get them in software
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Can't get IAMVideoProcAmp object.", hr);
-        return -99999;///TODO to return error value
+        return pipeline.getSoftwareProcAmp().getProperty(property);
     }
 
     switch (property) {
@@ -310,6 +368,11 @@ int MediaFoundation_Camera::getProperty(VideoProperty property)
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             DEBUG_PRINT("Error: Unsupported VideoProperty.");
             return -99999; ///TODO to return error value
@@ -320,9 +383,10 @@ int MediaFoundation_Camera::getProperty(VideoProperty property)
     long flags;
     hr = pProcAmp->Get(ampProperty, &value, &flags);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Couldn't get value of the VideoProperty.", hr);
-        return -99999;
+        pProcAmp->Release();
+        return pipeline.getSoftwareProcAmp().getProperty(property);
     }
 
     return value;
@@ -336,9 +400,9 @@ bool MediaFoundation_Camera::setProperty(const VideoProperty property, const int
     VideoProcAmpProperty ampProperty;
     HRESULT hr = imfMediaSource->QueryInterface(IID_PPV_ARGS(&pProcAmp));
 
+    // devices without image controls get them in software
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Can't get IAMVideoProcAmp object.", hr);
-        return false;
+        return pipeline.getSoftwareProcAmp().setProperty(property, value);
     }
 
     switch (property) {
@@ -357,6 +421,11 @@ bool MediaFoundation_Camera::setProperty(const VideoProperty property, const int
             break;
         }
 
+        case VideoProperty::Gamma : {
+            ampProperty = VideoProcAmp_Gamma;
+            break;
+        }
+
         default: {
             return 0; ///TODO to return error value
         }
@@ -366,9 +435,10 @@ bool MediaFoundation_Camera::setProperty(const VideoProperty property, const int
     long flags;
     hr = pProcAmp->Get(ampProperty, &val, &flags);
 
+    // and so do the properties the device has no control for
     if (FAILED(hr)) {
-        DEBUG_PRINT_HR_ERROR("Couldn't get value of the VideoProperty.", hr);
-        return false;
+        pProcAmp->Release();
+        return pipeline.getSoftwareProcAmp().setProperty(property, value);
     }
 
     hr = pProcAmp->Set(ampProperty, value, flags);
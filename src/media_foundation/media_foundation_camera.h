@@ -14,6 +14,8 @@
 #include <video_property.h>
 #include <video_property_range.h>
 
+#include "../frame_pipeline.h"
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,9 +39,10 @@ public:
     ~MediaFoundation_Camera();
     static std::unique_ptr<CameraInterface> create(std::shared_ptr<void> mfDeinitializer, const CameraInformation &information);
 
-    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN);
+    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN, DecompressionScale decompressScale = DecompressionScale::Full, FrameDelivery delivery = FrameDelivery::Direct, BackpressurePolicy backpressure = BackpressurePolicy::DropNewest);
     int stop();
-    std::unique_ptr<Frame> captureFrame();  //TODO
+    std::unique_ptr<Frame> captureFrame();
+    FrameDropStatistics getDropStatistics();
     // ---- Capabilities ----
     bool getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange);
     int getProperty(VideoProperty property);
@@ -83,6 +86,7 @@ public:
     bool capturing;
     CameraInformation information;
     FrameCallback frameCallback;
+    FramePipeline pipeline; // software stages between the transforms and the callback
 };
 
 } // namespace webcam_capture
@@ -217,6 +217,11 @@ MediaFoundation_PixelFormatTransform::~MediaFoundation_PixelFormatTransform()
     }
 }
 
+bool MediaFoundation_PixelFormatTransform::reusesOutputSample() const
+{
+    return weAllocateOutputSample;
+}
+
 bool MediaFoundation_PixelFormatTransform::convert(IMFSample *inputSample, IMFSample **outputSample)
 {
     HRESULT hr = transform->ProcessInput(inputStreamId, inputSample, 0);
@@ -43,6 +43,12 @@ public:
      */
     bool convert(IMFSample *inputSample, IMFSample **outputSample);
 
+    /**
+     * @return true if every sample gets converted into the same buffer, so that the output of a conversion is valid only
+     * until the next one.
+     */
+    bool reusesOutputSample() const;
+
 protected:
     static std::unique_ptr<MediaFoundation_PixelFormatTransform> getInstance(CComPtr<IMFTransform> &transform, int width, int height, PixelFormat inputPixelFormat, PixelFormat outputPixelFormat, RESULT &result);
     MediaFoundation_PixelFormatTransform(MediaFoundation_PixelFormatTransform &&other);
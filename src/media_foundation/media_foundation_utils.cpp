@@ -1,6 +1,7 @@
 #include "media_foundation_utils.h"
 
 #include "../utils.h"
+#include "../winapi_shared/winapi_shared_bayer_subtypes.h"
 
 #include <pixel_format.h>
 
@@ -89,6 +90,13 @@ PixelFormat MediaFoundation_Utils::videoFormatToPixelFormat(const GUID &guid)
         }
     }
 
+    // Media Foundation doesn't define Bayer subtypes
+    const PixelFormat bayerFormat = WinapiShared_BayerSubtypes::toPixelFormat(guid);
+
+    if (bayerFormat != PixelFormat::UNKNOWN) {
+        return bayerFormat;
+    }
+
 #ifdef WEBCAM_CAPTURE_DEBUG
     LPOLESTR guidString = NULL;
     HRESULT hr = StringFromCLSID(guid, &guidString);
@@ -114,7 +122,65 @@ bool MediaFoundation_Utils::pixelFormatToVideoFormat(PixelFormat pixelFormat, GU
         }
     }
 
-    return false;
+    return WinapiShared_BayerSubtypes::toSubtype(pixelFormat, guid);
+}
+
+void MediaFoundation_Utils::mediaTypeToColorimetry(IMFMediaType *mediaType, ColorSpace &colorSpace,
+        ColorRange &colorRange)
+{
+    colorSpace = ColorSpace::Unknown;
+    colorRange = ColorRange::Unknown;
+
+    UINT32 value;
+
+    if (SUCCEEDED(mediaType->GetUINT32(MF_MT_YUV_MATRIX, &value))) {
+        switch (value) {
+            case MFVideoTransferMatrix_BT601:
+                colorSpace = ColorSpace::BT601;
+                break;
+
+            case MFVideoTransferMatrix_BT709:
+                colorSpace = ColorSpace::BT709;
+                break;
+
+#if (WINVER >= _WIN32_WINNT_WIN8)
+            case MFVideoTransferMatrix_BT2020_10:
+            case MFVideoTransferMatrix_BT2020_12:
+                colorSpace = ColorSpace::BT2020;
+                break;
+#endif
+
+            default:
+                break;
+        }
+    }
+
+    if (SUCCEEDED(mediaType->GetUINT32(MF_MT_VIDEO_NOMINAL_RANGE, &value))) {
+        switch (value) {
+            case MFNominalRange_0_255:
+                colorRange = ColorRange::Full;
+                break;
+
+            case MFNominalRange_16_235:
+                colorRange = ColorRange::Limited;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+Orientation MediaFoundation_Utils::mediaTypeToOrientation(IMFMediaType *mediaType)
+{
+    UINT32 stride;
+
+    // the stride is stored as UINT32, but it's a signed value
+    if (SUCCEEDED(mediaType->GetUINT32(MF_MT_DEFAULT_STRIDE, &stride)) && static_cast<INT32>(stride) < 0) {
+        return Orientation::BottomUp;
+    }
+
+    return Orientation::TopDown;
 }
 
 } // namespace webcam_capture
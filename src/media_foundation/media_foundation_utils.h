@@ -9,6 +9,9 @@
 
 #include "../utils.h"
 
+#include <color_range.h>
+#include <color_space.h>
+#include <orientation.h>
 #include <pixel_format.h>
 
 #include <cassert>
@@ -17,6 +20,7 @@
 #include <vector>
 
 #include <rpc.h>
+#include <mfidl.h>
 
 #ifdef WEBCAM_CAPTURE_DEBUG
 #include <iomanip>
@@ -41,6 +45,18 @@ public:
      */
     static bool pixelFormatToVideoFormat(PixelFormat pixelFormat, GUID &guid);
 
+    /**
+     * Reads the YUV matrix and nominal range of a media type.
+     * Leaves colorSpace and colorRange Unknown if the media type doesn't specify them.
+     */
+    static void mediaTypeToColorimetry(IMFMediaType *mediaType, ColorSpace &colorSpace, ColorRange &colorRange);
+
+    /**
+     * Reads the row order of a media type from the sign of its default stride.
+     * Returns TopDown if the media type doesn't specify the stride.
+     */
+    static Orientation mediaTypeToOrientation(IMFMediaType *mediaType);
+
     // Convert a WCHAR to a std::string
     template<class T>
     static T string_cast(const wchar_t *src, unsigned int codePage = CP_ACP)
@@ -0,0 +1,1640 @@
+#include <pixel_format_converter.h>
+
+#include <frame_layout.h>
+
+#include "conversion/conversion_jpeg_decoder.h"
+#include "conversion/conversion_kernels.h"
+#include "conversion/conversion_planner.h"
+#include "conversion/conversion_resize.h"
+#include "conversion/conversion_scale.h"
+#include "conversion/conversion_thread_pool.h"
+#include "conversion/conversion_transform.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace webcam_capture {
+
+namespace {
+
+std::atomic<DitherMode> ditherMode(DitherMode::Round);
+std::atomic<DemosaicMode> demosaicMode(DemosaicMode::Bilinear);
+
+/**
+ * Thresholds added to 16-bit samples before dropping their low byte, indexed by row and column modulo 4.
+ */
+const uint16_t ROUNDING[4][4] = {
+    {128, 128, 128, 128}, {128, 128, 128, 128}, {128, 128, 128, 128}, {128, 128, 128, 128}
+};
+
+// 4x4 Bayer matrix, scaled to the 256 values a dropped low byte can take
+const uint16_t ORDERED_DITHER[4][4] = {
+    {8, 136, 40, 168}, {200, 72, 232, 104}, {56, 184, 24, 152}, {248, 120, 216, 88}
+};
+
+size_t getRgbPixelBytes(PixelFormat pixelFormat)
+{
+    switch (pixelFormat) {
+        case PixelFormat::RGB24:
+            return 3;
+
+        case PixelFormat::RGB32:
+        case PixelFormat::BGRA32:
+        case PixelFormat::ARGB32:
+            return 4;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @return Size of a pixel of the RGB formats getRgbRow() reads, 16-bit ones included, 0 for other formats.
+ */
+size_t getRgbSourcePixelBytes(PixelFormat pixelFormat)
+{
+    return Conversion_Kernels::getExpandRgb16Row(pixelFormat, PixelFormat::RGB24) ? 2 : getRgbPixelBytes(pixelFormat);
+}
+
+/**
+ * @return Size of a pixel of the formats conversions can flip and rotate, 0 for other formats.
+ */
+size_t getPixelBytes(PixelFormat pixelFormat)
+{
+    return pixelFormat == PixelFormat::Y800 ? 1 : getRgbPixelBytes(pixelFormat);
+}
+
+/**
+ * Combines the orientation of a frame with a transform applied to the upright frame.
+ */
+Conversion_Transform getTransform(const Frame &frame, Transform transform)
+{
+    // rotations by 90 degrees swap the axes of the frame flipped by the listed steps, see Conversion_Transform
+    Conversion_Transform steps = {false, false, false};
+
+    switch (transform) {
+        case Transform::FlipVertical:
+            steps.flipY = true;
+            break;
+
+        case Transform::FlipHorizontal:
+            steps.mirrorX = true;
+            break;
+
+        case Transform::Rotate90:
+            steps.flipY = true;
+            steps.transpose = true;
+            break;
+
+        case Transform::Rotate180:
+            steps.flipY = true;
+            steps.mirrorX = true;
+            break;
+
+        case Transform::Rotate270:
+            steps.mirrorX = true;
+            steps.transpose = true;
+            break;
+
+        default:
+            break;
+    }
+
+    // a bottom-up frame is flipped before anything else, which flips it once more
+    if (frame.orientation == Orientation::BottomUp) {
+        steps.flipY = !steps.flipY;
+    }
+
+    return steps;
+}
+
+bool isIdentity(const Conversion_Transform &transform)
+{
+    return !transform.flipY && !transform.mirrorX && !transform.transpose;
+}
+
+/**
+ * Runs convert on horizontal stripes of the frame in parallel.
+ * Rows get converted straight into the destination, bottom to top if it's flipped vertically. Mirroring and rotating
+ * conversions convert a tile at a time into a buffer on the stack instead, which gets written transformed into the
+ * destination while it's still in the cache.
+ * @param pixelBytes Size of the destination's pixels, see getPixelBytes().
+ * @param alignment Row multiple stripes start at.
+ * @param convert Called as convert(rowBegin, rowEnd, columnBegin, columnEnd, target) to convert the pixels in
+ * [columnBegin, columnEnd) of rows [rowBegin, rowEnd) into target. columnBegin is a multiple of
+ * Conversion_Transformer::TILE_COLUMNS, rowBegin a multiple of alignment.
+ */
+template<typename Convert>
+void runTransformed(const Frame &frame, const Frame &destination, const Conversion_Transform &transform,
+                    size_t pixelBytes, size_t alignment, const Convert &convert)
+{
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+
+    Conversion_ThreadPool::getInstance().runStripes(height, alignment, [&](size_t rowBegin, size_t rowEnd) {
+        if (!transform.mirrorX && !transform.transpose) {
+            const ptrdiff_t stride = static_cast<ptrdiff_t>(destination.stride[0]);
+            const size_t firstRow = transform.flipY ? height - 1 - rowBegin : rowBegin;
+            const Conversion_RowTarget target = {destination.plane[0] + firstRow * destination.stride[0],
+                                                 transform.flipY ? -stride : stride, rowBegin
+                                                };
+
+            convert(rowBegin, rowEnd, 0, width, target);
+            return;
+        }
+
+        const size_t TILE_ROWS = Conversion_Transformer::TILE_ROWS;
+        const size_t TILE_COLUMNS = Conversion_Transformer::TILE_COLUMNS;
+        uint8_t tile[TILE_ROWS * TILE_COLUMNS * Conversion_Transformer::MAX_PIXEL_BYTES];
+        const size_t tileStride = TILE_COLUMNS * pixelBytes;
+
+        for (size_t y = rowBegin; y < rowEnd; y += TILE_ROWS) {
+            const size_t rows = std::min(TILE_ROWS, rowEnd - y);
+
+            for (size_t x = 0; x < width; x += TILE_COLUMNS) {
+                const size_t columns = std::min(TILE_COLUMNS, width - x);
+                const Conversion_RowTarget target = {tile, static_cast<ptrdiff_t>(tileStride), y};
+
+                convert(y, y + rows, x, x + columns, target);
+                Conversion_Transformer::writeTile(tile, tileStride, pixelBytes, y, rows, x, columns, transform,
+                                                  destination.plane[0], destination.stride[0], width, height);
+            }
+        }
+    });
+}
+
+/**
+ * Locations of the planes of a 4:2:0 frame.
+ */
+struct PlanarYuv {
+    const uint8_t *luma;
+    const uint8_t *u;
+    const uint8_t *v;
+    size_t lumaStride;
+    size_t chromaStride;
+    size_t chromaStep; // distance between two U samples, 2 for semi-planar formats
+};
+
+/**
+ * Finds the luma and chroma planes of a 4:2:0 frame.
+ * Frame's planes are listed in the order they are laid out in memory, so YV12's plane[1] is V, for example.
+ * If the frame has only plane[0] set, the rest of the planes are expected to follow it as the format describes.
+ * @return true on success, false if the frame doesn't have the pixel data set.
+ */
+bool getPlanarYuv(const Frame &frame, PlanarYuv &planes)
+{
+    const uint8_t *base = frame.plane[0];
+
+    if (!base) {
+        return false;
+    }
+
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+    const size_t chromaHeight = (height + 1) / 2;
+    const bool swapChroma = frame.pixelFormat == PixelFormat::YV12 || frame.pixelFormat == PixelFormat::IMC1 ||
+                            frame.pixelFormat == PixelFormat::IMC2;
+
+    planes.luma = base;
+    planes.lumaStride = frame.stride[0] ? frame.stride[0] : width;
+    planes.chromaStep = frame.pixelFormat == PixelFormat::NV12 ? 2 : 1;
+
+    const uint8_t *first;
+    const uint8_t *second;
+
+    switch (frame.pixelFormat) {
+        case PixelFormat::NV12:
+            // an odd width still needs a whole UV pair for the last pixel
+            planes.chromaStride = frame.stride[1] ? frame.stride[1] : (planes.lumaStride + 1) / 2 * 2;
+            planes.u = frame.plane[1] ? frame.plane[1] : base + height * planes.lumaStride;
+            planes.v = planes.u + 1;
+            return true;
+
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::YV12:
+            planes.chromaStride = frame.stride[1] ? frame.stride[1] : (planes.lumaStride + 1) / 2;
+            first = frame.plane[1] ? frame.plane[1] : base + height * planes.lumaStride;
+            second = frame.plane[2] ? frame.plane[2] : first + chromaHeight * planes.chromaStride;
+            break;
+
+        case PixelFormat::IMC1:
+        case PixelFormat::IMC3:
+            // chroma planes have the same stride as the luma one
+            planes.chromaStride = frame.stride[1] ? frame.stride[1] : planes.lumaStride;
+            first = frame.plane[1] ? frame.plane[1] : base + height * planes.lumaStride;
+            second = frame.plane[2] ? frame.plane[2] : first + chromaHeight * planes.chromaStride;
+            break;
+
+        case PixelFormat::IMC2:
+        case PixelFormat::IMC4:
+            // every chroma row holds a full row of the first chroma plane followed by a full row of the second one
+            planes.chromaStride = planes.lumaStride;
+            first = frame.plane[1] ? frame.plane[1] : base + height * planes.lumaStride;
+            second = frame.plane[2] ? frame.plane[2] : first + planes.lumaStride / 2;
+            break;
+
+        default:
+            return false;
+    }
+
+    planes.u = swapChroma ? second : first;
+    planes.v = swapChroma ? first : second;
+
+    return true;
+}
+
+/**
+ * Lookup tables the samples of YUV frames get mapped through on their way into RGB, see convertInto().
+ */
+struct SampleTables {
+    const uint8_t *luma;
+    const uint8_t *chroma;
+    size_t pixelBytes; // size of the destination's pixels
+};
+
+// pixels of a row mapped through the tables at a time, into buffers on the stack that stay in the L1 cache until the
+// kernel reads them
+const size_t MAPPED_COLUMNS = 512;
+
+/**
+ * Maps count samples through a table, alternating with another one for interleaved samples.
+ */
+void mapSamples(const uint8_t *source, uint8_t *destination, size_t count, const uint8_t *even, const uint8_t *odd)
+{
+    size_t i = 0;
+
+    for (; i + 1 < count; i += 2) {
+        destination[i] = even[source[i]];
+        destination[i + 1] = odd[source[i + 1]];
+    }
+
+    if (i < count) {
+        destination[i] = even[source[i]];
+    }
+}
+
+/**
+ * @param columnBegin Even column to start at, so that it starts a macropixel.
+ * @param tables Tables to map the samples through, null to convert them as they are.
+ */
+void convertPackedYuvToRgb(const Frame &frame, Conversion_PackedYuvToRgbRow row, size_t rowBegin, size_t rowEnd,
+                           size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target,
+                           const SampleTables *tables)
+{
+    const size_t sourceStride = frame.stride[0] ? frame.stride[0] : (frame.width[0] + 1) / 2 * 4;
+    const uint8_t *source = frame.plane[0] + columnBegin * 2;
+    const size_t columns = columnEnd - columnBegin;
+
+    if (!tables) {
+        for (size_t y = rowBegin; y < rowEnd; y ++) {
+            row(source + y * sourceStride, target.row(y), columns);
+        }
+
+        return;
+    }
+
+    const bool lumaFirst = frame.pixelFormat != PixelFormat::UYVY;
+    const uint8_t *even = lumaFirst ? tables->luma : tables->chroma;
+    const uint8_t *odd = lumaFirst ? tables->chroma : tables->luma;
+    uint8_t mapped[MAPPED_COLUMNS * 2];
+
+    for (size_t y = rowBegin; y < rowEnd; y ++) {
+        for (size_t x = 0; x < columns; x += MAPPED_COLUMNS) {
+            const size_t count = std::min(MAPPED_COLUMNS, columns - x);
+
+            mapSamples(source + y * sourceStride + x * 2, mapped, (count + 1) / 2 * 4, even, odd);
+            row(mapped, target.row(y) + x * tables->pixelBytes, count);
+        }
+    }
+}
+
+/**
+ * @param rowBegin Even row to start at.
+ * @param columnBegin Even column to start at.
+ * @param tables Tables to map the samples through, null to convert them as they are.
+ */
+void convertPlanarYuvToRgb(const PlanarYuv &planes, Conversion_PlanarYuvToRgbRows rows, size_t rowBegin,
+                           size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target,
+                           const SampleTables *tables)
+{
+    const size_t chromaColumn = columnBegin / 2 * planes.chromaStep;
+    const size_t columns = columnEnd - columnBegin;
+    uint8_t mappedLuma[2][MAPPED_COLUMNS];
+    uint8_t mappedChroma[2][MAPPED_COLUMNS];
+
+    // every chroma row is shared by two luma rows, so convert rows in pairs and read the chroma only once
+    for (size_t y = rowBegin; y < rowEnd; y += 2) {
+        const size_t chromaOffset = y / 2 * planes.chromaStride + chromaColumn;
+        const bool pair = y + 1 < rowEnd;
+        const uint8_t *luma0 = planes.luma + y * planes.lumaStride + columnBegin;
+        const uint8_t *luma1 = pair ? luma0 + planes.lumaStride : nullptr;
+        uint8_t *destination0 = target.row(y);
+        uint8_t *destination1 = pair ? target.row(y + 1) : nullptr;
+
+        if (!tables) {
+            rows(luma0, luma1, planes.u + chromaOffset, planes.v + chromaOffset, destination0, destination1, columns);
+            continue;
+        }
+
+        for (size_t x = 0; x < columns; x += MAPPED_COLUMNS) {
+            const size_t count = std::min(MAPPED_COLUMNS, columns - x);
+            const size_t chromaCount = (count + 1) / 2;
+            const size_t chromaX = x / 2 * planes.chromaStep;
+            const size_t offset = x * tables->pixelBytes;
+
+            mapSamples(luma0 + x, mappedLuma[0], count, tables->luma, tables->luma);
+
+            if (pair) {
+                mapSamples(luma1 + x, mappedLuma[1], count, tables->luma, tables->luma);
+            }
+
+            // semi-planar chroma is a single row of UV pairs, mapped through the same table
+            if (planes.chromaStep == 2) {
+                mapSamples(planes.u + chromaOffset + chromaX, mappedChroma[0], chromaCount * 2, tables->chroma,
+                           tables->chroma);
+            } else {
+                mapSamples(planes.u + chromaOffset + chromaX, mappedChroma[0], chromaCount, tables->chroma,
+                           tables->chroma);
+                mapSamples(planes.v + chromaOffset + chromaX, mappedChroma[1], chromaCount, tables->chroma,
+                           tables->chroma);
+            }
+
+            rows(mappedLuma[0], pair ? mappedLuma[1] : nullptr, mappedChroma[0],
+                 planes.chromaStep == 2 ? mappedChroma[0] + 1 : mappedChroma[1], destination0 + offset,
+                 pair ? destination1 + offset : nullptr, count);
+        }
+    }
+}
+
+/**
+ * Repacks or expands RGB rows, or copies them if the formats match.
+ */
+void convertRgb(const Frame &frame, Conversion_RgbRow row, size_t rowBegin, size_t rowEnd, size_t columnBegin,
+                size_t columnEnd, const Conversion_RowTarget &target)
+{
+    const size_t pixelBytes = getRgbSourcePixelBytes(frame.pixelFormat);
+    const size_t sourceStride = frame.stride[0] ? frame.stride[0] : frame.width[0] * pixelBytes;
+    const uint8_t *source = frame.plane[0] + columnBegin * pixelBytes;
+
+    for (size_t y = rowBegin; y < rowEnd; y ++) {
+        row(source + y * sourceStride, target.row(y), columnEnd - columnBegin);
+    }
+}
+
+/**
+ * Picks the color space and range of a frame, falling back to the usual ones for what the backend didn't report.
+ * Unknown color space means BT.601 for SD frames and BT.709 for HD ones, unknown range means the limited one.
+ */
+void getColorimetry(const Frame &frame, ColorSpace &colorSpace, ColorRange &colorRange)
+{
+    colorSpace = frame.colorSpace;
+
+    if (colorSpace == ColorSpace::Unknown) {
+        colorSpace = frame.height[0] >= 720 ? ColorSpace::BT709 : ColorSpace::BT601;
+    }
+
+    colorRange = frame.colorRange == ColorRange::Unknown ? ColorRange::Limited : frame.colorRange;
+}
+
+/**
+ * Fills in the layout of a packed RGB destination of the given size, keeping a stride set by the caller.
+ * @return Number of bytes the destination takes.
+ */
+size_t setRgbLayout(Frame &destination, size_t width, size_t height)
+{
+    return FrameLayout::setLayout(destination, width, height);
+}
+
+/**
+ * Describes where the Y, U and V samples of a 4:2:2 or 4:2:0 frame are.
+ * @return true on success, false if the pixel format isn't a supported YUV one or the frame has no pixel data.
+ */
+bool getSamplePlanes(const Frame &frame, Conversion_SamplePlane planes[3])
+{
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+    size_t offsets[3];
+
+    switch (frame.pixelFormat) {
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+            offsets[0] = Conversion_Yuy2Layout::Y0;
+            offsets[1] = Conversion_Yuy2Layout::U;
+            offsets[2] = Conversion_Yuy2Layout::V;
+            break;
+
+        case PixelFormat::UYVY:
+            offsets[0] = Conversion_UyvyLayout::Y0;
+            offsets[1] = Conversion_UyvyLayout::U;
+            offsets[2] = Conversion_UyvyLayout::V;
+            break;
+
+        case PixelFormat::YVYU:
+            offsets[0] = Conversion_YvyuLayout::Y0;
+            offsets[1] = Conversion_YvyuLayout::U;
+            offsets[2] = Conversion_YvyuLayout::V;
+            break;
+
+        default: {
+            PlanarYuv planar;
+
+            if (!getPlanarYuv(frame, planar)) {
+                return false;
+            }
+
+            const Conversion_SamplePlane luma = {planar.luma, planar.lumaStride, 1, width, height};
+            const Conversion_SamplePlane u = {planar.u, planar.chromaStride, planar.chromaStep, (width + 1) / 2, (height + 1) / 2};
+            const Conversion_SamplePlane v = {planar.v, planar.chromaStride, planar.chromaStep, (width + 1) / 2, (height + 1) / 2};
+
+            planes[0] = luma;
+            planes[1] = u;
+            planes[2] = v;
+
+            return true;
+        }
+    }
+
+    if (!frame.plane[0]) {
+        return false;
+    }
+
+    // packed 4:2:2, the luma samples of a macropixel are 2 bytes apart and there is a chroma pair per 4 bytes
+    const size_t stride = frame.stride[0] ? frame.stride[0] : (width + 1) / 2 * 4;
+
+    for (int i = 0; i < 3; i ++) {
+        const Conversion_SamplePlane plane = {frame.plane[0] + offsets[i], stride, i == 0 ? 2u : 4u,
+                                              i == 0 ? width : (width + 1) / 2, height
+                                             };
+        planes[i] = plane;
+    }
+
+    return true;
+}
+
+/**
+ * Gets the chroma subsampling of the YUV formats high bit depth frames convert from and to, as shifts of the luma
+ * width and height.
+ * @return true on success, false if the format is not one of them.
+ */
+bool getChromaSubsampling(PixelFormat pixelFormat, int &shiftX, int &shiftY)
+{
+    switch (pixelFormat) {
+        case PixelFormat::NV12:
+        case PixelFormat::P010:
+        case PixelFormat::P016:
+            shiftX = 1;
+            shiftY = 1;
+            return true;
+
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+        case PixelFormat::P210:
+        case PixelFormat::P216:
+        case PixelFormat::v210:
+        case PixelFormat::Y210:
+        case PixelFormat::Y216:
+            shiftX = 1;
+            shiftY = 0;
+            return true;
+
+        case PixelFormat::AYUV:
+        case PixelFormat::Y410:
+        case PixelFormat::Y416:
+            shiftX = 0;
+            shiftY = 0;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Locations and chroma subsampling of the samples of a high bit depth frame.
+ */
+struct HighBitDepthYuv {
+    const uint8_t *luma;
+    const uint8_t *chroma; // null for packed formats
+    size_t lumaStride;
+    size_t chromaStride;
+    int chromaShiftX;
+    int chromaShiftY;
+};
+
+/**
+ * Finds the samples of a P010, P016, P210, P216, v210, Y210, Y216, Y410 or Y416 frame.
+ * @return true on success, false if the frame is of another format or doesn't have the pixel data set.
+ */
+bool getHighBitDepthYuv(const Frame &frame, HighBitDepthYuv &planes)
+{
+    const uint8_t *base = frame.plane[0];
+
+    if (!base || !getChromaSubsampling(frame.pixelFormat, planes.chromaShiftX, planes.chromaShiftY)) {
+        return false;
+    }
+
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+
+    planes.luma = base;
+    planes.chroma = nullptr;
+    planes.chromaStride = 0;
+
+    switch (frame.pixelFormat) {
+        case PixelFormat::P010:
+        case PixelFormat::P016:
+        case PixelFormat::P210:
+        case PixelFormat::P216:
+            planes.lumaStride = frame.stride[0] ? frame.stride[0] : width * 2;
+            // a UV pair takes 4 bytes, so an odd width needs 2 more bytes of chroma than of luma
+            planes.chromaStride = frame.stride[1] ? frame.stride[1] : (planes.lumaStride + 3) / 4 * 4;
+            planes.chroma = frame.plane[1] ? frame.plane[1] : base + height * planes.lumaStride;
+            return true;
+
+        case PixelFormat::v210:
+            // rows are padded to a multiple of 48 pixels, 128 bytes
+            planes.lumaStride = frame.stride[0] ? frame.stride[0] : (width + 47) / 48 * 128;
+            return true;
+
+        case PixelFormat::Y210:
+        case PixelFormat::Y216:
+            planes.lumaStride = frame.stride[0] ? frame.stride[0] : (width + 1) / 2 * 8;
+            return true;
+
+        case PixelFormat::Y410:
+            planes.lumaStride = frame.stride[0] ? frame.stride[0] : width * 4;
+            return true;
+
+        case PixelFormat::Y416:
+            planes.lumaStride = frame.stride[0] ? frame.stride[0] : width * 8;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Fills in the layout of a YUV destination of the given size, keeping strides set by the caller.
+ * Semi-planar destinations get their chroma plane right after the luma one.
+ * @return Number of bytes the destination takes, 0 if the pixel format isn't a supported YUV destination.
+ */
+size_t setYuvLayout(Frame &destination, size_t width, size_t height)
+{
+    switch (destination.pixelFormat) {
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::NV12:
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+        case PixelFormat::Y800:
+        case PixelFormat::AYUV:
+        case PixelFormat::P016:
+        case PixelFormat::P216:
+        case PixelFormat::Y416:
+            return FrameLayout::setLayout(destination, width, height);
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Gets the planes scaleInto() resizes frames of the pixel format as.
+ * @param channels Receives the number of bytes the samples of each plane take.
+ * @return Number of planes, 0 if frames of the pixel format can't be resized.
+ */
+int getResizePlanes(PixelFormat pixelFormat, size_t channels[3])
+{
+    channels[0] = 1;
+    channels[1] = 1;
+    channels[2] = 1;
+
+    switch (pixelFormat) {
+        case PixelFormat::NV12:
+            // interleaved U and V samples get resized as pairs
+            channels[1] = 2;
+            return 2;
+
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::YV12:
+            return 3;
+
+        case PixelFormat::Y800:
+            return 1;
+
+        default:
+            channels[0] = getRgbPixelBytes(pixelFormat);
+            return channels[0] ? 1 : 0;
+    }
+}
+
+/**
+ * Kernels converting a high bit depth frame. Only the ones the destination format needs are set.
+ */
+struct HighBitDepthKernels {
+    Conversion_UnpackRow unpack;
+    Conversion_NarrowRow narrow;
+    Conversion_PackYuvRow pack;
+    Conversion_PackYuv16Row pack16;
+    Conversion_PlanarYuvToRgbRows planarRows;
+    Conversion_Yuv444ToRgbRow yuv444Row;
+};
+
+/**
+ * @param destinationChroma Chroma plane of a semi-planar destination, null for other ones.
+ * @param thresholds ROUNDING or ORDERED_DITHER.
+ * @param columnBegin Multiple of 6, so that v210 groups aren't split. Always 0 for YUV destinations, as they can't
+ * be transformed.
+ */
+void convertHighBitDepth(const HighBitDepthYuv &planes, const Frame &destination, uint8_t *destinationChroma,
+                         const HighBitDepthKernels &kernels, const uint16_t thresholds[4][4], size_t rowBegin,
+                         size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target)
+{
+    // samples go through small buffers on the stack, one chunk of the row at a time
+    // the chunk is a multiple of v210's 6 pixel groups as well as of the SIMD kernels' widths
+    const size_t CHUNK = 192;
+    uint16_t samples[3][CHUNK];
+    uint8_t narrowed[3][CHUNK];
+
+    const size_t pixelBytes = getPixelBytes(destination.pixelFormat);
+    const bool lumaOnly = destination.pixelFormat == PixelFormat::Y800;
+
+    for (size_t y = rowBegin; y < rowEnd; y ++) {
+        const size_t chromaRow = y >> planes.chromaShiftY;
+        const uint8_t *luma = planes.luma + y * planes.lumaStride;
+        const uint8_t *chroma = planes.chroma ? planes.chroma + chromaRow * planes.chromaStride : nullptr;
+        uint8_t *pixels = target.row(y);
+
+        // 4:2:0 destinations get their chroma rows written along with the even luma rows
+        const bool writesChroma = destinationChroma && (!planes.chromaShiftY || y % 2 == 0);
+        uint8_t *chromaPixels = writesChroma ? destinationChroma + chromaRow * destination.stride[1] : nullptr;
+
+        for (size_t x = columnBegin; x < columnEnd; x += CHUNK) {
+            const size_t count = std::min(CHUNK, columnEnd - x);
+            const size_t chromaCount = (count + planes.chromaShiftX) >> planes.chromaShiftX;
+            uint8_t *chunkPixels = pixels + (x - columnBegin) * pixelBytes;
+
+            kernels.unpack(luma, chroma, x, count, samples[0], samples[1], samples[2]);
+
+            if (lumaOnly) {
+                kernels.narrow(samples[0], chunkPixels, count, thresholds[y % 4]);
+                continue;
+            }
+
+            if (kernels.pack16) {
+                kernels.pack16(samples[0], samples[1], samples[2], pixels, chromaPixels, x, count);
+                continue;
+            }
+
+            kernels.narrow(samples[0], narrowed[0], count, thresholds[y % 4]);
+            kernels.narrow(samples[1], narrowed[1], chromaCount, thresholds[chromaRow % 4]);
+            kernels.narrow(samples[2], narrowed[2], chromaCount, thresholds[chromaRow % 4]);
+
+            if (kernels.pack) {
+                kernels.pack(narrowed[0], narrowed[1], narrowed[2], pixels, chromaPixels, x, count);
+            } else if (kernels.yuv444Row) {
+                kernels.yuv444Row(narrowed[0], narrowed[1], narrowed[2], chunkPixels, count);
+            } else {
+                // a single row, with its chroma upsampled horizontally only
+                kernels.planarRows(narrowed[0], nullptr, narrowed[1], narrowed[2], chunkPixels, nullptr, count);
+            }
+        }
+    }
+}
+
+/**
+ * convertInto() for high bit depth sources.
+ */
+bool convertHighBitDepthInto(const Frame &frame, Frame &destination, Transform transform)
+{
+    ColorSpace colorSpace;
+    ColorRange colorRange;
+    getColorimetry(frame, colorSpace, colorRange);
+
+    HighBitDepthKernels kernels = HighBitDepthKernels();
+    kernels.unpack = Conversion_Kernels::getUnpackRow(frame.pixelFormat);
+    kernels.narrow = Conversion_Kernels::getNarrowRow();
+
+    HighBitDepthYuv planes;
+
+    if (!getHighBitDepthYuv(frame, planes)) {
+        DEBUG_PRINT("Error: Couldn't locate the planes of the frame.");
+        return false;
+    }
+
+    if (getRgbPixelBytes(destination.pixelFormat)) {
+        if (planes.chromaShiftX) {
+            // I420 takes separate chroma rows, which is what the unpacked samples are
+            kernels.planarRows = Conversion_Kernels::getPlanarYuvToRgbRows(PixelFormat::I420, destination.pixelFormat,
+                                 colorSpace, colorRange);
+        } else {
+            kernels.yuv444Row = Conversion_Kernels::getYuv444ToRgbRow(destination.pixelFormat, colorSpace, colorRange);
+        }
+    } else {
+        kernels.pack = Conversion_Kernels::getPackYuvRow(destination.pixelFormat);
+        kernels.pack16 = Conversion_Kernels::getPackYuv16Row(destination.pixelFormat);
+    }
+
+    Frame layout = destination;
+    const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, layout, transform);
+
+    if (!bytes) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion or transform.");
+        return false;
+    }
+
+    if (!destination.plane[0]) {
+        DEBUG_PRINT("Error: Destination frame has no pixel data.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    destination = layout;
+
+    // YUV destinations hold the same values, just with fewer bits
+    if (!getRgbPixelBytes(destination.pixelFormat)) {
+        destination.colorSpace = frame.colorSpace;
+        destination.colorRange = frame.colorRange;
+    }
+
+    uint8_t *destinationChroma = nullptr;
+
+    if (destination.pixelFormat == PixelFormat::NV12 || destination.pixelFormat == PixelFormat::P016 ||
+        destination.pixelFormat == PixelFormat::P216) {
+        destinationChroma = destination.plane[1] ? destination.plane[1] : destination.plane[0] + destination.offset[1];
+    }
+
+    const uint16_t (*thresholds)[4] = PixelFormatConverter::getDitherMode() == DitherMode::Ordered ? ORDERED_DITHER :
+                                      ROUNDING;
+
+    // 4:2:0 destinations write a chroma row per pair of luma rows, which has to belong to a single stripe
+    runTransformed(frame, destination, getTransform(frame, transform), getPixelBytes(destination.pixelFormat),
+                   planes.chromaShiftY ? 2 : 1,
+    [&](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target) {
+        convertHighBitDepth(planes, destination, destinationChroma, kernels, thresholds, rowBegin, rowEnd, columnBegin,
+                            columnEnd, target);
+    });
+
+    return true;
+}
+
+/**
+ * Finds the luma plane of an 8-bit planar YUV frame, Y800 included.
+ * @return true on success, false if the frame is of another format or doesn't have the pixel data set.
+ */
+bool findLumaPlane(const Frame &frame, const uint8_t *&luma, size_t &stride)
+{
+    if (frame.pixelFormat == PixelFormat::Y800) {
+        luma = frame.plane[0];
+        stride = frame.stride[0] ? frame.stride[0] : frame.width[0];
+        return luma != nullptr;
+    }
+
+    PlanarYuv planes;
+
+    if (!getPlanarYuv(frame, planes)) {
+        return false;
+    }
+
+    luma = planes.luma;
+    stride = planes.lumaStride;
+
+    return true;
+}
+
+/**
+ * @return true if frames of the pixel format can be converted to Y800.
+ */
+bool hasLuma(PixelFormat pixelFormat)
+{
+    return pixelFormat == PixelFormat::Y800 || Conversion_Kernels::getLumaRow(pixelFormat) ||
+           Conversion_Kernels::getUnpackRow(pixelFormat) ||
+           Conversion_Kernels::getPlanarYuvToRgbRows(pixelFormat, PixelFormat::RGB24, ColorSpace::Unknown,
+                   ColorRange::Unknown);
+}
+
+/**
+ * convertInto() for Y800 destinations of 8-bit sources.
+ * Packed formats have their luma samples deinterleaved, planar ones have their luma plane copied row by row, or
+ * with a single copy per stripe if the strides match.
+ */
+bool convertLumaInto(const Frame &frame, Frame &destination, Transform transform)
+{
+    const Conversion_LumaRow row = Conversion_Kernels::getLumaRow(frame.pixelFormat);
+    const size_t width = frame.width[0];
+    const uint8_t *luma = frame.plane[0];
+    size_t sourceStride = 0;
+    size_t sourcePixelBytes = 1;
+
+    if (row) {
+        const size_t packedStride = frame.pixelFormat == PixelFormat::AYUV ? width * 4 : (width + 1) / 2 * 4;
+        sourceStride = frame.stride[0] ? frame.stride[0] : packedStride;
+        sourcePixelBytes = frame.pixelFormat == PixelFormat::AYUV ? 4 : 2;
+    } else if (!findLumaPlane(frame, luma, sourceStride)) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion or no pixel data in the source frame.");
+        return false;
+    }
+
+    Frame layout = destination;
+    const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, layout, transform);
+
+    if (!bytes || !luma) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion or no pixel data in the source frame.");
+        return false;
+    }
+
+    if (!destination.plane[0]) {
+        DEBUG_PRINT("Error: Destination frame has no pixel data.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    destination = layout;
+    destination.colorSpace = frame.colorSpace;
+    destination.colorRange = frame.colorRange;
+
+    runTransformed(frame, destination, getTransform(frame, transform), 1, 1,
+    [&](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target) {
+        const uint8_t *source = luma + rowBegin * sourceStride + columnBegin * sourcePixelBytes;
+        const size_t count = columnEnd - columnBegin;
+
+        // rows with no padding between them get copied at once. Padding isn't copied along, as in frames cropped by
+        // FrameView::crop() it's pixels outside of the view
+        if (!row && count == width && sourceStride == width && target.stride == static_cast<ptrdiff_t>(width)) {
+            memcpy(target.row(rowBegin), source, (rowEnd - rowBegin) * width);
+            return;
+        }
+
+        for (size_t y = rowBegin; y < rowEnd; y ++, source += sourceStride) {
+            if (row) {
+                row(source, target.row(y), count);
+            } else {
+                memcpy(target.row(y), source, count);
+            }
+        }
+    });
+
+    return true;
+}
+
+/**
+ * Arrangement of the color samples of a Bayer format.
+ */
+struct BayerPattern {
+    bool redFirstRow; // the first row has red samples between its green ones, rather than blue ones
+    bool greenFirst; // the first sample of the first row is green
+    int bits;
+};
+
+const struct {
+    PixelFormat pixelFormat;
+    BayerPattern pattern;
+} BAYER_PATTERNS[] = {
+    {PixelFormat::BayerRGGB8,  {true,  false, 8}},
+    {PixelFormat::BayerGRBG8,  {true,  true,  8}},
+    {PixelFormat::BayerGBRG8,  {false, true,  8}},
+    {PixelFormat::BayerBGGR8,  {false, false, 8}},
+    {PixelFormat::BayerRGGB10, {true,  false, 10}},
+    {PixelFormat::BayerGRBG10, {true,  true,  10}},
+    {PixelFormat::BayerGBRG10, {false, true,  10}},
+    {PixelFormat::BayerBGGR10, {false, false, 10}},
+    {PixelFormat::BayerRGGB12, {true,  false, 12}},
+    {PixelFormat::BayerGRBG12, {true,  true,  12}},
+    {PixelFormat::BayerGBRG12, {false, true,  12}},
+    {PixelFormat::BayerBGGR12, {false, false, 12}}
+};
+
+/**
+ * @return true on success, false if the pixel format is not a Bayer one.
+ */
+bool getBayerPattern(PixelFormat pixelFormat, BayerPattern &pattern)
+{
+    for (auto &&entry : BAYER_PATTERNS) {
+        if (entry.pixelFormat == pixelFormat) {
+            pattern = entry.pattern;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Maps a row or column index past the edge of a Bayer frame onto the one to read instead.
+ * Mirroring around the first and last samples, rather than repeating them, keeps the colors of the pattern.
+ */
+size_t mirrorBayerIndex(ptrdiff_t index, size_t size)
+{
+    const ptrdiff_t last = static_cast<ptrdiff_t>(size) - 1;
+
+    if (index < 0) {
+        index = -index;
+    }
+
+    if (index > last) {
+        index = 2 * last - index;
+    }
+
+    // 2 samples wide or high frames mirror past their other edge too, the index's parity still tells the color
+    if (index < 0 || index > last) {
+        index &= 1;
+    }
+
+    return static_cast<size_t>(index);
+}
+
+/**
+ * Copies samples [columnBegin - 2, columnEnd + 2) of a row of a Bayer frame into padded, reduced to 8 bits.
+ */
+template<typename Sample>
+void padBayerRow(const uint8_t *row, int shift, size_t width, size_t columnBegin, size_t columnEnd, uint8_t *padded)
+{
+    const Sample *samples = reinterpret_cast<const Sample *>(row);
+    const ptrdiff_t begin = static_cast<ptrdiff_t>(columnBegin) - 2;
+    const ptrdiff_t end = static_cast<ptrdiff_t>(columnEnd) + 2;
+    const ptrdiff_t insideBegin = std::max<ptrdiff_t>(begin, 0);
+    const ptrdiff_t insideEnd = std::min<ptrdiff_t>(end, static_cast<ptrdiff_t>(width));
+
+    for (ptrdiff_t x = begin; x < end; x ++) {
+        if (x == insideBegin) {
+            // the samples inside the frame, which the compiler vectorizes
+            for (; x < insideEnd; x ++) {
+                padded[x - begin] = static_cast<uint8_t>(std::min(samples[x] >> shift, 255));
+            }
+
+            if (x == end) {
+                break;
+            }
+        }
+
+        padded[x - begin] = static_cast<uint8_t>(std::min(samples[mirrorBayerIndex(x, width)] >> shift, 255));
+    }
+}
+
+/**
+ * Demosaics the pixels in [columnBegin, columnEnd) of rows [rowBegin, rowEnd) of a Bayer frame.
+ * @param pixelBytes Size of the destination's pixels.
+ * Works through the columns in chunks, keeping the 5 source rows a row needs as a ring of padded 8-bit rows on the
+ * stack, so that every source row is read once per chunk.
+ */
+void convertBayer(const Frame &frame, const BayerPattern &pattern, Conversion_DemosaicRow row, size_t pixelBytes,
+                  size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd,
+                  const Conversion_RowTarget &target)
+{
+    const size_t CHUNK = 1024;
+    uint8_t buffer[5][CHUNK + 4];
+
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+    const bool wide = pattern.bits > 8;
+    const size_t stride = frame.stride[0] ? frame.stride[0] : width * (wide ? 2 : 1);
+
+    for (size_t x = columnBegin; x < columnEnd; x += CHUNK) {
+        const size_t count = std::min(CHUNK, columnEnd - x);
+        uint8_t *ring[5];
+
+        const auto pad = [&](ptrdiff_t y, uint8_t *padded) {
+            const uint8_t *source = frame.plane[0] + mirrorBayerIndex(y, height) * stride;
+
+            if (wide) {
+                padBayerRow<uint16_t>(source, pattern.bits - 8, width, x, x + count, padded);
+            } else {
+                padBayerRow<uint8_t>(source, 0, width, x, x + count, padded);
+            }
+        };
+
+        for (int i = 0; i < 5; i ++) {
+            ring[i] = buffer[i];
+            pad(static_cast<ptrdiff_t>(rowBegin) + i - 2, ring[i]);
+        }
+
+        for (size_t y = rowBegin; y < rowEnd; y ++) {
+            if (y > rowBegin) {
+                // move the ring a row down, refilling the row that dropped off the top with the one entering it
+                uint8_t *top = ring[0];
+                std::copy(ring + 1, ring + 5, ring);
+                ring[4] = top;
+                pad(static_cast<ptrdiff_t>(y) + 2, ring[4]);
+            }
+
+            const uint8_t *rows[5];
+
+            for (int i = 0; i < 5; i ++) {
+                rows[i] = ring[i] + 2;
+            }
+
+            const bool odd = y % 2 == 1;
+            row(rows, target.row(y) + (x - columnBegin) * pixelBytes, count, pattern.redFirstRow != odd,
+                pattern.greenFirst != (odd != (x % 2 == 1)));
+        }
+    }
+}
+
+/**
+ * convertInto() for Bayer sources.
+ */
+bool convertBayerInto(const Frame &frame, Frame &destination, Transform transform, const BayerPattern &pattern)
+{
+    const Conversion_DemosaicRow row = Conversion_Kernels::getDemosaicRow(destination.pixelFormat,
+                                       PixelFormatConverter::getDemosaicMode() == DemosaicMode::EdgeAware);
+
+    Frame layout = destination;
+    const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, layout, transform);
+
+    if (!row || !bytes) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion, transform or frame size.");
+        return false;
+    }
+
+    if (!frame.plane[0] || !destination.plane[0]) {
+        DEBUG_PRINT("Error: Source or destination frame has no pixel data.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    destination = layout;
+
+    const size_t pixelBytes = getRgbPixelBytes(destination.pixelFormat);
+
+    runTransformed(frame, destination, getTransform(frame, transform), pixelBytes, 1,
+    [&](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target) {
+        convertBayer(frame, pattern, row, pixelBytes, rowBegin, rowEnd, columnBegin, columnEnd, target);
+    });
+
+    return true;
+}
+
+/**
+ * convertInto() for YUV destinations of RGB sources.
+ * Rows of 4:2:0 destinations are converted in pairs, each pair with the row of chroma samples it shares.
+ */
+bool convertRgbToYuvInto(const Frame &frame, Frame &destination, Transform transform)
+{
+    Frame layout = destination;
+    const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, layout, transform);
+
+    // the destination's color space and range pick the matrix, the usual ones are filled in for unknown ones
+    ColorSpace colorSpace;
+    ColorRange colorRange;
+    getColorimetry(layout, colorSpace, colorRange);
+
+    const Conversion_RgbToPlanarYuvRows planarRows = Conversion_Kernels::getRgbToPlanarYuvRows(frame.pixelFormat,
+            destination.pixelFormat, colorSpace, colorRange);
+    const Conversion_RgbToPackedYuvRow packedRow = Conversion_Kernels::getRgbToPackedYuvRow(frame.pixelFormat,
+            destination.pixelFormat, colorSpace, colorRange);
+
+    if (!bytes || (!planarRows && !packedRow)) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion or transform.");
+        return false;
+    }
+
+    if (!frame.plane[0] || !destination.plane[0]) {
+        DEBUG_PRINT("Error: Source or destination frame has no pixel data.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    destination = layout;
+    destination.colorSpace = colorSpace;
+    destination.colorRange = colorRange;
+
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+    const size_t sourceStride = frame.stride[0] ? frame.stride[0] : width * getRgbPixelBytes(frame.pixelFormat);
+
+    // bottom-up sources are read from their last row up, which is the only transform YUV destinations allow
+    const bool flip = getTransform(frame, transform).flipY;
+    const uint8_t *firstRow = flip ? frame.plane[0] + (height - 1) * sourceStride : frame.plane[0];
+    const ptrdiff_t sourceStep = flip ? -static_cast<ptrdiff_t>(sourceStride) : static_cast<ptrdiff_t>(sourceStride);
+
+    uint8_t *luma = destination.plane[0];
+    uint8_t *u = destination.plane[1] ? destination.plane[1] : destination.plane[0] + destination.offset[1];
+    uint8_t *v = u + 1;
+    size_t vStride = destination.stride[1];
+
+    if (destination.pixelFormat != PixelFormat::NV12) {
+        v = destination.plane[2] ? destination.plane[2] : destination.plane[0] + destination.offset[2];
+        vStride = destination.stride[2];
+    }
+
+    // 4:2:0 stripes have to start at even rows, so that each chroma row belongs to a single stripe
+    const size_t rowStep = planarRows ? 2 : 1;
+
+    Conversion_ThreadPool::getInstance().runStripes(height, rowStep, [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t y = rowBegin; y < rowEnd; y += rowStep) {
+            const uint8_t *source = firstRow + static_cast<ptrdiff_t>(y) * sourceStep;
+            uint8_t *lumaRow = luma + y * destination.stride[0];
+
+            if (packedRow) {
+                packedRow(source, lumaRow, width);
+                continue;
+            }
+
+            const bool pair = y + 1 < rowEnd;
+            const size_t chromaRow = y / 2;
+
+            planarRows(source, pair ? source + sourceStep : nullptr, lumaRow,
+                       pair ? lumaRow + destination.stride[0] : nullptr, u + chromaRow * destination.stride[1],
+                       v + chromaRow * vStride, width);
+        }
+    });
+
+    return true;
+}
+
+/**
+ * convertInto() for RGB destinations of YUV and RGB sources, mapping the YUV samples through lumaTable and chromaTable
+ * on the way if they are set.
+ */
+bool convertToRgbInto(const Frame &frame, Frame &destination, Transform transform, const uint8_t *lumaTable,
+                      const uint8_t *chromaTable)
+{
+    ColorSpace colorSpace;
+    ColorRange colorRange;
+    getColorimetry(frame, colorSpace, colorRange);
+
+    Conversion_PackedYuvToRgbRow packedRow = Conversion_Kernels::getPackedYuvToRgbRow(frame.pixelFormat,
+            destination.pixelFormat, colorSpace, colorRange);
+    Conversion_PlanarYuvToRgbRows planarRows = Conversion_Kernels::getPlanarYuvToRgbRows(frame.pixelFormat,
+            destination.pixelFormat, colorSpace, colorRange);
+    Conversion_RgbRow rgbRow = Conversion_Kernels::getRgbRow(frame.pixelFormat, destination.pixelFormat);
+
+    if (!packedRow && !planarRows && !rgbRow) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion.");
+        return false;
+    }
+
+    if (lumaTable && !packedRow && !planarRows) {
+        DEBUG_PRINT("Error: Only 8-bit 4:2:2 and 4:2:0 YUV frames get mapped through lookup tables.");
+        return false;
+    }
+
+    if (!frame.plane[0] || !destination.plane[0]) {
+        DEBUG_PRINT("Error: Source or destination frame has no pixel data.");
+        return false;
+    }
+
+    // work on a copy, so that a failed call doesn't overwrite the size of the caller's buffer
+    Frame layout = destination;
+    const size_t bytes = PixelFormatConverter::getDestinationLayout(frame, layout, transform);
+
+    if (!bytes) {
+        DEBUG_PRINT("Error: Unsupported transform.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    PlanarYuv planes = PlanarYuv();
+
+    if (planarRows && !getPlanarYuv(frame, planes)) {
+        DEBUG_PRINT("Error: Couldn't locate the planes of the frame.");
+        return false;
+    }
+
+    destination = layout;
+
+    // 4:2:0 stripes have to start at even rows, so that each chroma row belongs to a single stripe
+    const size_t alignment = planarRows ? 2 : 1;
+
+    const SampleTables tables = {lumaTable, chromaTable, getRgbPixelBytes(destination.pixelFormat)};
+
+    runTransformed(frame, destination, getTransform(frame, transform), getRgbPixelBytes(destination.pixelFormat),
+                   alignment,
+    [&](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, const Conversion_RowTarget &target) {
+        if (packedRow) {
+            convertPackedYuvToRgb(frame, packedRow, rowBegin, rowEnd, columnBegin, columnEnd, target,
+                                  lumaTable ? &tables : nullptr);
+        } else if (planarRows) {
+            convertPlanarYuvToRgb(planes, planarRows, rowBegin, rowEnd, columnBegin, columnEnd, target,
+                                  lumaTable ? &tables : nullptr);
+        } else {
+            convertRgb(frame, rgbRow, rowBegin, rowEnd, columnBegin, columnEnd, target);
+        }
+    });
+
+    return true;
+}
+
+} // namespace
+
+size_t PixelFormatConverter::getDestinationLayout(const Frame &frame, Frame &destination, Transform transform)
+{
+    if (Conversion_JpegDecoder::isSupportedSource(frame.pixelFormat)) {
+        // libjpeg writes the rows straight into the destination, and JPEG images are never stored bottom-up
+        return transform == Transform::None ? getDestinationLayout(frame, destination, DecompressionScale::Full) : 0;
+    }
+
+    const Conversion_Transform steps = getTransform(frame, transform);
+
+    // chroma of YUV destinations is subsampled, so their pixels can't be moved around one by one. RGB sources can
+    // still be read bottom-up, which flips them vertically
+    const bool flipOnly = !steps.mirrorX && !steps.transpose && getRgbPixelBytes(frame.pixelFormat);
+
+    if (!isIdentity(steps) && !getPixelBytes(destination.pixelFormat) && !flipOnly) {
+        return 0;
+    }
+
+    const size_t width = steps.transpose ? frame.height[0] : frame.width[0];
+    const size_t height = steps.transpose ? frame.width[0] : frame.height[0];
+    BayerPattern pattern;
+
+    if (getBayerPattern(frame.pixelFormat, pattern)) {
+        // demosaicing works on whole 2x2 patterns
+        if (frame.width[0] % 2 || frame.height[0] % 2 || !getRgbPixelBytes(destination.pixelFormat)) {
+            return 0;
+        }
+
+        return setRgbLayout(destination, width, height);
+    }
+
+    if (destination.pixelFormat == PixelFormat::Y800) {
+        return hasLuma(frame.pixelFormat) ? setYuvLayout(destination, width, height) : 0;
+    }
+
+    if (Conversion_Kernels::getRgbRow(frame.pixelFormat, destination.pixelFormat)) {
+        return setRgbLayout(destination, width, height);
+    }
+
+    if (Conversion_Kernels::getRgbToPlanarYuvRows(frame.pixelFormat, destination.pixelFormat, ColorSpace::Unknown,
+            ColorRange::Unknown) ||
+        Conversion_Kernels::getRgbToPackedYuvRow(frame.pixelFormat, destination.pixelFormat, ColorSpace::Unknown,
+                ColorRange::Unknown)) {
+        return setYuvLayout(destination, width, height);
+    }
+
+    if (Conversion_Kernels::getUnpackRow(frame.pixelFormat)) {
+        if (getRgbPixelBytes(destination.pixelFormat)) {
+            return setRgbLayout(destination, width, height);
+        }
+
+        // YUV destinations keep the chroma subsampling of the source
+        int sourceShiftX;
+        int sourceShiftY;
+        int shiftX;
+        int shiftY;
+
+        if (!getChromaSubsampling(frame.pixelFormat, sourceShiftX, sourceShiftY) ||
+            !getChromaSubsampling(destination.pixelFormat, shiftX, shiftY) ||
+            sourceShiftX != shiftX || sourceShiftY != shiftY) {
+            return 0;
+        }
+
+        return setYuvLayout(destination, width, height);
+    }
+
+    if (!Conversion_Kernels::getPackedYuvToRgbRow(frame.pixelFormat, destination.pixelFormat, ColorSpace::Unknown,
+            ColorRange::Unknown) &&
+        !Conversion_Kernels::getPlanarYuvToRgbRows(frame.pixelFormat, destination.pixelFormat, ColorSpace::Unknown,
+                ColorRange::Unknown)) {
+        return 0;
+    }
+
+    return setRgbLayout(destination, width, height);
+}
+
+size_t PixelFormatConverter::getDestinationLayout(const Frame &frame, Frame &destination, size_t width,
+        size_t height)
+{
+    size_t channels[3];
+
+    if (destination.pixelFormat == frame.pixelFormat) {
+        return getResizePlanes(frame.pixelFormat, channels) && width && height ?
+               FrameLayout::setLayout(destination, width, height) : 0;
+    }
+
+    // scaling supports the same YUV formats as the plain conversion, except for the high bit depth ones
+    Frame unscaled = destination;
+    BayerPattern pattern;
+
+    if (Conversion_Kernels::getUnpackRow(frame.pixelFormat) || getBayerPattern(frame.pixelFormat, pattern) ||
+        getRgbSourcePixelBytes(frame.pixelFormat) ||
+        !getDestinationLayout(frame, unscaled) || !width || !height) {
+        return 0;
+    }
+
+    return setRgbLayout(destination, width, height);
+}
+
+bool PixelFormatConverter::convertInto(const Frame &frame, Frame &destination, Transform transform)
+{
+    if (Conversion_JpegDecoder::isSupportedSource(frame.pixelFormat)) {
+        if (transform != Transform::None) {
+            DEBUG_PRINT("Error: MJPEG frames can't be transformed while being decompressed.");
+            return false;
+        }
+
+        return decompressInto(frame, destination, DecompressionScale::Full);
+    }
+
+    if (Conversion_Kernels::getUnpackRow(frame.pixelFormat)) {
+        return convertHighBitDepthInto(frame, destination, transform);
+    }
+
+    BayerPattern pattern;
+
+    if (getBayerPattern(frame.pixelFormat, pattern)) {
+        return convertBayerInto(frame, destination, transform, pattern);
+    }
+
+    if (getRgbPixelBytes(frame.pixelFormat) && !getRgbPixelBytes(destination.pixelFormat)) {
+        return convertRgbToYuvInto(frame, destination, transform);
+    }
+
+    if (destination.pixelFormat == PixelFormat::Y800) {
+        return convertLumaInto(frame, destination, transform);
+    }
+
+    return convertToRgbInto(frame, destination, transform, nullptr, nullptr);
+}
+
+bool PixelFormatConverter::convertInto(const Frame &frame, Frame &destination, const uint8_t *lumaTable,
+                                       const uint8_t *chromaTable, Transform transform)
+{
+    if (!lumaTable || !chromaTable) {
+        DEBUG_PRINT("Error: The lookup tables are not set.");
+        return false;
+    }
+
+    return convertToRgbInto(frame, destination, transform, lumaTable, chromaTable);
+}
+
+bool PixelFormatConverter::convertAndScaleInto(const Frame &frame, Frame &destination, size_t width, size_t height,
+        ScaleFilter filter)
+{
+    ColorSpace colorSpace;
+    ColorRange colorRange;
+    getColorimetry(frame, colorSpace, colorRange);
+
+    Conversion_Yuv444ToRgbRow row = Conversion_Kernels::getYuv444ToRgbRow(destination.pixelFormat, colorSpace,
+                                    colorRange);
+    Conversion_SamplePlane planes[3];
+
+    if (!row || !getSamplePlanes(frame, planes)) {
+        DEBUG_PRINT("Error: Unsupported pixel format conversion or no pixel data in the source frame.");
+        return false;
+    }
+
+    if (!destination.plane[0] || !width || !height) {
+        DEBUG_PRINT("Error: Destination frame has no pixel data.");
+        return false;
+    }
+
+    Frame layout = destination;
+
+    if (destination.bytes && getDestinationLayout(frame, layout, width, height) > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    setRgbLayout(destination, width, height);
+
+    const Conversion_ScaleRow scaleRow = filter == ScaleFilter::Box ? &Conversion_Scaler::scaleRowBox :
+                                         filter == ScaleFilter::Nearest ? &Conversion_Scaler::scaleRowNearest :
+                                         &Conversion_Scaler::scaleRowBilinear;
+    const size_t pixelBytes = getRgbPixelBytes(destination.pixelFormat);
+
+    // bottom-up frames get their scaled rows written bottom to top
+    const bool flip = frame.orientation == Orientation::BottomUp;
+
+    Conversion_ThreadPool::getInstance().runStripes(height, 1, [&](size_t rowBegin, size_t rowEnd) {
+        // scaled samples go through a small buffer on the stack, one chunk of the row at a time
+        const size_t CHUNK = 256;
+        uint8_t samples[3][CHUNK];
+
+        for (size_t y = rowBegin; y < rowEnd; y ++) {
+            uint8_t *pixels = destination.plane[0] + (flip ? height - 1 - y : y) * destination.stride[0];
+
+            for (size_t x = 0; x < width; x += CHUNK) {
+                const size_t count = std::min(CHUNK, width - x);
+
+                for (int i = 0; i < 3; i ++) {
+                    scaleRow(planes[i], width, height, y, x, count, samples[i]);
+                }
+
+                row(samples[0], samples[1], samples[2], pixels + x * pixelBytes, count);
+            }
+        }
+    });
+
+    return true;
+}
+
+bool PixelFormatConverter::scaleInto(const Frame &frame, Frame &destination, size_t width, size_t height,
+                                     ScaleFilter filter)
+{
+    size_t channels[3];
+    const int planes = getResizePlanes(frame.pixelFormat, channels);
+
+    if (!planes || !frame.plane[0]) {
+        DEBUG_PRINT("Error: Unsupported pixel format or no pixel data in the source frame.");
+        return false;
+    }
+
+    if (!destination.plane[0]) {
+        DEBUG_PRINT("Error: Destination frame has no pixel data.");
+        return false;
+    }
+
+    Frame layout = destination;
+    layout.pixelFormat = frame.pixelFormat;
+    const size_t bytes = getDestinationLayout(frame, layout, width, height);
+
+    if (!bytes) {
+        DEBUG_PRINT("Error: Unsupported frame size.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    // planes of the source that aren't set follow plane[0] as the format lays them out
+    Frame source = frame;
+    FrameLayout::setLayout(source, frame.width[0], frame.height[0]);
+
+    for (int i = 0; i < planes; i ++) {
+        if (!Conversion_Resizer::getTable(source.width[i], layout.width[i], filter, channels[i]) ||
+            !Conversion_Resizer::getTable(source.height[i], layout.height[i], filter, 1)) {
+            DEBUG_PRINT("Error: The frame can't be downscaled that much with this filter.");
+            return false;
+        }
+    }
+
+    destination = layout;
+    destination.colorSpace = frame.colorSpace;
+    destination.colorRange = frame.colorRange;
+    destination.orientation = frame.orientation;
+
+    for (int i = 0; i < planes; i ++) {
+        const Conversion_ResizePlane from = {
+            frame.plane[i] ? frame.plane[i] : frame.plane[0] + source.offset[i], source.stride[i], source.width[i],
+            source.height[i]
+        };
+        const Conversion_ResizePlane to = {
+            destination.plane[i] ? destination.plane[i] : destination.plane[0] + destination.offset[i],
+            destination.stride[i], destination.width[i], destination.height[i]
+        };
+
+        Conversion_Resizer::resize(from, to, channels[i], filter);
+    }
+
+    return true;
+}
+
+bool PixelFormatConverter::getLumaPlane(const Frame &frame, Frame &luma)
+{
+    const uint8_t *plane;
+    size_t stride;
+
+    if (!findLumaPlane(frame, plane, stride)) {
+        DEBUG_PRINT("Error: The frame has no 8-bit luma plane or no pixel data.");
+        return false;
+    }
+
+    luma = Frame();
+    luma.plane[0] = const_cast<uint8_t *>(plane);
+    luma.stride[0] = stride;
+    luma.width[0] = frame.width[0];
+    luma.height[0] = frame.height[0];
+    luma.bytes = stride * frame.height[0];
+    luma.pixelFormat = PixelFormat::Y800;
+    luma.colorSpace = frame.colorSpace;
+    luma.colorRange = frame.colorRange;
+    luma.orientation = frame.orientation;
+
+    return true;
+}
+
+size_t PixelFormatConverter::getDestinationLayout(const Frame &frame, Frame &destination, DecompressionScale scale)
+{
+    if (!Conversion_JpegDecoder::isSupportedSource(frame.pixelFormat) ||
+        !Conversion_JpegDecoder::isSupportedDestination(destination.pixelFormat)) {
+        return 0;
+    }
+
+    const size_t width = Conversion_JpegDecoder::getScaledSize(frame.width[0], scale);
+    const size_t height = Conversion_JpegDecoder::getScaledSize(frame.height[0], scale);
+
+    return getRgbPixelBytes(destination.pixelFormat) ? setRgbLayout(destination, width, height) :
+           setYuvLayout(destination, width, height);
+}
+
+bool PixelFormatConverter::decompressInto(const Frame &frame, Frame &destination, DecompressionScale scale)
+{
+    Frame layout = destination;
+    const size_t bytes = getDestinationLayout(frame, layout, scale);
+
+    if (!bytes) {
+        DEBUG_PRINT("Error: Unsupported pixel format decompression.");
+        return false;
+    }
+
+    if (!frame.plane[0] || !destination.plane[0]) {
+        DEBUG_PRINT("Error: Source or destination frame has no pixel data.");
+        return false;
+    }
+
+    if (destination.bytes && bytes > destination.bytes) {
+        DEBUG_PRINT("Error: Destination buffer is too small.");
+        return false;
+    }
+
+    Conversion_JpegDecoder decoder;
+
+    if (!decoder.decode(frame.plane[0], frame.bytes, layout, scale)) {
+        return false;
+    }
+
+    destination = layout;
+    destination.colorSpace = ColorSpace::BT601;
+    destination.colorRange = ColorRange::Full;
+
+    return true;
+}
+
+void PixelFormatConverter::setDitherMode(DitherMode mode)
+{
+    ditherMode = mode;
+}
+
+DitherMode PixelFormatConverter::getDitherMode()
+{
+    return ditherMode;
+}
+
+void PixelFormatConverter::setDemosaicMode(DemosaicMode mode)
+{
+    demosaicMode = mode;
+}
+
+DemosaicMode PixelFormatConverter::getDemosaicMode()
+{
+    return demosaicMode;
+}
+
+void PixelFormatConverter::setThreadCount(size_t count)
+{
+    Conversion_ThreadPool::getInstance().setThreadCount(count);
+}
+
+size_t PixelFormatConverter::getThreadCount()
+{
+    return Conversion_ThreadPool::getInstance().getThreadCount();
+}
+
+bool PixelFormatConverter::convertToRGB(const Frame &frame, Frame &destination)
+{
+    if (!getRgbPixelBytes(destination.pixelFormat)) {
+        DEBUG_PRINT("Error: Destination pixel format is not an RGB one.");
+        return false;
+    }
+
+    return convertInto(frame, destination);
+}
+
+bool PixelFormatConverter::convertToYUV(const Frame &frame, Frame &destination)
+{
+    if (!getRgbPixelBytes(frame.pixelFormat)) {
+        DEBUG_PRINT("Error: Source pixel format is not an RGB one.");
+        return false;
+    }
+
+    return convertInto(frame, destination);
+}
+
+std::vector<PixelFormat> PixelFormatConverter::getConversionPath(PixelFormat source, PixelFormat destination,
+        size_t width, size_t height)
+{
+    std::vector<PixelFormat> path;
+    Conversion_Planner::getInstance().findPath(source, destination, width, height, path);
+
+    return path;
+}
+
+} // namespace webcam_capture
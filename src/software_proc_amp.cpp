@@ -0,0 +1,367 @@
+#include "software_proc_amp.h"
+
+#include "conversion/conversion_thread_pool.h"
+#include "frame_buffer.h"
+#include "frame_drop_counter.h"
+#include "utils.h"
+
+#include <frame_layout.h>
+#include <pixel_format_converter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace webcam_capture {
+
+namespace {
+
+const VideoPropertyRange RANGES[] = {
+    VideoPropertyRange(-100, 100, 1, 0), // Brightness
+    VideoPropertyRange(0, 200, 1, 100), // Contrast
+    VideoPropertyRange(0, 200, 1, 100), // Saturation
+    VideoPropertyRange(10, 500, 1, 100) // Gamma
+};
+
+/**
+ * Byte positions of the channels of the RGB formats the stage supports, see Conversion_Rgb24Layout.
+ */
+struct RgbBytes {
+    PixelFormat pixelFormat;
+    size_t bytes;
+    size_t r;
+    size_t g;
+    size_t b;
+};
+
+const RgbBytes RGB_BYTES[] = {
+    {PixelFormat::RGB24, 3, 2, 1, 0},
+    {PixelFormat::RGB32, 4, 2, 1, 0},
+    {PixelFormat::BGRA32, 4, 2, 1, 0},
+    {PixelFormat::ARGB32, 4, 1, 2, 3}
+};
+
+const RgbBytes *getRgbBytes(PixelFormat pixelFormat)
+{
+    for (const RgbBytes &rgb : RGB_BYTES) {
+        if (rgb.pixelFormat == pixelFormat) {
+            return &rgb;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @return true for the YUV formats the stage supports, with lumaFirst telling whether the first byte of packed rows
+ * is luma.
+ */
+bool isYuv(PixelFormat pixelFormat, bool &lumaFirst)
+{
+    lumaFirst = true;
+
+    switch (pixelFormat) {
+        case PixelFormat::UYVY:
+            lumaFirst = false;
+            return true;
+
+        case PixelFormat::YUY2:
+        case PixelFormat::YUYV:
+        case PixelFormat::YVYU:
+        case PixelFormat::NV12:
+        case PixelFormat::I420:
+        case PixelFormat::IYUV:
+        case PixelFormat::YV12:
+        case PixelFormat::Y800:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+int getIndex(VideoProperty property)
+{
+    const int index = static_cast<int>(property);
+
+    return index >= 0 && index < static_cast<int>(sizeof(RANGES) / sizeof(RANGES[0])) ? index : -1;
+}
+
+uint8_t clampSample(double value)
+{
+    return static_cast<uint8_t>(std::min(std::max(value + 0.5, 0.0), 255.0));
+}
+
+/**
+ * Maps count bytes of a row through the tables, first through the even one and alternating.
+ */
+void mapRow(const uint8_t *source, uint8_t *destination, size_t count, const uint8_t *even, const uint8_t *odd)
+{
+    size_t x = 0;
+
+    for (; x + 1 < count; x += 2) {
+        destination[x] = even[source[x]];
+        destination[x + 1] = odd[source[x + 1]];
+    }
+
+    if (x < count) {
+        destination[x] = even[source[x]];
+    }
+}
+
+void mapRgbRow(const uint8_t *source, uint8_t *destination, size_t width, const RgbBytes &rgb, const uint8_t *tone,
+               int saturation)
+{
+    for (size_t x = 0; x < width; x ++, source += rgb.bytes, destination += rgb.bytes) {
+        // the unused or alpha byte is kept
+        if (destination != source) {
+            memcpy(destination, source, rgb.bytes);
+        }
+
+        int r = tone[source[rgb.r]];
+        int g = tone[source[rgb.g]];
+        int b = tone[source[rgb.b]];
+
+        if (saturation != 256) {
+            // BT.601 luma weights in 1/256
+            const int luma = (77 * r + 150 * g + 29 * b) >> 8;
+            r = std::min(std::max(luma + (((r - luma) * saturation) >> 8), 0), 255);
+            g = std::min(std::max(luma + (((g - luma) * saturation) >> 8), 0), 255);
+            b = std::min(std::max(luma + (((b - luma) * saturation) >> 8), 0), 255);
+        }
+
+        destination[rgb.r] = static_cast<uint8_t>(r);
+        destination[rgb.g] = static_cast<uint8_t>(g);
+        destination[rgb.b] = static_cast<uint8_t>(b);
+    }
+}
+
+struct ProcAmpStage {
+    SoftwareProcAmpFilter filter;
+    bool inPlace;
+    FrameCallback callback;
+    std::shared_ptr<FrameDropCounter> drops;
+    FrameBuffer buffer;
+
+    explicit ProcAmpStage(std::shared_ptr<SoftwareProcAmp> procAmp) :
+        filter(procAmp),
+        inPlace(false)
+    {
+        // empty
+    }
+
+    void apply(Frame &frame)
+    {
+        if (filter.update() || !frame.plane[0] || !SoftwareProcAmpFilter::isSupported(frame.pixelFormat)) {
+            callback(frame);
+            return;
+        }
+
+        if (inPlace) {
+            filter.apply(frame, frame);
+            callback(frame);
+            return;
+        }
+
+        const size_t width = frame.width[0];
+        const size_t height = frame.height[0];
+
+        Frame adjusted = Frame();
+        adjusted.pixelFormat = frame.pixelFormat;
+        const size_t bytes = FrameLayout::setLayout(adjusted, width, height);
+        uint8_t *base = bytes ? buffer.get(adjusted, bytes) : nullptr;
+
+        if (!base) {
+            FrameDropCounter::count(drops, FrameDropCounter::Reason::PoolExhausted);
+            return;
+        }
+
+        FrameLayout::setLayout(adjusted, width, height, base);
+        adjusted.owner = buffer.getOwner();
+        adjusted.colorSpace = frame.colorSpace;
+        adjusted.colorRange = frame.colorRange;
+        adjusted.orientation = frame.orientation;
+
+        filter.apply(frame, adjusted);
+        callback(adjusted);
+    }
+};
+
+} // namespace
+
+SoftwareProcAmp::SoftwareProcAmp() :
+    generation(0)
+{
+    for (int i = 0; i < PROPERTIES; i ++) {
+        values[i] = RANGES[i].getDefault();
+    }
+}
+
+bool SoftwareProcAmp::getPropertyRange(VideoProperty property, VideoPropertyRange &range)
+{
+    const int index = getIndex(property);
+
+    if (index < 0) {
+        DEBUG_PRINT("Error: Unsupported VideoProperty.");
+        return false;
+    }
+
+    range = RANGES[index];
+
+    return true;
+}
+
+int SoftwareProcAmp::getProperty(VideoProperty property) const
+{
+    const int index = getIndex(property);
+
+    return index < 0 ? 0 : values[index].load();
+}
+
+bool SoftwareProcAmp::setProperty(VideoProperty property, int value)
+{
+    const int index = getIndex(property);
+
+    if (index < 0 || value < RANGES[index].getMinimum() || value > RANGES[index].getMaximum()) {
+        DEBUG_PRINT("Error: Unsupported VideoProperty or value out of its range.");
+        return false;
+    }
+
+    values[index] = value;
+    generation ++;
+
+    return true;
+}
+
+unsigned SoftwareProcAmp::getGeneration() const
+{
+    return generation.load();
+}
+
+SoftwareProcAmpFilter::SoftwareProcAmpFilter(std::shared_ptr<SoftwareProcAmp> procAmp) :
+    procAmp(procAmp)
+{
+    buildTables();
+}
+
+void SoftwareProcAmpFilter::buildTables()
+{
+    generation = procAmp->getGeneration();
+
+    const int brightness = procAmp->getProperty(VideoProperty::Brightness);
+    const int contrast = procAmp->getProperty(VideoProperty::Contrast);
+    const int saturationPercent = procAmp->getProperty(VideoProperty::Saturation);
+    const int gamma = procAmp->getProperty(VideoProperty::Gamma);
+
+    identity = brightness == 0 && contrast == 100 && saturationPercent == 100 && gamma == 100;
+    saturation = saturationPercent * 256 / 100;
+
+    for (int i = 0; i < 256; i ++) {
+        // gamma first, so that contrast and brightness work on the corrected midtones
+        const double corrected = std::pow(i / 255.0, 100.0 / gamma);
+        tone[i] = clampSample(((corrected - 0.5) * contrast / 100 + 0.5) * 255 + brightness * 127.5 / 100);
+        chroma[i] = clampSample((i - 128) * saturationPercent / 100.0 + 128);
+    }
+}
+
+bool SoftwareProcAmpFilter::update()
+{
+    if (procAmp->getGeneration() != generation) {
+        buildTables();
+    }
+
+    return identity;
+}
+
+bool SoftwareProcAmpFilter::isSupported(PixelFormat pixelFormat)
+{
+    bool lumaFirst;
+
+    return FrameLayout::getTraits(pixelFormat) && (getRgbBytes(pixelFormat) || isYuv(pixelFormat, lumaFirst));
+}
+
+bool SoftwareProcAmpFilter::apply(const Frame &frame, const Frame &destination) const
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+    const RgbBytes *rgb = getRgbBytes(frame.pixelFormat);
+    bool lumaFirst = true;
+
+    if (!frame.plane[0] || !destination.plane[0] || !traits || (!rgb && !isYuv(frame.pixelFormat, lumaFirst))) {
+        return false;
+    }
+
+    const size_t width = frame.width[0];
+    const size_t height = frame.height[0];
+
+    // strides and offsets of the frames, with the ones they leave unset derived from their luma strides
+    Frame layout = frame;
+    Frame target = destination;
+
+    if (!FrameLayout::setLayout(layout, width, height) || !FrameLayout::setLayout(target, width, height)) {
+        return false;
+    }
+
+    for (int i = 0; i < traits->planes; i ++) {
+        const uint8_t *source = frame.plane[i] ? frame.plane[i] : frame.plane[0] + layout.offset[i];
+        uint8_t *written = destination.plane[i] ? destination.plane[i] : destination.plane[0] + target.offset[i];
+        const size_t sourceStride = layout.stride[i];
+        const size_t writtenStride = target.stride[i];
+
+        // packed 4:2:2 rows alternate luma and chroma bytes, the other formats have them in planes of their own
+        const bool interleaved = traits->packing == PixelPacking::Packed && traits->chromaShiftX == 1;
+        const uint8_t *even = i > 0 || (interleaved && !lumaFirst) ? chroma : tone;
+        const uint8_t *odd = i > 0 || (interleaved && lumaFirst) ? chroma : tone;
+        const size_t rowBytes = i == 0 ?
+                                (width + traits->blockWidth - 1) / traits->blockWidth * traits->blockBytes :
+                                layout.width[i] * (traits->packing == PixelPacking::SemiPlanar ? 2 : 1);
+
+        Conversion_ThreadPool::getInstance().runStripes(layout.height[i], 1, [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t y = rowBegin; y < rowEnd; y ++) {
+                if (rgb) {
+                    mapRgbRow(source + y * sourceStride, written + y * writtenStride, width, *rgb, tone, saturation);
+                } else {
+                    mapRow(source + y * sourceStride, written + y * writtenStride, rowBytes, even, odd);
+                }
+            }
+        });
+    }
+
+    return true;
+}
+
+bool SoftwareProcAmpFilter::convertInto(const Frame &frame, Frame &destination) const
+{
+    // the RGB tables of the other formats aren't per sample of the YUV ones
+    bool lumaFirst;
+
+    if (frame.pixelFormat == PixelFormat::Y800 || !isYuv(frame.pixelFormat, lumaFirst) ||
+        !getRgbBytes(destination.pixelFormat)) {
+        return false;
+    }
+
+    return PixelFormatConverter::convertInto(frame, destination, tone, chroma);
+}
+
+FrameCallback SoftwareProcAmp::wrapCallback(std::shared_ptr<SoftwareProcAmp> procAmp, PixelFormat pixelFormat,
+        int width, int height, bool inPlace, FrameCallback callback, std::shared_ptr<FrameDropCounter> drops)
+{
+    if (!callback || !procAmp) {
+        return callback;
+    }
+
+    std::shared_ptr<ProcAmpStage> stage = std::make_shared<ProcAmpStage>(procAmp);
+    stage->inPlace = inPlace;
+    stage->callback = callback;
+    stage->drops = drops;
+
+    // capturing starts with the buffers of the adjusted frames allocated
+    if (!inPlace && width > 0 && height > 0) {
+        stage->buffer.prepare(pixelFormat, width, height);
+    }
+
+    return [stage](Frame & frame) {
+        stage->apply(frame);
+    };
+}
+
+} // namespace webcam_capture
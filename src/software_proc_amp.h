@@ -0,0 +1,133 @@
+#ifndef SOFTWARE_PROC_AMP_H
+#define SOFTWARE_PROC_AMP_H
+
+#include <camera_interface.h>
+#include <frame.h>
+#include <video_property.h>
+#include <video_property_range.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace webcam_capture {
+
+class FrameDropCounter;
+
+/**
+ * Brightness, contrast, saturation and gamma applied to the frames in software, for cameras that have no controls
+ * for them, so that setProperty() works the same on every backend.
+ * Each camera keeps one, the backends use it for the properties the device doesn't support and put its stage in
+ * front of the frame callback. Setting a property only stores the value, the stage rebuilds its 256-entry lookup
+ * tables on the next frame, so changes cost nothing per frame. While all properties are at their defaults frames
+ * are passed on untouched.
+ */
+class SoftwareProcAmp
+{
+public:
+    SoftwareProcAmp();
+
+    /**
+     * Ranges are the same for every camera: brightness from -100 to 100, an offset in percents of half the range of
+     * a sample, contrast and saturation from 0 to 200 percent, and gamma from 10 to 500 hundredths, brightening the
+     * midtones above 100.
+     */
+    static bool getPropertyRange(VideoProperty property, VideoPropertyRange &range);
+
+    /**
+     * @return Value of the property, its default until it's set.
+     */
+    int getProperty(VideoProperty property) const;
+
+    /**
+     * Can be called from any thread, the frames delivered next get the new value.
+     * @return true on success, false if the value is out of range.
+     */
+    bool setProperty(VideoProperty property, int value);
+
+    /**
+     * Wraps a callback into one applying the properties of procAmp to every frame before passing it on, for frames
+     * that no FrameConverter gets, which applies them itself.
+     * Applies to the formats SoftwareProcAmpFilter does, frames of other formats are passed on untouched.
+     * @param pixelFormat Format the frames come in, to prewarm the buffers of the stage for when it isn't in place.
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @param inPlace true if the frames are in buffers of the library nothing else reads yet, e.g. those of the
+     * decompresser or the queue's copies, which the properties are then applied to in place. Otherwise they are the
+     * driver's, and get copied into a buffer of the stage with the properties applied, a pass over the frame on the
+     * capture thread that only changing a property away from its default costs.
+     * @param drops Counter of the camera to count dropped frames into, if any.
+     * @return The wrapping callback.
+     */
+    static FrameCallback wrapCallback(std::shared_ptr<SoftwareProcAmp> procAmp, PixelFormat pixelFormat, int width,
+                                      int height, bool inPlace, FrameCallback callback,
+                                      std::shared_ptr<FrameDropCounter> drops = nullptr);
+
+    /**
+     * @return Number that changes whenever a property does.
+     */
+    unsigned getGeneration() const;
+
+private:
+    static const int PROPERTIES = 4;
+
+    std::atomic<int> values[PROPERTIES];
+
+    // incremented on every change, so that stages notice it with a single load per frame
+    std::atomic<unsigned> generation;
+};
+
+/**
+ * Lookup tables of the properties of a SoftwareProcAmp, rebuilt when a property changes, and the passes applying them
+ * to frames, for the stages that do.
+ * Applies to 8-bit YUV formats, YUY2, YUYV, UYVY, YVYU, NV12, I420, IYUV, YV12 and Y800, where brightness, contrast
+ * and gamma go to luma and saturation to chroma, and to RGB24, RGB32, BGRA32 and ARGB32.
+ * Keeps the tables between frames, so it has to be used from one thread at a time.
+ */
+class SoftwareProcAmpFilter
+{
+public:
+    explicit SoftwareProcAmpFilter(std::shared_ptr<SoftwareProcAmp> procAmp);
+
+    /**
+     * Picks up the properties that changed since the last call.
+     * @return true if all properties are at their defaults, so frames are to be left as they are.
+     */
+    bool update();
+
+    /**
+     * @return true if the properties can be applied to frames of the format.
+     */
+    static bool isSupported(PixelFormat pixelFormat);
+
+    /**
+     * Applies the properties to a frame, writing the result into destination, a frame of the same format and size
+     * laid out as FrameLayout::setLayout() has it, or the frame itself to apply them in place.
+     * @return false if the format is not supported.
+     */
+    bool apply(const Frame &frame, const Frame &destination) const;
+
+    /**
+     * Converts a frame with PixelFormatConverter::convertInto(), applying the properties in the same pass, for YUV
+     * frames going into RGB.
+     * @return false if the conversion is not one the properties can be applied in, or fails. The frame is left
+     * unconverted then.
+     */
+    bool convertInto(const Frame &frame, Frame &destination) const;
+
+private:
+    void buildTables();
+
+    std::shared_ptr<SoftwareProcAmp> procAmp;
+
+    // lookup tables built for the properties of the generation
+    unsigned generation;
+    bool identity;
+    uint8_t tone[256]; // brightness, contrast and gamma, of luma or of each RGB channel
+    uint8_t chroma[256]; // saturation of U and V
+    int saturation; // in 1/256, for RGB, whose saturation isn't a per sample function
+};
+
+} // namespace webcam_capture
+
+#endif // SOFTWARE_PROC_AMP_H
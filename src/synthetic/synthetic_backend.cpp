@@ -0,0 +1,36 @@
+#include "synthetic_backend.h"
+#include "synthetic_camera.h"
+#include "synthetic_unique_id.h"
+#include "../utils.h"
+
+namespace webcam_capture {
+
+Synthetic_Backend::Synthetic_Backend()
+    : BackendInterface(BackendImplementation::Synthetic)
+{
+}
+
+std::vector<CameraInformation> Synthetic_Backend::getAvailableCameras() const
+{
+    return {CameraInformation(std::make_shared<Synthetic_UniqueId>(0), "Synthetic Camera")};
+}
+
+std::unique_ptr<CameraInterface> Synthetic_Backend::getCamera(const CameraInformation &information) const
+{
+    if (!information.getUniqueId() || *information.getUniqueId() != Synthetic_UniqueId(0)) {
+        DEBUG_PRINT("Error: The camera is not a synthetic one.");
+        return nullptr;
+    }
+
+    return Synthetic_Camera::create(information);
+}
+
+int Synthetic_Backend::setCameraConnectionStateCallback(CameraConnectionStateCallback callback)
+{
+    // the synthetic camera is never connected or disconnected, so there is nothing to call the callback for
+    (void)callback;
+
+    return 1; //TODO ERR code (success)
+}
+
+} // namespace webcam_capture
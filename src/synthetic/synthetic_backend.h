@@ -0,0 +1,28 @@
+#ifndef SYNTHETIC_BACKEND_H
+#define SYNTHETIC_BACKEND_H
+
+#include <backend_interface.h>
+#include <camera_information.h>
+#include <camera_interface.h>
+
+#include <memory>
+#include <vector>
+
+namespace webcam_capture {
+
+/**
+ * Backend with a single camera that delivers a test pattern, available on every platform, so that the library can be
+ * exercised without a camera, e.g. on a build server.
+ */
+class Synthetic_Backend : public BackendInterface
+{
+public:
+    Synthetic_Backend();
+    std::vector<CameraInformation> getAvailableCameras() const;
+    std::unique_ptr<CameraInterface> getCamera(const CameraInformation &information) const;
+    int setCameraConnectionStateCallback(CameraConnectionStateCallback callback);
+};
+
+} // namespace webcam_capture
+
+#endif // SYNTHETIC_BACKEND_H
@@ -0,0 +1,284 @@
+#include "synthetic_camera.h"
+
+#include "../capability_tree_builder.h"
+#include "../software_proc_amp.h"
+#include "../utils.h"
+
+#include <frame_layout.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+
+namespace webcam_capture {
+
+namespace {
+
+const PixelFormat FORMATS[] = {PixelFormat::YUY2, PixelFormat::NV12, PixelFormat::I420, PixelFormat::RGB24};
+const int RESOLUTIONS[][2] = {{320, 240}, {640, 480}, {1280, 720}};
+const float FPSES[] = {15, 30, 60};
+
+// pixels the bars move by every frame
+const size_t SCROLL = 4;
+
+struct Bar {
+    uint8_t r, g, b;
+    uint8_t y, u, v;
+};
+
+/**
+ * Makes a bar of an RGB color, along with its BT.601 limited range YUV one.
+ */
+Bar makeBar(int r, int g, int b)
+{
+    Bar bar;
+    bar.r = static_cast<uint8_t>(r);
+    bar.g = static_cast<uint8_t>(g);
+    bar.b = static_cast<uint8_t>(b);
+    bar.y = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    bar.u = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+    bar.v = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+
+    return bar;
+}
+
+// 75% color bars
+const Bar BARS[] = {
+    makeBar(191, 191, 191), makeBar(191, 191, 0), makeBar(0, 191, 191), makeBar(0, 191, 0),
+    makeBar(191, 0, 191), makeBar(191, 0, 0), makeBar(0, 0, 191), makeBar(0, 0, 0)
+};
+
+const size_t BAR_COUNT = sizeof(BARS) / sizeof(BARS[0]);
+
+} // namespace
+
+Synthetic_Camera::Synthetic_Camera(const CameraInformation &information)
+    : information(information)
+    , capturing(false)
+{
+}
+
+std::unique_ptr<CameraInterface> Synthetic_Camera::create(const CameraInformation &information)
+{
+    return std::unique_ptr<Synthetic_Camera>(new Synthetic_Camera(information));
+}
+
+Synthetic_Camera::~Synthetic_Camera()
+{
+    // Stop capturing
+    if (capturing) {
+        stop();
+    }
+}
+
+int Synthetic_Camera::start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb,
+                            PixelFormat decodeFormat, PixelFormat decompressFormat, DecompressionScale decompressScale,
+                            FrameDelivery delivery, BackpressurePolicy backpressure)
+{
+    if (!cb) {
+        DEBUG_PRINT("Error: The callback function is empty. Capturing was not started.");
+        return -1;      //TODO Err code
+    }
+
+    if (capturing) {
+        DEBUG_PRINT("Error: Cannot start capture because we are already capturing.");
+        return -2;      //TODO Err code
+    }
+
+    bool supported = false;
+
+    for (const CapabilityFormat &format : getCapabilities()) {
+        for (const CapabilityResolution &resolution : format.getResolutions()) {
+            for (const CapabilityFps &capabilityFps : resolution.getFpses()) {
+                supported = supported || (format.getPixelFormat() == pixelFormat && resolution.getWidth() == width &&
+                                          resolution.getHeight() == height &&
+                                          std::fabs(capabilityFps.getFps() - fps) < 0.01f);
+            }
+        }
+    }
+
+    if (!supported) {
+        DEBUG_PRINT("Error: The camera doesn't support the pixel format, resolution and fps.");
+        return -3;      //TODO Err code
+    }
+
+    // the properties are applied in software, and as none of the formats is compressed, decompression fails the way it
+    // does on other backends
+    const int result = pipeline.start(cb, pixelFormat, width, height, decompressFormat, decompressScale, decodeFormat,
+                                      delivery, backpressure);
+
+    if (result < 0) {
+        return result;
+    }
+
+    capturing = true;
+    captureThread = std::thread(&Synthetic_Camera::capture, this, pixelFormat, width, height, fps, cb);
+
+    return 1;      //TODO Err code
+}
+
+int Synthetic_Camera::stop()
+{
+    if (!capturing) {
+        DEBUG_PRINT("Error: Can't stop capture because we're not capturing yet.");
+        return -1;    //TODO Err code
+    }
+
+    capturing = false;
+    captureThread.join();
+
+    // frames still queued are dropped, so that the callback isn't called once stop() returned
+    pipeline.stop();
+
+    return 1;   //TODO Err code
+}
+
+std::unique_ptr<Frame> Synthetic_Camera::captureFrame()
+{
+    return pipeline.captureFrame();
+}
+
+FrameDropStatistics Synthetic_Camera::getDropStatistics()
+{
+    return pipeline.getDropStatistics();
+}
+
+void Synthetic_Camera::capture(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback callback)
+{
+    Frame frame = Frame();
+    frame.pixelFormat = pixelFormat;
+    frame.colorSpace = ColorSpace::BT601;
+    frame.colorRange = ColorRange::Limited;
+    frame.orientation = Orientation::TopDown;
+
+    std::vector<uint8_t> buffer(FrameLayout::setLayout(frame, width, height));
+    FrameLayout::setLayout(frame, width, height, buffer.data());
+
+    const std::chrono::steady_clock::duration period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    for (size_t frameNumber = 0; capturing; frameNumber ++) {
+        drawFrame(frame, frameNumber);
+        callback(frame);
+
+        // a consumer slower than the frame rate gets the frames as fast as it takes them, with no burst after it
+        next += period;
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (next < now) {
+            next = now;
+        }
+
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Synthetic_Camera::drawFrame(Frame &frame, size_t frameNumber)
+{
+    const size_t width = frame.width[0];
+    const size_t shift = frameNumber * SCROLL;
+
+    // bar of every pixel of a row, the same for all rows
+    std::vector<const Bar *> row(width);
+
+    for (size_t x = 0; x < width; x ++) {
+        row[x] = &BARS[(x + shift) % width * BAR_COUNT / width];
+    }
+
+    for (size_t y = 0; y < frame.height[0]; y ++) {
+        uint8_t *luma = frame.plane[0] + y * frame.stride[0];
+
+        switch (frame.pixelFormat) {
+            case PixelFormat::YUY2:
+                for (size_t x = 0; x + 1 < width; x += 2) {
+                    luma[x * 2] = row[x]->y;
+                    luma[x * 2 + 1] = row[x]->u;
+                    luma[x * 2 + 2] = row[x + 1]->y;
+                    luma[x * 2 + 3] = row[x]->v;
+                }
+
+                break;
+
+            case PixelFormat::RGB24:
+                for (size_t x = 0; x < width; x ++) {
+                    luma[x * 3] = row[x]->b;
+                    luma[x * 3 + 1] = row[x]->g;
+                    luma[x * 3 + 2] = row[x]->r;
+                }
+
+                break;
+
+            default:
+                for (size_t x = 0; x < width; x ++) {
+                    luma[x] = row[x]->y;
+                }
+
+                break;
+        }
+    }
+
+    // chroma planes, taking the color of the left pixel of every pair
+    for (size_t y = 0; y < frame.height[1]; y ++) {
+        switch (frame.pixelFormat) {
+            case PixelFormat::NV12: {
+                uint8_t *chroma = frame.plane[1] + y * frame.stride[1];
+
+                for (size_t x = 0; x < frame.width[1]; x ++) {
+                    chroma[x * 2] = row[x * 2]->u;
+                    chroma[x * 2 + 1] = row[x * 2]->v;
+                }
+
+                break;
+            }
+
+            case PixelFormat::I420: {
+                uint8_t *u = frame.plane[1] + y * frame.stride[1];
+                uint8_t *v = frame.plane[2] + y * frame.stride[2];
+
+                for (size_t x = 0; x < frame.width[1]; x ++) {
+                    u[x] = row[x * 2]->u;
+                    v[x] = row[x * 2]->v;
+                }
+
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+// ---- Capabilities ----
+std::vector<CapabilityFormat> Synthetic_Camera::getCapabilities()
+{
+    CapabilityTreeBuilder capabilityBuilder;
+
+    for (PixelFormat pixelFormat : FORMATS) {
+        for (const int (&resolution)[2] : RESOLUTIONS) {
+            capabilityBuilder.addCapability(pixelFormat, resolution[0], resolution[1],
+                                            std::vector<float>(std::begin(FPSES), std::end(FPSES)));
+        }
+    }
+
+    return capabilityBuilder.build();
+}
+
+bool Synthetic_Camera::getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange)
+{
+    return SoftwareProcAmp::getPropertyRange(property, videoPropRange);
+}
+
+int Synthetic_Camera::getProperty(VideoProperty property)
+{
+    return pipeline.getSoftwareProcAmp().getProperty(property);
+}
+
+bool Synthetic_Camera::setProperty(const VideoProperty property, const int value)
+{
+    return pipeline.getSoftwareProcAmp().setProperty(property, value);
+}
+
+} // namespace webcam_capture
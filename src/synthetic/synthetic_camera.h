@@ -0,0 +1,64 @@
+#ifndef SYNTHETIC_CAMERA_H
+#define SYNTHETIC_CAMERA_H
+
+#include <camera_information.h>
+#include <camera_interface.h>
+#include <capability.h>
+#include <frame.h>
+#include <video_property.h>
+#include <video_property_range.h>
+
+#include "../frame_pipeline.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace webcam_capture {
+
+/**
+ * Camera delivering color bars that scroll by a few pixels every frame, in YUY2, NV12, I420 or RGB24, at the frame
+ * rate asked for, from a capture thread of its own.
+ * Frames go through the same software stages as on the other backends, and their pixel data is valid only during the
+ * callback, like that of a driver's buffer.
+ */
+class Synthetic_Camera : public CameraInterface
+{
+public:
+    ~Synthetic_Camera();
+    static std::unique_ptr<CameraInterface> create(const CameraInformation &information);
+
+    int start(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback cb, PixelFormat decodeFormat = PixelFormat::UNKNOWN, PixelFormat decompressFormat = PixelFormat::UNKNOWN, DecompressionScale decompressScale = DecompressionScale::Full, FrameDelivery delivery = FrameDelivery::Direct, BackpressurePolicy backpressure = BackpressurePolicy::DropNewest);
+    int stop();
+    std::unique_ptr<Frame> captureFrame();
+    FrameDropStatistics getDropStatistics();
+    // ---- Capabilities ----
+    bool getPropertyRange(VideoProperty property, VideoPropertyRange &videoPropRange);
+    int getProperty(VideoProperty property);
+    bool setProperty(const VideoProperty property, const int value);
+    std::vector<CapabilityFormat> getCapabilities();
+
+private:
+    Synthetic_Camera(const CameraInformation &information);
+
+    /**
+     * Delivers frames at the frame rate until stop() is called. Runs on the capture thread.
+     */
+    void capture(PixelFormat pixelFormat, int width, int height, float fps, FrameCallback callback);
+
+    /**
+     * Draws the color bars, scrolled by the frame number, into a laid out frame.
+     */
+    static void drawFrame(Frame &frame, size_t frameNumber);
+
+    CameraInformation information;
+    std::thread captureThread;
+    std::atomic<bool> capturing;
+
+    FramePipeline pipeline; // software stages between the capture thread and the callback
+};
+
+} // namespace webcam_capture
+
+#endif // SYNTHETIC_CAMERA_H
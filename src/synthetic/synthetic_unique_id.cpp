@@ -0,0 +1,31 @@
+#include "synthetic_unique_id.h"
+
+namespace webcam_capture {
+
+Synthetic_UniqueId::Synthetic_UniqueId(int index)
+    :   UniqueId(BackendImplementation::Synthetic),
+        index(index)
+{
+}
+
+Synthetic_UniqueId::~Synthetic_UniqueId()
+{
+}
+
+bool Synthetic_UniqueId::equals(const UniqueId &other) const
+{
+    // "other" must be a UniqueId of the same backend implementation in order to proceed
+    if (!UniqueId::equals(other)) {
+        return false;
+    }
+
+    const Synthetic_UniqueId &otherUniqueId = static_cast<const Synthetic_UniqueId &>(other);
+    return (index == otherUniqueId.getIndex());
+}
+
+int Synthetic_UniqueId::getIndex() const
+{
+    return index;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,25 @@
+#ifndef SYNTHETIC_UNIQUE_ID_H
+#define SYNTHETIC_UNIQUE_ID_H
+
+#include <unique_id.h>
+
+namespace webcam_capture {
+
+class Synthetic_UniqueId : public UniqueId
+{
+public:
+    Synthetic_UniqueId(int index);
+    ~Synthetic_UniqueId();
+
+    int getIndex() const;
+
+protected:
+    bool equals(const UniqueId &other) const override;
+
+private:
+    int index;
+};
+
+} // namespace webcam_capture
+
+#endif // SYNTHETIC_UNIQUE_ID_H
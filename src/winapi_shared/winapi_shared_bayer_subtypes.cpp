@@ -0,0 +1,63 @@
+#include "winapi_shared_bayer_subtypes.h"
+
+namespace webcam_capture {
+
+namespace {
+
+const struct {
+    PixelFormat pixelFormat;
+    char fourcc[5];
+} BAYER_FOURCCS[] = {
+    {PixelFormat::BayerRGGB8,  "RGGB"},
+    {PixelFormat::BayerGRBG8,  "GRBG"},
+    {PixelFormat::BayerGBRG8,  "GBRG"},
+    {PixelFormat::BayerBGGR8,  "BA81"},
+    {PixelFormat::BayerBGGR8,  "BGGR"}, // not a V4L2 one, but some drivers use it
+    {PixelFormat::BayerRGGB10, "RG10"},
+    {PixelFormat::BayerGRBG10, "BA10"},
+    {PixelFormat::BayerGBRG10, "GB10"},
+    {PixelFormat::BayerBGGR10, "BG10"},
+    {PixelFormat::BayerRGGB12, "RG12"},
+    {PixelFormat::BayerGRBG12, "BA12"},
+    {PixelFormat::BayerGBRG12, "GB12"},
+    {PixelFormat::BayerBGGR12, "BG12"}
+};
+
+GUID fourccToSubtype(const char fourcc[4])
+{
+    const DWORD data1 = static_cast<DWORD>(static_cast<BYTE>(fourcc[0])) |
+                        static_cast<DWORD>(static_cast<BYTE>(fourcc[1])) << 8 |
+                        static_cast<DWORD>(static_cast<BYTE>(fourcc[2])) << 16 |
+                        static_cast<DWORD>(static_cast<BYTE>(fourcc[3])) << 24;
+    const GUID subtype = {data1, 0x0000, 0x0010, {0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71}};
+
+    return subtype;
+}
+
+} // namespace
+
+PixelFormat WinapiShared_BayerSubtypes::toPixelFormat(const GUID &subtype)
+{
+    for (auto &&entry : BAYER_FOURCCS) {
+        if (IsEqualGUID(subtype, fourccToSubtype(entry.fourcc))) {
+            return entry.pixelFormat;
+        }
+    }
+
+    return PixelFormat::UNKNOWN;
+}
+
+bool WinapiShared_BayerSubtypes::toSubtype(PixelFormat pixelFormat, GUID &subtype)
+{
+    // the first FOURCC listed for a format is the one to request
+    for (auto &&entry : BAYER_FOURCCS) {
+        if (entry.pixelFormat == pixelFormat) {
+            subtype = fourccToSubtype(entry.fourcc);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,33 @@
+#ifndef WINAPI_SHARED_BAYER_SUBTYPES_H
+#define WINAPI_SHARED_BAYER_SUBTYPES_H
+
+#include <pixel_format.h>
+
+#include <windows.h>
+
+namespace webcam_capture {
+
+/**
+ * Maps raw Bayer media subtypes, which neither DirectShow nor Media Foundation define.
+ * Drivers of cameras outputting raw Bayer expose it as FOURCC subtypes, {FOURCC-0000-0010-8000-00AA00389B71}, with
+ * the FOURCCs V4L2 uses.
+ */
+class WinapiShared_BayerSubtypes
+{
+public:
+    WinapiShared_BayerSubtypes() = delete;
+
+    /**
+     * @return Bayer format of the subtype, PixelFormat::UNKNOWN if the subtype is not a Bayer one.
+     */
+    static PixelFormat toPixelFormat(const GUID &subtype);
+
+    /**
+     * @return true if set subtype, false if pixelFormat is not a Bayer format.
+     */
+    static bool toSubtype(PixelFormat pixelFormat, GUID &subtype);
+};
+
+} // namespace webcam_capture
+
+#endif // WINAPI_SHARED_BAYER_SUBTYPES_H
@@ -0,0 +1,29 @@
+#include "winapi_shared_frame_layout.h"
+
+#include <frame_layout.h>
+
+namespace webcam_capture {
+
+bool WinapiShared_FrameLayout::setLayout(Frame &frame, uint8_t *data, size_t length, size_t stride)
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+
+    if (!traits) {
+        frame.plane[0] = data;
+        frame.bytes = length;
+        return true;
+    }
+
+    // the frame is reused between samples, whose buffers can differ in stride
+    for (int i = 0; i < 3; i ++) {
+        frame.stride[i] = 0;
+    }
+
+    frame.stride[0] = stride;
+
+    const size_t rowAlignment = traits->colorModel == ColorModel::RGB ? 4 : 1;
+
+    return FrameLayout::setLayout(frame, frame.width[0], frame.height[0], data, rowAlignment) <= length;
+}
+
+} // namespace webcam_capture
@@ -0,0 +1,34 @@
+#ifndef WINAPI_SHARED_FRAME_LAYOUT_H
+#define WINAPI_SHARED_FRAME_LAYOUT_H
+
+#include <frame.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webcam_capture {
+
+/**
+ * Lays out the frames DirectShow and Media Foundation deliver in media buffers.
+ */
+class WinapiShared_FrameLayout
+{
+public:
+    WinapiShared_FrameLayout() = delete;
+
+    /**
+     * Points the planes of frame into a media buffer and fills in their strides and offsets.
+     * Rows of RGB formats are padded to 4 bytes, as in bitmaps, unless the buffer tells its own stride. Compressed
+     * formats get only plane[0] and bytes set.
+     * @param frame Frame with the pixel format and size set.
+     * @param data Start of the buffer.
+     * @param length Number of bytes in the buffer.
+     * @param stride Stride of the buffer's luma rows, 0 if the buffer doesn't tell it.
+     * @return true on success, false if the buffer is too short for the frame.
+     */
+    static bool setLayout(Frame &frame, uint8_t *data, size_t length, size_t stride);
+};
+
+} // namespace webcam_capture
+
+#endif // WINAPI_SHARED_FRAME_LAYOUT_H
@@ -179,11 +179,15 @@ void CameraForm::on_captureVideoBtb_clicked()
 //                      videoForm->getFrameCallback(),
 //                      PixelFormat::UYVY,
 //                      PixelFormat::YUY2) < 0) {
+    // only compressed formats need decompressing
+    const PixelFormat decompressFormat = capFormat.getPixelFormat() == PixelFormat::MJPG ? PixelFormat::YUY2 :
+                                         PixelFormat::UNKNOWN;
+
     if (camera->start(capFormat.getPixelFormat(),
                       capResolution.getWidth(),
                       capResolution.getHeight(),
                       capFps.getFps(),
-                      videoForm->getFrameCallback(), PixelFormat::UNKNOWN, PixelFormat::YUY2) < 0) {
+                      videoForm->getFrameCallback(), PixelFormat::UNKNOWN, decompressFormat) < 0) {
         delete videoForm;
     } else {
         videoForm->setCapturingStatus(true);
@@ -294,6 +298,43 @@ std::string  CameraForm::formatToString(PixelFormat format)
         case PixelFormat::Y416:
             return "Y416";
 
+        ///Raw Bayer Formats
+        case PixelFormat::BayerRGGB8:
+            return "BayerRGGB8";
+
+        case PixelFormat::BayerGRBG8:
+            return "BayerGRBG8";
+
+        case PixelFormat::BayerGBRG8:
+            return "BayerGBRG8";
+
+        case PixelFormat::BayerBGGR8:
+            return "BayerBGGR8";
+
+        case PixelFormat::BayerRGGB10:
+            return "BayerRGGB10";
+
+        case PixelFormat::BayerGRBG10:
+            return "BayerGRBG10";
+
+        case PixelFormat::BayerGBRG10:
+            return "BayerGBRG10";
+
+        case PixelFormat::BayerBGGR10:
+            return "BayerBGGR10";
+
+        case PixelFormat::BayerRGGB12:
+            return "BayerRGGB12";
+
+        case PixelFormat::BayerGRBG12:
+            return "BayerGRBG12";
+
+        case PixelFormat::BayerGBRG12:
+            return "BayerGBRG12";
+
+        case PixelFormat::BayerBGGR12:
+            return "BayerBGGR12";
+
         ///Encoded Video Types
         case PixelFormat::DV25:
             return "DV25";
@@ -55,6 +55,11 @@ void MainWindow::fillFrameworkListCB()
                 this->ui->frameworkListComboBox->addItem("AV Foundation");
                 break;
             }
+
+            case BackendImplementation::Synthetic: {
+                this->ui->frameworkListComboBox->addItem("Synthetic");
+                break;
+            }
         }
     }
 }
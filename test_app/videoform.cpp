@@ -4,6 +4,8 @@
 #include <QPoint>
 #include <QMatrix>
 
+#include <pixel_format_converter.h>
+
 using namespace std::placeholders; //for std::bind _1
 
 //TO SAVE mjpg to file
@@ -36,14 +38,13 @@ void VideoForm::FrameCaptureCallback(Frame &frame)
 {
     QImage img;
 
-    if (frame.pixelFormat == PixelFormat::YUY2) {
-        img = YUV422toRGBA32(frame);
-    } else if (frame.pixelFormat == PixelFormat::RGB24) {
-        // display RGB24
-        img = QImage(frame.plane[0], frame.width[0], frame.height[0], 3*frame.width[0], QImage::Format_RGB888).rgbSwapped();
+    Frame rgba = Frame();
+    rgba.pixelFormat = PixelFormat::BGRA32;
 
-        // some RGB images are upside down
-        img = img.mirrored();
+    // any format the converter takes can be shown
+    if (PixelFormatConverter::getDestinationLayout(frame, rgba) != 0) {
+        // the conversion also turns bottom-up RGB frames upright
+        img = toRGBA32(frame);
     }
 
     this->ui->videoLabel->setPixmap(QPixmap::fromImage(img));
@@ -67,46 +68,30 @@ void VideoForm::setCapturingStatus(bool isCapturing)
 }
 
 
-// https://en.wikipedia.org/wiki/YUV#Converting_between_Y.27UV_and_RGB
-QImage VideoForm::YUV422toRGBA32(Frame &frame)
+QImage VideoForm::toRGBA32(Frame &frame)
 {
-    QImage rgbImg(frame.width[0], frame.height[0], QImage::Format_RGB888);
-
-    int w = 0;
-    int h = 0;
-
-#define CLAMP(X) (((X) > 255) ? 255 : (((X) < 0) ? 0 : (X)))
-#define YUV_TO_R(Y, U, V) (CLAMP((Y) + 1.402 * ((V) - 128)))
-#define YUV_TO_G(Y, U, V) (CLAMP((Y) - 0.334 * ((U) - 128) - 0.714 * ((V) - 128)))
-#define YUV_TO_B(Y, U, V) (CLAMP((Y) + 1.772 * ((U) - 128)))
-#define YUV_TO_QRGB(Y, U, V) (qRgb(YUV_TO_R((Y), (U), (V)), YUV_TO_G((Y), (U), (V)), YUV_TO_B((Y), (U), (V))))
-
-    for (unsigned int i = 0 ; i <= frame.bytes - 4 ; i += 4) {
-        int y1 = frame.plane[0][i + 0];
-        int u  = frame.plane[0][i + 1];
-        int y2 = frame.plane[0][i + 2];
-        int v  = frame.plane[0][i + 3];
-
-        if (w == frame.width[0]) {
-            w = 0;
-            h ++;
-        }
-        rgbImg.setPixel(w++, h, YUV_TO_QRGB(y1, u, v));
-
-        if (w == frame.width[0]) {
-            w = 0;
-            h ++;
-        }
-        rgbImg.setPixel(w++, h, YUV_TO_QRGB(y2, u, v));
+    // Format_RGB32 pixels are 0xffRRGGBB integers, i.e. B, G, R, A bytes on little-endian machines
+    Frame rgbFrame = Frame();
+    rgbFrame.pixelFormat = PixelFormat::BGRA32;
+
+    if (!PixelFormatConverter::getDestinationLayout(frame, rgbFrame)) {
+        return QImage();
+    }
+
+    // reuse the image between frames, it only gets reallocated when the frame size changes
+    if (rgbImage.width() != (int)rgbFrame.width[0] || rgbImage.height() != (int)rgbFrame.height[0]) {
+        rgbImage = QImage(rgbFrame.width[0], rgbFrame.height[0], QImage::Format_RGB32);
     }
 
-#undef CLAMP
-#undef YUV_TO_R
-#undef YUV_TO_G
-#undef YUV_TO_B
-#undef YUV_TO_QRGB
+    rgbFrame.plane[0] = rgbImage.bits();
+    rgbFrame.stride[0] = rgbImage.bytesPerLine();
+    rgbFrame.bytes = rgbImage.byteCount();
+
+    if (!PixelFormatConverter::convertInto(frame, rgbFrame)) {
+        return QImage();
+    }
 
-    return rgbImg;
+    return rgbImage;
 }
 
 FrameCallback VideoForm::getFrameCallback()
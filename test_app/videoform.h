@@ -1,6 +1,7 @@
 #ifndef VIDEOFORM_H
 #define VIDEOFORM_H
 
+#include <QImage>
 #include <QWidget>
 #include <frame.h>
 #include <functional>
@@ -22,7 +23,7 @@ public:
 
     void FrameCaptureCallback(Frame &frame);
     FrameCallback getFrameCallback();
-    QImage YUV422toRGBA32(Frame &frame);
+    QImage toRGBA32(Frame &frame);
 
     void setCapturingStatus(bool isCapturing);
 
@@ -30,6 +31,7 @@ private:
     Ui::VideoForm *ui;
     CameraInterface &camera;
     bool isCapturing;
+    QImage rgbImage;
 };
 
 #endif // VIDEOFORM_H
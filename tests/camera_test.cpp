@@ -0,0 +1,123 @@
+#include "test_utils.h"
+
+#include <backend_factory.h>
+#include <backend_interface.h>
+#include <camera_interface.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+const float FPS = 30;
+
+/**
+ * Waits for the callback to get a number of frames, for at most a few seconds.
+ */
+bool waitForFrames(const std::atomic<int> &frames, int count)
+{
+    for (int i = 0; i < 300 && frames.load() < count; i ++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return frames.load() >= count;
+}
+
+/**
+ * Captures with a delivery and conversion, checking the frames the callback gets, captureFrame() and the counters.
+ */
+void testCapture(CameraInterface &camera, PixelFormat decodeFormat, FrameDelivery delivery)
+{
+    const PixelFormat outputFormat = decodeFormat == PixelFormat::UNKNOWN ? PixelFormat::YUY2 : decodeFormat;
+
+    std::atomic<int> frames(0);
+    std::atomic<int> mismatches(0);
+    const std::thread::id startThread = std::this_thread::get_id();
+    std::atomic<bool> onStartThread(false);
+
+    FrameCallback callback = [&](Frame & frame) {
+        if (frame.pixelFormat != outputFormat || frame.width[0] != static_cast<size_t>(WIDTH) ||
+            frame.height[0] != static_cast<size_t>(HEIGHT) || !frame.plane[0]) {
+            mismatches ++;
+        }
+
+        if (std::this_thread::get_id() == startThread) {
+            onStartThread = true;
+        }
+
+        frames ++;
+    };
+
+    CHECK(camera.start(PixelFormat::YUY2, WIDTH, HEIGHT, FPS, callback, decodeFormat, PixelFormat::UNKNOWN,
+                       DecompressionScale::Full, delivery) == 1);
+    CHECK(waitForFrames(frames, 5));
+
+    std::unique_ptr<Frame> frame = camera.captureFrame();
+    CHECK(frame != nullptr);
+
+    if (frame) {
+        CHECK(frame->pixelFormat == outputFormat);
+        CHECK(frame->width[0] == static_cast<size_t>(WIDTH));
+        CHECK(frame->height[0] == static_cast<size_t>(HEIGHT));
+        CHECK(frame->plane[0] != nullptr);
+    }
+
+    CHECK(camera.stop() == 1);
+
+    const int delivered = frames.load();
+    const FrameDropStatistics statistics = camera.getDropStatistics();
+    CHECK(statistics.delivered == static_cast<uint64_t>(delivered));
+    CHECK(statistics.poolExhausted == 0);
+    CHECK(statistics.decodeFailed == 0);
+
+    CHECK(mismatches.load() == 0);
+    CHECK(!onStartThread.load());
+
+    // no frame comes in once stop() returned, the last one stays for captureFrame()
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(frames.load() == delivered);
+    CHECK(camera.captureFrame() != nullptr);
+}
+
+} // namespace
+
+int main()
+{
+    std::unique_ptr<BackendInterface> backend = BackendFactory::getBackend(BackendImplementation::Synthetic);
+    CHECK(backend != nullptr);
+
+    if (!backend) {
+        return 1;
+    }
+
+    const std::vector<CameraInformation> cameras = backend->getAvailableCameras();
+    CHECK(!cameras.empty());
+
+    if (cameras.empty()) {
+        return 1;
+    }
+
+    std::unique_ptr<CameraInterface> camera = backend->getCamera(cameras.front());
+    CHECK(camera != nullptr);
+
+    if (!camera) {
+        return 1;
+    }
+
+    // the first call has frames kept for the later ones
+    CHECK(camera->captureFrame() == nullptr);
+
+    testCapture(*camera, PixelFormat::UNKNOWN, FrameDelivery::Direct);
+    testCapture(*camera, PixelFormat::RGB24, FrameDelivery::Direct);
+    testCapture(*camera, PixelFormat::UNKNOWN, FrameDelivery::Queued);
+    testCapture(*camera, PixelFormat::RGB24, FrameDelivery::Queued);
+
+    return finishTest();
+}
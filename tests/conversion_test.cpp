@@ -0,0 +1,454 @@
+#include "test_utils.h"
+
+#include <frame_deinterlacer.h>
+#include <frame_layout.h>
+#include <pixel_format_converter.h>
+
+#include "conversion/conversion_cpu_features.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+/**
+ * Differential test of the SIMD kernels: every conversion, resize and deinterlacing is run at every SIMD level the CPU
+ * has, and the outputs have to be identical to the plain C one, byte for byte, padding of the rows included.
+ * Sizes are odd and not multiples of any vector width, so the kernels' tails run too, and the planes start at odd
+ * addresses with odd strides, so no kernel relies on alignment.
+ */
+
+struct FormatName {
+    PixelFormat pixelFormat;
+    const char *name;
+};
+
+#define FORMAT(name) {PixelFormat::name, #name}
+
+// uncompressed formats, every pair of them the converter supports gets tested
+const FormatName FORMATS[] = {
+    FORMAT(RGB1), FORMAT(RGB4), FORMAT(RGB8), FORMAT(RGB555), FORMAT(RGB565), FORMAT(RGB24), FORMAT(RGB32),
+    FORMAT(BGRA32), FORMAT(BE16_555), FORMAT(BE16_565), FORMAT(LE16_555), FORMAT(LE16_565), FORMAT(LE16_5551),
+    FORMAT(ARGB1555), FORMAT(ARGB32), FORMAT(ARGB4444), FORMAT(A2R10G10B10), FORMAT(A2B10G10R10), FORMAT(IA44),
+    FORMAT(AI44), FORMAT(AYUV), FORMAT(I420), FORMAT(IYUV), FORMAT(NV11), FORMAT(NV12), FORMAT(UYVY), FORMAT(YUYV),
+    FORMAT(Y211), FORMAT(Y411), FORMAT(Y41P), FORMAT(Y41T), FORMAT(Y42T), FORMAT(YUY2), FORMAT(YV12), FORMAT(IMC1),
+    FORMAT(IMC2), FORMAT(IMC3), FORMAT(IMC4), FORMAT(IF09), FORMAT(YVU9), FORMAT(YVYU), FORMAT(Y800), FORMAT(P010),
+    FORMAT(P016), FORMAT(P210), FORMAT(P216), FORMAT(v210), FORMAT(v216), FORMAT(v308), FORMAT(v408), FORMAT(v410),
+    FORMAT(Y210), FORMAT(Y216), FORMAT(Y410), FORMAT(Y416), FORMAT(BayerRGGB8), FORMAT(BayerGRBG8), FORMAT(BayerGBRG8),
+    FORMAT(BayerBGGR8), FORMAT(BayerRGGB10), FORMAT(BayerGRBG10), FORMAT(BayerGBRG10), FORMAT(BayerBGGR10),
+    FORMAT(BayerRGGB12), FORMAT(BayerGRBG12), FORMAT(BayerGBRG12), FORMAT(BayerBGGR12), FORMAT(O420),
+    FORMAT(RGB32_D3D_DX7_RT), FORMAT(RGB16_D3D_DX7_RT), FORMAT(ARGB32_D3D_DX7_RT), FORMAT(ARGB4444_D3D_DX7_RT),
+    FORMAT(ARGB1555_D3D_DX7_RT), FORMAT(RGB32_D3D_DX9_RT), FORMAT(RGB16_D3D_DX9_RT), FORMAT(ARGB32_D3D_DX9_RT),
+    FORMAT(ARGB4444_D3D_DX9_RT), FORMAT(ARGB1555_D3D_DX9_RT), FORMAT(CLJR), FORMAT(IndexedGray8_WhiteIsZero)
+};
+
+const char *TRANSFORM_NAMES[] = {"None", "FlipVertical", "FlipHorizontal", "Rotate90", "Rotate180", "Rotate270"};
+
+struct Size {
+    size_t width;
+    size_t height;
+};
+
+// odd sizes, one of them wider than the widest vector loop, and an even one whose rows are exactly vector multiples
+const Size SIZES[] = {{67, 35}, {35, 67}, {131, 3}, {64, 18}};
+
+const Conversion_CpuFeatures::SimdLevel SIMD_LEVELS[] = {
+    Conversion_CpuFeatures::SimdLevel::None,
+    Conversion_CpuFeatures::SimdLevel::SSE2,
+    Conversion_CpuFeatures::SimdLevel::AVX2
+};
+
+// bytes the strides get padded by and the planes get offset by, odd so that nothing is aligned
+const size_t STRIDE_PADDING = 7;
+const size_t BASE_OFFSET = 1;
+
+// value unwritten bytes keep, so that writes outside of the rows show up as differences
+const uint8_t CANARY = 0xCD;
+
+size_t comparisons = 0;
+
+/**
+ * A frame laid out in a buffer of its own, with its planes at an odd address and, if padded, odd strides.
+ */
+struct TestFrame {
+    std::vector<uint8_t> buffer;
+    Frame frame;
+};
+
+size_t getLayout(PixelFormat pixelFormat, size_t width, size_t height, bool padded, Frame &frame)
+{
+    frame = Frame();
+    frame.pixelFormat = pixelFormat;
+
+    if (!FrameLayout::setLayout(frame, width, height)) {
+        return 0;
+    }
+
+    const size_t tightStride = frame.stride[0];
+    frame = Frame();
+    frame.pixelFormat = pixelFormat;
+    frame.stride[0] = padded ? tightStride + STRIDE_PADDING : 0;
+
+    return FrameLayout::setLayout(frame, width, height);
+}
+
+bool makeSource(PixelFormat pixelFormat, size_t width, size_t height, bool padded, TestFrame &source)
+{
+    const size_t bytes = getLayout(pixelFormat, width, height, padded, source.frame);
+
+    if (!bytes) {
+        return false;
+    }
+
+    source.buffer.resize(bytes + BASE_OFFSET);
+
+    // noise, so that no kernel gets to take a shortcut on flat input
+    uint32_t seed = static_cast<uint32_t>(pixelFormat) * 7919 + static_cast<uint32_t>(width * 31 + height);
+
+    for (uint8_t &byte : source.buffer) {
+        seed = seed * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+
+    FrameLayout::setLayout(source.frame, width, height, source.buffer.data() + BASE_OFFSET);
+
+    return true;
+}
+
+/**
+ * Runs an operation at every SIMD level the CPU has, into a fresh copy of the destination for each, and checks that
+ * all of them succeed or fail alike, and that the successful ones all write the same bytes.
+ * @param destination Destination, its layout filled in, with plane[0] pointing at offset BASE_OFFSET of buffer.
+ * @param run Operation, writing into the frame it gets.
+ */
+template<typename Operation>
+void compareLevels(const char *description, const Frame &destination, size_t bytes, const Operation &run)
+{
+    std::vector<uint8_t> reference;
+    bool referenceResult = false;
+
+    for (const Conversion_CpuFeatures::SimdLevel level : SIMD_LEVELS) {
+        Conversion_CpuFeatures::setMaxSimdLevel(level);
+
+        if (Conversion_CpuFeatures::getSimdLevel() != level) {
+            continue;
+        }
+
+        std::vector<uint8_t> buffer(bytes + BASE_OFFSET, CANARY);
+        Frame output = destination;
+        output.plane[0] = buffer.data() + BASE_OFFSET;
+        FrameLayout::setPlanes(output);
+
+        const bool result = run(output);
+
+        if (level == Conversion_CpuFeatures::SimdLevel::None) {
+            reference.swap(buffer);
+            referenceResult = result;
+            continue;
+        }
+
+        if (result != referenceResult) {
+            std::fprintf(stderr, "%s: level %d %s where C %s\n", description, static_cast<int>(level),
+                         result ? "succeeded" : "failed", referenceResult ? "succeeded" : "failed");
+            failures ++;
+        } else if (result && buffer != reference) {
+            size_t first = 0;
+
+            while (buffer[first] == reference[first]) {
+                first ++;
+            }
+
+            std::fprintf(stderr, "%s: level %d differs from C first at byte %u\n", description,
+                         static_cast<int>(level), static_cast<unsigned>(first - BASE_OFFSET));
+            failures ++;
+        } else if (result) {
+            comparisons ++;
+        }
+    }
+
+    Conversion_CpuFeatures::setMaxSimdLevel(Conversion_CpuFeatures::SimdLevel::AVX2);
+}
+
+void testConversions()
+{
+    for (const FormatName &sourceFormat : FORMATS) {
+        for (const Size &size : SIZES) {
+            for (int padded = 0; padded < 2; padded ++) {
+                TestFrame source;
+
+                if (!makeSource(sourceFormat.pixelFormat, size.width, size.height, padded != 0, source)) {
+                    continue;
+                }
+
+                for (const FormatName &destinationFormat : FORMATS) {
+                    // transforms at one size, the rest of the sizes without
+                    const int transforms = &size == SIZES ? 6 : 1;
+
+                    for (int t = 0; t < transforms; t ++) {
+                        const Transform transform = static_cast<Transform>(t);
+
+                        Frame destination = Frame();
+                        destination.pixelFormat = destinationFormat.pixelFormat;
+
+                        if (!PixelFormatConverter::getDestinationLayout(source.frame, destination, transform)) {
+                            continue;
+                        }
+
+                        // padded sources get padded destinations
+                        if (padded) {
+                            destination.stride[0] += STRIDE_PADDING;
+                            destination.stride[1] = 0;
+                            destination.stride[2] = 0;
+                            destination.bytes = FrameLayout::setLayout(destination, destination.width[0],
+                                                destination.height[0]);
+                        }
+
+                        char description[160];
+                        std::snprintf(description, sizeof(description), "%s>%s %ux%u %s %s", sourceFormat.name,
+                                      destinationFormat.name, static_cast<unsigned>(size.width),
+                                      static_cast<unsigned>(size.height), padded ? "padded" : "tight",
+                                      TRANSFORM_NAMES[t]);
+
+                        compareLevels(description, destination, destination.bytes, [&](Frame & output) {
+                            return PixelFormatConverter::convertInto(source.frame, output, transform);
+                        });
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Kernels whose output depends on a mode or on the colorimetry of the source, at one size.
+ */
+void testModes()
+{
+    const PixelFormat rgbFormats[] = {PixelFormat::RGB24, PixelFormat::RGB32, PixelFormat::ARGB32};
+    const ColorSpace colorSpaces[] = {ColorSpace::BT601, ColorSpace::BT709, ColorSpace::BT2020};
+    const ColorRange colorRanges[] = {ColorRange::Limited, ColorRange::Full};
+    const DitherMode ditherModes[] = {DitherMode::Round, DitherMode::Ordered};
+    const DemosaicMode demosaicModes[] = {DemosaicMode::Bilinear, DemosaicMode::EdgeAware};
+
+    for (const FormatName &sourceFormat : FORMATS) {
+        TestFrame source;
+
+        if (!makeSource(sourceFormat.pixelFormat, 67, 35, true, source)) {
+            continue;
+        }
+
+        for (const PixelFormat rgbFormat : rgbFormats) {
+            for (const ColorSpace colorSpace : colorSpaces) {
+                for (const ColorRange colorRange : colorRanges) {
+                    for (const DitherMode ditherMode : ditherModes) {
+                        for (const DemosaicMode demosaicMode : demosaicModes) {
+                            source.frame.colorSpace = colorSpace;
+                            source.frame.colorRange = colorRange;
+                            PixelFormatConverter::setDitherMode(ditherMode);
+                            PixelFormatConverter::setDemosaicMode(demosaicMode);
+
+                            Frame destination = Frame();
+                            destination.pixelFormat = rgbFormat;
+
+                            if (!PixelFormatConverter::getDestinationLayout(source.frame, destination)) {
+                                continue;
+                            }
+
+                            char description[160];
+                            std::snprintf(description, sizeof(description), "%s>%d space %d range %d dither %d "
+                                          "demosaic %d", sourceFormat.name, static_cast<int>(rgbFormat),
+                                          static_cast<int>(colorSpace), static_cast<int>(colorRange),
+                                          static_cast<int>(ditherMode), static_cast<int>(demosaicMode));
+
+                            compareLevels(description, destination, destination.bytes, [&](Frame & output) {
+                                return PixelFormatConverter::convertInto(source.frame, output);
+                            });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    PixelFormatConverter::setDitherMode(DitherMode::Round);
+    PixelFormatConverter::setDemosaicMode(DemosaicMode::Bilinear);
+}
+
+/**
+ * The YUV to RGB kernels mapping the samples through lookup tables.
+ */
+void testLookupTables()
+{
+    uint8_t luma[256];
+    uint8_t chroma[256];
+
+    for (int i = 0; i < 256; i ++) {
+        luma[i] = static_cast<uint8_t>(255 - i);
+        chroma[i] = static_cast<uint8_t>(i / 2 + 64);
+    }
+
+    for (const FormatName &sourceFormat : FORMATS) {
+        for (const Size &size : SIZES) {
+            TestFrame source;
+
+            if (!makeSource(sourceFormat.pixelFormat, size.width, size.height, true, source)) {
+                continue;
+            }
+
+            Frame destination = Frame();
+            destination.pixelFormat = PixelFormat::RGB24;
+
+            if (!PixelFormatConverter::getDestinationLayout(source.frame, destination)) {
+                continue;
+            }
+
+            char description[160];
+            std::snprintf(description, sizeof(description), "%s>RGB24 %ux%u with tables", sourceFormat.name,
+                          static_cast<unsigned>(size.width), static_cast<unsigned>(size.height));
+
+            compareLevels(description, destination, destination.bytes, [&](Frame & output) {
+                return PixelFormatConverter::convertInto(source.frame, output, luma, chroma);
+            });
+        }
+    }
+}
+
+void testScaling()
+{
+    const ScaleFilter filters[] = {ScaleFilter::Box, ScaleFilter::Bilinear, ScaleFilter::Nearest};
+    const Size scaledSizes[] = {{33, 17}, {131, 71}, {9, 5}};
+
+    for (const FormatName &sourceFormat : FORMATS) {
+        TestFrame source;
+
+        if (!makeSource(sourceFormat.pixelFormat, 67, 35, true, source)) {
+            continue;
+        }
+
+        for (const FormatName &destinationFormat : FORMATS) {
+            for (const Size &scaled : scaledSizes) {
+                Frame destination = Frame();
+                destination.pixelFormat = destinationFormat.pixelFormat;
+
+                if (!PixelFormatConverter::getDestinationLayout(source.frame, destination, scaled.width,
+                        scaled.height)) {
+                    continue;
+                }
+
+                for (const ScaleFilter filter : filters) {
+                    char description[160];
+                    std::snprintf(description, sizeof(description), "%s>%s scaled to %ux%u filter %d",
+                                  sourceFormat.name, destinationFormat.name, static_cast<unsigned>(scaled.width),
+                                  static_cast<unsigned>(scaled.height), static_cast<int>(filter));
+
+                    const bool same = sourceFormat.pixelFormat == destinationFormat.pixelFormat;
+
+                    compareLevels(description, destination, destination.bytes, [&](Frame & output) {
+                        if (same) {
+                            return PixelFormatConverter::scaleInto(source.frame, output, scaled.width, scaled.height,
+                                                                   filter);
+                        }
+
+                        return PixelFormatConverter::convertAndScaleInto(source.frame, output, scaled.width,
+                                scaled.height, filter);
+                    });
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Copies the rows of every plane of a frame into another one of the same format and size.
+ */
+bool copyFrame(const Frame &frame, const Frame &destination)
+{
+    const PixelFormatTraits *traits = FrameLayout::getTraits(frame.pixelFormat);
+
+    if (!traits || frame.pixelFormat != destination.pixelFormat) {
+        return false;
+    }
+
+    for (int i = 0; i < traits->planes; i ++) {
+        const uint8_t *source = frame.plane[i] ? frame.plane[i] : frame.plane[0] + frame.offset[i];
+        uint8_t *target = destination.plane[i] ? destination.plane[i] : destination.plane[0] + destination.offset[i];
+        const size_t rowBytes = std::min(frame.stride[i], destination.stride[i]);
+
+        for (size_t y = 0; y < frame.height[i]; y ++) {
+            std::memcpy(target + y * destination.stride[i], source + y * frame.stride[i], rowBytes);
+        }
+    }
+
+    return true;
+}
+
+void testDeinterlacing()
+{
+    const DeinterlaceMode modes[] = {DeinterlaceMode::Bob, DeinterlaceMode::MotionAdaptive};
+    const FieldOrder fieldOrders[] = {FieldOrder::TopFirst, FieldOrder::BottomFirst};
+
+    for (const FormatName &format : FORMATS) {
+        for (const Size &size : SIZES) {
+            // two frames, so that the motion adaptive mode has a previous field to compare against
+            TestFrame first;
+            TestFrame second;
+
+            if (!makeSource(format.pixelFormat, size.width, size.height, true, first) ||
+                !makeSource(format.pixelFormat, size.width, size.height, true, second)) {
+                continue;
+            }
+
+            // half of the second frame stays still, so that both weaving and bobbing run
+            std::memcpy(second.buffer.data(), first.buffer.data(), second.buffer.size() / 2);
+
+            for (const DeinterlaceMode mode : modes) {
+                for (const FieldOrder fieldOrder : fieldOrders) {
+                    char description[160];
+                    std::snprintf(description, sizeof(description), "%s %ux%u deinterlaced mode %d order %d",
+                                  format.name, static_cast<unsigned>(size.width), static_cast<unsigned>(size.height),
+                                  static_cast<int>(mode), static_cast<int>(fieldOrder));
+
+                    compareLevels(description, first.frame, first.buffer.size() - BASE_OFFSET, [&](Frame & output) {
+                        bool delivered = false;
+                        FrameCallback deinterlacer = FrameDeinterlacer::wrapCallback(mode, fieldOrder,
+                        [&](Frame & deinterlaced) {
+                            delivered = copyFrame(deinterlaced, output);
+                        });
+
+                        Frame frame = first.frame;
+                        deinterlacer(frame);
+                        frame = second.frame;
+                        deinterlacer(frame);
+
+                        return delivered;
+                    });
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    if (Conversion_CpuFeatures::getSimdLevel() == Conversion_CpuFeatures::SimdLevel::None) {
+        std::printf("The CPU has no SIMD instruction set the kernels are written for, nothing to compare\n");
+        return 0;
+    }
+
+    testConversions();
+    testModes();
+    testLookupTables();
+    testScaling();
+    testDeinterlacing();
+
+    std::printf("%u outputs identical to the C ones\n", static_cast<unsigned>(comparisons));
+    CHECK(comparisons > 0);
+
+    return finishTest();
+}
@@ -0,0 +1,178 @@
+#include "test_utils.h"
+
+#include <frame_buffer_pool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+void testRegistry()
+{
+    std::shared_ptr<FrameBufferPool> pool = FrameBufferPool::getPool(PixelFormat::RGB24, 33, 2);
+    CHECK(pool != nullptr);
+
+    if (!pool) {
+        return;
+    }
+
+    // one pool per pixel format, size and row alignment
+    CHECK(FrameBufferPool::getPool(PixelFormat::RGB24, 33, 2) == pool);
+    CHECK(FrameBufferPool::getPool(PixelFormat::RGB24, 33, 2, 1) == pool);
+    CHECK(FrameBufferPool::getPool(PixelFormat::RGB24, 34, 2) != pool);
+    CHECK(FrameBufferPool::getPool(PixelFormat::RGB32, 33, 2) != pool);
+    CHECK(pool->getBufferSize() == 33 * 3 * 2);
+
+    // rows padded further take bigger buffers, of a pool of their own
+    std::shared_ptr<FrameBufferPool> aligned = FrameBufferPool::getPool(PixelFormat::RGB24, 33, 2, 4);
+    CHECK(aligned != nullptr && aligned != pool);
+    CHECK(aligned && aligned->getBufferSize() == 100 * 2);
+
+    CHECK(FrameBufferPool::getPool(PixelFormat::UNKNOWN, 33, 2) == nullptr);
+
+    // a pool nothing uses any more is gone, with its buffers
+    pool->prewarm(2);
+    std::weak_ptr<FrameBufferPool> released = pool;
+    pool.reset();
+    CHECK(released.expired());
+
+    pool = FrameBufferPool::getPool(PixelFormat::RGB24, 33, 2);
+    CHECK(pool && pool->getStatistics().buffers == 0);
+}
+
+void testPrewarm()
+{
+    std::shared_ptr<FrameBufferPool> pool = FrameBufferPool::getPool(PixelFormat::YUY2, 64, 4);
+
+    if (!pool) {
+        CHECK(pool != nullptr);
+        return;
+    }
+
+    pool->prewarm(FrameBufferPool::DEFAULT_PREWARMED_BUFFERS);
+    FrameBufferPoolStatistics statistics = pool->getStatistics();
+    CHECK(statistics.buffers == FrameBufferPool::DEFAULT_PREWARMED_BUFFERS);
+    CHECK(statistics.inUse == 0);
+    CHECK(statistics.grows == 0);
+
+    // prewarming never shrinks the pool, and never grows it past its cap
+    pool->prewarm(1);
+    CHECK(pool->getStatistics().buffers == FrameBufferPool::DEFAULT_PREWARMED_BUFFERS);
+    pool->prewarm(FrameBufferPool::DEFAULT_MAX_BUFFERS + 4);
+    CHECK(pool->getStatistics().buffers == FrameBufferPool::DEFAULT_MAX_BUFFERS);
+
+    // the prewarmed buffers are handed out without allocating, zero-filled
+    std::vector<std::shared_ptr<uint8_t> > held;
+
+    for (size_t i = 0; i < FrameBufferPool::DEFAULT_MAX_BUFFERS; i ++) {
+        held.push_back(pool->acquire());
+        CHECK(held.back() != nullptr);
+    }
+
+    statistics = pool->getStatistics();
+    CHECK(statistics.hits == FrameBufferPool::DEFAULT_MAX_BUFFERS);
+    CHECK(statistics.misses == 0 && statistics.grows == 0);
+    CHECK(statistics.inUse == FrameBufferPool::DEFAULT_MAX_BUFFERS);
+    CHECK(held.front() && held.front().get()[0] == 0 && held.front().get()[pool->getBufferSize() - 1] == 0);
+}
+
+void testCap()
+{
+    std::shared_ptr<FrameBufferPool> pool = FrameBufferPool::getPool(PixelFormat::I420, 16, 16);
+
+    if (!pool) {
+        CHECK(pool != nullptr);
+        return;
+    }
+
+    pool->setMaxBuffers(2);
+    CHECK(pool->getMaxBuffers() == 2);
+
+    // the pool grows when all buffers are held, up to its cap
+    std::shared_ptr<uint8_t> first = pool->acquire();
+    std::shared_ptr<uint8_t> second = pool->acquire();
+    CHECK(first != nullptr && second != nullptr && first != second);
+    CHECK(pool->acquire() == nullptr);
+
+    FrameBufferPoolStatistics statistics = pool->getStatistics();
+    CHECK(statistics.buffers == 2 && statistics.inUse == 2);
+    CHECK(statistics.misses == 3 && statistics.grows == 2 && statistics.hits == 0);
+
+    // a buffer dropped by its last holder goes back to the pool
+    uint8_t *const data = first.get();
+    first.reset();
+    first = pool->acquire();
+    CHECK(first.get() == data);
+
+    // and the one handed out last is handed out first, as it's the likeliest to be in the cache
+    second.reset();
+    first.reset();
+    first = pool->acquire();
+    CHECK(first.get() == data);
+
+    statistics = pool->getStatistics();
+    CHECK(statistics.hits == 2 && statistics.buffers == 2);
+
+    // lowering the cap keeps the buffers already there
+    pool->setMaxBuffers(0);
+    CHECK(pool->getMaxBuffers() == 1);
+    CHECK(pool->getStatistics().buffers == 2);
+    first.reset();
+    CHECK(pool->acquire() != nullptr);
+}
+
+void testConcurrentCap()
+{
+    std::shared_ptr<FrameBufferPool> pool = FrameBufferPool::getPool(PixelFormat::ARGB32, 320, 240);
+
+    if (!pool) {
+        CHECK(pool != nullptr);
+        return;
+    }
+
+    const size_t maxBuffers = 4;
+    pool->setMaxBuffers(maxBuffers);
+
+    // buffers allocated outside of the pool's lock count against the cap all the same
+    std::atomic<size_t> acquired(0);
+    std::vector<std::thread> threads;
+    std::vector<std::shared_ptr<uint8_t> > held[8];
+
+    for (size_t i = 0; i < 8; i ++) {
+        threads.push_back(std::thread([&, i]() {
+            for (int j = 0; j < 4; j ++) {
+                std::shared_ptr<uint8_t> buffer = pool->acquire();
+
+                if (buffer) {
+                    held[i].push_back(buffer);
+                    acquired ++;
+                }
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(acquired.load() == maxBuffers);
+    CHECK(pool->getStatistics().buffers == maxBuffers);
+    CHECK(pool->getStatistics().grows == maxBuffers);
+}
+
+} // namespace
+
+int main()
+{
+    testRegistry();
+    testPrewarm();
+    testCap();
+    testConcurrentCap();
+
+    return finishTest();
+}
@@ -0,0 +1,190 @@
+#include "test_utils.h"
+
+#include <frame_buffer_pool.h>
+#include <frame_layout.h>
+
+#include "frame_mailbox.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+const size_t WIDTH = 37;
+const size_t HEIGHT = 11;
+
+/**
+ * Frame whose every byte is value, so that frames can be told apart and torn ones spotted.
+ */
+struct TestFrame
+{
+    explicit TestFrame(uint8_t value) :
+        frame()
+    {
+        frame.pixelFormat = PixelFormat::RGB24;
+        data.resize(FrameLayout::setLayout(frame, WIDTH, HEIGHT));
+        FrameLayout::setLayout(frame, WIDTH, HEIGHT, data.data());
+        fill(value);
+    }
+
+    void fill(uint8_t value)
+    {
+        std::memset(data.data(), value, data.size());
+    }
+
+    Frame frame;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @return The value every byte of frame is, -1 if there is no frame or its bytes differ.
+ */
+int getValue(const std::unique_ptr<Frame> &frame)
+{
+    if (!frame || !frame->plane[0] || frame->width[0] != WIDTH || frame->height[0] != HEIGHT) {
+        return -1;
+    }
+
+    for (size_t y = 0; y < HEIGHT; y ++) {
+        const uint8_t *row = frame->plane[0] + y * frame->stride[0];
+
+        for (size_t x = 0; x < WIDTH * 3; x ++) {
+            if (row[x] != frame->plane[0][0]) {
+                return -1;
+            }
+        }
+    }
+
+    return frame->plane[0][0];
+}
+
+void testFreshness()
+{
+    std::shared_ptr<FrameMailbox> mailbox = std::make_shared<FrameMailbox>();
+    int passedOn = 0;
+    FrameCallback post = FrameMailbox::wrapCallback(mailbox, [&](Frame &) {
+        passedOn ++;
+    });
+
+    // nothing is copied before the first take(), which gets nothing, but frames are passed on all the same
+    TestFrame first(1);
+    post(first.frame);
+    CHECK(passedOn == 1);
+    CHECK(mailbox->take() == nullptr);
+    CHECK(mailbox->take() == nullptr);
+
+    // frames posted once polled are copies, untouched by what happens to the posted ones
+    TestFrame second(2);
+    post(second.frame);
+    second.fill(20);
+    std::unique_ptr<Frame> taken = mailbox->take();
+    CHECK(getValue(taken) == 2);
+    CHECK(taken && taken->owner != nullptr);
+
+    // polls between two frames get the last one again
+    CHECK(getValue(mailbox->take()) == 2);
+
+    // only the newest of the frames posted since the last poll is taken
+    TestFrame third(3);
+    TestFrame fourth(4);
+    post(third.frame);
+    post(fourth.frame);
+    CHECK(getValue(mailbox->take()) == 4);
+    CHECK(passedOn == 4);
+
+    // frames kept by the reader aren't written over by later ones
+    for (uint8_t value = 5; value < 10; value ++) {
+        TestFrame later(value);
+        post(later.frame);
+    }
+
+    CHECK(getValue(taken) == 2);
+    CHECK(getValue(mailbox->take()) == 9);
+
+    // frames without pixel data aren't posted
+    Frame empty = Frame();
+    post(empty);
+    CHECK(getValue(mailbox->take()) == 9);
+
+    // reset() drops the frames of the earlier capture, posting goes on
+    mailbox->reset();
+    CHECK(mailbox->take() == nullptr);
+    TestFrame restarted(10);
+    post(restarted.frame);
+    CHECK(getValue(mailbox->take()) == 10);
+}
+
+void testPrepare()
+{
+    // a size of its own, so that no other pool gets in the way
+    std::shared_ptr<FrameBufferPool> pool = FrameBufferPool::getPool(PixelFormat::RGB24, WIDTH + 1, HEIGHT);
+    FrameMailbox mailbox;
+
+    // cameras nobody polls don't get any buffers
+    mailbox.prepare(PixelFormat::RGB24, WIDTH + 1, HEIGHT);
+    CHECK(pool && pool->getStatistics().buffers == 0);
+
+    // the first poll prewarms them
+    CHECK(mailbox.take() == nullptr);
+    CHECK(pool && pool->getStatistics().buffers > 0);
+}
+
+void testConcurrentPolls()
+{
+    std::shared_ptr<FrameMailbox> mailbox = std::make_shared<FrameMailbox>();
+    FrameCallback post = FrameMailbox::wrapCallback(mailbox, [](Frame &) {});
+    CHECK(mailbox->take() == nullptr);
+
+    std::atomic<bool> done(false);
+    std::thread capture([&]() {
+        TestFrame frame(0);
+
+        for (int value = 1; value < 250; value ++) {
+            frame.fill(static_cast<uint8_t>(value));
+            post(frame.frame);
+        }
+
+        done = true;
+    });
+
+    // the reader never sees a torn frame, nor an older one than it saw already
+    int last = 0;
+    int torn = 0;
+    int older = 0;
+
+    while (!done.load()) {
+        std::unique_ptr<Frame> frame = mailbox->take();
+
+        if (!frame) {
+            continue;
+        }
+
+        const int value = getValue(frame);
+        torn += value < 0;
+        older += value >= 0 && value < last;
+        last = value >= 0 ? value : last;
+    }
+
+    capture.join();
+
+    CHECK(torn == 0);
+    CHECK(older == 0);
+    CHECK(getValue(mailbox->take()) == 249);
+}
+
+} // namespace
+
+int main()
+{
+    testFreshness();
+    testPrepare();
+    testConcurrentPolls();
+
+    return finishTest();
+}
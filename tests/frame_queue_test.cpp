@@ -0,0 +1,287 @@
+#include "test_utils.h"
+
+#include <frame_layout.h>
+
+#include "frame_drop_counter.h"
+#include "frame_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+/**
+ * Frame telling its number apart, uncompressed or an H.264 one that is a keyframe, with an IDR slice, or not.
+ */
+struct TestFrame
+{
+    TestFrame(uint8_t number, PixelFormat pixelFormat = PixelFormat::RGB24, bool keyframe = true) :
+        frame()
+    {
+        frame.pixelFormat = pixelFormat;
+
+        if (pixelFormat == PixelFormat::H264) {
+            const uint8_t slice[] = {0, 0, 1, static_cast<uint8_t>(keyframe ? 0x65 : 0x41), number, 0, 0, 0};
+            data.assign(slice, slice + sizeof(slice));
+            frame.plane[0] = data.data();
+            frame.bytes = data.size();
+        } else {
+            data.assign(FrameLayout::setLayout(frame, 8, 2), number);
+            FrameLayout::setLayout(frame, 8, 2, data.data());
+        }
+    }
+
+    Frame frame;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * Callback stuck on its first frame until released, so that the ring fills up behind it, recording the numbers of
+ * the frames it gets.
+ */
+class StuckConsumer
+{
+public:
+    StuckConsumer() :
+        released(false)
+    {
+        // empty
+    }
+
+    FrameCallback getCallback()
+    {
+        return [this](Frame & frame) {
+            std::unique_lock<std::mutex> lock(mutex);
+            numbers.push_back(frame.pixelFormat == PixelFormat::H264 ? frame.plane[0][4] : frame.plane[0][0]);
+            changed.notify_all();
+
+            while (!released) {
+                changed.wait(lock);
+            }
+        };
+    }
+
+    /**
+     * Waits for the callback to get count frames, for at most a few seconds.
+     */
+    bool waitForFrames(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        return changed.wait_for(lock, std::chrono::seconds(3), [this, count]() {
+            return numbers.size() >= count;
+        });
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        changed.notify_all();
+    }
+
+    std::vector<int> getNumbers()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return numbers;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool released;
+    std::vector<int> numbers;
+};
+
+/**
+ * Pushes frames numbered first to last, the way the capture thread does.
+ */
+void pushFrames(const FrameCallback &push, uint8_t first, uint8_t last)
+{
+    for (uint8_t number = first; number <= last; number ++) {
+        TestFrame frame(number);
+        push(frame.frame);
+    }
+}
+
+/**
+ * Fills the ring behind a callback stuck on frame 1, and pushes two frames more, 6 and 7, which find it full.
+ * @return Numbers of the frames the callback got, once released.
+ */
+std::vector<int> overflow(BackpressurePolicy policy, const std::shared_ptr<FrameDropCounter> &drops)
+{
+    StuckConsumer consumer;
+    std::shared_ptr<FrameQueue> queue = std::make_shared<FrameQueue>(consumer.getCallback(), policy, drops, 4);
+    FrameCallback push = FrameQueue::wrapCallback(queue);
+
+    pushFrames(push, 1, 1);
+    CHECK(consumer.waitForFrames(1));
+    pushFrames(push, 2, 7);
+
+    consumer.release();
+    CHECK(consumer.waitForFrames(5));
+    queue->stop();
+
+    return consumer.getNumbers();
+}
+
+void testDropNewest()
+{
+    std::shared_ptr<FrameDropCounter> drops = std::make_shared<FrameDropCounter>();
+    const std::vector<int> numbers = overflow(BackpressurePolicy::DropNewest, drops);
+
+    // the callback catches up on the frames queued first
+    CHECK(numbers == std::vector<int>({1, 2, 3, 4, 5}));
+    CHECK(drops->getStatistics().queueFull == 2);
+}
+
+void testDropOldest()
+{
+    std::shared_ptr<FrameDropCounter> drops = std::make_shared<FrameDropCounter>();
+    const std::vector<int> numbers = overflow(BackpressurePolicy::DropOldest, drops);
+
+    // the callback gets the newest frames
+    CHECK(numbers == std::vector<int>({1, 4, 5, 6, 7}));
+    CHECK(drops->getStatistics().queueFull == 2);
+}
+
+void testBlock()
+{
+    std::shared_ptr<FrameDropCounter> drops = std::make_shared<FrameDropCounter>();
+    StuckConsumer consumer;
+    std::shared_ptr<FrameQueue> queue = std::make_shared<FrameQueue>(consumer.getCallback(), BackpressurePolicy::Block,
+                                        drops, 4);
+    FrameCallback push = FrameQueue::wrapCallback(queue);
+
+    pushFrames(push, 1, 1);
+    CHECK(consumer.waitForFrames(1));
+    pushFrames(push, 2, 5);
+
+    // the capture thread waits for the callback to free a slot
+    std::atomic<bool> pushed(false);
+    std::thread capture([&]() {
+        pushFrames(push, 6, 7);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(!pushed.load());
+
+    consumer.release();
+    capture.join();
+    CHECK(consumer.waitForFrames(7));
+    queue->stop();
+
+    // and no frame is dropped
+    CHECK(consumer.getNumbers() == std::vector<int>({1, 2, 3, 4, 5, 6, 7}));
+    CHECK(drops->getStatistics().queueFull == 0);
+}
+
+void testKeyframesOnly()
+{
+    std::shared_ptr<FrameDropCounter> drops = std::make_shared<FrameDropCounter>();
+    StuckConsumer consumer;
+    std::shared_ptr<FrameQueue> queue = std::make_shared<FrameQueue>(consumer.getCallback(),
+                                        BackpressurePolicy::KeyframesOnly, drops, 4);
+    FrameCallback push = FrameQueue::wrapCallback(queue);
+
+    // a keyframe the callback is stuck on, followed by four frames referencing it, which fill the ring
+    TestFrame first(1, PixelFormat::H264, true);
+    push(first.frame);
+    CHECK(consumer.waitForFrames(1));
+
+    for (uint8_t number = 2; number <= 5; number ++) {
+        TestFrame frame(number, PixelFormat::H264, false);
+        push(frame.frame);
+    }
+
+    // a frame finding the ring full is dropped, along with the ones up to the next keyframe, even with room for them
+    for (uint8_t number = 6; number <= 7; number ++) {
+        TestFrame frame(number, PixelFormat::H264, false);
+        push(frame.frame);
+    }
+
+    CHECK(drops->getStatistics().queueFull == 2);
+
+    // which replaces the queued frames, that it doesn't need, and frames referencing it are queued again
+    TestFrame keyframe(8, PixelFormat::H264, true);
+    push(keyframe.frame);
+    TestFrame next(9, PixelFormat::H264, false);
+    push(next.frame);
+
+    consumer.release();
+    CHECK(consumer.waitForFrames(3));
+    queue->stop();
+
+    CHECK(consumer.getNumbers() == std::vector<int>({1, 8, 9}));
+    CHECK(drops->getStatistics().queueFull == 6);
+
+    // uncompressed frames are all keyframes, each one finding the ring full replaces the queued ones
+    drops->reset();
+    StuckConsumer uncompressed;
+    queue = std::make_shared<FrameQueue>(uncompressed.getCallback(), BackpressurePolicy::KeyframesOnly, drops, 4);
+    push = FrameQueue::wrapCallback(queue);
+
+    pushFrames(push, 1, 1);
+    CHECK(uncompressed.waitForFrames(1));
+    pushFrames(push, 2, 7);
+
+    uncompressed.release();
+    CHECK(uncompressed.waitForFrames(3));
+    queue->stop();
+
+    CHECK(uncompressed.getNumbers() == std::vector<int>({1, 6, 7}));
+    CHECK(drops->getStatistics().queueFull == 4);
+}
+
+void testStop()
+{
+    std::shared_ptr<FrameDropCounter> drops = std::make_shared<FrameDropCounter>();
+    StuckConsumer consumer;
+    std::shared_ptr<FrameQueue> queue = std::make_shared<FrameQueue>(consumer.getCallback(),
+                                        BackpressurePolicy::DropNewest, drops, 4);
+    FrameCallback push = FrameQueue::wrapCallback(queue);
+
+    pushFrames(push, 1, 1);
+    CHECK(consumer.waitForFrames(1));
+    pushFrames(push, 2, 3);
+
+    // stop() waits for the callback, the frames it didn't get to are dropped, every frame is delivered or dropped
+    std::thread stopping([&]() {
+        queue->stop();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    consumer.release();
+    stopping.join();
+
+    const size_t delivered = consumer.getNumbers().size();
+    CHECK(delivered >= 1 && delivered + drops->getStatistics().queueFull == 3);
+
+    // and so are the frames that come in once stopped
+    pushFrames(push, 4, 4);
+    CHECK(consumer.getNumbers().size() == delivered);
+    CHECK(delivered + drops->getStatistics().queueFull == 4);
+}
+
+} // namespace
+
+int main()
+{
+    testDropNewest();
+    testDropOldest();
+    testBlock();
+    testKeyframesOnly();
+    testStop();
+
+    return finishTest();
+}
@@ -0,0 +1,154 @@
+#include "test_utils.h"
+
+#include <frame_layout.h>
+#include <frame_view.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace webcam_capture;
+
+namespace {
+
+bool operator==(const Rect &a, const Rect &b)
+{
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+Rect makeRect(size_t x, size_t y, size_t width, size_t height)
+{
+    Rect rect = Rect();
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+
+    return rect;
+}
+
+Frame makeFrame(PixelFormat pixelFormat, size_t width, size_t height, std::vector<uint8_t> &buffer,
+                size_t stridePadding = 0)
+{
+    Frame frame = Frame();
+    frame.pixelFormat = pixelFormat;
+    FrameLayout::setLayout(frame, width, height);
+
+    if (stridePadding) {
+        const size_t stride = frame.stride[0] + stridePadding;
+        frame = Frame();
+        frame.pixelFormat = pixelFormat;
+        frame.stride[0] = stride;
+    }
+
+    buffer.assign(FrameLayout::setLayout(frame, width, height), 0);
+    FrameLayout::setLayout(frame, width, height, buffer.data());
+
+    return frame;
+}
+
+void testAlignment()
+{
+    std::vector<uint8_t> buffer;
+
+    // 4:2:0 chroma covers 2x2 pixels, the rectangle grows outwards to whole ones
+    const Frame i420 = makeFrame(PixelFormat::I420, 33, 17, buffer);
+    CHECK(FrameView::alignRect(i420, makeRect(3, 5, 6, 4)) == makeRect(2, 4, 8, 6));
+    CHECK(FrameView::alignRect(i420, makeRect(2, 4, 8, 6)) == makeRect(2, 4, 8, 6));
+
+    // and gets clipped to the frame, whose odd last column and row are whole chroma samples of their own
+    CHECK(FrameView::alignRect(i420, makeRect(31, 15, 10, 10)) == makeRect(30, 14, 3, 3));
+
+    // 4:2:2 chroma covers 2x1 pixels
+    const Frame yuy2 = makeFrame(PixelFormat::YUY2, 32, 8, buffer);
+    CHECK(FrameView::alignRect(yuy2, makeRect(3, 3, 2, 1)) == makeRect(2, 3, 4, 1));
+
+    // macropixels of packed formats, 8 pixels for Y41P
+    const Frame y41p = makeFrame(PixelFormat::Y41P, 32, 8, buffer);
+    CHECK(FrameView::alignRect(y41p, makeRect(9, 1, 2, 2)) == makeRect(8, 1, 8, 2));
+
+    // 2x2 cells of Bayer formats, so that the first sample keeps its color
+    const Frame bayer = makeFrame(PixelFormat::BayerRGGB8, 32, 8, buffer);
+    CHECK(FrameView::alignRect(bayer, makeRect(1, 1, 1, 1)) == makeRect(0, 0, 2, 2));
+
+    // RGB pixels stand on their own
+    const Frame rgb = makeFrame(PixelFormat::RGB24, 32, 8, buffer);
+    CHECK(FrameView::alignRect(rgb, makeRect(3, 5, 7, 1)) == makeRect(3, 5, 7, 1));
+
+    // rectangles outside of the frame and empty ones make no view
+    CHECK(FrameView::alignRect(rgb, makeRect(32, 0, 1, 1)).width == 0);
+    CHECK(FrameView::alignRect(rgb, makeRect(0, 8, 1, 1)).width == 0);
+    CHECK(FrameView::alignRect(rgb, makeRect(0, 0, 0, 1)).width == 0);
+
+    // bottom-up frames align their rows where they are in memory, from the bottom, so with an odd height the upright
+    // rows pair up the other way round
+    Frame bottomUp = makeFrame(PixelFormat::I420, 32, 9, buffer);
+    bottomUp.orientation = Orientation::BottomUp;
+    CHECK(FrameView::alignRect(bottomUp, makeRect(0, 1, 2, 2)) == makeRect(0, 1, 2, 2));
+    CHECK(FrameView::alignRect(bottomUp, makeRect(0, 2, 2, 2)) == makeRect(0, 1, 2, 4));
+    CHECK(FrameView::alignRect(bottomUp, makeRect(0, 0, 2, 1)) == makeRect(0, 0, 2, 1));
+}
+
+void testCrop()
+{
+    std::vector<uint8_t> buffer;
+
+    // odd stride, so that nothing lines up by chance
+    const Frame i420 = makeFrame(PixelFormat::I420, 33, 17, buffer, 5);
+    const uint8_t *u = i420.plane[0] + i420.offset[1];
+    const uint8_t *v = i420.plane[0] + i420.offset[2];
+
+    Frame view = Frame();
+    CHECK(FrameView::crop(i420, makeRect(3, 5, 6, 4), view));
+    CHECK(view.pixelFormat == PixelFormat::I420);
+    CHECK(view.width[0] == 8 && view.height[0] == 6);
+    CHECK(view.width[1] == 4 && view.height[1] == 3);
+    CHECK(view.stride[0] == i420.stride[0] && view.stride[1] == i420.stride[1] && view.stride[2] == i420.stride[2]);
+    CHECK(view.plane[0] == i420.plane[0] + 4 * i420.stride[0] + 2);
+    CHECK(view.plane[1] == u + 2 * i420.stride[1] + 1);
+    CHECK(view.plane[2] == v + 2 * i420.stride[2] + 1);
+
+    // the view covers the bytes up to the end of its last chroma row
+    CHECK(view.plane[0] + view.bytes == view.plane[2] + 2 * view.stride[2] + 4);
+
+    // views of views point where a view of the whole frame would
+    Frame nested = Frame();
+    Frame direct = Frame();
+    CHECK(FrameView::crop(view, makeRect(2, 2, 2, 2), nested));
+    CHECK(FrameView::crop(i420, makeRect(4, 6, 2, 2), direct));
+    CHECK(nested.plane[0] == direct.plane[0] && nested.plane[1] == direct.plane[1] &&
+          nested.plane[2] == direct.plane[2]);
+
+    // semi-planar chroma holds a pair of samples per subsampled pixel
+    const Frame nv12 = makeFrame(PixelFormat::NV12, 32, 16, buffer);
+    CHECK(FrameView::crop(nv12, makeRect(6, 4, 4, 4), view));
+    CHECK(view.plane[1] == nv12.plane[0] + nv12.offset[1] + 2 * nv12.stride[1] + 6);
+
+    // packed macropixels are stepped over whole
+    const Frame yuy2 = makeFrame(PixelFormat::YUY2, 32, 8, buffer, 3);
+    CHECK(FrameView::crop(yuy2, makeRect(5, 2, 3, 1), view));
+    CHECK(view.plane[0] == yuy2.plane[0] + 2 * yuy2.stride[0] + 8);
+    CHECK(view.width[0] == 4);
+
+    // bottom-up frames store the upright top row last
+    Frame bottomUp = makeFrame(PixelFormat::RGB24, 8, 8, buffer);
+    bottomUp.orientation = Orientation::BottomUp;
+    CHECK(FrameView::crop(bottomUp, makeRect(1, 0, 2, 3), view));
+    CHECK(view.plane[0] == bottomUp.plane[0] + 5 * bottomUp.stride[0] + 3);
+    CHECK(view.orientation == Orientation::BottomUp);
+
+    // no view of a frame without pixel data or of a rectangle outside of it
+    Frame empty = i420;
+    empty.plane[0] = nullptr;
+    CHECK(!FrameView::crop(empty, makeRect(0, 0, 2, 2), view));
+    CHECK(!FrameView::crop(i420, makeRect(33, 0, 2, 2), view));
+}
+
+} // namespace
+
+int main()
+{
+    testAlignment();
+    testCrop();
+
+    return finishTest();
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <cstdio>
+
+/**
+ * Checks shared by the tests, which are plain executables failing with a non-zero exit code, so that they need nothing
+ * but CMake's ctest to run.
+ */
+
+namespace {
+
+int failures = 0;
+
+/**
+ * Reports the outcome of the checks.
+ * @return The exit code of the test.
+ */
+int finishTest()
+{
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+
+    return 0;
+}
+
+} // namespace
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures ++; \
+        } \
+    } while (0)
+
+#endif // TEST_UTILS_H
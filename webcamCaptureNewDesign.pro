@@ -19,7 +19,54 @@ SOURCES += \
     test_app/videoform.cpp \
     src/backend_factory.cpp \
     src/capability_tree_builder.cpp \
+    src/frame_buffer.cpp \
+    src/frame_buffer_pool.cpp \
+    src/frame_converter.cpp \
+    src/frame_decompresser.cpp \
+    src/frame_drop_counter.cpp \
+    src/frame_deinterlacer.cpp \
+    src/frame_layout.cpp \
+    src/frame_mailbox.cpp \
+    src/frame_pipeline.cpp \
+    src/frame_queue.cpp \
+    src/frame_ref.cpp \
+    src/frame_scaler.cpp \
+    src/frame_view.cpp \
+    src/pixel_format_converter.cpp \
+    src/software_proc_amp.cpp \
     src/unique_id.cpp \
+    src/conversion/conversion_bayer.cpp \
+    src/conversion/conversion_bayer_avx2.cpp \
+    src/conversion/conversion_bayer_sse2.cpp \
+    src/conversion/conversion_cpu_features.cpp \
+    src/conversion/conversion_deinterlace.cpp \
+    src/conversion/conversion_deinterlace_avx2.cpp \
+    src/conversion/conversion_deinterlace_sse2.cpp \
+    src/conversion/conversion_high_bit_depth.cpp \
+    src/conversion/conversion_high_bit_depth_avx2.cpp \
+    src/conversion/conversion_high_bit_depth_sse2.cpp \
+    src/conversion/conversion_jpeg_decoder.cpp \
+    src/conversion/conversion_luma.cpp \
+    src/conversion/conversion_luma_avx2.cpp \
+    src/conversion/conversion_luma_sse2.cpp \
+    src/conversion/conversion_packed_yuv.cpp \
+    src/conversion/conversion_packed_yuv_avx2.cpp \
+    src/conversion/conversion_packed_yuv_sse2.cpp \
+    src/conversion/conversion_planar_yuv.cpp \
+    src/conversion/conversion_planar_yuv_avx2.cpp \
+    src/conversion/conversion_planar_yuv_sse2.cpp \
+    src/conversion/conversion_planner.cpp \
+    src/conversion/conversion_resize.cpp \
+    src/conversion/conversion_resize_avx2.cpp \
+    src/conversion/conversion_rgb.cpp \
+    src/conversion/conversion_rgb_avx2.cpp \
+    src/conversion/conversion_rgb_sse2.cpp \
+    src/conversion/conversion_rgb_to_yuv.cpp \
+    src/conversion/conversion_rgb_to_yuv_avx2.cpp \
+    src/conversion/conversion_rgb_to_yuv_sse2.cpp \
+    src/conversion/conversion_scale.cpp \
+    src/conversion/conversion_thread_pool.cpp \
+    src/conversion/conversion_transform.cpp \
     src/av_foundation/av_foundation_backend.cpp \
     src/av_foundation/av_foundation_unique_id.cpp \
     src/av_foundation/av_foundation_camera.cpp \
@@ -29,10 +76,23 @@ HEADERS  += \
     include/backend_factory.h \
     include/backend_implementation.h \
     include/backend_interface.h \
+    include/backpressure_policy.h \
     include/camera_information.h \
     include/camera_interface.h \
     include/capability.h \
+    include/color_range.h \
+    include/color_space.h \
+    include/decompression_scale.h \
     include/frame.h \
+    include/frame_buffer_pool.h \
+    include/frame_delivery.h \
+    include/frame_drop_statistics.h \
+    include/frame_deinterlacer.h \
+    include/frame_layout.h \
+    include/frame_ref.h \
+    include/frame_scaler.h \
+    include/frame_view.h \
+    include/orientation.h \
     include/pixel_format_converter.h \
     include/pixel_format.h \
     include/unique_id.h \
@@ -42,7 +102,35 @@ HEADERS  += \
     test_app/mainwindow.h \
     test_app/videoform.h \
     src/capability_tree_builder.h \
+    src/frame_buffer.h \
+    src/frame_converter.h \
+    src/frame_decompresser.h \
+    src/frame_drop_counter.h \
+    src/frame_mailbox.h \
+    src/frame_pipeline.h \
+    src/frame_queue.h \
+    src/software_proc_amp.h \
     src/utils.h \
+    src/conversion/conversion_bayer.h \
+    src/conversion/conversion_colorimetry.h \
+    src/conversion/conversion_cpu_features.h \
+    src/conversion/conversion_deinterlace.h \
+    src/conversion/conversion_high_bit_depth.h \
+    src/conversion/conversion_jpeg_decoder.h \
+    src/conversion/conversion_kernels.h \
+    src/conversion/conversion_layouts.h \
+    src/conversion/conversion_luma.h \
+    src/conversion/conversion_packed_yuv.h \
+    src/conversion/conversion_planar_yuv.h \
+    src/conversion/conversion_planner.h \
+    src/conversion/conversion_resize.h \
+    src/conversion/conversion_rgb.h \
+    src/conversion/conversion_rgb_to_yuv.h \
+    src/conversion/conversion_scale.h \
+    src/conversion/conversion_simd_avx2.h \
+    src/conversion/conversion_simd_sse2.h \
+    src/conversion/conversion_thread_pool.h \
+    src/conversion/conversion_transform.h \
     src/av_foundation/av_foundation_backend.h \
     src/av_foundation/av_foundation_implementation.h \
     src/av_foundation/av_foundation_interface.h \
@@ -58,6 +146,7 @@ FORMS    += \
     test_app/videoform.ui
 
 INCLUDEPATH += ./include \
+               $$OUT_PWD/export \
 
 QMAKE_CXXFLAGS += -std=c++11 \
                   -std=c++1y \
@@ -75,3 +164,17 @@ LIBS += -framework AVFoundation
 LIBS += -framework Cocoa
 LIBS += -framework CoreVideo
 LIBS += -framework CoreMedia
+
+# software MJPEG decompression, if libjpeg-turbo is installed
+CONFIG += link_pkgconfig
+packagesExist(libjpeg) {
+    PKGCONFIG += libjpeg
+    DEFINES += WEBCAM_CAPTURE_JPEG
+}
+
+# the public headers include the export header CMake generates for the library, whose sources are built into the app
+# here, so its macro expands to nothing
+EXPORT_HEADER = "$${LITERAL_HASH}ifndef WEBCAM_CAPTURE_EXPORT" \
+                "$${LITERAL_HASH}define WEBCAM_CAPTURE_EXPORT" \
+                "$${LITERAL_HASH}endif"
+write_file($$OUT_PWD/export/webcam_capture_export.h, EXPORT_HEADER)